@@ -0,0 +1,433 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file bench/main.c
+  @brief Sprite batch fill, upload and draw throughput benchmarks.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Every scenario draws one batch of 1k, 100k or 1M sprites, either filled
+           once or rebuilt every frame, and prints one JSON object per line:
+
+             {"scenario":"rebuilt","sprite_count":100000,"frames":300,...}
+
+           Usage: moss_bench [--frames N] [--warmup N]
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __APPLE__
+#  include <mach/mach_time.h>
+#endif
+
+#include <moss/camera.h>
+#include <moss/engine.h>
+#include <moss/result.h>
+#include <moss/sprite.h>
+#include <moss/sprite_batch.h>
+
+/* Default number of measured frames per scenario. */
+#define BENCH_DEFAULT_FRAME_COUNT (uint32_t)(300)
+
+/* Default number of frames run before measuring, covers pipeline and upload warmup. */
+#define BENCH_DEFAULT_WARMUP_FRAME_COUNT (uint32_t)(30)
+
+/* Size of headless frame images in pixels. */
+#define BENCH_FRAME_WIDTH  (uint32_t)(1280)
+#define BENCH_FRAME_HEIGHT (uint32_t)(720)
+
+/* Half extent of the square sprites are scattered over. */
+#define BENCH_WORLD_HALF_EXTENT (1000.0F)
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Benchmark scenario.
+*/
+typedef struct
+{
+  const char *name;         /* Scenario name. */
+  size_t      sprite_count; /* Number of sprites in the batch. */
+  bool        is_rebuilt;   /* Whether the batch is refilled every frame. */
+} BenchScenario;
+
+/*
+  @brief Measured scenario results.
+*/
+typedef struct
+{
+  uint32_t frame_count;     /* Number of measured frames. */
+  double   frame_seconds;   /* CPU time of measured frames. */
+  double   fill_seconds;    /* CPU time spent filling the batch. */
+  uint64_t upload_bytes;    /* Bytes uploaded during measured frames. */
+  uint32_t gpu_frame_count; /* Number of measured frames GPU time was read for. */
+  double   gpu_ms;          /* Sum of GPU render pass times. */
+} BenchResult;
+
+static const BenchScenario g_scenarios[] = {
+  { .name = "static", .sprite_count = 1000, .is_rebuilt = false },
+  { .name = "static", .sprite_count = 100000, .is_rebuilt = false },
+  { .name = "static", .sprite_count = 1000000, .is_rebuilt = false },
+  { .name = "rebuilt", .sprite_count = 1000, .is_rebuilt = true },
+  { .name = "rebuilt", .sprite_count = 100000, .is_rebuilt = true },
+  { .name = "rebuilt", .sprite_count = 1000000, .is_rebuilt = true },
+};
+
+static const MossAppInfo g_app_info = {
+  .app_name    = "Moss Benchmark",
+  .app_version = { 0, 1, 0 },
+};
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Returns monotonic clock time in seconds.
+*/
+static double get_time_seconds (void)
+{
+#ifdef __APPLE__
+  static mach_timebase_info_data_t timebase_info = { 0, 0 };
+  if (timebase_info.denom == 0) { mach_timebase_info (&timebase_info); }
+
+  const uint64_t time_nanos =
+    mach_absolute_time ( ) * timebase_info.numer / timebase_info.denom;
+  return (double)time_nanos / 1000000000.0;
+#else
+  struct timespec time;
+  clock_gettime (CLOCK_MONOTONIC, &time);
+  return (double)time.tv_sec + (double)time.tv_nsec / 1000000000.0;
+#endif
+}
+
+/*
+  @brief Returns next pseudo-random number in [0, 1).
+  @details Fixed xorshift sequence keeps sprites identical between runs.
+*/
+static float next_random (uint32_t *state)
+{
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return (float)(*state >> 8) / 16777216.0F;
+}
+
+/*
+  @brief Generates sprites scattered over the world.
+*/
+static void generate_sprites (MossSprite *sprites, size_t sprite_count)
+{
+  uint32_t random_state = 0x9E3779B9U;
+
+  for (size_t i = 0; i < sprite_count; ++i)
+  {
+    const float size = 4.0F + next_random (&random_state) * 12.0F;
+
+    sprites[ i ] = (MossSprite) {
+      .position      = {
+        (next_random (&random_state) * 2.0F - 1.0F) * BENCH_WORLD_HALF_EXTENT,
+        (next_random (&random_state) * 2.0F - 1.0F) * BENCH_WORLD_HALF_EXTENT,
+      },
+      .size          = { size, size },
+      .depth         = next_random (&random_state),
+      .uv            = {
+        .top_left     = { 0.0F, 0.0F },
+        .bottom_right = { 1.0F, 1.0F },
+      },
+      .texture_index = 0,
+    };
+  }
+}
+
+/*
+  @brief Fills sprite batch with sprites.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+static MossResult fill_sprite_batch (
+  MossSpriteBatch  *sprite_batch,
+  const MossSprite *sprites,
+  size_t            sprite_count
+)
+{
+  moss_clear_sprite_batch (sprite_batch);
+
+  if (moss_begin_sprite_batch (sprite_batch) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  const MossAddSpritesToSpriteBatchInfo add_info = {
+    .sprites      = sprites,
+    .sprite_count = sprite_count,
+  };
+  if (moss_add_sprites_to_sprite_batch (sprite_batch, &add_info) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  return moss_end_sprite_batch (sprite_batch);
+}
+
+/*
+  @brief Runs one benchmark scenario.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+static MossResult run_scenario (
+  MossEngine          *engine,
+  const BenchScenario *scenario,
+  const MossSprite    *sprites,
+  uint32_t             warmup_frame_count,
+  uint32_t             frame_count,
+  BenchResult         *out_result
+)
+{
+  const MossSpriteBatchCreateInfo create_info = {
+    .engine   = engine,
+    .capacity = scenario->sprite_count,
+    .mode     = MOSS_SPRITE_BATCH_MODE_INSTANCED,
+    .usage    = scenario->is_rebuilt ? MOSS_SPRITE_BATCH_USAGE_STREAM
+                                     : MOSS_SPRITE_BATCH_USAGE_STATIC,
+  };
+  MossSpriteBatch *const sprite_batch = moss_create_sprite_batch (&create_info);
+  if (sprite_batch == NULL) { return MOSS_RESULT_ERROR; }
+
+  if (!scenario->is_rebuilt &&
+      fill_sprite_batch (sprite_batch, sprites, scenario->sprite_count) !=
+        MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_sprite_batch (sprite_batch);
+    return MOSS_RESULT_ERROR;
+  }
+
+  *out_result = (BenchResult) { .frame_count = frame_count };
+
+  // GPU time arrives a few frames late, so it's matched by frame index
+  uint64_t first_measured_frame_index = 0;
+  uint64_t last_gpu_frame_index       = 0;
+
+  MossResult result = MOSS_RESULT_SUCCESS;
+  for (uint32_t i = 0; i < warmup_frame_count + frame_count; ++i)
+  {
+    const bool   is_measured = i >= warmup_frame_count;
+    const double frame_start = get_time_seconds ( );
+
+    if (moss_begin_frame (engine) != MOSS_RESULT_SUCCESS)
+    {
+      result = MOSS_RESULT_ERROR;
+      break;
+    }
+
+    if (scenario->is_rebuilt)
+    {
+      const double fill_start = get_time_seconds ( );
+      if (fill_sprite_batch (sprite_batch, sprites, scenario->sprite_count) !=
+          MOSS_RESULT_SUCCESS)
+      {
+        result = MOSS_RESULT_ERROR;
+      }
+      if (is_measured) { out_result->fill_seconds += get_time_seconds ( ) - fill_start; }
+    }
+
+    if (result == MOSS_RESULT_SUCCESS)
+    {
+      result = moss_draw_sprite_batch (engine, sprite_batch);
+    }
+
+    // Frame has to be ended even if recording failed
+    if (moss_end_frame (engine) != MOSS_RESULT_SUCCESS) { result = MOSS_RESULT_ERROR; }
+    if (result != MOSS_RESULT_SUCCESS) { break; }
+
+    MossFrameStats stats;
+    moss_get_frame_stats (engine, &stats);
+
+    if (!is_measured)
+    {
+      last_gpu_frame_index = stats.gpu_frame_index;
+      continue;
+    }
+
+    out_result->frame_seconds += get_time_seconds ( ) - frame_start;
+    out_result->upload_bytes += stats.upload_bytes;
+
+    if (first_measured_frame_index == 0)
+    {
+      first_measured_frame_index = stats.frame_index;
+    }
+
+    if (stats.has_gpu_time && stats.gpu_frame_index > last_gpu_frame_index &&
+        stats.gpu_frame_index >= first_measured_frame_index)
+    {
+      out_result->gpu_ms += stats.gpu_render_ms;
+      ++out_result->gpu_frame_count;
+    }
+    last_gpu_frame_index = stats.gpu_frame_index;
+  }
+
+  moss_destroy_sprite_batch (sprite_batch);
+
+  return result;
+}
+
+/*
+  @brief Prints scenario results as one JSON object line.
+*/
+static void print_result (const BenchScenario *scenario, const BenchResult *result)
+{
+  const double frame_count = (double)result->frame_count;
+
+  printf (
+    "{\"scenario\":\"%s\",\"sprite_count\":%zu,\"frames\":%u,"
+    "\"sprites_per_sec\":%.1f,\"upload_gb_per_sec\":%.3f,"
+    "\"cpu_ms_per_frame\":%.4f,\"fill_ms_per_frame\":%.4f,",
+    scenario->name,
+    scenario->sprite_count,
+    result->frame_count,
+    (double)scenario->sprite_count * frame_count / result->frame_seconds,
+    (double)result->upload_bytes / result->frame_seconds / 1000000000.0,
+    result->frame_seconds * 1000.0 / frame_count,
+    result->fill_seconds * 1000.0 / frame_count
+  );
+
+  // Devices without timestamp support report no GPU time
+  if (result->gpu_frame_count > 0)
+  {
+    printf (
+      "\"gpu_ms_per_frame\":%.4f}\n",
+      result->gpu_ms / (double)result->gpu_frame_count
+    );
+  }
+  else {
+    printf ("\"gpu_ms_per_frame\":null}\n");
+  }
+
+  fflush (stdout);
+}
+
+/*
+  @brief Parses unsigned integer option value.
+  @return Returns true on success, false otherwise.
+*/
+static bool parse_count (const char *value, uint32_t *out_count)
+{
+  char *end = NULL;
+
+  const unsigned long count = strtoul (value, &end, 10);
+  if (end == value || *end != '\0' || count > UINT32_MAX) { return false; }
+
+  *out_count = (uint32_t)count;
+  return true;
+}
+
+int main (int argc, char **argv)
+{
+  uint32_t frame_count        = BENCH_DEFAULT_FRAME_COUNT;
+  uint32_t warmup_frame_count = BENCH_DEFAULT_WARMUP_FRAME_COUNT;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const bool has_value = i + 1 < argc;
+
+    if (has_value && strcmp (argv[ i ], "--frames") == 0 &&
+        parse_count (argv[ i + 1 ], &frame_count) && frame_count > 0)
+    {
+      ++i;
+      continue;
+    }
+
+    if (has_value && strcmp (argv[ i ], "--warmup") == 0 &&
+        parse_count (argv[ i + 1 ], &warmup_frame_count))
+    {
+      ++i;
+      continue;
+    }
+
+    fprintf (stderr, "usage: %s [--frames N] [--warmup N]\n", argv[ 0 ]);
+    return EXIT_FAILURE;
+  }
+
+  // Nothing is presented, so frames aren't throttled by the display
+  const MossEngineConfig engine_config = {
+    .app_info        = &g_app_info,
+    .enable_headless = true,
+    .headless_width  = BENCH_FRAME_WIDTH,
+    .headless_height = BENCH_FRAME_HEIGHT,
+  };
+  MossEngine *const engine = moss_create_engine (&engine_config);
+  if (engine == NULL) { return EXIT_FAILURE; }
+
+  // Whole world is in view, so every sprite is rasterized
+  MossCamera *const camera = moss_get_camera (engine);
+  const float world_extent = BENCH_WORLD_HALF_EXTENT * 2.0F;
+  moss_set_camera_position (camera, (vec2) { 0.0F, 0.0F });
+  moss_set_camera_size (camera, (vec2) { world_extent * 16.0F / 9.0F, world_extent });
+
+  const size_t scenario_count = sizeof (g_scenarios) / sizeof (g_scenarios[ 0 ]);
+
+  size_t max_sprite_count = 0;
+  for (size_t i = 0; i < scenario_count; ++i)
+  {
+    if (g_scenarios[ i ].sprite_count > max_sprite_count)
+    {
+      max_sprite_count = g_scenarios[ i ].sprite_count;
+    }
+  }
+
+  MossSprite *const sprites = malloc (sizeof (MossSprite) * max_sprite_count);
+  if (sprites == NULL)
+  {
+    fprintf (stderr, "Failed to allocate memory for sprites.\n");
+    moss_destroy_engine (engine);
+    return EXIT_FAILURE;
+  }
+  generate_sprites (sprites, max_sprite_count);
+
+  int exit_code = EXIT_SUCCESS;
+  for (size_t i = 0; i < scenario_count; ++i)
+  {
+    BenchResult result;
+    if (run_scenario (
+          engine,
+          &g_scenarios[ i ],
+          sprites,
+          warmup_frame_count,
+          frame_count,
+          &result
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      fprintf (
+        stderr,
+        "Scenario %s with %zu sprites failed.\n",
+        g_scenarios[ i ].name,
+        g_scenarios[ i ].sprite_count
+      );
+      exit_code = EXIT_FAILURE;
+      break;
+    }
+
+    print_result (&g_scenarios[ i ], &result);
+  }
+
+  free (sprites);
+  moss_destroy_engine (engine);
+
+  return exit_code;
+}
@@ -37,6 +37,7 @@
 #include <moss/engine.h>
 #include <moss/result.h>
 #include <moss/sprite.h>
+#include <moss/texture.h>
 
 #include <stuffy/app.h>
 #include <stuffy/input/keyboard.h>
@@ -81,6 +82,8 @@ int main (void)
   const MossEngineConfig moss_engine_config = {
     .app_info                    = &moss_app_info,
     .get_window_framebuffer_size = get_window_framebuffer_size,
+    .enable_bindless_textures    = true,
+    .pipeline_cache_path         = "pipeline_cache.bin",
 #ifdef __APPLE__
     .metal_layer = metal_layer,
 #endif
@@ -97,6 +100,17 @@ int main (void)
   moss_set_camera_size (camera, camera_size);
   moss_set_camera_position (camera, camera_position);
 
+  // Load texture atlas
+  const MossTextureCreateFromFileInfo texture_info = {
+    .engine           = engine,
+    .file_path        = "textures/atlas.png",
+    .generate_mipmaps = true,
+  };
+  MossTexture *const atlas = moss_create_texture_from_file (&texture_info);
+
+  // Atlas slot in the bindless texture array, slot 0 is plain white
+  const uint32_t atlas_index = atlas != NULL ? moss_get_texture_index (atlas) : 0;
+
   // Create 1000000 static sprites with random positions and sizes
   const size_t NUM_SPRITES = 700000;
   MossSprite  *sprites     = malloc (sizeof (MossSprite) * NUM_SPRITES);
@@ -124,12 +138,16 @@ int main (void)
     sprites[ i ].uv.top_left[ 1 ]     = 0.0F;
     sprites[ i ].uv.bottom_right[ 0 ] = 1.0F;
     sprites[ i ].uv.bottom_right[ 1 ] = 1.0F;
+
+    sprites[ i ].texture_index = atlas_index;
   }
 
   // Create sprite batch
   const MossSpriteBatchCreateInfo sprite_batch_info = {
     .engine   = engine,
     .capacity = NUM_SPRITES,
+    .mode     = MOSS_SPRITE_BATCH_MODE_INSTANCED,
+    .texture  = atlas,
   };
   MossSpriteBatch *const sprite_batch = moss_create_sprite_batch (&sprite_batch_info);
 
@@ -424,6 +442,7 @@ int main (void)
   // Cleanup
   free (sprites);
   moss_destroy_sprite_batch (sprite_batch);
+  moss_destroy_texture (atlas);
   moss_destroy_engine (engine);
   stuffy_window_close (g_window);
   stuffy_app_deinit ( );
@@ -1,14 +0,0 @@
-#version 450
-
-layout(location = 0) in vec2 fragTexCoord;
-
-layout(location = 0) out vec4 outColor;
-
-layout(binding = 1) uniform sampler2D texSampler;
-
-void main() {
-    outColor = texture(texSampler, fragTexCoord);
-
-    if (outColor.a < 0.01) { discard; }
-}
-
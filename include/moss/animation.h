@@ -0,0 +1,83 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file include/moss/animation.h
+  @brief Sprite animation clip declarations.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Clips are UV frame tables stored on the GPU. Sprites of instanced batches
+           refer to a clip with MossSprite.animation_clip and the vertex shader
+           picks the current frame from the frame time, so animated sprites stay
+           in static batches without being refilled.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cglm/vec2.h>
+
+#include "moss/engine.h"
+#include "moss/result.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief UV rect of a single animation frame.
+*/
+typedef struct
+{
+  vec2 top_left;     /* UV coords of the top left corner on texture atlas. */
+  vec2 bottom_right; /* UV coords of the bottom right corner on texture atlas. */
+} MossAnimationFrame;
+
+/*
+  @brief Animation clip create info.
+*/
+typedef struct
+{
+  MossEngine               *engine;         /* Engine handle. */
+  const MossAnimationFrame *frames;         /* Frames in playback order. */
+  uint32_t                  frame_count;    /* Number of frames. */
+  float                     frame_duration; /* Seconds every frame is shown for. */
+  bool                      is_looped;      /* Whether to loop, or hold last frame. */
+} MossAnimationClipCreateInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Registers animation clip with the engine.
+  @details Clips stay registered until the engine is destroyed. Frames are uploaded
+           with the next frame.
+  @param info Required operation info.
+  @param out_clip Output clip ID to store in MossSprite.animation_clip, never 0.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+*/
+MossResult
+moss_create_animation_clip (const MossAnimationClipCreateInfo *info, uint32_t *out_clip);
+
+/*
+  @brief Returns animation time of the current frame.
+  @details Time is counted in seconds from engine creation and sampled by
+           moss_begin_frame. Store it in MossSprite.animation_start_time to start
+           an animation from its first frame.
+  @param engine Engine handle.
+  @return Animation time in seconds.
+*/
+float moss_get_animation_time (const MossEngine *engine);
@@ -33,6 +33,41 @@ typedef struct MossCamera MossCamera;
 */
 MossCamera *moss_get_camera (MossEngine *engine);
 
+/*
+  @brief Creates camera.
+  @details Camera is independent of the engine's one and covers the whole
+           framebuffer until its viewport is set. Any number of cameras may be used
+           within a frame, each draw is recorded with the camera set at that point.
+  @param engine Engine handle.
+  @return On success returns valid pointer to camera, otherwise returns NULL.
+*/
+MossCamera *moss_create_camera (MossEngine *engine);
+
+/*
+  @brief Destroys camera.
+  @details Camera must not be set to any command recorder. The engine's camera
+           must not be destroyed.
+  @param camera Camera handle.
+*/
+void moss_destroy_camera (MossCamera *camera);
+
+/*
+  @brief Sets camera the main command recorder records following draws with.
+  @details Engine's camera is used by default. Camera may be changed between draws
+           and stays set across frames.
+  @param engine Engine handle.
+  @param camera Camera handle.
+*/
+void moss_set_camera (MossEngine *engine, MossCamera *camera);
+
+/*
+  @brief Sets camera the command recorder records following draws with.
+  @details Engine's camera is used by default.
+  @param recorder Command recorder handle.
+  @param camera Camera handle.
+*/
+void moss_set_command_recorder_camera (MossCommandRecorder *recorder, MossCamera *camera);
+
 /*
   @brief Sets camera position.
   @param camera Camera handle.
@@ -46,3 +81,14 @@ void moss_set_camera_position (MossCamera *camera, const vec2 new_position);
   @param new_size New size to resize camera to.
 */
 void moss_set_camera_size (MossCamera *camera, const vec2 new_size);
+
+/*
+  @brief Sets region of the framebuffer the camera renders to.
+  @details Position and size are normalized, { 0, 0 } and { 1, 1 } cover the whole
+           framebuffer. Split screen or a minimap is drawn with a camera per region,
+           camera size should match the region aspect ratio.
+  @param camera Camera handle.
+  @param position Top left corner of the viewport.
+  @param size Size of the viewport, must be positive.
+*/
+void moss_set_camera_viewport (MossCamera *camera, const vec2 position, const vec2 size);
@@ -21,12 +21,19 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "moss/apidef.h"
 #include "moss/app_info.h"
 #include "moss/result.h"
 
+/* Maximum number of command recorders. */
+#define MOSS_MAX_COMMAND_RECORDER_COUNT (uint32_t)(16)
+
+/* Maximum number of frames in flight. */
+#define MOSS_MAX_FRAMES_IN_FLIGHT (uint32_t)(3)
+
 /*=============================================================================
     STRUCTURES
   =============================================================================*/
@@ -36,6 +43,18 @@
 */
 typedef struct MossEngine MossEngine;
 
+/*
+  @brief Command recorder.
+  @details Records draws of one thread into a secondary command buffer of the frame.
+*/
+typedef struct MossCommandRecorder MossCommandRecorder;
+
+/*
+  @brief Frame readback.
+  @details Host-visible copy of a headless frame image, see moss_request_frame_readback.
+*/
+typedef struct MossFrameReadback MossFrameReadback;
+
 /*
   @brief Callback function to get window framebuffer size.
   @details This callback is called whenever the engine needs to know the current
@@ -46,6 +65,63 @@ typedef struct MossEngine MossEngine;
 */
 typedef void (*MossGetWindowFramebufferSizeCallback) (uint32_t *width, uint32_t *height);
 
+/*
+  @brief Swap chain present mode.
+  @details FIFO is used if the surface doesn't support the preferred mode.
+*/
+typedef enum
+{
+  /* Newest frame replaces the queued one on vertical blank, no tearing. */
+  MOSS_PRESENT_MODE_MAILBOX = 0,
+  /* Frames are presented right away and may tear, lowest latency. */
+  MOSS_PRESENT_MODE_IMMEDIATE,
+  /* Frames are queued and presented on vertical blank, lowest power usage. */
+  MOSS_PRESENT_MODE_FIFO,
+  /* Like FIFO, but a frame that missed vertical blank is presented right away. */
+  MOSS_PRESENT_MODE_FIFO_RELAXED,
+} MossPresentMode;
+
+/*
+  @brief Host memory allocator.
+  @details Every CPU allocation of the engine goes through it, including ones the
+           Vulkan driver makes for engine objects. Returned memory must be aligned
+           like malloc one, stricter alignments are handled by the engine.
+           Callbacks are called from the texture loader thread too, so they must
+           be thread safe. Pixels decoded by stb_image still use malloc.
+*/
+typedef struct
+{
+  /* Allocates size bytes, returns NULL on failure. */
+  void *(*allocate) (void *user_data, size_t size);
+  /* Resizes memory returned by allocate, returns NULL on failure. */
+  void *(*reallocate) (void *user_data, void *memory, size_t size);
+  /* Frees memory returned by allocate or reallocate. */
+  void (*free) (void *user_data, void *memory);
+  /* User data passed to every callback. */
+  void *user_data;
+} MossAllocator;
+
+/*
+  @brief Category host allocations are counted in.
+*/
+typedef enum
+{
+  /* Engine, recorders, queues, cameras, animation clips, tilemaps and particles. */
+  MOSS_ALLOCATION_CATEGORY_ENGINE = 0,
+  /* Sprite batches, their chunks, dirty ranges and sort buffers. */
+  MOSS_ALLOCATION_CATEGORY_SPRITE_BATCH,
+  /* Textures and decoded pixels. */
+  MOSS_ALLOCATION_CATEGORY_TEXTURE,
+  /* Device memory allocator bookkeeping. */
+  MOSS_ALLOCATION_CATEGORY_DEVICE_MEMORY,
+  /* Allocations the Vulkan driver makes through VkAllocationCallbacks. */
+  MOSS_ALLOCATION_CATEGORY_VULKAN,
+  /* Temporary buffers freed before the function that allocated them returns. */
+  MOSS_ALLOCATION_CATEGORY_TEMPORARY,
+  /* Number of allocation categories. */
+  MOSS_ALLOCATION_CATEGORY_COUNT,
+} MossAllocationCategory;
+
 /*
   @brief Moss engine configuration.
 */
@@ -54,11 +130,108 @@ typedef struct
   const MossAppInfo *app_info; /* Application info. */
   MossGetWindowFramebufferSizeCallback
     get_window_framebuffer_size; /* Callback to get framebuffer size. */
+  /* Whether to sample textures from one bindless array indexed per sprite. Falls
+     back to per-batch textures if the device lacks descriptor indexing support. */
+  bool enable_bindless_textures;
+  /* Path of the file compiled pipelines are cached in between runs. The cache is
+     loaded on engine creation and saved on destruction, NULL disables it. */
+  const char *pipeline_cache_path;
+  /* Number of command recorders draws can be recorded with in parallel, up to
+     MOSS_MAX_COMMAND_RECORDER_COUNT. Zero records every draw inline. */
+  uint32_t command_recorder_count;
+  /* Whether to render into engine-owned images instead of a window surface, frames
+     are read back with moss_request_frame_readback. get_window_framebuffer_size
+     and metal_layer are ignored then. */
+  bool     enable_headless;
+  uint32_t headless_width;  /* Width of headless frame images in pixels. */
+  uint32_t headless_height; /* Height of headless frame images in pixels. */
+  /* Number of frames recorded while previous ones are rendered, up to
+     MOSS_MAX_FRAMES_IN_FLIGHT. Zero uses two. */
+  uint32_t        frames_in_flight_count;
+  MossPresentMode present_mode; /* Preferred swap chain present mode. */
+  /* Whether moss_begin_frame waits until the previous frame is displayed, so the
+     next one is recorded as late as possible. Waits until the previous frame is
+     rendered if the device doesn't support present wait. */
+  bool enable_low_latency;
+  /* Host memory allocator, NULL uses malloc, realloc and free. Must stay valid
+     until the engine is destroyed. */
+  const MossAllocator *allocator;
 #ifdef __APPLE__
   void *metal_layer; /* Metal layer (CAMetalLayer*). */
 #endif
 } MossEngineConfig;
 
+/*
+  @brief GPU memory allocation statistics.
+  @details Buffers and images are sub-allocated from large device memory blocks.
+*/
+typedef struct
+{
+  uint32_t block_count;      /* Number of device memory blocks. */
+  uint32_t allocation_count; /* Number of live buffer and image allocations. */
+  uint64_t block_bytes;      /* Total size of device memory blocks in bytes. */
+  uint64_t allocation_bytes; /* Total size of live allocations in bytes. */
+} MossMemoryStats;
+
+/*
+  @brief Host allocation counters.
+*/
+typedef struct
+{
+  uint64_t live_bytes;            /* Bytes allocated and not freed yet. */
+  uint64_t peak_bytes;            /* Highest live bytes observed. */
+  uint64_t allocation_count;      /* Number of allocations and reallocations made. */
+  uint64_t live_allocation_count; /* Number of allocations not freed yet. */
+} MossAllocationCounters;
+
+/*
+  @brief Host memory allocation statistics.
+  @details Counters are updated on every allocation, so comparing allocation
+           counts of two frames shows whether anything was allocated in between.
+           Peak of the total is tracked separately from peaks of categories.
+*/
+typedef struct
+{
+  MossAllocationCounters total; /* Counters of all categories together. */
+  MossAllocationCounters categories[ MOSS_ALLOCATION_CATEGORY_COUNT ]; /* Per category. */
+} MossHostMemoryStats;
+
+/*
+  @brief Frame statistics.
+  @details CPU timings and counters are of the last ended frame. GPU time is read
+           back without stalling once the frame slot is reused, so it's of an older
+           frame, see gpu_frame_index.
+*/
+typedef struct
+{
+  uint64_t frame_index;        /* Index of the frame CPU timings and counters are of. */
+  double   cpu_pacing_wait_ms; /* Time spent waiting in low-latency mode. */
+  double   cpu_fence_wait_ms;  /* Time spent waiting for the frame slot fence. */
+  double   cpu_acquire_ms;     /* Time spent acquiring swap chain image. */
+  double   cpu_submit_ms;      /* Time spent submitting uploads and frame commands. */
+  double   cpu_present_ms;     /* Time spent presenting swap chain image. */
+  uint32_t draw_call_count;    /* Number of recorded draw calls. */
+  uint64_t sprite_count;       /* Number of sprites drawn, before GPU culling. */
+  uint64_t upload_bytes;       /* Bytes uploaded since the previous frame, including
+                                  data written in place to stream batches. */
+  bool     has_gpu_time;       /* Whether GPU time was read back, false if the device
+                                  doesn't support timestamps. */
+  uint64_t gpu_frame_index;    /* Index of the frame GPU time is of. */
+  double   gpu_render_ms;      /* GPU time of the frame render pass. */
+} MossFrameStats;
+
+/*
+  @brief Pixels of a completed frame readback.
+*/
+typedef struct
+{
+  const void *pixels;      /* RGBA8 sRGB pixels, rows go from top to bottom. */
+  uint32_t    width;       /* Image width in pixels. */
+  uint32_t    height;      /* Image height in pixels. */
+  uint32_t    row_pitch;   /* Distance between rows in bytes. */
+  uint64_t    frame_index; /* Index of the frame pixels are of, see MossFrameStats. */
+} MossFrameReadbackData;
+
 /*=============================================================================
     FUNCTIONS
   =============================================================================*/
@@ -79,9 +252,10 @@ __MOSS_API__ void moss_destroy_engine (MossEngine *engine);
 
 /*
   @brief Begins a new frame.
-  @details Acquires the next swap chain image, begins command buffer recording,
-           and begins the render pass. After calling this function, you can call
-           drawing functions like moss_draw_sprite_batch.
+  @details Acquires the next swap chain image, or takes the next headless image,
+           begins command buffer recording, and begins the render pass. After
+           calling this function, you can call drawing functions like
+           moss_draw_sprite_batch.
   @param engine Engine handle.
   @return On success return MOSS_RESULT_SUCCESS, otherwise returns MOSS_RESULT_ERROR.
   @note Must be paired with moss_end_frame.
@@ -91,9 +265,95 @@ __MOSS_API__ MossResult moss_begin_frame (MossEngine *engine);
 /*
   @brief Ends the current frame.
   @details Ends the render pass, ends command buffer recording, submits the command
-           buffer to the graphics queue, and presents the swap chain image.
+           buffer to the graphics queue, and presents the swap chain image
+           unless the engine is headless.
   @param engine Engine handle.
   @return On success return MOSS_RESULT_SUCCESS, otherwise returns MOSS_RESULT_ERROR.
   @note Must be paired with moss_begin_frame.
 */
 __MOSS_API__ MossResult moss_end_frame (MossEngine *engine);
+
+/*
+  @brief Begins recording draws with a command recorder.
+  @details Every recorder owns a command pool per frame in flight, so recorders can
+           be begun and used from different threads at the same time. Draws are
+           recorded with moss_record_sprite_batch.
+  @param engine Engine handle, frame must be begun.
+  @param recorder_index Index of the recorder, less than command_recorder_count.
+  @return On success returns recorder handle, otherwise returns NULL.
+  @note Each recorder can be begun once per frame and must be ended with
+        moss_end_command_recorder before moss_end_frame.
+*/
+__MOSS_API__ MossCommandRecorder *
+moss_begin_command_recorder (MossEngine *engine, uint32_t recorder_index);
+
+/*
+  @brief Ends recording draws with a command recorder.
+  @details Recorded draws are executed on moss_end_frame after the draws of
+           moss_draw_sprite_batch, recorders go in index order.
+  @param recorder Command recorder handle.
+  @return On success return MOSS_RESULT_SUCCESS, otherwise returns MOSS_RESULT_ERROR.
+*/
+__MOSS_API__ MossResult moss_end_command_recorder (MossCommandRecorder *recorder);
+
+/*
+  @brief Requests readback of the current frame image.
+  @details The image is copied to host-visible memory once the frame is rendered.
+           The copy is submitted after the frame and completes on its own, poll it
+           with moss_poll_frame_readback instead of waiting for later frames.
+  @param engine Engine handle, must be headless and the frame must be begun.
+  @return On success returns readback handle, otherwise returns NULL. Fails if
+          MAX_FRAME_READBACK_COUNT readbacks are in use.
+  @note Readback must be released with moss_release_frame_readback.
+*/
+__MOSS_API__ MossFrameReadback *moss_request_frame_readback (MossEngine *engine);
+
+/*
+  @brief Checks whether frame readback is completed without waiting for it.
+  @param readback Frame readback handle.
+  @param out_data Output pixels, filled only if the readback is completed.
+  @return Returns true if the readback is completed, false otherwise.
+  @note Pixels stay valid until the readback is released.
+*/
+__MOSS_API__ bool
+moss_poll_frame_readback (MossFrameReadback *readback, MossFrameReadbackData *out_data);
+
+/*
+  @brief Releases frame readback.
+  @details Waits for the copy if it isn't completed yet, so releasing a readback
+           that is still in flight stalls.
+  @param readback Frame readback handle.
+*/
+__MOSS_API__ void moss_release_frame_readback (MossFrameReadback *readback);
+
+/*
+  @brief Returns GPU memory allocation statistics.
+  @param engine Engine handle.
+  @param out_stats Output statistics.
+*/
+__MOSS_API__ void
+moss_get_memory_stats (const MossEngine *engine, MossMemoryStats *out_stats);
+
+/*
+  @brief Returns host memory allocation statistics.
+  @param engine Engine handle.
+  @param out_stats Output statistics.
+*/
+__MOSS_API__ void
+moss_get_host_memory_stats (const MossEngine *engine, MossHostMemoryStats *out_stats);
+
+/*
+  @brief Returns frame statistics.
+  @param engine Engine handle.
+  @param out_stats Output statistics.
+*/
+__MOSS_API__ void
+moss_get_frame_stats (const MossEngine *engine, MossFrameStats *out_stats);
+
+/*
+  @brief Checks whether textures are sampled from the bindless texture array.
+  @param engine Engine handle.
+  @return Returns true if bindless textures were requested and are supported by the
+          device, false otherwise.
+*/
+__MOSS_API__ bool moss_is_bindless_textures_enabled (const MossEngine *engine);
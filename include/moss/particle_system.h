@@ -0,0 +1,154 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file include/moss/particle_system.h
+  @brief Particle system struct and function declarations.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Particle system keeps particle state in device-local storage buffers. A
+           compute shader emits and simulates particles in moss_begin_frame and
+           writes sprite instances of alive ones, which are drawn with a single
+           indirect draw through the instanced sprite pipeline. Particles never go
+           through host memory.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cglm/vec2.h>
+
+#include "moss/engine.h"
+#include "moss/result.h"
+#include "moss/sprite_batch.h"
+#include "moss/texture.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Particle system.
+*/
+typedef struct MossParticleSystem MossParticleSystem;
+
+/*
+  @brief Particle emitter parameters.
+  @details Parameters given as a min and max pair are sampled uniformly between them
+           for every emitted particle.
+*/
+typedef struct
+{
+  vec2  position;        /* World position particles are emitted around. */
+  vec2  position_spread; /* World size of the rect around position to emit in. */
+  vec2  min_velocity;    /* Minimum initial velocity in world units per second. */
+  vec2  max_velocity;    /* Maximum initial velocity in world units per second. */
+  vec2  acceleration;    /* Acceleration of every alive particle, e.g. gravity. */
+  float min_lifetime;    /* Minimum lifetime in seconds. */
+  float max_lifetime;    /* Maximum lifetime in seconds. */
+  vec2  start_size;      /* World size of a particle when it's emitted. */
+  vec2  end_size;        /* World size of a particle at the end of its lifetime. */
+  float emission_rate;   /* Number of particles emitted per second. */
+} MossParticleEmitter;
+
+/*
+  @brief Particle system create info.
+  @note Particles are emitted into a ring of capacity slots, once the ring is full
+        the oldest particles are replaced. Keep capacity above emission rate times
+        max lifetime to let every particle live out its lifetime.
+  @note Draw order of particles is unspecified, translucent particles of one system
+        are blended in arbitrary order.
+  @note Texture is sampled as in instanced sprite batches, animated particles start
+        playing the clip when they are emitted.
+*/
+typedef struct
+{
+  MossEngine             *engine;   /* Engine handle. */
+  uint32_t                capacity; /* Maximum number of alive particles. */
+  MossTexture            *texture;  /* Texture to draw with, NULL for white. */
+  MossSpriteBatchMaterial material; /* Blending and depth writes of particles. */
+  float                   depth;    /* Depth particles are drawn at. */
+  struct
+  {
+    vec2 top_left;     /* UV coords of the top left corner on texture atlas. */
+    vec2 bottom_right; /* UV coords of the bottom right on texture atlas. */
+  } uv;
+  uint32_t                   animation_clip; /* Animation clip ID, 0 if not animated. */
+  float                      animation_rate; /* Playback speed, 1 plays at frame rate. */
+  const MossParticleEmitter *emitter;        /* Initial emitter parameters. */
+} MossParticleSystemCreateInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Creates particle system.
+  @details Particles are first simulated in the next moss_begin_frame.
+  @param info Required operation info.
+  @return Returns a valid pointer to a particle system on success, otherwise returns
+          NULL.
+*/
+MossParticleSystem *
+moss_create_particle_system (const MossParticleSystemCreateInfo *info);
+
+/*
+  @brief Destroys particle system.
+  @param particle_system Particle system handle.
+*/
+void moss_destroy_particle_system (MossParticleSystem *particle_system);
+
+/*
+  @brief Sets emitter parameters of a particle system.
+  @details Takes effect on the next simulation step, alive particles keep their
+           velocity and lifetime.
+  @param particle_system Particle system handle.
+  @param emitter Emitter parameters.
+*/
+void moss_set_particle_system_emitter (
+  MossParticleSystem        *particle_system,
+  const MossParticleEmitter *emitter
+);
+
+/*
+  @brief Emits a burst of particles on the next simulation step.
+  @details Burst is emitted in addition to particles of the emission rate.
+  @param particle_system Particle system handle.
+  @param particle_count Number of particles to emit.
+*/
+void moss_emit_particles (MossParticleSystem *particle_system, uint32_t particle_count);
+
+/*
+  @brief Draws particle system.
+  @details Draws particles simulated in the current frame. Nothing is drawn until
+           the system is first simulated.
+  @param engine Engine handle.
+  @param particle_system Particle system handle.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+*/
+MossResult
+moss_draw_particle_system (MossEngine *engine, MossParticleSystem *particle_system);
+
+/*
+  @brief Records particle system draw with a command recorder.
+  @details Same as moss_draw_particle_system, but can be called from the thread that
+           owns the recorder in parallel with other recorders.
+  @param recorder Command recorder handle, must be begun.
+  @param particle_system Particle system handle.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+*/
+MossResult moss_record_particle_system (
+  MossCommandRecorder *recorder,
+  MossParticleSystem  *particle_system
+);
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <cglm/vec2.h>
 
 #include "moss/engine.h"
@@ -27,7 +29,11 @@
 
 /*
   @brief Sprite.
-  @details Represents info that is used to draw a rectangle.
+  @details Represents info that is used to draw a rectangle. Texture index selects
+           a texture from the bindless texture array, index 0 is plain white. It's
+           ignored when bindless textures are disabled, the batch texture is used.
+           Sprites of instanced batches with non-zero animation clip take UVs from
+           the clip frame at the current time instead, see moss/animation.h.
 */
 typedef struct
 {
@@ -39,4 +45,8 @@ typedef struct
     vec2 top_left;     /* UV coords of the top left corner on texture altas. */
     vec2 bottom_right; /* UV coords of the bottom right on texture atlas. */
   } uv;
+  uint32_t texture_index;        /* Bindless texture index, see moss_get_texture_index. */
+  uint32_t animation_clip;       /* Animation clip ID, 0 if not animated. */
+  float    animation_start_time; /* Animation time the clip starts playing at. */
+  float    animation_rate;       /* Playback speed, 1 plays at clip frame rate. */
 } MossSprite;
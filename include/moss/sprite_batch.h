@@ -20,9 +20,14 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 #include "moss/engine.h"
 #include "moss/result.h"
 #include "moss/sprite.h"
+#include "moss/texture.h"
 
 /*=============================================================================
     STRUCTURES
@@ -33,13 +38,89 @@
 */
 typedef struct MossSpriteBatch MossSpriteBatch;
 
+/*
+  @brief Sprite batch mode.
+  @details Defines how sprites are stored in a batch and rendered.
+*/
+typedef enum
+{
+  /* Each sprite is expanded to 4 vertices and 6 indices. */
+  MOSS_SPRITE_BATCH_MODE_INDEXED = 0,
+  /* Each sprite is stored as a single packed instance, quad is built on the GPU. */
+  MOSS_SPRITE_BATCH_MODE_INSTANCED,
+  /* Same as indexed, but vertices are quantized to 12 bytes instead of 24. */
+  MOSS_SPRITE_BATCH_MODE_COMPACT,
+} MossSpriteBatchMode;
+
+/*
+  @brief Sprite batch usage.
+  @details Defines how often sprite batch content is expected to change.
+*/
+typedef enum
+{
+  /* Content rarely changes, it's uploaded to device-local memory through staging. */
+  MOSS_SPRITE_BATCH_USAGE_STATIC = 0,
+  /* Content is rewritten every frame directly in host-visible memory. */
+  MOSS_SPRITE_BATCH_USAGE_STREAM,
+} MossSpriteBatchUsage;
+
+/*
+  @brief Sprite batch material.
+  @details Defines how sprite texels are blended and written to the depth buffer.
+*/
+typedef enum
+{
+  /* Texels with alpha below 0.01 are discarded, the rest are blended and write depth. */
+  MOSS_SPRITE_BATCH_MATERIAL_ALPHA_TEST = 0,
+  /* Texels are written without blending or discard, sprites are sorted front-to-back
+     so the depth test rejects hidden texels before shading. */
+  MOSS_SPRITE_BATCH_MATERIAL_OPAQUE,
+  /* Texels are blended without writing depth, sprites are sorted back-to-front. */
+  MOSS_SPRITE_BATCH_MATERIAL_TRANSLUCENT,
+} MossSpriteBatchMaterial;
+
 /*
   @brief Sprite batch create info.
+  @note Indexed batches share the engine quad index buffers. Batches of up to 16384
+        sprites use 16-bit indices, larger batches use 32-bit indices.
+  @note Texture is ignored in bindless mode, see moss_is_bindless_textures_enabled.
+  @note Culled batches test sprites against the camera in a compute pass and draw
+        only visible ones with an indirect draw. They take an extra device-local
+        buffer of 24 bytes per sprite for indexed and 44 bytes per sprite for
+        instanced batches. Draw order of visible sprites is unspecified, use depth
+        to order overlapping sprites. Culling runs on the first draw of the batch
+        in a frame, later draws in the same frame reuse its results.
+  @note Chunked batches are culled on the CPU instead. moss_end_sprite_batch buckets
+        sprites into a grid of chunk_size cells and draws only issue ranges of
+        chunks that overlap the camera view. Sprites are reordered by chunk, so use
+        depth to order overlapping sprites. Only static batches without GPU
+        culling can be chunked.
+  @note Static batches are filled into a host copy of sprite data the size of the
+        batch buffer, so chunking, depth sorting and updates never read staging
+        memory. Only moss_end_sprite_batch writes staging memory of the batch.
+  @note Compact batches store positions as 16-bit values normalized to the rect
+        given by bounds_position and bounds_size, so precision is the bounds size
+        over 65535. Sprites outside the bounds are clamped to them. UVs and depth
+        are stored as 16-bit values in [0, 1] range and texture index must be
+        below 65536. Compact batches can't be culled or chunked.
+  @note Opaque and translucent static batches are sorted by depth in
+        moss_end_sprite_batch, chunked ones within every chunk. Stream batches are
+        drawn in fill order. Sorting only orders sprites within a batch, draw opaque
+        batches first and translucent ones last. Translucent batches can't be
+        culled or chunked, as both break back-to-front order.
 */
 typedef struct
 {
-  MossEngine *engine;   /* Engine handle. */
-  size_t      capacity; /* Maximum number of sprites that can be added to this batch. */
+  MossEngine             *engine;          /* Engine handle. */
+  size_t                  capacity;        /* Maximum number of sprites in the batch. */
+  MossSpriteBatchMode     mode;            /* Storage and rendering mode of the batch. */
+  MossSpriteBatchUsage    usage;           /* Expected update frequency of the batch. */
+  MossTexture            *texture;         /* Texture to draw with, NULL for white. */
+  bool                    enable_culling;  /* Whether to cull sprites on the GPU. */
+  float                   chunk_size;      /* World size of chunks, 0 disables them. */
+  MossSpriteBatchMaterial material;        /* Blending and depth writes of sprites. */
+  vec2                    bounds_position; /* Center of compact batch bounds. */
+  vec2                    bounds_size;     /* World size of compact batch bounds. */
 } MossSpriteBatchCreateInfo;
 
 /*
@@ -51,6 +132,35 @@ typedef struct
   size_t            sprite_count;
 } MossAddSpritesToSpriteBatchInfo;
 
+/*
+  @brief Range of sprite slots reserved in a sprite batch.
+*/
+typedef struct
+{
+  uint32_t first_sprite; /* Index of the first reserved sprite slot. */
+  uint32_t sprite_count; /* Number of reserved sprite slots. */
+} MossSpriteBatchRange;
+
+/*
+  @brief Sprites write operation info.
+*/
+typedef struct
+{
+  uint32_t          first_sprite; /* Index of the first slot to write to. */
+  const MossSprite *sprites;      /* Sprites to write. */
+  size_t            sprite_count; /* Number of sprites to write. */
+} MossWriteSpritesToSpriteBatchInfo;
+
+/*
+  @brief Sprite batch draw queue operation info.
+*/
+typedef struct
+{
+  MossSpriteBatch *sprite_batch; /* Sprite batch to draw. */
+  uint32_t         layer;        /* Layer to draw in, lower layers are drawn first. */
+  float            depth;        /* Depth draws of a layer are ordered by. */
+} MossQueueSpriteBatchInfo;
+
 /*=============================================================================
     FUNCTIONS
   =============================================================================*/
@@ -59,6 +169,8 @@ typedef struct
   @brief Creates sprite batch.
   @return Returns a valid pointer to a sprite batch on success,
           otherwise returns error code.
+  @warning Don't create sprite batches between moss_begin_frame and moss_end_frame,
+           creation fails if the shared quad index buffer has to grow.
 */
 MossSpriteBatch *moss_create_sprite_batch (const MossSpriteBatchCreateInfo *info);
 
@@ -80,6 +192,8 @@ void moss_clear_sprite_batch (MossSpriteBatch *sprite_batch);
   @return MOSS_RESULT_SUCCESS on success, otherwise returns error code.
   @note It's required to run this function before adding new sprites to the batch.
   @note Previously added sprites won't be removed from the batch.
+  @note Stream batches write to the region of the current frame, so they have to be
+        refilled in every frame they are drawn in.
 */
 MossResult moss_begin_sprite_batch (MossSpriteBatch *sprite_batch);
 
@@ -89,20 +203,120 @@ MossResult moss_begin_sprite_batch (MossSpriteBatch *sprite_batch);
   @param info Required operation info.
   @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
   @warning Make sure that you beginned passed sprite batch before calling this function.
+  @note Safe to call from multiple threads at once on the same begun batch, order
+        of sprites added from different threads is unspecified.
 */
 MossResult moss_add_sprites_to_sprite_batch (
   MossSpriteBatch                       *sprite_batch,
   const MossAddSpritesToSpriteBatchInfo *info
 );
 
+/*
+  @brief Reserves a range of sprite slots in the sprite batch.
+  @param sprite_batch Sprite batch handle.
+  @param sprite_count Number of sprite slots to reserve.
+  @param out_range Output reserved range.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+  @note Safe to call from multiple threads at once on the same begun batch.
+  @warning Reserved slots must be written with moss_write_sprites_to_sprite_batch
+           before moss_end_sprite_batch, otherwise they hold garbage.
+*/
+MossResult moss_reserve_sprite_batch_range (
+  MossSpriteBatch      *sprite_batch,
+  size_t                sprite_count,
+  MossSpriteBatchRange *out_range
+);
+
+/*
+  @brief Writes sprites to previously reserved slots of the sprite batch.
+  @param sprite_batch Sprite batch handle.
+  @param info Required operation info.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+  @note Safe to call from multiple threads at once as long as written slots
+        don't overlap.
+  @warning All writes must be finished before moss_end_sprite_batch is called.
+*/
+MossResult moss_write_sprites_to_sprite_batch (
+  MossSpriteBatch                         *sprite_batch,
+  const MossWriteSpritesToSpriteBatchInfo *info
+);
+
+/*
+  @brief Rewrites sprites of an ended static sprite batch in place.
+  @details Only written slots are copied to the GPU. Updated ranges are merged and
+           copied ahead of the draws of the frame ended next, so the frame shows
+           them while frames in flight keep drawing the old sprites. Moving a few
+           sprites of a big batch costs kilobytes instead of a full refill.
+  @param sprite_batch Sprite batch handle, must be static, ended, alpha tested and
+                      not chunked.
+  @param info Required operation info, slots must be below the sprite count.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+  @note Sorted and chunked batches reorder sprites, so their slots can't be updated.
+  @warning Not safe to call from multiple threads at once.
+*/
+MossResult moss_update_sprites_in_sprite_batch (
+  MossSpriteBatch                         *sprite_batch,
+  const MossWriteSpritesToSpriteBatchInfo *info
+);
+
 /*
   @brief End sprite batch.
   @param sprite_batch Sprite batch handle.
   @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
   @note It's required to end sprite batch before attempting to draw it.
+  @warning Static batches may wait for the submitted frame that copies the previous
+           fill to finish reading staging memory.
 */
 MossResult moss_end_sprite_batch (MossSpriteBatch *sprite_batch);
 
+/*
+  @brief Saves snapshot of sprite batch content to a binary file.
+  @details Snapshot holds sprite data as it's stored in the batch after
+           moss_end_sprite_batch, sorted and chunked, along with chunk bounds and
+           in-place updates. It's written to a temporary file first and renamed
+           over the old one, so a failed save never leaves a truncated snapshot.
+  @param sprite_batch Sprite batch handle, must be static and ended.
+  @param file_path Path to the snapshot file.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+  @note Snapshots are stored in native byte order and versioned, files written by
+        another engine version or with another sprite layout fail to load.
+  @note Texture of the batch isn't stored. Bindless texture indices of sprites are
+        stored as is, so textures must take the same indices when the snapshot is
+        loaded, e.g. by creating them in the same order.
+*/
+MossResult moss_save_sprite_batch_snapshot (
+  const MossSpriteBatch *sprite_batch,
+  const char            *file_path
+);
+
+/*
+  @brief Replaces sprite batch content with a snapshot file.
+  @details File is memory mapped and sprite data is copied straight to the staging
+           memory without per-sprite conversion, sorting or chunking. Upload is
+           recorded as in moss_end_sprite_batch, the batch can be drawn right after.
+  @param sprite_batch Sprite batch handle, must be static and not begun.
+  @param file_path Path to the snapshot file.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+  @note Snapshot must be saved from a batch of the same mode, material and chunk
+        size, and fit into the batch capacity. Compact batches take bounds of the
+        snapshot. With bindless textures, snapshots holding texture indices past
+        the texture array are rejected.
+  @warning May wait for the submitted frame that copies the previous fill to finish
+           reading staging memory.
+*/
+MossResult
+moss_load_sprite_batch_snapshot (MossSpriteBatch *sprite_batch, const char *file_path);
+
+/*
+  @brief Sets texture sprite batch is drawn with.
+  @param sprite_batch Sprite batch handle.
+  @param texture Texture handle, NULL to draw with plain white.
+  @note Takes effect on the next moss_draw_sprite_batch, doesn't require the batch
+        to be refilled. Ignored in bindless mode, where sprites select textures
+        with MossSprite.texture_index.
+*/
+void moss_set_sprite_batch_texture (MossSpriteBatch *sprite_batch, MossTexture *texture);
+
 /*
   @brief Draws sprite batch.
   @param engine Engine handle.
@@ -111,3 +325,46 @@ MossResult moss_end_sprite_batch (MossSpriteBatch *sprite_batch);
   @warning Make sure that you ended passed sprite batch before calling this function.
 */
 MossResult moss_draw_sprite_batch (MossEngine *engine, MossSpriteBatch *sprite_batch);
+
+/*
+  @brief Records sprite batch draw with a command recorder.
+  @details Same as moss_draw_sprite_batch, but can be called from the thread that
+           owns the recorder in parallel with other recorders.
+  @param recorder Command recorder handle, must be begun.
+  @param sprite_batch Sprite batch handle.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+  @warning Sprite batch must not be filled while it's being recorded.
+*/
+MossResult
+moss_record_sprite_batch (MossCommandRecorder *recorder, MossSpriteBatch *sprite_batch);
+
+/*
+  @brief Queues sprite batch draw.
+  @details Queued draws are sorted and recorded on moss_end_frame, after the draws
+           of moss_draw_sprite_batch. Within a layer opaque batches go first, then
+           alpha tested and translucent ones. Opaque and alpha tested batches are
+           grouped by pipeline, texture and batch to skip redundant binds, and go
+           front-to-back. Translucent batches go back-to-front by depth, batches of
+           equal depth keep queue order.
+  @param engine Engine handle.
+  @param info Required operation info.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+  @note Camera and texture are captured when the draw is queued.
+  @warning Sprite batch must not be filled until the frame is ended.
+*/
+MossResult
+moss_queue_sprite_batch (MossEngine *engine, const MossQueueSpriteBatchInfo *info);
+
+/*
+  @brief Queues sprite batch draw with a command recorder.
+  @details Same as moss_queue_sprite_batch, but draws are sorted and recorded on
+           moss_end_command_recorder, after the draws of moss_record_sprite_batch.
+  @param recorder Command recorder handle, must be begun.
+  @param info Required operation info.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+  @warning Sprite batch must not be filled until the recorder is ended.
+*/
+MossResult moss_queue_command_recorder_sprite_batch (
+  MossCommandRecorder            *recorder,
+  const MossQueueSpriteBatchInfo *info
+);
@@ -0,0 +1,166 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file include/moss/texture.h
+  @brief Texture struct and function declarations.
+  @author Ilya Buravov (ilburale@gmail.com)
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "moss/engine.h"
+#include "moss/result.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Texture.
+*/
+typedef struct MossTexture MossTexture;
+
+/*
+  @brief Texture loading state.
+*/
+typedef enum
+{
+  /* Texture is being loaded, it's drawn as plain white meanwhile. */
+  MOSS_TEXTURE_STATE_LOADING = 0,
+  /* Texture is uploaded and can be drawn. */
+  MOSS_TEXTURE_STATE_READY,
+  /* Texture failed to load, it keeps being drawn as plain white. */
+  MOSS_TEXTURE_STATE_FAILED,
+} MossTextureState;
+
+/*
+  @brief Callback invoked once an asynchronously loaded texture is finished.
+  @param texture Texture handle.
+  @param result MOSS_RESULT_SUCCESS if texture is ready, MOSS_RESULT_ERROR otherwise.
+  @param user_data User data passed on load.
+*/
+typedef void (*MossTextureLoadCallback) (
+  MossTexture *texture,
+  MossResult   result,
+  void        *user_data
+);
+
+/*
+  @brief Texture create info for loading an image file.
+  @details KTX2 files are uploaded as is, with the format and mip levels they were
+           exported with. Other files are decoded with stb_image.
+*/
+typedef struct
+{
+  MossEngine *engine;           /* Engine handle. */
+  const char *file_path;        /* Path to a KTX2 file or any stb_image format. */
+  bool        generate_mipmaps; /* Whether to generate mips, ignored for KTX2. */
+} MossTextureCreateFromFileInfo;
+
+/*
+  @brief Texture create info for raw pixel data.
+  @details Pixel rows go from top to bottom.
+*/
+typedef struct
+{
+  MossEngine *engine;           /* Engine handle. */
+  const void *pixels;           /* Tightly packed 8-bit sRGB RGBA pixels. */
+  uint32_t    width;            /* Texture width in pixels. */
+  uint32_t    height;           /* Texture height in pixels. */
+  bool        generate_mipmaps; /* Whether to generate a full mip chain. */
+} MossTextureCreateFromMemoryInfo;
+
+/*
+  @brief Texture load info for loading an image file on the loader thread.
+*/
+typedef struct
+{
+  MossEngine             *engine;           /* Engine handle. */
+  const char             *file_path;        /* Path to a KTX2 file or any stb_image
+                                               format, copied. */
+  bool                    generate_mipmaps; /* Whether to generate mips, ignored for
+                                               KTX2. */
+  MossTextureLoadCallback callback;         /* Callback to invoke once the texture
+                                               is finished, may be NULL. */
+  void                   *user_data;        /* User data passed to the callback. */
+} MossTextureLoadAsyncInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Creates texture from an image file.
+  @param info Required operation info.
+  @return Returns a valid pointer to a texture on success, otherwise returns NULL.
+  @note Pixel upload is submitted with the next frame, it's safe to create
+        textures between moss_begin_frame and moss_end_frame.
+*/
+MossTexture *moss_create_texture_from_file (const MossTextureCreateFromFileInfo *info);
+
+/*
+  @brief Creates texture from raw pixel data.
+  @param info Required operation info.
+  @return Returns a valid pointer to a texture on success, otherwise returns NULL.
+  @note Pixels are copied, so the memory may be freed right after the call.
+  @note Mips are downsampled on the CPU, uploads go through the transfer queue,
+        which can't blit.
+*/
+MossTexture *
+moss_create_texture_from_memory (const MossTextureCreateFromMemoryInfo *info);
+
+/*
+  @brief Starts loading texture from an image file in background.
+  @details File is read and decoded on the loader thread, mips included. Decoded
+           textures are uploaded by moss_begin_frame, which also invokes the
+           callback, so it runs on the thread that begins frames. Until then the
+           texture is drawn as plain white.
+  @param info Required operation info.
+  @return Returns a valid pointer to a loading texture on success, otherwise returns
+          NULL.
+  @note In bindless mode moss_get_texture_index returns the plain white slot until
+        the texture is ready, sprites must be refilled with the new index then.
+*/
+MossTexture *moss_load_texture_async (const MossTextureLoadAsyncInfo *info);
+
+/*
+  @brief Returns texture loading state.
+  @param texture Texture handle.
+  @return Texture loading state, textures created synchronously are always ready.
+*/
+MossTextureState moss_get_texture_state (const MossTexture *texture);
+
+/*
+  @brief Destroys texture.
+  @details Texture resources are released once frames that may sample it finish,
+           the call doesn't wait for the device.
+           Destroying a loading texture cancels the load, its callback is not invoked.
+  @param texture Texture handle.
+  @warning Make sure that no sprite batch refers to the texture when it's drawn next.
+*/
+void moss_destroy_texture (MossTexture *texture);
+
+/*
+  @brief Returns index of the texture in the bindless texture array.
+  @details Store it in MossSprite.texture_index to draw the sprite with the texture.
+           Index stays valid until the texture is destroyed, after that it may be
+           given to another texture.
+  @param texture Texture handle.
+  @return Bindless texture index, 0 if bindless textures are disabled.
+*/
+uint32_t moss_get_texture_index (const MossTexture *texture);
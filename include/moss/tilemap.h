@@ -0,0 +1,125 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file include/moss/tilemap.h
+  @brief Tilemap struct and function declarations.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Tilemap keeps 16-bit tile indices in a device-local storage buffer and
+           draws every visible chunk of tiles as a single quad, the fragment shader
+           looks up the tile and its atlas cell. It takes 2 bytes per tile instead
+           of 4 vertices, and editing tiles uploads only the changed ones.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cglm/vec2.h>
+
+#include "moss/engine.h"
+#include "moss/result.h"
+#include "moss/texture.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Tilemap.
+*/
+typedef struct MossTilemap MossTilemap;
+
+/*
+  @brief Tilemap create info.
+  @note Tile value 0 is an empty tile, value N samples atlas cell N - 1. Cells are
+        counted row by row from the top left corner of the atlas, which is split
+        into atlas_columns by atlas_rows equal cells.
+  @note Tile rows go down from position, the top left corner of the map. Tiles are
+        drawn with the alpha test material at a single depth.
+  @note Atlas cells are sampled with the shared linear sampler, pad cells in the
+        atlas to avoid bleeding of neighbouring cells.
+*/
+typedef struct
+{
+  MossEngine     *engine;        /* Engine handle. */
+  MossTexture    *atlas;         /* Texture atlas, NULL for white. */
+  uint32_t        atlas_columns; /* Number of atlas cell columns. */
+  uint32_t        atlas_rows;    /* Number of atlas cell rows. */
+  uint32_t        width;         /* Map width in tiles. */
+  uint32_t        height;        /* Map height in tiles. */
+  vec2            position;      /* World position of the top left corner. */
+  vec2            tile_size;     /* World size of a single tile. */
+  float           depth;         /* Depth tiles are drawn at. */
+  const uint16_t *tiles;         /* Row-major initial tiles, NULL for empty map. */
+} MossTilemapCreateInfo;
+
+/*
+  @brief Tilemap tiles write operation info.
+*/
+typedef struct
+{
+  uint32_t        x;      /* Column of the first tile to write. */
+  uint32_t        y;      /* Row of the first tile to write. */
+  uint32_t        width;  /* Number of columns to write. */
+  uint32_t        height; /* Number of rows to write. */
+  const uint16_t *tiles;  /* Row-major tiles, width * height of them. */
+} MossSetTilemapTilesInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Creates tilemap.
+  @param info Required operation info.
+  @return Returns a valid pointer to a tilemap on success, otherwise returns NULL.
+*/
+MossTilemap *moss_create_tilemap (const MossTilemapCreateInfo *info);
+
+/*
+  @brief Destroys tilemap.
+  @param tilemap Tilemap handle.
+*/
+void moss_destroy_tilemap (MossTilemap *tilemap);
+
+/*
+  @brief Writes a rect of tiles.
+  @details Only the written rows are uploaded, changes are visible from the next
+           submitted frame.
+  @param tilemap Tilemap handle.
+  @param info Required operation info.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+*/
+MossResult
+moss_set_tilemap_tiles (MossTilemap *tilemap, const MossSetTilemapTilesInfo *info);
+
+/*
+  @brief Draws tilemap.
+  @details Only chunks that overlap the camera view are drawn.
+  @param engine Engine handle.
+  @param tilemap Tilemap handle.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+*/
+MossResult moss_draw_tilemap (MossEngine *engine, MossTilemap *tilemap);
+
+/*
+  @brief Records tilemap draw with a command recorder.
+  @details Same as moss_draw_tilemap, but can be called from the thread that owns
+           the recorder in parallel with other recorders.
+  @param recorder Command recorder handle, must be begun.
+  @param tilemap Tilemap handle.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns error code.
+*/
+MossResult moss_record_tilemap (MossCommandRecorder *recorder, MossTilemap *tilemap);
@@ -0,0 +1,144 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/animation.c
+  @brief Sprite animation clip functions implementation.
+  @author Ilya Buravov (ilburale@gmail.com)
+*/
+
+#include <stdint.h>
+
+#include "moss/animation.h"
+#include "moss/engine.h"
+#include "moss/result.h"
+
+#include "src/internal/animation.h"
+#include "src/internal/config.h"
+#include "src/internal/engine.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+#include "src/internal/upload_queue.h"
+
+MossResult moss_create_animation_clip (
+  const MossAnimationClipCreateInfo *const info,
+  uint32_t *const                          out_clip
+)
+{
+  if (info == NULL || info->engine == NULL || info->frames == NULL ||
+      info->frame_count == 0 || !(info->frame_duration > 0.0F) || out_clip == NULL)
+  {
+    moss__error ("Invalid parameters to moss_create_animation_clip.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  MossEngine *const engine = info->engine;
+
+  if (engine->animation_clip_count >= MAX_ANIMATION_CLIP_COUNT)
+  {
+    moss__error ("Animation clip limit of %zu is reached.\n", MAX_ANIMATION_CLIP_COUNT);
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (info->frame_count > MAX_ANIMATION_FRAME_COUNT - engine->animation_frame_count)
+  {
+    moss__error (
+      "Animation frame limit of %zu is exceeded.\n",
+      MAX_ANIMATION_FRAME_COUNT
+    );
+    return MOSS_RESULT_ERROR;
+  }
+
+  const size_t frames_size = (size_t)info->frame_count * 4 * sizeof (float);
+  float *const frames      = moss__allocate (
+    &engine->host_allocator,
+    frames_size,
+    MOSS_ALLOCATION_CATEGORY_TEMPORARY
+  );
+  if (frames == NULL)
+  {
+    moss__error ("Failed to allocate memory for animation frames.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  for (uint32_t i = 0; i < info->frame_count; ++i)
+  {
+    const MossAnimationFrame *const frame = &info->frames[ i ];
+
+    frames[ i * 4 + 0 ] = frame->top_left[ 0 ];
+    frames[ i * 4 + 1 ] = frame->top_left[ 1 ];
+    frames[ i * 4 + 2 ] = frame->bottom_right[ 0 ];
+    frames[ i * 4 + 3 ] = frame->bottom_right[ 1 ];
+  }
+
+  const Moss__AnimationClip clip = {
+    .first_frame    = engine->animation_frame_count,
+    .frame_count    = info->frame_count,
+    .frame_duration = info->frame_duration,
+    .is_looped      = info->is_looped ? 1 : 0,
+  };
+
+  {  // Record frames upload
+    const Moss__UploadQueueFillBufferInfo fill_info = {
+      .destination_buffer = engine->animation_frame_buffer,
+      .destination_offset =
+        (VkDeviceSize)engine->animation_frame_count * 4 * sizeof (float),
+      .source_data                     = frames,
+      .data_size                       = (VkDeviceSize)frames_size,
+      .sharing_mode                    = engine->buffer_sharing_mode,
+      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+    };
+    const MossResult result =
+      moss__upload_queue_fill_buffer (&engine->upload_queue, &fill_info);
+    moss__free (&engine->host_allocator, frames);
+    if (result != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to upload animation frames.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Record clip upload
+    const Moss__UploadQueueFillBufferInfo fill_info = {
+      .destination_buffer = engine->animation_clip_buffer,
+      .destination_offset =
+        (VkDeviceSize)engine->animation_clip_count * sizeof (Moss__AnimationClip),
+      .source_data                     = &clip,
+      .data_size                       = sizeof (clip),
+      .sharing_mode                    = engine->buffer_sharing_mode,
+      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+    };
+    if (moss__upload_queue_fill_buffer (&engine->upload_queue, &fill_info) !=
+        MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to upload animation clip.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  engine->animation_frame_count += info->frame_count;
+  engine->animation_clip_count += 1;
+
+  // Zero is reserved for sprites without animation
+  *out_clip = engine->animation_clip_count;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+float moss_get_animation_time (const MossEngine *const engine)
+{
+  return engine->animation_time;
+}
@@ -25,9 +25,55 @@
 
 #include "src/internal/camera.h"
 #include "src/internal/engine.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
 
 MossCamera *moss_get_camera (MossEngine *const engine) { return &engine->camera; }
 
+MossCamera *moss_create_camera (MossEngine *const engine)
+{
+  if (engine == NULL)
+  {
+    moss__error ("Invalid parameters to moss_create_camera.\n");
+    return NULL;
+  }
+
+  MossCamera *const camera = moss__allocate (
+    &engine->host_allocator,
+    sizeof (MossCamera),
+    MOSS_ALLOCATION_CATEGORY_ENGINE
+  );
+  if (camera == NULL)
+  {
+    moss__error ("Failed to allocate memory for camera.\n");
+    return NULL;
+  }
+
+  moss__init_camera_state (camera);
+  camera->host_allocator = &engine->host_allocator;
+
+  return camera;
+}
+
+void moss_destroy_camera (MossCamera *const camera)
+{
+  if (camera == NULL) { return; }
+  moss__free (camera->host_allocator, camera);
+}
+
+void moss_set_camera (MossEngine *const engine, MossCamera *const camera)
+{
+  moss_set_command_recorder_camera (&engine->main_recorder, camera);
+}
+
+void moss_set_command_recorder_camera (
+  MossCommandRecorder *const recorder,
+  MossCamera *const          camera
+)
+{
+  recorder->camera = camera != NULL ? camera : &recorder->engine->camera;
+}
+
 void moss_set_camera_position (MossCamera *const camera, const vec2 new_position)
 {
   camera->offset[ 0 ] = -1 * new_position[ 0 ] * camera->scale[ 0 ];
@@ -45,3 +91,21 @@ void moss_set_camera_size (MossCamera *const camera, const vec2 new_size)
   camera->offset[ 0 ] *= camera->scale[ 0 ];
   camera->offset[ 1 ] *= camera->scale[ 1 ];
 }
+
+void moss_set_camera_viewport (
+  MossCamera *const camera,
+  const vec2        position,
+  const vec2        size
+)
+{
+  if (size[ 0 ] <= 0.0F || size[ 1 ] <= 0.0F)
+  {
+    moss__error ("Camera viewport size must be positive.\n");
+    return;
+  }
+
+  camera->viewport_position[ 0 ] = position[ 0 ];
+  camera->viewport_position[ 1 ] = position[ 1 ];
+  camera->viewport_size[ 0 ]     = size[ 0 ];
+  camera->viewport_size[ 1 ]     = size[ 1 ];
+}
@@ -34,18 +34,31 @@
 
 #include <cglm/cglm.h>
 
-#include <src/internal/stb_image.h>
-
 #include "moss/app_info.h"
 #include "moss/engine.h"
 #include "moss/result.h"
+#include "moss/sprite_batch.h"
+#include "moss/texture.h"
 
+#include "src/internal/animation.h"
 #include "src/internal/app_info.h"
+#include "src/internal/clock.h"
 #include "src/internal/config.h"
+#include "src/internal/deletion_queue.h"
 #include "src/internal/engine.h"
+#include "src/internal/frame_readback.h"
+#include "src/internal/frame_stats.h"
 #include "src/internal/log.h"
 #include "src/internal/memory_utils.h"
+#include "src/internal/particle_system.h"
+#include "src/internal/quad_index_buffer.h"
 #include "src/internal/shaders.h"
+#include "src/internal/sprite_batch.h"
+#include "src/internal/sprite_culling.h"
+#include "src/internal/texture.h"
+#include "src/internal/texture_loader.h"
+#include "src/internal/tilemap.h"
+#include "src/internal/upload_queue.h"
 #include "src/internal/vertex.h"
 #include "src/internal/vulkan/utils/buffer.h"
 #include "src/internal/vulkan/utils/command_pool.h"
@@ -53,10 +66,32 @@
 #include "src/internal/vulkan/utils/image_view.h"
 #include "src/internal/vulkan/utils/instance.h"
 #include "src/internal/vulkan/utils/physical_device.h"
+#include "src/internal/vulkan/utils/pipeline_cache.h"
 #include "src/internal/vulkan/utils/shader.h"
 #include "src/internal/vulkan/utils/swapchain.h"
 #include "src/internal/vulkan/utils/validation_layers.h"
 
+/*=============================================================================
+    INTERNAL STRUCT DECLARATIONS
+  =============================================================================*/
+
+/*
+  @brief Graphics pipeline create info.
+*/
+typedef struct
+{
+  /* Vertex shader SPIR-V code. */
+  const Moss__ShaderCode *vert_shader;
+  /* Fragment shader SPIR-V code. */
+  const Moss__ShaderCode *frag_shader;
+  /* Vertex input state the vertex shader expects. */
+  const VkPipelineVertexInputStateCreateInfo *vertex_input_info;
+  /* Material that selects blending, depth writes and alpha test. */
+  MossSpriteBatchMaterial material;
+  /* Output pipeline. */
+  VkPipeline *out_pipeline;
+} Moss__CreateGraphicsPipelineInfo;
+
 /*=============================================================================
     INTERNAL FUNCTION DECLARATIONS
   =============================================================================*/
@@ -81,6 +116,21 @@ inline static MossResult moss__create_surface (MossEngine *engine);
 */
 inline static MossResult moss__create_logical_device (MossEngine *engine);
 
+/*
+  @brief Converts engine present mode to Vulkan present mode.
+  @param present_mode Engine present mode.
+  @return Vulkan present mode.
+*/
+inline static VkPresentModeKHR moss__get_vk_present_mode (MossPresentMode present_mode);
+
+/*
+  @brief Waits for the previous frame in low-latency mode.
+  @details Waits until the previous frame is displayed if present wait is enabled,
+           or until it's rendered otherwise.
+  @param engine Engine handle.
+*/
+inline static void moss__wait_low_latency_pacing (MossEngine *engine);
+
 /*
   @brief Initializes buffer sharing mode and queue family indices.
   @details Determines whether graphics and transfer queue families are the same,
@@ -98,6 +148,16 @@ inline static void moss__init_buffer_sharing_mode (MossEngine *engine);
 inline static MossResult
 moss__create_swapchain (MossEngine *engine, uint32_t width, uint32_t height);
 
+/*
+  @brief Creates images headless frames are rendered into in place of a swap chain.
+  @param engine Engine handle.
+  @param width Image width.
+  @param height Image height.
+  @return On success returns MOSS_RESULT_SUCCESS, otherwise returns MOSS_RESULT_ERROR.
+*/
+inline static MossResult
+moss__create_headless_images (MossEngine *engine, uint32_t width, uint32_t height);
+
 /*
   @brief Creates image views for swap chain images.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
@@ -118,52 +178,100 @@ inline static VkPipelineVertexInputStateCreateInfo
 moss__create_vk_pipeline_vertex_input_state_info (void);
 
 /*
-  @brief Creates descriptor pool.
+  @brief Returns Vulkan pipeline vertex input state info for instanced sprites.
+  @return Vulkan pipeline vertex input state info.
+*/
+inline static VkPipelineVertexInputStateCreateInfo
+moss__create_vk_pipeline_instance_input_state_info (void);
+
+/*
+  @brief Returns Vulkan pipeline vertex input state info for compact sprites.
+  @return Vulkan pipeline vertex input state info.
+*/
+inline static VkPipelineVertexInputStateCreateInfo
+moss__create_vk_pipeline_compact_vertex_input_state_info (void);
+
+/*
+  @brief Creates descriptor pool texture descriptor sets are allocated from.
   @return Returns MOSS_RESULT_SUCCESS on successs, MOSS_RESULT_ERROR otherwise.
 */
-inline static MossResult moss__create_descriptor_pool (MossEngine *engine);
+inline static MossResult moss__create_texture_descriptor_pool (MossEngine *engine);
+
+/*
+  @brief Creates descriptor set layout of per-texture descriptor sets.
+  @details In bindless mode the layout holds the whole texture array instead.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_texture_descriptor_set_layout (MossEngine *engine);
 
 /*
-  @brief Creates descriptor set layout.
+  @brief Allocates descriptor set holding the bindless texture array.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
 */
-inline static MossResult moss__create_descriptor_set_layout (MossEngine *engine);
+inline static MossResult moss__allocate_bindless_descriptor_set (MossEngine *engine);
 
 /*
-  @brief Allocates descriptor set.
+  @brief Creates default 1x1 white texture used by batches without a texture.
+  @details It's the first texture created, so in bindless mode it takes index 0.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
 */
-inline static MossResult moss__allocate_descriptor_sets (MossEngine *engine);
+inline static MossResult moss__create_default_texture (MossEngine *engine);
 
 /*
-  @brief Sets up descriptor sets.
+  @brief Creates pipeline layout shared by all graphics pipelines.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
 */
-inline static void moss__configure_descriptor_sets (MossEngine *engine);
+inline static MossResult moss__create_pipeline_layout (MossEngine *engine);
 
 /*
   @brief Creates graphics pipeline.
+  @param info Required operation info.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
 */
-inline static MossResult moss__create_graphics_pipeline (MossEngine *engine);
+inline static MossResult moss__create_graphics_pipeline (
+  MossEngine                             *engine,
+  const Moss__CreateGraphicsPipelineInfo *info
+);
 
 /*
-  @brief Creates framebuffers.
+  @brief Creates graphics pipelines for every sprite batch mode and material.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
 */
-inline static MossResult moss__create_framebuffers (MossEngine *engine);
+inline static MossResult moss__create_graphics_pipelines (MossEngine *engine);
+
+/*
+  @brief Creates compute pipeline from SPIR-V code.
+  @param shader Compute shader SPIR-V code.
+  @param layout Pipeline layout.
+  @param specialization_info Specialization constants of the shader, may be NULL.
+  @param out_pipeline Output pipeline.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_compute_pipeline (
+  MossEngine                 *engine,
+  const Moss__ShaderCode     *shader,
+  VkPipelineLayout            layout,
+  const VkSpecializationInfo *specialization_info,
+  VkPipeline                 *out_pipeline
+);
+
+/*
+  @brief Creates descriptor pool, layouts and pipelines of sprite culling.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_cull_pipelines (MossEngine *engine);
 
 /*
-  @brief Creates texture image.
+  @brief Creates descriptor pool, layouts and pipeline of particle simulation.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
 */
-inline static MossResult moss__create_texture_image (MossEngine *engine);
+inline static MossResult moss__create_particle_pipeline (MossEngine *engine);
 
 /*
-  @brief Creates texture image view.
+  @brief Creates framebuffers.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
 */
-inline static MossResult moss__create_texture_image_view (MossEngine *engine);
+inline static MossResult moss__create_framebuffers (MossEngine *engine);
 
 /*
   @brief Creates texture sampler.
@@ -183,16 +291,51 @@ inline static MossResult moss__create_depth_resources (MossEngine *engine);
 inline static void moss__cleanup_depth_resources (MossEngine *engine);
 
 /*
-  @brief Creates camera UBO buffers.
+  @brief Creates command buffers.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
 */
-inline static MossResult moss__create_camera_ubo_buffers (MossEngine *engine);
+inline static MossResult moss__create_general_command_buffers (MossEngine *engine);
 
 /*
-  @brief Creates command buffers.
+  @brief Creates command pools and secondary command buffers of command recorders.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
 */
-inline static MossResult moss__create_general_command_buffers (MossEngine *engine);
+inline static MossResult moss__create_command_recorders (MossEngine *engine);
+
+/*
+  @brief Destroys command pools of command recorders.
+*/
+inline static void moss__destroy_command_recorders (MossEngine *engine);
+
+/*
+  @brief Begins recording of the command recorder for the current frame.
+  @details Secondary command buffers don't inherit state, so every recorder binds
+           default pipeline, dynamic state and camera descriptor set itself.
+  @param recorder Command recorder.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__begin_command_recorder_commands (MossCommandRecorder *recorder);
+
+/*
+  @brief Ends recording of the command recorder for the current frame.
+  @param recorder Command recorder.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__end_command_recorder_commands (MossCommandRecorder *recorder);
+
+/*
+  @brief Executes secondary command buffers of recorders in the frame render pass.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__execute_command_recorders (MossEngine *engine);
+
+/*
+  @brief Records staged frame uploads into the upload command buffer of the frame.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__record_frame_upload_command_buffer (MossEngine *engine);
 
 /*
   @brief Creates image available semaphores.
@@ -272,6 +415,8 @@ inline static void moss__cleanup_swapchain (MossEngine *engine);
 
 /*
   @brief Recreates swap chain.
+  @details Doesn't wait for the device, old resources are destroyed through the
+           deletion queue once frames in flight stop using them.
   @param width Window width.
   @param height Window height.
   @return Returns MOSS_RESULT_SUCCESS on success, error code otherwise.
@@ -279,11 +424,6 @@ inline static void moss__cleanup_swapchain (MossEngine *engine);
 inline static MossResult
 moss__recreate_swapchain (MossEngine *engine, uint32_t width, uint32_t height);
 
-/*
-  @brief Updates camera ubo data.
-*/
-inline static void moss__update_camera_ubo_data (MossEngine *engine);
-
 /*=============================================================================
     PUBLIC API FUNCTIONS IMPLEMENTATION
   =============================================================================*/
@@ -295,34 +435,75 @@ inline static void moss__update_camera_ubo_data (MossEngine *engine);
 */
 MossEngine *moss_create_engine (const MossEngineConfig *const config)
 {
-  MossEngine *const engine = malloc (sizeof (MossEngine));
+  // Engine is allocated before its state exists, so a copy of the allocator is used
+  Moss__HostAllocator host_allocator;
+  moss__init_host_allocator (&host_allocator, config->allocator);
+
+  MossEngine *const engine = moss__allocate (
+    &host_allocator,
+    sizeof (MossEngine),
+    MOSS_ALLOCATION_CATEGORY_ENGINE
+  );
   if (engine == NULL) { return NULL; }
 
   moss__init_engine_state (engine);
+  engine->host_allocator = host_allocator;
+  engine->vk_allocation_callbacks =
+    moss__get_vk_allocation_callbacks (&engine->host_allocator);
 
-#ifdef __APPLE__
-  // Store metal_layer from config
-  engine->metal_layer = config->metal_layer;
-  if (engine->metal_layer == NULL)
+  engine->is_headless = config->enable_headless;
+  if (engine->is_headless)
   {
-    moss__error ("metal_layer must be provided in config.\n");
-    free (engine);
-    return NULL;
+    if (config->headless_width == 0 || config->headless_height == 0)
+    {
+      moss__error ("Headless image size must be provided in config.\n");
+      moss__free (&host_allocator, engine);
+      return NULL;
+    }
   }
+  else {
+#ifdef __APPLE__
+    // Store metal_layer from config
+    engine->metal_layer = config->metal_layer;
+    if (engine->metal_layer == NULL)
+    {
+      moss__error ("metal_layer must be provided in config.\n");
+      moss__free (&host_allocator, engine);
+      return NULL;
+    }
 #else
-  moss__error ("Metal layer is only supported on macOS.\n");
-  free (engine);
-  return NULL;
+    moss__error ("Metal layer is only supported on macOS.\n");
+    moss__free (&host_allocator, engine);
+    return NULL;
 #endif
 
-  // Store framebuffer size callback
-  engine->get_window_framebuffer_size = config->get_window_framebuffer_size;
-  if (engine->get_window_framebuffer_size == NULL)
+    // Store framebuffer size callback
+    engine->get_window_framebuffer_size = config->get_window_framebuffer_size;
+    if (engine->get_window_framebuffer_size == NULL)
+    {
+      moss__error ("get_window_framebuffer_size callback must be provided in config.\n");
+      moss__free (&host_allocator, engine);
+      return NULL;
+    }
+  }
+
+  if (config->frames_in_flight_count > MOSS_MAX_FRAMES_IN_FLIGHT)
   {
-    moss__error ("get_window_framebuffer_size callback must be provided in config.\n");
-    free (engine);
+    moss__error (
+      "Frames in flight count %u exceeds maximum of %u.\n",
+      config->frames_in_flight_count,
+      MOSS_MAX_FRAMES_IN_FLIGHT
+    );
+    moss__free (&host_allocator, engine);
     return NULL;
   }
+  if (config->frames_in_flight_count != 0)
+  {
+    engine->frames_in_flight_count = config->frames_in_flight_count;
+  }
+
+  engine->preferred_present_mode = moss__get_vk_present_mode (config->present_mode);
+  engine->is_low_latency         = config->enable_low_latency;
 
   if (moss__create_api_instance (engine, config->app_info) != MOSS_RESULT_SUCCESS)
   {
@@ -330,7 +511,8 @@ MossEngine *moss_create_engine (const MossEngineConfig *const config)
     return NULL;
   }
 
-  if (moss__create_surface (engine) != MOSS_RESULT_SUCCESS)
+  // Headless engine has no surface, devices are selected without present support
+  if (!engine->is_headless && moss__create_surface (engine) != MOSS_RESULT_SUCCESS)
   {
     moss_destroy_engine ((MossEngine *)engine);
     return NULL;
@@ -357,12 +539,149 @@ MossEngine *moss_create_engine (const MossEngineConfig *const config)
     engine->queue_family_indices = moss_vk__find_queue_families (&find_info);
   }
 
+  if (config->enable_bindless_textures)
+  {
+    engine->is_bindless =
+      moss_vk__check_device_bindless_support (engine->physical_device);
+    if (!engine->is_bindless)
+    {
+      moss__warning (
+        "Device doesn't support descriptor indexing required by bindless textures, "
+        "falling back to per-batch textures.\n"
+      );
+    }
+  }
+
+  // Headless frames aren't displayed, low latency only waits for rendering then
+  if (engine->is_low_latency && !engine->is_headless)
+  {
+    engine->is_present_wait_enabled =
+      moss_vk__check_device_present_wait_support (engine->physical_device);
+    if (!engine->is_present_wait_enabled)
+    {
+      moss__info (
+        "Device doesn't support present wait, low-latency mode waits for the "
+        "previous frame to be rendered instead.\n"
+      );
+    }
+  }
+
   if (moss__create_logical_device (engine) != MOSS_RESULT_SUCCESS)
   {
     moss_destroy_engine ((MossEngine *)engine);
     return NULL;
   }
 
+  {
+    const Moss__CreateVkAllocatorInfo create_info = {
+      .physical_device      = engine->physical_device,
+      .device               = engine->device,
+      .out_allocator        = &engine->allocator,
+      .allocation_callbacks = &engine->vk_allocation_callbacks,
+      .host_allocator       = &engine->host_allocator,
+    };
+    if (moss_vk__create_allocator (&create_info) != MOSS_RESULT_SUCCESS)
+    {
+      moss_destroy_engine ((MossEngine *)engine);
+      return NULL;
+    }
+  }
+
+  if (config->pipeline_cache_path != NULL)
+  {
+    engine->pipeline_cache_path = moss__duplicate_string (
+      &engine->host_allocator,
+      config->pipeline_cache_path,
+      MOSS_ALLOCATION_CATEGORY_ENGINE
+    );
+    if (engine->pipeline_cache_path == NULL)
+    {
+      moss__error ("Failed to allocate memory for pipeline cache path.\n");
+      moss_destroy_engine ((MossEngine *)engine);
+      return NULL;
+    }
+  }
+
+  {
+    const Moss__CreateVkPipelineCacheInfo create_info = {
+      .physical_device      = engine->physical_device,
+      .device               = engine->device,
+      .file_path            = engine->pipeline_cache_path,
+      .out_pipeline_cache   = &engine->pipeline_cache,
+      .allocation_callbacks = &engine->vk_allocation_callbacks,
+      .host_allocator       = &engine->host_allocator,
+    };
+    if (moss_vk__create_pipeline_cache (&create_info) != MOSS_RESULT_SUCCESS)
+    {
+      moss_destroy_engine ((MossEngine *)engine);
+      return NULL;
+    }
+  }
+
+  if (moss__create_timestamp_query_pool (engine) != MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
+  }
+
+  if (config->command_recorder_count > MOSS_MAX_COMMAND_RECORDER_COUNT)
+  {
+    moss__error (
+      "Command recorder count %u exceeds maximum of %u.\n",
+      config->command_recorder_count,
+      MOSS_MAX_COMMAND_RECORDER_COUNT
+    );
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
+  }
+  engine->command_recorder_count = config->command_recorder_count;
+
+  if (pthread_mutex_init (&engine->cull_mutex, NULL) != 0)
+  {
+    moss__error ("Failed to create cull mutex.\n");
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
+  }
+  engine->is_cull_mutex_initialized = true;
+
+  {
+    const Moss__CreateDeletionQueueInfo create_info = {
+      .device             = engine->device,
+      .allocator          = &engine->allocator,
+      .texture_index_pool = &engine->texture_index_pool,
+      .out_deletion_queue = &engine->deletion_queue,
+    };
+    if (moss__create_deletion_queue (&create_info) != MOSS_RESULT_SUCCESS)
+    {
+      moss_destroy_engine ((MossEngine *)engine);
+      return NULL;
+    }
+  }
+
+  {
+    const Moss__CreateFrameUploadQueueInfo create_info = {
+      .device                 = engine->device,
+      .allocator              = &engine->allocator,
+      .out_frame_upload_queue = &engine->frame_upload_queue,
+    };
+    if (moss__create_frame_upload_queue (&create_info) != MOSS_RESULT_SUCCESS)
+    {
+      moss_destroy_engine ((MossEngine *)engine);
+      return NULL;
+    }
+  }
+
+  if (engine->is_bindless &&
+      moss__create_texture_index_pool (
+        &engine->texture_index_pool,
+        &engine->host_allocator,
+        MAX_TEXTURE_COUNT
+      ) != MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
+  }
+
   vkGetDeviceQueue (
     engine->device,
     engine->queue_family_indices.graphics_family,
@@ -386,9 +705,9 @@ MossEngine *moss_create_engine (const MossEngineConfig *const config)
 
   moss__init_buffer_sharing_mode (engine);
 
-  // Get framebuffer size from callback
-  uint32_t width, height;
-  engine->get_window_framebuffer_size (&width, &height);
+  // Headless images have fixed size, window framebuffer size comes from the callback
+  uint32_t width = config->headless_width, height = config->headless_height;
+  if (!engine->is_headless) { engine->get_window_framebuffer_size (&width, &height); }
 
   if (moss__create_swapchain (engine, width, height) != MOSS_RESULT_SUCCESS)
   {
@@ -408,18 +727,13 @@ MossEngine *moss_create_engine (const MossEngineConfig *const config)
     return NULL;
   }
 
-  if (moss__create_camera_ubo_buffers (engine) != MOSS_RESULT_SUCCESS)
-  {
-    moss_destroy_engine ((MossEngine *)engine);
-    return NULL;
-  }
-
   // Create general command pool
   {
     const Moss__CreateVkCommandPoolInfo create_info = {
-      .device             = engine->device,
-      .queue_family_index = engine->queue_family_indices.graphics_family,
-      .out_command_pool   = &engine->general_command_pool,
+      .device               = engine->device,
+      .queue_family_index   = engine->queue_family_indices.graphics_family,
+      .out_command_pool     = &engine->general_command_pool,
+      .allocation_callbacks = &engine->vk_allocation_callbacks,
     };
     if (moss_vk__create_command_pool (&create_info) != MOSS_RESULT_SUCCESS)
     {
@@ -431,9 +745,10 @@ MossEngine *moss_create_engine (const MossEngineConfig *const config)
   // Create transfer command pool
   {
     const Moss__CreateVkCommandPoolInfo create_info = {
-      .device             = engine->device,
-      .queue_family_index = engine->queue_family_indices.transfer_family,
-      .out_command_pool   = &engine->transfer_command_pool,
+      .device               = engine->device,
+      .queue_family_index   = engine->queue_family_indices.transfer_family,
+      .out_command_pool     = &engine->transfer_command_pool,
+      .allocation_callbacks = &engine->vk_allocation_callbacks,
     };
     if (moss_vk__create_command_pool (&create_info) != MOSS_RESULT_SUCCESS)
     {
@@ -442,13 +757,24 @@ MossEngine *moss_create_engine (const MossEngineConfig *const config)
     }
   }
 
-  if (moss__create_texture_image (engine) != MOSS_RESULT_SUCCESS)
+  // Create upload queue
   {
-    moss_destroy_engine ((MossEngine *)engine);
-    return NULL;
+    const Moss__CreateUploadQueueInfo create_info = {
+      .device           = engine->device,
+      .queue            = engine->transfer_queue,
+      .command_pool     = engine->transfer_command_pool,
+      .allocator        = &engine->allocator,
+      .out_upload_queue = &engine->upload_queue,
+    };
+    if (moss__create_upload_queue (&create_info) != MOSS_RESULT_SUCCESS)
+    {
+      moss_destroy_engine ((MossEngine *)engine);
+      return NULL;
+    }
   }
 
-  if (moss__create_texture_image_view (engine) != MOSS_RESULT_SUCCESS)
+  if (moss__reserve_quad_indices (engine, QUAD_INDEX_BUFFER_INITIAL_CAPACITY) !=
+      MOSS_RESULT_SUCCESS)
   {
     moss_destroy_engine ((MossEngine *)engine);
     return NULL;
@@ -466,27 +792,50 @@ MossEngine *moss_create_engine (const MossEngineConfig *const config)
     return NULL;
   }
 
-  if (moss__create_descriptor_pool (engine) != MOSS_RESULT_SUCCESS)
+  if (moss__create_texture_descriptor_pool (engine) != MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
+  }
+
+  if (moss__create_texture_descriptor_set_layout (engine) != MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
+  }
+
+  if (engine->is_bindless &&
+      moss__allocate_bindless_descriptor_set (engine) != MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
+  }
+
+  if (moss__create_animation_resources (engine) != MOSS_RESULT_SUCCESS)
   {
     moss_destroy_engine ((MossEngine *)engine);
     return NULL;
   }
 
-  if (moss__create_descriptor_set_layout (engine) != MOSS_RESULT_SUCCESS)
+  if (moss__create_tilemap_descriptor_objects (engine) != MOSS_RESULT_SUCCESS)
   {
     moss_destroy_engine ((MossEngine *)engine);
     return NULL;
   }
 
-  if (moss__allocate_descriptor_sets (engine) != MOSS_RESULT_SUCCESS)
+  if (moss__create_graphics_pipelines (engine) != MOSS_RESULT_SUCCESS)
   {
     moss_destroy_engine ((MossEngine *)engine);
     return NULL;
   }
 
-  moss__configure_descriptor_sets (engine);
+  if (moss__create_cull_pipelines (engine) != MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
+  }
 
-  if (moss__create_graphics_pipeline (engine) != MOSS_RESULT_SUCCESS)
+  if (moss__create_particle_pipeline (engine) != MOSS_RESULT_SUCCESS)
   {
     moss_destroy_engine ((MossEngine *)engine);
     return NULL;
@@ -504,24 +853,33 @@ MossEngine *moss_create_engine (const MossEngineConfig *const config)
     return NULL;
   }
 
-  if (moss__create_synchronization_objects (engine) != MOSS_RESULT_SUCCESS)
+  if (moss__create_command_recorders (engine) != MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
+  }
+
+  if (engine->is_headless && moss__create_frame_readbacks (engine) != MOSS_RESULT_SUCCESS)
   {
     moss_destroy_engine ((MossEngine *)engine);
     return NULL;
   }
 
-  engine->current_frame = 0;
+  if (moss__create_synchronization_objects (engine) != MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
+  }
 
-  // Initialize camera UBO data for all frames
-  for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+  if (moss__create_default_texture (engine) != MOSS_RESULT_SUCCESS)
   {
-    memcpy (
-      engine->camera_ubo_buffer_mapped_memory_blocks[ i ],
-      &engine->camera,
-      sizeof (engine->camera)
-    );
+    moss_destroy_engine ((MossEngine *)engine);
+    return NULL;
   }
 
+  engine->current_frame         = 0;
+  engine->animation_time_origin = moss__get_time_ns ( );
+
   return (MossEngine *)engine;
 }
 
@@ -532,6 +890,13 @@ MossEngine *moss_create_engine (const MossEngineConfig *const config)
 */
 void moss_destroy_engine (MossEngine *const engine)
 {
+  // Decoded textures that were never uploaded are dropped along with the thread
+  moss__stop_texture_loader (&engine->texture_loader);
+
+  // Texture destruction may submit pending uploads, so it goes before the wait
+  moss_destroy_texture (engine->default_texture);
+  engine->default_texture = NULL;
+
   if (engine->device != VK_NULL_HANDLE) { vkDeviceWaitIdle (engine->device); }
 
   moss__cleanup_swapchain (engine);
@@ -539,98 +904,250 @@ void moss_destroy_engine (MossEngine *const engine)
 
   if (engine->device != VK_NULL_HANDLE)
   {
+    // Deletion queue releases texture indices, so the pool outlives it
+    moss__destroy_deletion_queue (&engine->deletion_queue);
+    moss__destroy_texture_index_pool (&engine->texture_index_pool);
+    moss__destroy_upload_queue (&engine->upload_queue);
+    moss__destroy_frame_upload_queue (&engine->frame_upload_queue);
+
     if (engine->transfer_command_pool != VK_NULL_HANDLE)
     {
-      vkDestroyCommandPool (engine->device, engine->transfer_command_pool, NULL);
+      vkDestroyCommandPool (
+        engine->device,
+        engine->transfer_command_pool,
+        &engine->vk_allocation_callbacks
+      );
     }
 
-    if (engine->general_command_pool != VK_NULL_HANDLE)
-    {
-      vkDestroyCommandPool (engine->device, engine->general_command_pool, NULL);
-    }
+    moss__destroy_frame_readbacks (engine);
 
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    if (engine->general_command_pool != VK_NULL_HANDLE)
     {
-      moss_vk__destroy_buffer (
+      vkDestroyCommandPool (
         engine->device,
-        engine->camera_ubo_buffers[ i ],
-        engine->camera_ubo_memories[ i ]
+        engine->general_command_pool,
+        &engine->vk_allocation_callbacks
       );
     }
 
+    moss__destroy_command_recorders (engine);
+
+    moss__destroy_quad_index_buffers (engine);
+
+    moss__destroy_animation_resources (engine);
+
+    moss__destroy_tilemap_descriptor_objects (engine);
+
     moss__cleanup_depth_resources (engine);
 
     if (engine->sampler != VK_NULL_HANDLE)
     {
-      vkDestroySampler (engine->device, engine->sampler, NULL);
+      vkDestroySampler (
+        engine->device,
+        engine->sampler,
+        &engine->vk_allocation_callbacks
+      );
     }
 
-    if (engine->texture_image_view != VK_NULL_HANDLE)
+    for (size_t i = 0; i < MOSS__SPRITE_BATCH_MATERIAL_COUNT; ++i)
     {
-      vkDestroyImageView (engine->device, engine->texture_image_view, NULL);
+      const VkPipeline pipelines[] = {
+        engine->graphics_pipelines[ i ],
+        engine->instanced_graphics_pipelines[ i ],
+        engine->compact_graphics_pipelines[ i ],
+      };
+
+      for (size_t j = 0; j < sizeof (pipelines) / sizeof (pipelines[ 0 ]); ++j)
+      {
+        if (pipelines[ j ] == VK_NULL_HANDLE) { continue; }
+        vkDestroyPipeline (
+          engine->device,
+          pipelines[ j ],
+          &engine->vk_allocation_callbacks
+        );
+      }
     }
 
-    if (engine->texture_image != VK_NULL_HANDLE)
+    if (engine->tilemap_graphics_pipeline != VK_NULL_HANDLE)
     {
-      vkDestroyImage (engine->device, engine->texture_image, NULL);
+      vkDestroyPipeline (
+        engine->device,
+        engine->tilemap_graphics_pipeline,
+        &engine->vk_allocation_callbacks
+      );
     }
 
-    if (engine->texture_image_memory != VK_NULL_HANDLE)
+    if (engine->pipeline_layout != VK_NULL_HANDLE)
     {
-      vkFreeMemory (engine->device, engine->texture_image_memory, NULL);
+      vkDestroyPipelineLayout (
+        engine->device,
+        engine->pipeline_layout,
+        &engine->vk_allocation_callbacks
+      );
     }
 
-    if (engine->graphics_pipeline != VK_NULL_HANDLE)
+    if (engine->pipeline_cache != VK_NULL_HANDLE)
     {
-      vkDestroyPipeline (engine->device, engine->graphics_pipeline, NULL);
+      // Saving failure only costs a slower start next time, so it isn't fatal
+      if (engine->pipeline_cache_path != NULL)
+      {
+        moss_vk__save_pipeline_cache (
+          &engine->host_allocator,
+          engine->device,
+          engine->pipeline_cache,
+          engine->pipeline_cache_path
+        );
+      }
+      vkDestroyPipelineCache (
+        engine->device,
+        engine->pipeline_cache,
+        &engine->vk_allocation_callbacks
+      );
     }
 
-    if (engine->pipeline_layout != VK_NULL_HANDLE)
+    if (engine->timestamp_query_pool != VK_NULL_HANDLE)
     {
-      vkDestroyPipelineLayout (engine->device, engine->pipeline_layout, NULL);
+      vkDestroyQueryPool (
+        engine->device,
+        engine->timestamp_query_pool,
+        &engine->vk_allocation_callbacks
+      );
     }
 
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    if (engine->cull_pipeline != VK_NULL_HANDLE)
     {
-      if (engine->descriptor_sets[ i ] == VK_NULL_HANDLE) { continue; }
-
-      vkFreeDescriptorSets (
+      vkDestroyPipeline (
         engine->device,
-        engine->descriptor_pool,
-        1,
-        &engine->descriptor_sets[ i ]
+        engine->cull_pipeline,
+        &engine->vk_allocation_callbacks
       );
     }
 
-    if (engine->descriptor_pool != VK_NULL_HANDLE)
+    if (engine->instanced_cull_pipeline != VK_NULL_HANDLE)
     {
-      vkDestroyDescriptorPool (engine->device, engine->descriptor_pool, NULL);
+      vkDestroyPipeline (
+        engine->device,
+        engine->instanced_cull_pipeline,
+        &engine->vk_allocation_callbacks
+      );
+    }
+
+    if (engine->cull_pipeline_layout != VK_NULL_HANDLE)
+    {
+      vkDestroyPipelineLayout (
+        engine->device,
+        engine->cull_pipeline_layout,
+        &engine->vk_allocation_callbacks
+      );
+    }
+
+    if (engine->cull_descriptor_pool != VK_NULL_HANDLE)
+    {
+      vkDestroyDescriptorPool (
+        engine->device,
+        engine->cull_descriptor_pool,
+        &engine->vk_allocation_callbacks
+      );
+    }
+
+    if (engine->cull_descriptor_set_layout != VK_NULL_HANDLE)
+    {
+      vkDestroyDescriptorSetLayout (
+        engine->device,
+        engine->cull_descriptor_set_layout,
+        &engine->vk_allocation_callbacks
+      );
+    }
+
+    if (engine->particle_pipeline != VK_NULL_HANDLE)
+    {
+      vkDestroyPipeline (
+        engine->device,
+        engine->particle_pipeline,
+        &engine->vk_allocation_callbacks
+      );
+    }
+
+    if (engine->particle_pipeline_layout != VK_NULL_HANDLE)
+    {
+      vkDestroyPipelineLayout (
+        engine->device,
+        engine->particle_pipeline_layout,
+        &engine->vk_allocation_callbacks
+      );
+    }
+
+    if (engine->particle_descriptor_pool != VK_NULL_HANDLE)
+    {
+      vkDestroyDescriptorPool (
+        engine->device,
+        engine->particle_descriptor_pool,
+        &engine->vk_allocation_callbacks
+      );
+    }
+
+    if (engine->particle_descriptor_set_layout != VK_NULL_HANDLE)
+    {
+      vkDestroyDescriptorSetLayout (
+        engine->device,
+        engine->particle_descriptor_set_layout,
+        &engine->vk_allocation_callbacks
+      );
+    }
+
+    if (engine->texture_descriptor_pool != VK_NULL_HANDLE)
+    {
+      vkDestroyDescriptorPool (
+        engine->device,
+        engine->texture_descriptor_pool,
+        &engine->vk_allocation_callbacks
+      );
     }
 
-    if (engine->descriptor_set_layout != VK_NULL_HANDLE)
+    if (engine->texture_descriptor_set_layout != VK_NULL_HANDLE)
     {
-      vkDestroyDescriptorSetLayout (engine->device, engine->descriptor_set_layout, NULL);
+      vkDestroyDescriptorSetLayout (
+        engine->device,
+        engine->texture_descriptor_set_layout,
+        &engine->vk_allocation_callbacks
+      );
     }
 
     if (engine->render_pass != VK_NULL_HANDLE)
     {
-      vkDestroyRenderPass (engine->device, engine->render_pass, NULL);
+      vkDestroyRenderPass (
+        engine->device,
+        engine->render_pass,
+        &engine->vk_allocation_callbacks
+      );
     }
 
-    vkDestroyDevice (engine->device, NULL);
+    moss_vk__destroy_allocator (&engine->allocator);
+
+    vkDestroyDevice (engine->device, &engine->vk_allocation_callbacks);
   }
 
   if (engine->surface != VK_NULL_HANDLE)
   {
-    vkDestroySurfaceKHR (engine->api_instance, engine->surface, NULL);
+    vkDestroySurfaceKHR (
+      engine->api_instance,
+      engine->surface,
+      &engine->vk_allocation_callbacks
+    );
   }
 
   if (engine->api_instance != VK_NULL_HANDLE)
   {
-    vkDestroyInstance (engine->api_instance, NULL);
+    vkDestroyInstance (engine->api_instance, &engine->vk_allocation_callbacks);
   }
 
-  free (engine);
+  if (engine->is_cull_mutex_initialized) { pthread_mutex_destroy (&engine->cull_mutex); }
+
+  moss__free (&engine->host_allocator, engine->pipeline_cache_path);
+
+  // Engine memory holds the allocator, so it's freed through a copy
+  Moss__HostAllocator host_allocator = engine->host_allocator;
+  moss__free (&host_allocator, engine);
 }
 
 /*
@@ -646,26 +1163,86 @@ MossResult moss_begin_frame (MossEngine *const engine)
   const VkCommandBuffer command_buffer =
     engine->general_command_buffers[ engine->current_frame ];
 
+  MossFrameStats *const stats = &engine->recording_frame_stats;
+
+  const uint64_t pacing_wait_start = moss__get_time_ns ( );
+  if (engine->is_low_latency) { moss__wait_low_latency_pacing (engine); }
+
+  // Fence is reset only once an image is acquired, a failed acquire must leave it
+  // signaled or the next wait on this slot would never return
+  const uint64_t fence_wait_start = moss__get_time_ns ( );
   vkWaitForFences (engine->device, 1, &in_flight_fence, VK_TRUE, UINT64_MAX);
-  vkResetFences (engine->device, 1, &in_flight_fence);
 
-  uint32_t current_image_index;
-  VkResult result = vkAcquireNextImageKHR (
-    engine->device,
-    engine->swapchain,
-    UINT64_MAX,
-    image_available_semaphore,
-    VK_NULL_HANDLE,
-    &current_image_index
+  // GPU time is kept from the last read back until a newer one is available
+  *stats = (MossFrameStats) {
+    .cpu_pacing_wait_ms = moss__ns_to_ms (fence_wait_start - pacing_wait_start),
+    .cpu_fence_wait_ms  = moss__ns_to_ms (moss__get_time_ns ( ) - fence_wait_start),
+    .has_gpu_time      = engine->frame_stats.has_gpu_time,
+    .gpu_frame_index   = engine->frame_stats.gpu_frame_index,
+    .gpu_render_ms     = engine->frame_stats.gpu_render_ms,
+  };
+  moss__read_frame_timestamps (engine, stats);
+
+  // Sampled once, so every recorder of the frame animates sprites in lockstep
+  engine->animation_time =
+    (float)((double)(moss__get_time_ns ( ) - engine->animation_time_origin) / 1e9);
+
+  // Cull command buffer of this slot is begun by the first culled batch draw
+  engine->is_cull_recording = false;
+
+  // Release staging buffers of uploads the GPU has already finished
+  moss__collect_upload_staging_buffers (&engine->upload_queue);
+
+  // Frames complete in submission order, so every frame up to the one that used this
+  // slot is finished and resources retired before it can be destroyed
+  moss__collect_deletion_queue (
+    &engine->deletion_queue,
+    engine->in_flight_frame_counts[ engine->current_frame ],
+    moss__get_upload_queue_completed_value (&engine->upload_queue)
   );
 
-  if (result == VK_ERROR_OUT_OF_DATE_KHR)
+  // Upload textures the loader thread decoded, they are submitted with this frame
+  moss__finish_texture_loads (engine);
+
+  uint32_t current_image_index = 0;
+  VkResult result              = VK_SUCCESS;
+  if (engine->is_headless)
   {
-    // Swap chain is out of date, need to recreate before we can acquire image
-    // Get current framebuffer size from callback
-    uint32_t width, height;
-    engine->get_window_framebuffer_size (&width, &height);
-    return moss__recreate_swapchain (engine, width, height);
+    // Frames take headless images in turn, frames that used this image before are
+    // older than the one the slot fence has just completed
+    current_image_index = (uint32_t)(engine->frame_count % engine->swapchain_image_count);
+  }
+  else {
+    const uint64_t acquire_start = moss__get_time_ns ( );
+    result                       = vkAcquireNextImageKHR (
+      engine->device,
+      engine->swapchain,
+      UINT64_MAX,
+      image_available_semaphore,
+      VK_NULL_HANDLE,
+      &current_image_index
+    );
+
+    if (result == VK_ERROR_OUT_OF_DATE_KHR)
+    {
+      // Swap chain is recreated and acquired from again, so the frame still begins
+      uint32_t width, height;
+      engine->get_window_framebuffer_size (&width, &height);
+      if (moss__recreate_swapchain (engine, width, height) != MOSS_RESULT_SUCCESS)
+      {
+        return MOSS_RESULT_ERROR;
+      }
+
+      result = vkAcquireNextImageKHR (
+        engine->device,
+        engine->swapchain,
+        UINT64_MAX,
+        image_available_semaphore,
+        VK_NULL_HANDLE,
+        &current_image_index
+      );
+    }
+    stats->cpu_acquire_ms = moss__ns_to_ms (moss__get_time_ns ( ) - acquire_start);
   }
 
   if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
@@ -674,6 +1251,8 @@ MossResult moss_begin_frame (MossEngine *const engine)
     return MOSS_RESULT_ERROR;
   }
 
+  vkResetFences (engine->device, 1, &in_flight_fence);
+
   engine->current_image_index = current_image_index;
 
   vkResetCommandBuffer (command_buffer, 0);
@@ -688,6 +1267,14 @@ MossResult moss_begin_frame (MossEngine *const engine)
     return MOSS_RESULT_ERROR;
   }
 
+  moss__write_frame_begin_timestamp (engine, command_buffer);
+
+  // Recorded to the cull command buffer, which is submitted ahead of the frame one
+  if (moss__simulate_particle_systems (engine) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
   const VkClearValue clear_values[] = {
     { .color = { { 0.01F, 0.01F, 0.01F, 1.0F } } },
     { .depthStencil = { 1.0F, 0 } },
@@ -705,44 +1292,26 @@ MossResult moss_begin_frame (MossEngine *const engine)
     .pClearValues    = clear_values,
   };
 
-  vkCmdBeginRenderPass (command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
+  // Worker recorders can't share the render pass with inline draws, so with them
+  // every draw is recorded into a secondary command buffer
+  const VkSubpassContents subpass_contents =
+    engine->command_recorder_count > 0 ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+                                       : VK_SUBPASS_CONTENTS_INLINE;
+  vkCmdBeginRenderPass (command_buffer, &render_pass_info, subpass_contents);
 
-  vkCmdBindPipeline (
-    command_buffer,
-    VK_PIPELINE_BIND_POINT_GRAPHICS,
-    engine->graphics_pipeline
-  );
-
-  const VkViewport viewport = {
-    .x        = 0.0F,
-    .y        = 0.0F,
-    .width    = (float)engine->swapchain_extent.width,
-    .height   = (float)engine->swapchain_extent.height,
-    .minDepth = 0.0F,
-    .maxDepth = 1.0F,
-  };
-
-  const VkRect2D scissor = {
-    .offset = { 0, 0 },
-    .extent = engine->swapchain_extent,
-  };
-
-  vkCmdSetViewport (command_buffer, 0, 1, &viewport);
-  vkCmdSetScissor (command_buffer, 0, 1, &scissor);
+  for (uint32_t i = 0; i < engine->command_recorder_count; ++i)
+  {
+    engine->command_recorders[ i ].is_recording = false;
+    engine->command_recorders[ i ].is_recorded  = false;
+  }
 
-  vkCmdBindDescriptorSets (
-    command_buffer,
-    VK_PIPELINE_BIND_POINT_GRAPHICS,
-    engine->pipeline_layout,
-    0,
-    1,
-    &engine->descriptor_sets[ engine->current_frame ],
-    0,
-    NULL
-  );
+  if (moss__begin_command_recorder_commands (&engine->main_recorder) !=
+      MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
 
-  // Update camera UBO data before rendering
-  moss__update_camera_ubo_data (engine);
+  engine->is_frame_begun = true;
 
   return MOSS_RESULT_SUCCESS;
 }
@@ -763,31 +1332,139 @@ MossResult moss_end_frame (MossEngine *const engine)
   const VkFence  in_flight_fence     = engine->in_flight_fences[ engine->current_frame ];
   const uint32_t current_image_index = engine->current_image_index;
 
+  if (moss__flush_draw_queue (&engine->main_recorder) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (engine->command_recorder_count > 0)
+  {
+    if (moss__execute_command_recorders (engine) != MOSS_RESULT_SUCCESS)
+    {
+      return MOSS_RESULT_ERROR;
+    }
+  }
+  else {
+    engine->main_recorder.is_recording = false;
+  }
+
   vkCmdEndRenderPass (command_buffer);
 
+  moss__write_frame_end_timestamp (engine, command_buffer);
+
+  // Updates are staged while the frame is begun, the slot fence is reset already
+  moss__upload_sprite_batch_updates (engine);
+
+  const bool has_upload_commands = engine->frame_upload_queue.copy_count > 0;
+  if (has_upload_commands &&
+      moss__record_frame_upload_command_buffer (engine) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  engine->is_frame_begun = false;
+
+  MossFrameStats *const stats = &engine->recording_frame_stats;
+  moss__collect_recorder_counters (engine, stats);
+
+  const uint64_t recorded_upload_bytes = engine->upload_queue.recorded_bytes;
+  stats->upload_bytes = recorded_upload_bytes - engine->frame_upload_bytes_mark;
+  engine->frame_upload_bytes_mark = recorded_upload_bytes;
+
   if (vkEndCommandBuffer (command_buffer) != VK_SUCCESS)
   {
     moss__error ("Failed to end recording command buffer.\n");
     return MOSS_RESULT_ERROR;
   }
 
-  const VkSemaphore wait_semaphores[] = { image_available_semaphore };
-  const size_t      wait_semaphore_count =
+  const bool has_cull_commands = engine->is_cull_recording;
+  if (has_cull_commands &&
+      moss__end_cull_command_buffer (engine) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Frame uploads go first and culling after them, the barriers they end with order
+  // the draws
+  VkCommandBuffer command_buffers[ 3 ];
+  uint32_t        command_buffer_count = 0;
+  if (has_upload_commands)
+  {
+    command_buffers[ command_buffer_count++ ] =
+      engine->upload_command_buffers[ engine->current_frame ];
+  }
+  if (has_cull_commands)
+  {
+    command_buffers[ command_buffer_count++ ] =
+      engine->cull_command_buffers[ engine->current_frame ];
+  }
+  command_buffers[ command_buffer_count++ ] = command_buffer;
+
+  const uint64_t submit_start = moss__get_time_ns ( );
+
+  // Submit uploads recorded so far, the draw submit waits for them on the GPU
+  if (moss__flush_upload_queue (&engine->upload_queue) != MOSS_RESULT_SUCCESS)
+  {
+    moss__error ("Failed to flush upload queue.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  const VkSemaphore wait_semaphores[] = {
+    image_available_semaphore,
+    engine->upload_queue.timeline_semaphore,
+  };
+  const size_t wait_semaphore_count =
     sizeof (wait_semaphores) / sizeof (wait_semaphores[ 0 ]);
 
-  const VkSemaphore signal_semaphores[] = { render_finished_semaphore };
-  const size_t      signal_semaphore_count =
+  // Binary semaphore value is ignored
+  const uint64_t wait_semaphore_values[] = {
+    0,
+    engine->upload_queue.submitted_value,
+  };
+
+  // Frame uploads may copy into buffers the upload queue has just filled
+  const VkPipelineStageFlags wait_stages[] = {
+    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+    VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+      VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+  };
+
+  // Frame timeline lets the host wait for frames copying from staging buffers
+  const VkSemaphore signal_semaphores[] = {
+    engine->upload_queue.frame_semaphore,
+    render_finished_semaphore,
+  };
+  const size_t signal_semaphore_count =
     sizeof (signal_semaphores) / sizeof (signal_semaphores[ 0 ]);
 
+  // Binary semaphore value is ignored
+  const uint64_t signal_semaphore_values[] = {
+    engine->frame_count + 1,
+    0,
+  };
+
+  // Headless frames neither wait for an acquired image nor signal presentation
+  const size_t first_wait_semaphore = engine->is_headless ? 1 : 0;
+  const size_t frame_signal_count   = engine->is_headless ? 1 : signal_semaphore_count;
+
+  const VkTimelineSemaphoreSubmitInfo timeline_info = {
+    .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+    .waitSemaphoreValueCount   = wait_semaphore_count - first_wait_semaphore,
+    .pWaitSemaphoreValues      = wait_semaphore_values + first_wait_semaphore,
+    .signalSemaphoreValueCount = frame_signal_count,
+    .pSignalSemaphoreValues    = signal_semaphore_values,
+  };
+
   const VkSubmitInfo submit_info = {
-    .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-    .waitSemaphoreCount = wait_semaphore_count,
-    .pWaitSemaphores    = wait_semaphores,
-    .pWaitDstStageMask =
-      (const VkPipelineStageFlags[]) { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT },
-    .commandBufferCount   = 1,
-    .pCommandBuffers      = &command_buffer,
-    .signalSemaphoreCount = signal_semaphore_count,
+    .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+    .pNext                = &timeline_info,
+    .waitSemaphoreCount   = wait_semaphore_count - first_wait_semaphore,
+    .pWaitSemaphores      = wait_semaphores + first_wait_semaphore,
+    .pWaitDstStageMask    = wait_stages + first_wait_semaphore,
+    .commandBufferCount   = command_buffer_count,
+    .pCommandBuffers      = command_buffers,
+    .signalSemaphoreCount = frame_signal_count,
     .pSignalSemaphores    = signal_semaphores,
   };
 
@@ -798,16 +1475,60 @@ MossResult moss_end_frame (MossEngine *const engine)
     return MOSS_RESULT_ERROR;
   }
 
+  stats->cpu_submit_ms = moss__ns_to_ms (moss__get_time_ns ( ) - submit_start);
+
+  // Staging of this slot is read until the slot fence signals
+  moss__end_frame_upload_slot (&engine->frame_upload_queue);
+
+  // Remember which frame the fence of this slot signals completion of
+  ++engine->frame_count;
+  engine->in_flight_frame_counts[ engine->current_frame ] = engine->frame_count;
+
+  stats->frame_index = engine->frame_count;
+  engine->are_timestamps_pending[ engine->current_frame ] =
+    engine->timestamp_query_pool != VK_NULL_HANDLE;
+
+  if (engine->is_headless)
+  {
+    // Readbacks of the frame are submitted right after it, nothing is presented
+    const MossResult result = moss__submit_frame_readbacks (engine, engine->frame_count);
+
+    engine->frame_stats   = *stats;
+    engine->current_frame = (engine->current_frame + 1) % engine->frames_in_flight_count;
+
+    return result;
+  }
+
+  // Frame count identifies the present, low-latency mode waits for it later
+  const uint64_t      present_id      = engine->frame_count;
+  const VkPresentIdKHR present_id_info = {
+    .sType          = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+    .pNext          = NULL,
+    .swapchainCount = 1,
+    .pPresentIds    = &present_id,
+  };
+
   const VkPresentInfoKHR present_info = {
     .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-    .waitSemaphoreCount = signal_semaphore_count,
-    .pWaitSemaphores    = signal_semaphores,
+    .pNext              = engine->is_present_wait_enabled ? &present_id_info : NULL,
+    .waitSemaphoreCount = 1,
+    .pWaitSemaphores    = &render_finished_semaphore,
     .swapchainCount     = 1,
     .pSwapchains        = &engine->swapchain,
     .pImageIndices      = &current_image_index,
   };
 
-  const VkResult result = vkQueuePresentKHR (engine->present_queue, &present_info);
+  const uint64_t present_start = moss__get_time_ns ( );
+  const VkResult result        = vkQueuePresentKHR (engine->present_queue, &present_info);
+  stats->cpu_present_ms = moss__ns_to_ms (moss__get_time_ns ( ) - present_start);
+
+  // Stats are published before a possible swap chain recreation fails
+  engine->frame_stats = *stats;
+
+  if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+  {
+    engine->last_present_id = present_id;
+  }
 
   if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
   {
@@ -826,11 +1547,184 @@ MossResult moss_end_frame (MossEngine *const engine)
     return MOSS_RESULT_ERROR;
   }
 
-  engine->current_frame = (engine->current_frame + 1) % MAX_FRAMES_IN_FLIGHT;
+  engine->current_frame = (engine->current_frame + 1) % engine->frames_in_flight_count;
 
   return MOSS_RESULT_SUCCESS;
 }
 
+MossCommandRecorder *
+moss_begin_command_recorder (MossEngine *const engine, const uint32_t recorder_index)
+{
+  if (!engine->is_frame_begun)
+  {
+    moss__error ("Command recorder can only be begun within a frame.\n");
+    return NULL;
+  }
+
+  if (recorder_index >= engine->command_recorder_count)
+  {
+    moss__error (
+      "Command recorder index %u is out of range, engine has %u recorders.\n",
+      recorder_index,
+      engine->command_recorder_count
+    );
+    return NULL;
+  }
+
+  MossCommandRecorder *const recorder = &engine->command_recorders[ recorder_index ];
+  if (recorder->is_recording || recorder->is_recorded)
+  {
+    moss__error ("Command recorder %u is already begun this frame.\n", recorder_index);
+    return NULL;
+  }
+
+  if (moss__begin_command_recorder_commands (recorder) != MOSS_RESULT_SUCCESS)
+  {
+    return NULL;
+  }
+
+  return recorder;
+}
+
+MossResult moss_end_command_recorder (MossCommandRecorder *const recorder)
+{
+  if (!recorder->is_recording)
+  {
+    moss__error ("Command recorder isn't begun.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (moss__flush_draw_queue (recorder) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  return moss__end_command_recorder_commands (recorder);
+}
+
+MossFrameReadback *moss_request_frame_readback (MossEngine *const engine)
+{
+  if (!engine->is_headless)
+  {
+    moss__error ("Frame readback requires a headless engine.\n");
+    return NULL;
+  }
+
+  if (!engine->is_frame_begun)
+  {
+    moss__error ("Frame readback can only be requested within a frame.\n");
+    return NULL;
+  }
+
+  for (size_t i = 0; i < MAX_FRAME_READBACK_COUNT; ++i)
+  {
+    MossFrameReadback *const readback = &engine->frame_readbacks[ i ];
+    if (readback->is_in_use) { continue; }
+
+    // Copy is recorded and submitted by moss_end_frame
+    readback->frame_index  = engine->frame_count + 1;
+    readback->image_index  = engine->current_image_index;
+    readback->is_in_use    = true;
+    readback->is_submitted = false;
+
+    return readback;
+  }
+
+  moss__error (
+    "All %zu frame readbacks are in use, release completed ones first.\n",
+    MAX_FRAME_READBACK_COUNT
+  );
+  return NULL;
+}
+
+bool moss_poll_frame_readback (
+  MossFrameReadback *const     readback,
+  MossFrameReadbackData *const out_data
+)
+{
+  if (!readback->is_submitted) { return false; }
+
+  const MossEngine *const engine = readback->engine;
+  if (vkGetFenceStatus (engine->device, readback->fence) != VK_SUCCESS) { return false; }
+
+  // Rows are copied tightly packed
+  *out_data = (MossFrameReadbackData) {
+    .pixels      = readback->allocation.mapped_memory,
+    .width       = engine->swapchain_extent.width,
+    .height      = engine->swapchain_extent.height,
+    .row_pitch   = engine->swapchain_extent.width * MOSS__FRAME_READBACK_PIXEL_SIZE,
+    .frame_index = readback->frame_index,
+  };
+
+  return true;
+}
+
+void moss_release_frame_readback (MossFrameReadback *const readback)
+{
+  // Copy may still read into the buffer, so it's waited before the slot is reused
+  if (readback->is_submitted)
+  {
+    vkWaitForFences (readback->engine->device, 1, &readback->fence, VK_TRUE, UINT64_MAX);
+  }
+
+  readback->is_in_use    = false;
+  readback->is_submitted = false;
+}
+
+/*
+  @brief Returns GPU memory allocation statistics.
+  @param engine Engine handle.
+  @param out_stats Output statistics.
+*/
+void moss_get_memory_stats (
+  const MossEngine *const engine,
+  MossMemoryStats *const  out_stats
+)
+{
+  *out_stats = (MossMemoryStats) {
+    .block_count      = (uint32_t)engine->allocator.block_count,
+    .allocation_count = (uint32_t)engine->allocator.allocation_count,
+    .block_bytes      = (uint64_t)engine->allocator.block_bytes,
+    .allocation_bytes = (uint64_t)engine->allocator.allocation_bytes,
+  };
+}
+
+/*
+  @brief Returns host memory allocation statistics.
+  @param engine Engine handle.
+  @param out_stats Output statistics.
+*/
+void moss_get_host_memory_stats (
+  const MossEngine *const    engine,
+  MossHostMemoryStats *const out_stats
+)
+{
+  out_stats->total = moss__read_allocation_counters (&engine->host_allocator.total);
+  for (size_t i = 0; i < MOSS_ALLOCATION_CATEGORY_COUNT; ++i)
+  {
+    out_stats->categories[ i ] =
+      moss__read_allocation_counters (&engine->host_allocator.categories[ i ]);
+  }
+}
+
+/*
+  @brief Returns statistics of the last ended frame.
+  @param engine Engine handle.
+  @param out_stats Output statistics.
+*/
+void moss_get_frame_stats (
+  const MossEngine *const engine,
+  MossFrameStats *const   out_stats
+)
+{
+  *out_stats = engine->frame_stats;
+}
+
+bool moss_is_bindless_textures_enabled (const MossEngine *const engine)
+{
+  return engine->is_bindless;
+}
+
 /*=============================================================================
     INTERNAL FUNCTIONS IMPLEMENTATION
   =============================================================================*/
@@ -880,8 +1774,11 @@ moss__create_api_instance (MossEngine *const engine, const MossAppInfo *const ap
     .flags                   = moss_vk__get_required_instance_flags ( ),
   };
 
-  const VkResult result =
-    vkCreateInstance (&instance_create_info, NULL, &engine->api_instance);
+  const VkResult result = vkCreateInstance (
+    &instance_create_info,
+    &engine->vk_allocation_callbacks,
+    &engine->api_instance
+  );
   if (result != VK_SUCCESS)
   {
     moss__error ("Failed to create Vulkan instance. Error code: %d.\n", result);
@@ -904,7 +1801,7 @@ inline static MossResult moss__create_surface (MossEngine *const engine)
   const VkResult result = vkCreateMetalSurfaceEXT (
     engine->api_instance,
     &surface_create_info,
-    NULL,
+    &engine->vk_allocation_callbacks,
     &engine->surface
   );
 
@@ -923,9 +1820,22 @@ inline static MossResult moss__create_surface (MossEngine *const engine)
 
 inline static MossResult moss__create_logical_device (MossEngine *const engine)
 {
-  const Moss__VkPhysicalDeviceExtensions extensions =
+  const Moss__VkPhysicalDeviceExtensions required_extensions =
     moss_vk__get_required_device_extensions ( );
 
+  // Optional extensions are enabled after the required ones
+  const char *extension_names[ required_extensions.count + 2 ];
+  uint32_t    extension_count = 0;
+  for (uint32_t i = 0; i < required_extensions.count; ++i)
+  {
+    extension_names[ extension_count++ ] = required_extensions.names[ i ];
+  }
+  if (engine->is_present_wait_enabled)
+  {
+    extension_names[ extension_count++ ] = VK_KHR_PRESENT_ID_EXTENSION_NAME;
+    extension_names[ extension_count++ ] = VK_KHR_PRESENT_WAIT_EXTENSION_NAME;
+  }
+
   uint32_t                queue_create_info_count = 0;
   VkDeviceQueueCreateInfo queue_create_infos[ 3 ];
   const float             queue_priority = 1.0F;
@@ -967,28 +1877,122 @@ inline static MossResult moss__create_logical_device (MossEngine *const engine)
     queue_create_infos[ queue_create_info_count++ ] = create_info;
   }
 
-  VkPhysicalDeviceFeatures device_features = { 0 };
+  // Compressed formats are enabled when available, KTX2 textures are checked
+  // against device format support when loaded
+  VkPhysicalDeviceFeatures supported_features;
+  vkGetPhysicalDeviceFeatures (engine->physical_device, &supported_features);
+
+  VkPhysicalDeviceFeatures device_features = {
+    .textureCompressionBC       = supported_features.textureCompressionBC,
+    .textureCompressionASTC_LDR = supported_features.textureCompressionASTC_LDR,
+  };
+
+  // Present id and present wait pace frames in low-latency mode
+  VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features = {
+    .sType       = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+    .pNext       = NULL,
+    .presentWait = VK_TRUE,
+  };
+  VkPhysicalDevicePresentIdFeaturesKHR present_id_features = {
+    .sType     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+    .pNext     = &present_wait_features,
+    .presentId = VK_TRUE,
+  };
+
+  // Timeline semaphores are used by the upload queue, descriptor indexing features
+  // by the bindless texture array
+  const VkBool32                         is_bindless       = engine->is_bindless;
+  const VkPhysicalDeviceVulkan12Features vulkan12_features = {
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+    .pNext = engine->is_present_wait_enabled ? &present_id_features : NULL,
+    .timelineSemaphore = VK_TRUE,
+    .shaderSampledImageArrayNonUniformIndexing    = is_bindless,
+    .descriptorBindingSampledImageUpdateAfterBind = is_bindless,
+    .descriptorBindingUpdateUnusedWhilePending    = is_bindless,
+    .descriptorBindingPartiallyBound              = is_bindless,
+    .runtimeDescriptorArray                       = is_bindless,
+  };
 
   const VkDeviceCreateInfo create_info = {
     .sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+    .pNext                   = &vulkan12_features,
     .queueCreateInfoCount    = queue_create_info_count,
     .pQueueCreateInfos       = queue_create_infos,
-    .enabledExtensionCount   = extensions.count,
-    .ppEnabledExtensionNames = extensions.names,
+    .enabledExtensionCount   = extension_count,
+    .ppEnabledExtensionNames = extension_names,
     .pEnabledFeatures        = &device_features,
   };
 
-  const VkResult result =
-    vkCreateDevice (engine->physical_device, &create_info, NULL, &engine->device);
+  const VkResult result = vkCreateDevice (
+    engine->physical_device,
+    &create_info,
+    &engine->vk_allocation_callbacks,
+    &engine->device
+  );
   if (result != VK_SUCCESS)
   {
     moss__error ("Failed to create logical device. Error code: %d.\n", result);
     return MOSS_RESULT_ERROR;
   }
 
+  // Extension commands aren't exported by the loader, they're queried from the device
+  if (engine->is_present_wait_enabled)
+  {
+    engine->wait_for_present = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr (
+      engine->device,
+      "vkWaitForPresentKHR"
+    );
+    engine->is_present_wait_enabled = engine->wait_for_present != NULL;
+  }
+
   return MOSS_RESULT_SUCCESS;
 }
 
+inline static VkPresentModeKHR
+moss__get_vk_present_mode (const MossPresentMode present_mode)
+{
+  switch (present_mode)
+  {
+    case MOSS_PRESENT_MODE_IMMEDIATE: return VK_PRESENT_MODE_IMMEDIATE_KHR;
+    case MOSS_PRESENT_MODE_FIFO: return VK_PRESENT_MODE_FIFO_KHR;
+    case MOSS_PRESENT_MODE_FIFO_RELAXED: return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+    case MOSS_PRESENT_MODE_MAILBOX:
+    default: return VK_PRESENT_MODE_MAILBOX_KHR;
+  }
+}
+
+inline static void moss__wait_low_latency_pacing (MossEngine *const engine)
+{
+  if (engine->frame_count == 0) { return; }
+
+  if (engine->is_present_wait_enabled)
+  {
+    // Nothing was presented to this swap chain yet right after recreation
+    if (engine->last_present_id == 0) { return; }
+
+    // Timeout only bounds the wait if the present never reaches the display
+    engine->wait_for_present (
+      engine->device,
+      engine->swapchain,
+      engine->last_present_id,
+      LOW_LATENCY_PRESENT_WAIT_TIMEOUT
+    );
+    return;
+  }
+
+  // Previous frame used the slot before the current one
+  const uint32_t previous_frame =
+    (engine->current_frame + engine->frames_in_flight_count - 1) %
+    engine->frames_in_flight_count;
+  vkWaitForFences (
+    engine->device,
+    1,
+    &engine->in_flight_fences[ previous_frame ],
+    VK_TRUE,
+    UINT64_MAX
+  );
+}
+
 inline static void moss__init_buffer_sharing_mode (MossEngine *const engine)
 {
   if (engine->queue_family_indices.graphics_family ==
@@ -1013,6 +2017,11 @@ inline static MossResult moss__create_swapchain (
   const uint32_t    height
 )
 {
+  if (engine->is_headless)
+  {
+    return moss__create_headless_images (engine, width, height);
+  }
+
   const Moss__QuerySwapchainSupportInfo query_info = {
     .device  = engine->physical_device,
     .surface = engine->surface,
@@ -1026,7 +2035,8 @@ inline static MossResult moss__create_swapchain (
   );
   const VkPresentModeKHR present_mode = moss_vk__choose_swap_present_mode (
     swapchain_support.present_modes,
-    swapchain_support.present_mode_count
+    swapchain_support.present_mode_count,
+    engine->preferred_present_mode
   );
   const VkExtent2D extent =
     moss_vk__choose_swap_extent (&swapchain_support.capabilities, width, height);
@@ -1044,7 +2054,7 @@ inline static MossResult moss__create_swapchain (
     .compositeAlpha   = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
     .presentMode      = present_mode,
     .clipped          = VK_TRUE,
-    .oldSwapchain     = VK_NULL_HANDLE,
+    .oldSwapchain     = engine->swapchain,
   };
 
   uint32_t queue_family_indices[] = {
@@ -1065,8 +2075,23 @@ inline static MossResult moss__create_swapchain (
     create_info.pQueueFamilyIndices   = NULL;
   }
 
-  const VkResult result =
-    vkCreateSwapchainKHR (engine->device, &create_info, NULL, &engine->swapchain);
+  VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+  const VkResult result = vkCreateSwapchainKHR (
+    engine->device,
+    &create_info,
+    &engine->vk_allocation_callbacks,
+    &swapchain
+  );
+
+  // Old swap chain is retired even if creation fails, frames in flight may still
+  // present its images, so it's destroyed once they are finished
+  if (create_info.oldSwapchain != VK_NULL_HANDLE)
+  {
+    const Moss__DeletionQueueEntry entry = { .swapchain = create_info.oldSwapchain };
+    moss__defer_deletion (engine, &entry, 0);
+  }
+
+  engine->swapchain = swapchain;
   if (result != VK_SUCCESS)
   {
     moss__error ("Failed to create swap chain. Error code: %d.\n", result);
@@ -1103,13 +2128,65 @@ inline static MossResult moss__create_swapchain (
   return MOSS_RESULT_SUCCESS;
 }
 
+inline static MossResult moss__create_headless_images (
+  MossEngine *const engine,
+  const uint32_t    width,
+  const uint32_t    height
+)
+{
+  // sRGB matches the preferred swap chain format, readback pixels are RGBA
+  const VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+
+  const MossVk__CreateImageInfo image_info = {
+    .device                          = engine->device,
+    .format                          = format,
+    .image_width                     = width,
+    .image_height                    = height,
+    .mip_level_count                 = 1,
+    .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+    .sharing_mode                    = VK_SHARING_MODE_EXCLUSIVE,
+    .shared_queue_family_index_count = 0,
+    .shared_queue_family_indices     = NULL,
+    .allocation_callbacks            = &engine->vk_allocation_callbacks,
+  };
+
+  for (uint32_t i = 0; i < HEADLESS_IMAGE_COUNT; ++i)
+  {
+    const VkImage image = moss_vk__create_image (&image_info);
+    if (image == VK_NULL_HANDLE) { return MOSS_RESULT_ERROR; }
+
+    engine->swapchain_images[ i ]  = image;
+    engine->swapchain_image_count = i + 1;
+
+    const MossVk__AllocateImageMemoryInfo allocate_info = {
+      .allocator = &engine->allocator,
+      .device    = engine->device,
+      .image     = image,
+    };
+    if (moss_vk__allocate_image_memory (
+          &allocate_info,
+          &engine->headless_image_allocations[ i ]
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to allocate memory for headless image %u.\n", i);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  engine->swapchain_image_format = format;
+  engine->swapchain_extent       = (VkExtent2D) { .width = width, .height = height };
+
+  return MOSS_RESULT_SUCCESS;
+}
+
 inline static MossResult moss__create_swapchain_image_views (MossEngine *const engine)
 {
   Moss__VkImageViewCreateInfo info = {
-    .device = engine->device,
-    .image  = VK_NULL_HANDLE,
-    .format = engine->swapchain_image_format,
-    .aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+    .device               = engine->device,
+    .image                = VK_NULL_HANDLE,
+    .format               = engine->swapchain_image_format,
+    .aspect               = VK_IMAGE_ASPECT_COLOR_BIT,
+    .allocation_callbacks = &engine->vk_allocation_callbacks,
   };
 
   for (uint32_t i = 0; i < engine->swapchain_image_count; ++i)
@@ -1136,7 +2213,9 @@ inline static MossResult moss__create_render_pass (MossEngine *const engine)
     .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
     .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
     .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
-    .finalLayout    = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+    // Headless images are only ever read back after the render pass
+    .finalLayout = engine->is_headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+                                       : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
   };
 
   const VkAttachmentReference color_attachment_ref = {
@@ -1168,16 +2247,32 @@ inline static MossResult moss__create_render_pass (MossEngine *const engine)
     .pDepthStencilAttachment = &depth_attachment_ref,
   };
 
-  const VkSubpassDependency subpass_dependency = {
-    .srcSubpass   = VK_SUBPASS_EXTERNAL,
-    .dstSubpass   = 0,
-    .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-                    VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-    .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-    .dstStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-                    VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-    .dstAccessMask =
-      VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+  // Readback of a previous frame reads the same headless image that the next
+  // frame clears, transfer reads need only an execution dependency
+  const VkPipelineStageFlags readback_stage =
+    engine->is_headless ? VK_PIPELINE_STAGE_TRANSFER_BIT : 0;
+
+  const VkSubpassDependency subpass_dependencies[] = {
+    {
+      .srcSubpass   = VK_SUBPASS_EXTERNAL,
+      .dstSubpass   = 0,
+      .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | readback_stage,
+      .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+      .dstStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                      VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+      .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+    },
+    // Orders readback copies, submitted after the frame, after its color writes
+    {
+      .srcSubpass    = 0,
+      .dstSubpass    = VK_SUBPASS_EXTERNAL,
+      .srcStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+      .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+      .dstStageMask  = VK_PIPELINE_STAGE_TRANSFER_BIT,
+      .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+    },
   };
 
   const VkAttachmentDescription attachments[] = {
@@ -1191,29 +2286,73 @@ inline static MossResult moss__create_render_pass (MossEngine *const engine)
     .pAttachments    = attachments,
     .subpassCount    = 1,
     .pSubpasses      = &subpass,
-    .dependencyCount = 1,
-    .pDependencies   = &subpass_dependency,
+    .dependencyCount = engine->is_headless ? 2 : 1,
+    .pDependencies   = subpass_dependencies,
   };
 
-  const VkResult result =
-    vkCreateRenderPass (engine->device, &render_pass_info, NULL, &engine->render_pass);
+  const VkResult result = vkCreateRenderPass (
+    engine->device,
+    &render_pass_info,
+    &engine->vk_allocation_callbacks,
+    &engine->render_pass
+  );
   if (result != VK_SUCCESS)
   {
     moss__error ("Failed to create render pass. Error code: %d.\n", result);
     return MOSS_RESULT_ERROR;
   }
 
-  return MOSS_RESULT_SUCCESS;
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static VkPipelineVertexInputStateCreateInfo
+moss__create_vk_pipeline_vertex_input_state_info (void)
+{
+  const Moss__VkVertexInputBindingDescriptionPack binding_descriptions_pack =
+    moss__get_vk_vertex_input_binding_description ( );
+
+  const Moss__VkVertexInputAttributeDescriptionPack attribute_descriptions_pack =
+    moss__get_vk_vertex_input_attribute_description ( );
+
+  const VkPipelineVertexInputStateCreateInfo info = {
+    .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+    .vertexBindingDescriptionCount   = binding_descriptions_pack.count,
+    .pVertexBindingDescriptions      = binding_descriptions_pack.descriptions,
+    .vertexAttributeDescriptionCount = attribute_descriptions_pack.count,
+    .pVertexAttributeDescriptions    = attribute_descriptions_pack.descriptions,
+  };
+
+  return info;
+}
+
+inline static VkPipelineVertexInputStateCreateInfo
+moss__create_vk_pipeline_instance_input_state_info (void)
+{
+  const Moss__VkVertexInputBindingDescriptionPack binding_descriptions_pack =
+    moss__get_vk_instance_input_binding_description ( );
+
+  const Moss__VkVertexInputAttributeDescriptionPack attribute_descriptions_pack =
+    moss__get_vk_instance_input_attribute_description ( );
+
+  const VkPipelineVertexInputStateCreateInfo info = {
+    .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+    .vertexBindingDescriptionCount   = binding_descriptions_pack.count,
+    .pVertexBindingDescriptions      = binding_descriptions_pack.descriptions,
+    .vertexAttributeDescriptionCount = attribute_descriptions_pack.count,
+    .pVertexAttributeDescriptions    = attribute_descriptions_pack.descriptions,
+  };
+
+  return info;
 }
 
 inline static VkPipelineVertexInputStateCreateInfo
-moss__create_vk_pipeline_vertex_input_state_info (void)
+moss__create_vk_pipeline_compact_vertex_input_state_info (void)
 {
   const Moss__VkVertexInputBindingDescriptionPack binding_descriptions_pack =
-    moss__get_vk_vertex_input_binding_description ( );
+    moss__get_vk_compact_vertex_input_binding_description ( );
 
   const Moss__VkVertexInputAttributeDescriptionPack attribute_descriptions_pack =
-    moss__get_vk_vertex_input_attribute_description ( );
+    moss__get_vk_compact_vertex_input_attribute_description ( );
 
   const VkPipelineVertexInputStateCreateInfo info = {
     .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
@@ -1226,56 +2365,71 @@ moss__create_vk_pipeline_vertex_input_state_info (void)
   return info;
 }
 
-inline static MossResult moss__create_descriptor_pool (MossEngine *const engine)
+inline static MossResult moss__create_texture_descriptor_pool (MossEngine *const engine)
 {
   const VkDescriptorPoolSize pool_sizes[] = {
-    {
-     .type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-     .descriptorCount = MAX_FRAMES_IN_FLIGHT,
-     },
     {
      .type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-     .descriptorCount = MAX_FRAMES_IN_FLIGHT,
-     }
+     .descriptorCount = MAX_TEXTURE_COUNT,
+     },
   };
 
+  // Bindless mode allocates a single set with the whole texture array
   const VkDescriptorPoolCreateInfo create_info = {
     .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
     .poolSizeCount = sizeof (pool_sizes) / sizeof (pool_sizes[ 0 ]),
     .pPoolSizes    = pool_sizes,
-    .maxSets       = MAX_FRAMES_IN_FLIGHT,
-    .flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+    .maxSets       = engine->is_bindless ? 1 : MAX_TEXTURE_COUNT,
+    .flags         = engine->is_bindless
+                       ? VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT
+                       : VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
   };
 
-  const VkResult result =
-    vkCreateDescriptorPool (engine->device, &create_info, NULL, &engine->descriptor_pool);
+  const VkResult result = vkCreateDescriptorPool (
+    engine->device,
+    &create_info,
+    &engine->vk_allocation_callbacks,
+    &engine->texture_descriptor_pool
+  );
   if (result != VK_SUCCESS)
   {
-    moss__error ("Failed to create descriptor pool: %d.", result);
+    moss__error ("Failed to create texture descriptor pool: %d.", result);
     return MOSS_RESULT_ERROR;
   }
   return MOSS_RESULT_SUCCESS;
 }
 
-inline static MossResult moss__create_descriptor_set_layout (MossEngine *const engine)
+inline static MossResult
+moss__create_texture_descriptor_set_layout (MossEngine *const engine)
 {
   const VkDescriptorSetLayoutBinding layout_bindings[] = {
     {
      .binding         = 0,
-     .descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-     .descriptorCount = 1,
-     .stageFlags      = VK_SHADER_STAGE_VERTEX_BIT,
-     },
-    {
-     .binding         = 1,
      .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-     .descriptorCount = 1,
+     .descriptorCount = engine->is_bindless ? MAX_TEXTURE_COUNT : 1,
      .stageFlags      = VK_SHADER_STAGE_FRAGMENT_BIT,
      },
   };
 
+  // Texture array has holes and gets new textures while frames are in flight
+  const VkDescriptorBindingFlags binding_flags[] = {
+    VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+      VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+      VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+  };
+
+  const VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info = {
+    .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+    .bindingCount  = sizeof (binding_flags) / sizeof (binding_flags[ 0 ]),
+    .pBindingFlags = binding_flags,
+  };
+
   const VkDescriptorSetLayoutCreateInfo create_info = {
     .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+    .pNext        = engine->is_bindless ? &binding_flags_info : NULL,
+    .flags        = engine->is_bindless
+                      ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT
+                      : 0,
     .bindingCount = sizeof (layout_bindings) / sizeof (layout_bindings[ 0 ]),
     .pBindings    = layout_bindings,
   };
@@ -1283,132 +2437,152 @@ inline static MossResult moss__create_descriptor_set_layout (MossEngine *const e
   const VkResult result = vkCreateDescriptorSetLayout (
     engine->device,
     &create_info,
-    NULL,
-    &engine->descriptor_set_layout
+    &engine->vk_allocation_callbacks,
+    &engine->texture_descriptor_set_layout
   );
   if (result != VK_SUCCESS)
   {
-    moss__error ("Failed to create Vulkan descriptor layout: %d.", result);
+    moss__error ("Failed to create Vulkan texture descriptor layout: %d.", result);
     return MOSS_RESULT_ERROR;
   }
   return MOSS_RESULT_SUCCESS;
 }
 
-inline static MossResult moss__allocate_descriptor_sets (MossEngine *const engine)
+inline static MossResult moss__allocate_bindless_descriptor_set (MossEngine *const engine)
 {
-  VkDescriptorSetLayout layouts[ MAX_FRAMES_IN_FLIGHT ];
-  for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
-  {
-    layouts[ i ] = engine->descriptor_set_layout;
-  }
-
   const VkDescriptorSetAllocateInfo alloc_info = {
     .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-    .descriptorSetCount = MAX_FRAMES_IN_FLIGHT,
-    .pSetLayouts        = layouts,
-    .descriptorPool     = engine->descriptor_pool
+    .descriptorPool     = engine->texture_descriptor_pool,
+    .descriptorSetCount = 1,
+    .pSetLayouts        = &engine->texture_descriptor_set_layout,
   };
 
-  const VkResult result =
-    vkAllocateDescriptorSets (engine->device, &alloc_info, engine->descriptor_sets);
+  const VkResult result = vkAllocateDescriptorSets (
+    engine->device,
+    &alloc_info,
+    &engine->bindless_descriptor_set
+  );
   if (result != VK_SUCCESS)
   {
-    moss__error ("Failed to allocate descriptor sets: %d.\n", result);
+    engine->bindless_descriptor_set = VK_NULL_HANDLE;
+    moss__error ("Failed to allocate bindless descriptor set: %d.\n", result);
     return MOSS_RESULT_ERROR;
   }
 
   return MOSS_RESULT_SUCCESS;
 }
 
-inline static void moss__configure_descriptor_sets (MossEngine *const engine)
+inline static MossResult moss__create_default_texture (MossEngine *const engine)
 {
-  VkDescriptorBufferInfo buffer_infos[ MAX_FRAMES_IN_FLIGHT ];
-  VkDescriptorImageInfo  image_infos[ MAX_FRAMES_IN_FLIGHT ];
-  VkWriteDescriptorSet   descriptor_writes[ MAX_FRAMES_IN_FLIGHT * 2 ];
+  static const uint8_t white_pixel[ 4 ] = { 255, 255, 255, 255 };
+
+  const MossTextureCreateFromMemoryInfo create_info = {
+    .engine = engine,
+    .pixels = white_pixel,
+    .width  = 1,
+    .height = 1,
+  };
 
-  for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+  engine->default_texture = moss_create_texture_from_memory (&create_info);
+  if (engine->default_texture == NULL)
   {
-    VkMemoryRequirements memory_requirements;
-    vkGetBufferMemoryRequirements (
-      engine->device,
-      engine->camera_ubo_buffers[ i ],
-      &memory_requirements
-    );
+    moss__error ("Failed to create default texture.\n");
+    return MOSS_RESULT_ERROR;
+  }
 
-    buffer_infos[ i ] = (VkDescriptorBufferInfo) {
-      .offset = 0,
-      .buffer = engine->camera_ubo_buffers[ i ],
-      .range  = memory_requirements.size,
-    };
+  return MOSS_RESULT_SUCCESS;
+}
 
-    descriptor_writes[ i ] = (VkWriteDescriptorSet) {
-      .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-      .dstSet          = engine->descriptor_sets[ i ],
-      .dstBinding      = 0,
-      .dstArrayElement = 0,
-      .descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-      .descriptorCount = 1,
-      .pBufferInfo     = &buffer_infos[ i ],
-    };
-  }
+inline static MossResult moss__create_pipeline_layout (MossEngine *const engine)
+{
+  // Set 0 is bound per texture or holds the bindless texture array, set 1 holds
+  // animation clips and is bound once per recording, set 2 is bound per tilemap
+  const VkDescriptorSetLayout set_layouts[] = {
+    engine->texture_descriptor_set_layout,
+    engine->animation_descriptor_set_layout,
+    engine->tilemap_descriptor_set_layout,
+  };
 
-  for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
-  {
-    image_infos[ i ] = (VkDescriptorImageInfo) {
-      .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-      .sampler     = engine->sampler,
-      .imageView   = engine->texture_image_view,
-    };
+  // Camera goes through push constants, so any number of cameras can be used per
+  // frame without descriptor sets or uniform buffer writes. Animation time follows,
+  // tilemap parameters are read by both stages and get their own range
+  const VkPushConstantRange push_constant_ranges[] = {
+    {
+      .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+      .offset     = 0,
+      .size       = MOSS__ANIMATION_TIME_PUSH_CONSTANT_OFFSET + sizeof (float),
+    },
+    {
+      .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+      .offset     = MOSS__TILEMAP_PUSH_CONSTANT_OFFSET,
+      .size       = sizeof (Moss__TilemapPushConstants),
+    },
+  };
 
-    descriptor_writes[ MAX_FRAMES_IN_FLIGHT + i ] = (VkWriteDescriptorSet) {
-      .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-      .dstSet          = engine->descriptor_sets[ i ],
-      .dstBinding      = 1,
-      .dstArrayElement = 0,
-      .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-      .descriptorCount = 1,
-      .pImageInfo      = &image_infos[ i ],
-    };
+  const VkPipelineLayoutCreateInfo pipeline_layout_info = {
+    .sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+    .pNext          = NULL,
+    .setLayoutCount = sizeof (set_layouts) / sizeof (set_layouts[ 0 ]),
+    .pSetLayouts    = set_layouts,
+    .pushConstantRangeCount =
+      sizeof (push_constant_ranges) / sizeof (push_constant_ranges[ 0 ]),
+    .pPushConstantRanges = push_constant_ranges,
+  };
+
+  if (vkCreatePipelineLayout (
+        engine->device,
+        &pipeline_layout_info,
+        &engine->vk_allocation_callbacks,
+        &engine->pipeline_layout
+      ) != VK_SUCCESS)
+  {
+    moss__error ("Failed to create pipeline layout.\n");
+    return MOSS_RESULT_ERROR;
   }
 
-  vkUpdateDescriptorSets (
-    engine->device,
-    sizeof (descriptor_writes) / sizeof (descriptor_writes[ 0 ]),
-    descriptor_writes,
-    0,
-    NULL
-  );
+  return MOSS_RESULT_SUCCESS;
 }
 
-inline static MossResult moss__create_graphics_pipeline (MossEngine *const engine)
+inline static MossResult moss__create_graphics_pipeline (
+  MossEngine *const                             engine,
+  const Moss__CreateGraphicsPipelineInfo *const info
+)
 {
   VkShaderModule vert_shader_module;
   VkShaderModule frag_shader_module;
 
   {
-    const Moss__CreateShaderModuleFromFileInfo create_info = {
-      .device            = engine->device,
-      .file_path         = MOSS__VERT_SHADER_PATH,
-      .out_shader_module = &vert_shader_module,
+    const Moss__CreateShaderModuleInfo create_info = {
+      .device               = engine->device,
+      .code                 = info->vert_shader->code,
+      .code_size            = info->vert_shader->code_size,
+      .out_shader_module    = &vert_shader_module,
+      .allocation_callbacks = &engine->vk_allocation_callbacks,
     };
-    const MossResult result = moss_vk__create_shader_module_from_file (&create_info);
+    const MossResult result = moss_vk__create_shader_module (&create_info);
     if (result != MOSS_RESULT_SUCCESS)
     {
-      moss__error ("Failed to create fragment shader module.");
+      moss__error ("Failed to create vertex shader module.\n");
       return MOSS_RESULT_ERROR;
     }
   }
 
   {
-    const Moss__CreateShaderModuleFromFileInfo create_info = {
-      .device            = engine->device,
-      .file_path         = MOSS__FRAG_SHADER_PATH,
-      .out_shader_module = &frag_shader_module,
+    const Moss__CreateShaderModuleInfo create_info = {
+      .device               = engine->device,
+      .code                 = info->frag_shader->code,
+      .code_size            = info->frag_shader->code_size,
+      .out_shader_module    = &frag_shader_module,
+      .allocation_callbacks = &engine->vk_allocation_callbacks,
     };
-    const MossResult result = moss_vk__create_shader_module_from_file (&create_info);
+    const MossResult result = moss_vk__create_shader_module (&create_info);
     if (result != MOSS_RESULT_SUCCESS)
     {
-      vkDestroyShaderModule (engine->device, vert_shader_module, NULL);
+      vkDestroyShaderModule (
+        engine->device,
+        vert_shader_module,
+        &engine->vk_allocation_callbacks
+      );
 
       moss__error ("Failed to create fragment shader module.\n");
       return MOSS_RESULT_ERROR;
@@ -1422,19 +2596,35 @@ inline static MossResult moss__create_graphics_pipeline (MossEngine *const engin
     .pName  = "main",
   };
 
+  // Alpha test is a specialization constant, without discard the driver keeps early
+  // depth test enabled
+  const VkBool32 is_alpha_tested =
+    info->material == MOSS_SPRITE_BATCH_MATERIAL_ALPHA_TEST ? VK_TRUE : VK_FALSE;
+
+  const VkSpecializationMapEntry specialization_entry = {
+    .constantID = MOSS__ALPHA_TEST_CONSTANT_ID,
+    .offset     = 0,
+    .size       = sizeof (is_alpha_tested),
+  };
+
+  const VkSpecializationInfo specialization_info = {
+    .mapEntryCount = 1,
+    .pMapEntries   = &specialization_entry,
+    .dataSize      = sizeof (is_alpha_tested),
+    .pData         = &is_alpha_tested,
+  };
+
   const VkPipelineShaderStageCreateInfo frag_shader_stage_info = {
-    .sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-    .stage  = VK_SHADER_STAGE_FRAGMENT_BIT,
-    .module = frag_shader_module,
-    .pName  = "main",
+    .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+    .stage               = VK_SHADER_STAGE_FRAGMENT_BIT,
+    .module              = frag_shader_module,
+    .pName               = "main",
+    .pSpecializationInfo = &specialization_info,
   };
 
   const VkPipelineShaderStageCreateInfo shader_stages[] = { vert_shader_stage_info,
                                                             frag_shader_stage_info };
 
-  const VkPipelineVertexInputStateCreateInfo vertex_input_info =
-    moss__create_vk_pipeline_vertex_input_state_info ( );
-
   const VkPipelineInputAssemblyStateCreateInfo input_assembly = {
     .sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
     .topology               = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
@@ -1469,7 +2659,8 @@ inline static MossResult moss__create_graphics_pipeline (MossEngine *const engin
   const VkPipelineColorBlendAttachmentState color_blend_attachment = {
     .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
                       VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
-    .blendEnable         = VK_TRUE,
+    .blendEnable =
+      info->material == MOSS_SPRITE_BATCH_MATERIAL_OPAQUE ? VK_FALSE : VK_TRUE,
     .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
     .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
     .colorBlendOp        = VK_BLEND_OP_ADD,
@@ -1485,30 +2676,6 @@ inline static MossResult moss__create_graphics_pipeline (MossEngine *const engin
     .pAttachments    = &color_blend_attachment,
   };
 
-  const VkDescriptorSetLayout set_layouts[] = { engine->descriptor_set_layout };
-
-  const VkPipelineLayoutCreateInfo pipeline_layout_info = {
-    .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-    .pNext                  = NULL,
-    .setLayoutCount         = sizeof (set_layouts) / sizeof (set_layouts[ 0 ]),
-    .pSetLayouts            = set_layouts,
-    .pushConstantRangeCount = 0,
-    .pPushConstantRanges    = NULL,
-  };
-
-  if (vkCreatePipelineLayout (
-        engine->device,
-        &pipeline_layout_info,
-        NULL,
-        &engine->pipeline_layout
-      ) != VK_SUCCESS)
-  {
-    moss__error ("Failed to create pipeline layout.\n");
-    vkDestroyShaderModule (engine->device, frag_shader_module, NULL);
-    vkDestroyShaderModule (engine->device, vert_shader_module, NULL);
-    return MOSS_RESULT_ERROR;
-  }
-
   const VkDynamicState dynamic_states[] = {
     VK_DYNAMIC_STATE_VIEWPORT,
     VK_DYNAMIC_STATE_SCISSOR,
@@ -1524,7 +2691,8 @@ inline static MossResult moss__create_graphics_pipeline (MossEngine *const engin
     .sType                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
     .pNext                 = VK_FALSE,
     .depthTestEnable       = VK_TRUE,
-    .depthWriteEnable      = VK_TRUE,
+    .depthWriteEnable =
+      info->material == MOSS_SPRITE_BATCH_MATERIAL_TRANSLUCENT ? VK_FALSE : VK_TRUE,
     .depthCompareOp        = VK_COMPARE_OP_LESS,
     .depthBoundsTestEnable = VK_FALSE,
     .minDepthBounds        = 0.0F,
@@ -1539,7 +2707,7 @@ inline static MossResult moss__create_graphics_pipeline (MossEngine *const engin
     .pNext               = NULL,
     .stageCount          = 2,
     .pStages             = shader_stages,
-    .pVertexInputState   = &vertex_input_info,
+    .pVertexInputState   = info->vertex_input_info,
     .pInputAssemblyState = &input_assembly,
     .pViewportState      = &viewport_state,
     .pRasterizationState = &rasterizer,
@@ -1556,231 +2724,475 @@ inline static MossResult moss__create_graphics_pipeline (MossEngine *const engin
 
   const VkResult result = vkCreateGraphicsPipelines (
     engine->device,
-    VK_NULL_HANDLE,
+    engine->pipeline_cache,
     1,
     &pipeline_info,
-    NULL,
-    &engine->graphics_pipeline
+    &engine->vk_allocation_callbacks,
+    info->out_pipeline
   );
 
-  vkDestroyShaderModule (engine->device, frag_shader_module, NULL);
-  vkDestroyShaderModule (engine->device, vert_shader_module, NULL);
+  vkDestroyShaderModule (
+    engine->device,
+    frag_shader_module,
+    &engine->vk_allocation_callbacks
+  );
+  vkDestroyShaderModule (
+    engine->device,
+    vert_shader_module,
+    &engine->vk_allocation_callbacks
+  );
 
   if (result != VK_SUCCESS)
   {
     moss__error ("Failed to create graphics pipeline. Error code: %d.\n", result);
-    vkDestroyPipelineLayout (engine->device, engine->pipeline_layout, NULL);
     return MOSS_RESULT_ERROR;
   }
 
   return MOSS_RESULT_SUCCESS;
 }
 
-inline static MossResult moss__create_framebuffers (MossEngine *const engine)
+inline static MossResult moss__create_graphics_pipelines (MossEngine *const engine)
 {
-  for (uint32_t i = 0; i < engine->swapchain_image_count; ++i)
+  if (moss__create_pipeline_layout (engine) != MOSS_RESULT_SUCCESS)
   {
-    const VkImageView attachments[] = {
-      engine->swapchain_image_views[ i ],
-      engine->depth_image_view,
-    };
+    return MOSS_RESULT_ERROR;
+  }
 
-    const VkFramebufferCreateInfo framebuffer_info = {
-      .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-      .renderPass      = engine->render_pass,
-      .attachmentCount = sizeof (attachments) / sizeof (attachments[ 0 ]),
-      .pAttachments    = attachments,
-      .width           = engine->swapchain_extent.width,
-      .height          = engine->swapchain_extent.height,
-      .layers          = 1,
+  const Moss__ShaderCode *const frag_shader =
+    engine->is_bindless ? &moss__bindless_frag_shader_code : &moss__frag_shader_code;
+
+  const VkPipelineVertexInputStateCreateInfo vertex_input_info =
+    moss__create_vk_pipeline_vertex_input_state_info ( );
+  const VkPipelineVertexInputStateCreateInfo instance_input_info =
+    moss__create_vk_pipeline_instance_input_state_info ( );
+  const VkPipelineVertexInputStateCreateInfo compact_vertex_input_info =
+    moss__create_vk_pipeline_compact_vertex_input_state_info ( );
+
+  {  // Create tilemap pipeline, chunk quads are built without vertex input
+    const VkPipelineVertexInputStateCreateInfo empty_input_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
     };
 
-    if (vkCreateFramebuffer (
-          engine->device,
-          &framebuffer_info,
-          NULL,
-          &engine->swapchain_framebuffers[ i ]
-        ) != VK_SUCCESS)
+    const Moss__CreateGraphicsPipelineInfo create_info = {
+      .vert_shader       = &moss__tilemap_vert_shader_code,
+      .frag_shader       = engine->is_bindless ? &moss__bindless_tilemap_frag_shader_code
+                                               : &moss__tilemap_frag_shader_code,
+      .vertex_input_info = &empty_input_info,
+      .material          = MOSS_SPRITE_BATCH_MATERIAL_ALPHA_TEST,
+      .out_pipeline      = &engine->tilemap_graphics_pipeline,
+    };
+    if (moss__create_graphics_pipeline (engine, &create_info) != MOSS_RESULT_SUCCESS)
     {
-      moss__error ("Failed to create framebuffer %u.\n", i);
-      for (uint32_t j = 0; j < i; ++j)
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  for (size_t material = 0; material < MOSS__SPRITE_BATCH_MATERIAL_COUNT; ++material)
+  {
+    {  // Create indexed sprite pipeline
+      const Moss__CreateGraphicsPipelineInfo create_info = {
+        .vert_shader       = &moss__vert_shader_code,
+        .frag_shader       = frag_shader,
+        .vertex_input_info = &vertex_input_info,
+        .material          = (MossSpriteBatchMaterial)material,
+        .out_pipeline      = &engine->graphics_pipelines[ material ],
+      };
+      if (moss__create_graphics_pipeline (engine, &create_info) != MOSS_RESULT_SUCCESS)
       {
-        vkDestroyFramebuffer (engine->device, engine->swapchain_framebuffers[ j ], NULL);
+        return MOSS_RESULT_ERROR;
+      }
+    }
+
+    {  // Create instanced sprite pipeline
+      const Moss__CreateGraphicsPipelineInfo create_info = {
+        .vert_shader       = &moss__instanced_vert_shader_code,
+        .frag_shader       = frag_shader,
+        .vertex_input_info = &instance_input_info,
+        .material          = (MossSpriteBatchMaterial)material,
+        .out_pipeline      = &engine->instanced_graphics_pipelines[ material ],
+      };
+      if (moss__create_graphics_pipeline (engine, &create_info) != MOSS_RESULT_SUCCESS)
+      {
+        return MOSS_RESULT_ERROR;
+      }
+    }
+
+    {  // Create compact sprite pipeline
+      const Moss__CreateGraphicsPipelineInfo create_info = {
+        .vert_shader       = &moss__compact_vert_shader_code,
+        .frag_shader       = frag_shader,
+        .vertex_input_info = &compact_vertex_input_info,
+        .material          = (MossSpriteBatchMaterial)material,
+        .out_pipeline      = &engine->compact_graphics_pipelines[ material ],
+      };
+      if (moss__create_graphics_pipeline (engine, &create_info) != MOSS_RESULT_SUCCESS)
+      {
+        return MOSS_RESULT_ERROR;
       }
-      return MOSS_RESULT_ERROR;
     }
   }
 
   return MOSS_RESULT_SUCCESS;
 }
 
-inline static MossResult moss__create_texture_image (MossEngine *const engine)
+inline static MossResult moss__create_compute_pipeline (
+  MossEngine *const                 engine,
+  const Moss__ShaderCode *const     shader,
+  const VkPipelineLayout            layout,
+  const VkSpecializationInfo *const specialization_info,
+  VkPipeline *const                 out_pipeline
+)
 {
-  // Load texture
-  int texture_width, texture_height, texture_channels;  // NOLINT
-
-  const stbi_uc *const pixels = stbi_load (
-    "textures/atlas.png",
-    &texture_width,
-    &texture_height,
-    &texture_channels,
-    STBI_rgb_alpha
-  );
-  if (pixels == NULL)
-  {
-    moss__error ("Failed to load texture.");
-    return MOSS_RESULT_ERROR;
-  }
+  VkShaderModule shader_module;
 
-  VkBuffer       staging_buffer;
-  VkDeviceMemory staging_buffer_memory;
-  {  // Create staging buffer
-    const Moss__CreateVkBufferInfo create_info = {
-      .physical_device = engine->physical_device,
-      .device          = engine->device,
-      .size            = (VkDeviceSize)(texture_width * texture_height * 4),
-      .usage           = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-      .memory_properties =
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-      .sharing_mode                    = engine->buffer_sharing_mode,
-      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
-      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+  {
+    const Moss__CreateShaderModuleInfo create_info = {
+      .device               = engine->device,
+      .code                 = shader->code,
+      .code_size            = shader->code_size,
+      .out_shader_module    = &shader_module,
+      .allocation_callbacks = &engine->vk_allocation_callbacks,
     };
-    const MossResult result =
-      moss_vk__create_buffer (&create_info, &staging_buffer, &staging_buffer_memory);
+    const MossResult result = moss_vk__create_shader_module (&create_info);
     if (result != MOSS_RESULT_SUCCESS)
     {
-      moss__error ("Failed to create staging buffer.");
+      moss__error ("Failed to create compute shader module.\n");
       return MOSS_RESULT_ERROR;
     }
   }
 
-  // Copy pixels into the buffer
-  void *data;
-  vkMapMemory (
+  const VkComputePipelineCreateInfo pipeline_info = {
+    .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+    .stage = {
+      .sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+      .stage               = VK_SHADER_STAGE_COMPUTE_BIT,
+      .module              = shader_module,
+      .pName               = "main",
+      .pSpecializationInfo = specialization_info,
+    },
+    .layout = layout,
+  };
+
+  const VkResult result = vkCreateComputePipelines (
     engine->device,
-    staging_buffer_memory,
-    0,
-    (VkDeviceSize)(texture_width * texture_height * 4),
-    0,
-    &data
+    engine->pipeline_cache,
+    1,
+    &pipeline_info,
+    &engine->vk_allocation_callbacks,
+    out_pipeline
   );
-  memcpy (data, pixels, (size_t)(texture_width * texture_height * 4));
-  vkUnmapMemory (engine->device, staging_buffer_memory);
-
-  // Free pixels
-  stbi_image_free ((void *)pixels);
 
-  // Create texture image
-  const MossVk__CreateImageInfo create_info = {
-    .device       = engine->device,
-    .format       = VK_FORMAT_R8G8B8A8_SRGB,
-    .image_width  = texture_width,
-    .image_height = texture_height,
-    .usage        = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-    .sharing_mode = engine->buffer_sharing_mode,
-    .shared_queue_family_indices     = engine->shared_queue_family_indices,
-    .shared_queue_family_index_count = engine->shared_queue_family_index_count,
-  };
+  vkDestroyShaderModule (engine->device, shader_module, &engine->vk_allocation_callbacks);
 
-  engine->texture_image = moss_vk__create_image (&create_info);
-  if (engine->texture_image == VK_NULL_HANDLE)
+  if (result != VK_SUCCESS)
   {
-    moss_vk__destroy_buffer (engine->device, staging_buffer, staging_buffer_memory);
-    moss__error ("Failed to create texture image.\n");
+    moss__error ("Failed to create compute pipeline. Error code: %d.\n", result);
     return MOSS_RESULT_ERROR;
   }
 
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult moss__create_cull_pipelines (MossEngine *const engine)
+{
+  {  // Create descriptor pool
+    const VkDescriptorPoolSize pool_sizes[] = {
+      {
+       .type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+       .descriptorCount = (uint32_t)(3 * MAX_CULLED_SPRITE_BATCH_COUNT),
+       },
+    };
+
+    // Batches free their sets on destruction
+    const VkDescriptorPoolCreateInfo pool_info = {
+      .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+      .poolSizeCount = sizeof (pool_sizes) / sizeof (pool_sizes[ 0 ]),
+      .pPoolSizes    = pool_sizes,
+      .maxSets       = (uint32_t)MAX_CULLED_SPRITE_BATCH_COUNT,
+    };
+
+    const VkResult result = vkCreateDescriptorPool (
+      engine->device,
+      &pool_info,
+      &engine->vk_allocation_callbacks,
+      &engine->cull_descriptor_pool
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to create cull descriptor pool: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Create descriptor set layout
+    VkDescriptorSetLayoutBinding layout_bindings[ 3 ];
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+      layout_bindings[ i ] = (VkDescriptorSetLayoutBinding) {
+        .binding         = i,
+        .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = 1,
+        .stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT,
+      };
+    }
+
+    const VkDescriptorSetLayoutCreateInfo create_info = {
+      .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .bindingCount = sizeof (layout_bindings) / sizeof (layout_bindings[ 0 ]),
+      .pBindings    = layout_bindings,
+    };
+
+    const VkResult result = vkCreateDescriptorSetLayout (
+      engine->device,
+      &create_info,
+      &engine->vk_allocation_callbacks,
+      &engine->cull_descriptor_set_layout
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to create cull descriptor layout: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Create pipeline layout
+    // Set 0 is bound per batch, camera is passed in push constants
+    const VkDescriptorSetLayout set_layouts[] = {
+      engine->cull_descriptor_set_layout,
+    };
+
+    const VkPushConstantRange push_constant_range = {
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset     = 0,
+      .size       = sizeof (Moss__SpriteCullPushConstants),
+    };
+
+    const VkPipelineLayoutCreateInfo pipeline_layout_info = {
+      .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount         = sizeof (set_layouts) / sizeof (set_layouts[ 0 ]),
+      .pSetLayouts            = set_layouts,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges    = &push_constant_range,
+    };
+
+    if (vkCreatePipelineLayout (
+          engine->device,
+          &pipeline_layout_info,
+          &engine->vk_allocation_callbacks,
+          &engine->cull_pipeline_layout
+        ) != VK_SUCCESS)
+    {
+      moss__error ("Failed to create cull pipeline layout.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
 
-  // Allocate memory for texture image
-  const MossVk__AllocateImageMemoryInfo alloc_info = {
-    .physical_device = engine->physical_device,
-    .device          = engine->device,
-    .image           = engine->texture_image,
+  // Both culling pipelines are specializations of one shader
+  VkPipeline *const pipelines[] = {
+    &engine->cull_pipeline,
+    &engine->instanced_cull_pipeline,
   };
 
-  engine->texture_image_memory = moss_vk__allocate_image_memory (&alloc_info);
-  if (engine->texture_image_memory == VK_NULL_HANDLE)
+  for (size_t i = 0; i < sizeof (pipelines) / sizeof (pipelines[ 0 ]); ++i)
   {
-    moss_vk__destroy_buffer (engine->device, staging_buffer, staging_buffer_memory);
-    vkDestroyImage (engine->device, engine->texture_image, NULL);
-    moss__error ("Failed to allocate memory for the texture image.\n");
-    return MOSS_RESULT_ERROR;
+    const struct
+    {
+      VkBool32 is_instanced;
+      uint32_t workgroup_size;
+    } constants = {
+      .is_instanced   = i == 1 ? VK_TRUE : VK_FALSE,
+      .workgroup_size = SPRITE_CULL_WORKGROUP_SIZE,
+    };
+
+    const VkSpecializationMapEntry specialization_entries[] = {
+      {
+        .constantID = MOSS__CULL_INSTANCED_CONSTANT_ID,
+        .offset     = 0,
+        .size       = sizeof (constants.is_instanced),
+      },
+      {
+        .constantID = MOSS__CULL_WORKGROUP_SIZE_CONSTANT_ID,
+        .offset     = sizeof (constants.is_instanced),
+        .size       = sizeof (constants.workgroup_size),
+      },
+    };
+
+    const VkSpecializationInfo specialization_info = {
+      .mapEntryCount =
+        sizeof (specialization_entries) / sizeof (specialization_entries[ 0 ]),
+      .pMapEntries = specialization_entries,
+      .dataSize    = sizeof (constants),
+      .pData       = &constants,
+    };
+
+    if (moss__create_compute_pipeline (
+          engine,
+          &moss__cull_comp_shader_code,
+          engine->cull_pipeline_layout,
+          &specialization_info,
+          pipelines[ i ]
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      return MOSS_RESULT_ERROR;
+    }
   }
 
-  {
-    const MossVk__TransitionImageLayoutInfo transition_info = {
-      .device         = engine->device,
-      .command_pool   = engine->transfer_command_pool,
-      .transfer_queue = engine->transfer_queue,
-      .image          = engine->texture_image,
-      .old_layout     = VK_IMAGE_LAYOUT_UNDEFINED,
-      .new_layout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult moss__create_particle_pipeline (MossEngine *const engine)
+{
+  {  // Create descriptor pool
+    const VkDescriptorPoolSize pool_size = {
+      .type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      .descriptorCount = (uint32_t)(3 * MAX_PARTICLE_SYSTEM_COUNT),
+    };
+
+    // Particle systems free their sets on destruction
+    const VkDescriptorPoolCreateInfo pool_info = {
+      .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+      .poolSizeCount = 1,
+      .pPoolSizes    = &pool_size,
+      .maxSets       = (uint32_t)MAX_PARTICLE_SYSTEM_COUNT,
+    };
+
+    const VkResult result = vkCreateDescriptorPool (
+      engine->device,
+      &pool_info,
+      &engine->vk_allocation_callbacks,
+      &engine->particle_descriptor_pool
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to create particle descriptor pool: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Create descriptor set layout
+    VkDescriptorSetLayoutBinding layout_bindings[ 3 ];
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+      layout_bindings[ i ] = (VkDescriptorSetLayoutBinding) {
+        .binding         = i,
+        .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = 1,
+        .stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT,
+      };
+    }
+
+    const VkDescriptorSetLayoutCreateInfo create_info = {
+      .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .bindingCount = sizeof (layout_bindings) / sizeof (layout_bindings[ 0 ]),
+      .pBindings    = layout_bindings,
+    };
+
+    const VkResult result = vkCreateDescriptorSetLayout (
+      engine->device,
+      &create_info,
+      &engine->vk_allocation_callbacks,
+      &engine->particle_descriptor_set_layout
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to create particle descriptor layout: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Create pipeline layout
+    // Set 0 is bound per system, emitter parameters are passed in push constants
+    const VkPushConstantRange push_constant_range = {
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset     = 0,
+      .size       = sizeof (Moss__ParticlePushConstants),
+    };
+
+    const VkPipelineLayoutCreateInfo pipeline_layout_info = {
+      .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount         = 1,
+      .pSetLayouts            = &engine->particle_descriptor_set_layout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges    = &push_constant_range,
     };
-    if (moss_vk__transition_image_layout (&transition_info) != MOSS_RESULT_SUCCESS)
+
+    if (vkCreatePipelineLayout (
+          engine->device,
+          &pipeline_layout_info,
+          &engine->vk_allocation_callbacks,
+          &engine->particle_pipeline_layout
+        ) != VK_SUCCESS)
     {
-      moss_vk__destroy_buffer (engine->device, staging_buffer, staging_buffer_memory);
-      vkFreeMemory (engine->device, engine->texture_image_memory, NULL);
-      vkDestroyImage (engine->device, engine->texture_image, NULL);
+      moss__error ("Failed to create particle pipeline layout.\n");
       return MOSS_RESULT_ERROR;
     }
   }
 
+  const uint32_t workgroup_size = PARTICLE_WORKGROUP_SIZE;
+
+  const VkSpecializationMapEntry specialization_entry = {
+    .constantID = MOSS__PARTICLE_WORKGROUP_SIZE_CONSTANT_ID,
+    .offset     = 0,
+    .size       = sizeof (workgroup_size),
+  };
+
+  const VkSpecializationInfo specialization_info = {
+    .mapEntryCount = 1,
+    .pMapEntries   = &specialization_entry,
+    .dataSize      = sizeof (workgroup_size),
+    .pData         = &workgroup_size,
+  };
+
+  return moss__create_compute_pipeline (
+    engine,
+    &moss__particle_comp_shader_code,
+    engine->particle_pipeline_layout,
+    &specialization_info,
+    &engine->particle_pipeline
+  );
+}
+
+inline static MossResult moss__create_framebuffers (MossEngine *const engine)
+{
+  for (uint32_t i = 0; i < engine->swapchain_image_count; ++i)
   {
-    const Moss__CopyVkBufferToImageInfo copy_info = {
-      .device         = engine->device,
-      .command_pool   = engine->transfer_command_pool,
-      .transfer_queue = engine->transfer_queue,
-      .buffer         = staging_buffer,
-      .image          = engine->texture_image,
-      .width          = texture_width,
-      .height         = texture_height,
+    const VkImageView attachments[] = {
+      engine->swapchain_image_views[ i ],
+      engine->depth_image_view,
     };
-    if (moss_vk__copy_buffer_to_image (&copy_info) != MOSS_RESULT_SUCCESS)
-    {
-      moss_vk__destroy_buffer (engine->device, staging_buffer, staging_buffer_memory);
-      vkFreeMemory (engine->device, engine->texture_image_memory, NULL);
-      vkDestroyImage (engine->device, engine->texture_image, NULL);
-      return MOSS_RESULT_ERROR;
-    }
-  }
 
-  {
-    const MossVk__TransitionImageLayoutInfo transition_info = {
-      .device         = engine->device,
-      .command_pool   = engine->transfer_command_pool,
-      .transfer_queue = engine->transfer_queue,
-      .image          = engine->texture_image,
-      .old_layout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-      .new_layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    const VkFramebufferCreateInfo framebuffer_info = {
+      .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+      .renderPass      = engine->render_pass,
+      .attachmentCount = sizeof (attachments) / sizeof (attachments[ 0 ]),
+      .pAttachments    = attachments,
+      .width           = engine->swapchain_extent.width,
+      .height          = engine->swapchain_extent.height,
+      .layers          = 1,
     };
-    if (moss_vk__transition_image_layout (&transition_info) != MOSS_RESULT_SUCCESS)
+
+    if (vkCreateFramebuffer (
+          engine->device,
+          &framebuffer_info,
+          &engine->vk_allocation_callbacks,
+          &engine->swapchain_framebuffers[ i ]
+        ) != VK_SUCCESS)
     {
-      moss_vk__destroy_buffer (engine->device, staging_buffer, staging_buffer_memory);
-      vkFreeMemory (engine->device, engine->texture_image_memory, NULL);
-      vkDestroyImage (engine->device, engine->texture_image, NULL);
+      moss__error ("Failed to create framebuffer %u.\n", i);
+      for (uint32_t j = 0; j < i; ++j)
+      {
+        vkDestroyFramebuffer (
+          engine->device,
+          engine->swapchain_framebuffers[ j ],
+          &engine->vk_allocation_callbacks
+        );
+      }
       return MOSS_RESULT_ERROR;
     }
   }
 
-  moss_vk__destroy_buffer (engine->device, staging_buffer, staging_buffer_memory);
-
-  return MOSS_RESULT_SUCCESS;
-}
-
-inline static MossResult moss__create_texture_image_view (MossEngine *const engine)
-{
-  const Moss__VkImageViewCreateInfo info = {
-    .device = engine->device,
-    .image  = engine->texture_image,
-    .format = VK_FORMAT_R8G8B8A8_SRGB,
-    .aspect = VK_IMAGE_ASPECT_COLOR_BIT,
-  };
-  const VkImageView image_view = moss_vk__create_image_view (&info);
-
-  if (image_view == VK_NULL_HANDLE) { return MOSS_RESULT_ERROR; }
-
-  engine->texture_image_view = image_view;
   return MOSS_RESULT_SUCCESS;
 }
 
@@ -1797,10 +3209,12 @@ inline static MossResult moss__create_depth_resources (MossEngine *const engine)
       .format                          = depth_image_format,
       .image_width                     = engine->swapchain_extent.width,
       .image_height                    = engine->swapchain_extent.height,
+      .mip_level_count                 = 1,
       .usage                           = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
       .sharing_mode                    = engine->buffer_sharing_mode,
       .shared_queue_family_indices     = engine->shared_queue_family_indices,
       .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .allocation_callbacks            = &engine->vk_allocation_callbacks,
     };
 
     engine->depth_image = moss_vk__create_image (&info);
@@ -1814,15 +3228,19 @@ inline static MossResult moss__create_depth_resources (MossEngine *const engine)
 
   {  // Allocate memory for texture image
     const MossVk__AllocateImageMemoryInfo info = {
-      .physical_device = engine->physical_device,
-      .device          = engine->device,
-      .image           = engine->depth_image,
+      .allocator = &engine->allocator,
+      .device    = engine->device,
+      .image     = engine->depth_image,
     };
 
-    engine->depth_image_memory = moss_vk__allocate_image_memory (&info);
-    if (engine->depth_image_memory == VK_NULL_HANDLE)
+    if (moss_vk__allocate_image_memory (&info, &engine->depth_image_allocation) !=
+        MOSS_RESULT_SUCCESS)
     {
-      vkDestroyImage (engine->device, engine->depth_image, NULL);
+      vkDestroyImage (
+        engine->device,
+        engine->depth_image,
+        &engine->vk_allocation_callbacks
+      );
 
       moss__error ("Failed to allocate memory for the depth image.\n");
       return MOSS_RESULT_ERROR;
@@ -1831,44 +3249,31 @@ inline static MossResult moss__create_depth_resources (MossEngine *const engine)
 
   {  // Create depth image view
     const Moss__VkImageViewCreateInfo info = {
-      .device = engine->device,
-      .image  = engine->depth_image,
-      .format = depth_image_format,
-      .aspect = VK_IMAGE_ASPECT_DEPTH_BIT,
+      .device               = engine->device,
+      .image                = engine->depth_image,
+      .format               = depth_image_format,
+      .aspect               = VK_IMAGE_ASPECT_DEPTH_BIT,
+      .allocation_callbacks = &engine->vk_allocation_callbacks,
     };
 
     engine->depth_image_view = moss_vk__create_image_view (&info);
     if (engine->depth_image_view == VK_NULL_HANDLE)
     {
-      vkFreeMemory (engine->device, engine->depth_image_memory, NULL);
-      vkDestroyImage (engine->device, engine->depth_image, NULL);
+      moss_vk__free_memory (&engine->allocator, &engine->depth_image_allocation);
+      vkDestroyImage (
+        engine->device,
+        engine->depth_image,
+        &engine->vk_allocation_callbacks
+      );
 
       moss__error ("Failed to create depth image view.\n");
       return MOSS_RESULT_ERROR;
     }
   }
 
-  {  // Transition depth image layout
-    const MossVk__TransitionImageLayoutInfo info = {
-      .device         = engine->device,
-      .command_pool   = engine->transfer_command_pool,
-      .transfer_queue = engine->transfer_queue,
-      .image          = engine->depth_image,
-      .old_layout     = VK_IMAGE_LAYOUT_UNDEFINED,
-      .new_layout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-    };
-
-    const MossResult result = moss_vk__transition_image_layout (&info);
-    if (result != MOSS_RESULT_SUCCESS)
-    {
-      vkDestroyImageView (engine->device, engine->depth_image_view, NULL);
-      vkFreeMemory (engine->device, engine->depth_image_memory, NULL);
-      vkDestroyImage (engine->device, engine->depth_image, NULL);
-
-      moss__error ("Failed to transition depth image layout.\n");
-      return MOSS_RESULT_ERROR;
-    }
-  }
+  // Render pass transitions the image from undefined layout and clears it, so the
+  // image is used right away without a blocking layout transition
+  engine->depth_image_extent = engine->swapchain_extent;
 
   return MOSS_RESULT_SUCCESS;
 }
@@ -1890,11 +3295,15 @@ inline static MossResult moss__create_texture_sampler (MossEngine *const engine)
     .mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR,
     .mipLodBias              = 0.0F,
     .minLod                  = 0.0F,
-    .maxLod                  = 0.0F,
+    .maxLod                  = VK_LOD_CLAMP_NONE,
   };
 
-  const VkResult result =
-    vkCreateSampler (engine->device, &create_info, NULL, &engine->sampler);
+  const VkResult result = vkCreateSampler (
+    engine->device,
+    &create_info,
+    &engine->vk_allocation_callbacks,
+    &engine->sampler
+  );
   if (result != VK_SUCCESS)
   {
     moss__error ("Failed to create sampler: %d.", result);
@@ -1905,78 +3314,288 @@ inline static MossResult moss__create_texture_sampler (MossEngine *const engine)
 }
 
 
-inline static MossResult moss__create_camera_ubo_buffers (MossEngine *const engine)
+inline static MossResult moss__create_general_command_buffers (MossEngine *const engine)
 {
-  const Moss__CreateVkBufferInfo create_info = {
-    .physical_device = engine->physical_device,
-    .device          = engine->device,
-    .size            = sizeof (engine->camera),
-    .usage           = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-    .memory_properties =
-      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-    .sharing_mode                    = engine->buffer_sharing_mode,
-    .shared_queue_family_index_count = engine->shared_queue_family_index_count,
-    .shared_queue_family_indices     = engine->shared_queue_family_indices,
+  const VkCommandBufferAllocateInfo alloc_info = {
+    .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+    .commandPool        = engine->general_command_pool,
+    .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+    .commandBufferCount = engine->frames_in_flight_count,
   };
 
-  for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+  VkCommandBuffer *const command_buffer_arrays[] = {
+    engine->general_command_buffers,
+    engine->cull_command_buffers,
+    engine->upload_command_buffers,
+  };
+
+  const size_t command_buffer_array_count =
+    sizeof (command_buffer_arrays) / sizeof (command_buffer_arrays[ 0 ]);
+
+  for (size_t i = 0; i < command_buffer_array_count; ++i)
   {
-    const MossResult result = moss_vk__create_buffer (
-      &create_info,
-      &engine->camera_ubo_buffers[ i ],
-      &engine->camera_ubo_memories[ i ]
-    );
-    if (result != MOSS_RESULT_SUCCESS)
+    const VkResult result =
+      vkAllocateCommandBuffers (engine->device, &alloc_info, command_buffer_arrays[ i ]);
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to allocate command buffers. Error code: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult moss__create_command_recorders (MossEngine *const engine)
+{
+  // Inline main recorder needs no pools, the frame command buffer is used instead
+  if (engine->command_recorder_count == 0) { return MOSS_RESULT_SUCCESS; }
+
+  for (uint32_t i = 0; i <= engine->command_recorder_count; ++i)
+  {
+    MossCommandRecorder *const recorder =
+      i == 0 ? &engine->main_recorder : &engine->command_recorders[ i - 1 ];
+
+    // Pool per frame in flight is reset as a whole once the frame fence is waited
+    for (uint32_t frame = 0; frame < engine->frames_in_flight_count; ++frame)
     {
-      for (uint32_t j = i; j >= 0; --j)
+      const Moss__CreateVkCommandPoolInfo create_info = {
+        .device               = engine->device,
+        .queue_family_index   = engine->queue_family_indices.graphics_family,
+        .out_command_pool     = &recorder->command_pools[ frame ],
+        .allocation_callbacks = &engine->vk_allocation_callbacks,
+      };
+      if (moss_vk__create_command_pool (&create_info) != MOSS_RESULT_SUCCESS)
       {
-        moss_vk__destroy_buffer (
-          engine->device,
-          engine->camera_ubo_buffers[ j ],
-          engine->camera_ubo_memories[ j ]
+        return MOSS_RESULT_ERROR;
+      }
+
+      const VkCommandBufferAllocateInfo alloc_info = {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool        = recorder->command_pools[ frame ],
+        .level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+        .commandBufferCount = 1,
+      };
+
+      const VkResult result = vkAllocateCommandBuffers (
+        engine->device,
+        &alloc_info,
+        &recorder->command_buffers[ frame ]
+      );
+      if (result != VK_SUCCESS)
+      {
+        moss__error (
+          "Failed to allocate recorder command buffer. Error code: %d.\n",
+          result
         );
+        return MOSS_RESULT_ERROR;
       }
-      moss__error ("Failed to create camera UBO buffer.\n");
-      return result;
     }
+  }
 
-    VkMemoryRequirements memory_requirements;
-    vkGetBufferMemoryRequirements (
-      engine->device,
-      engine->camera_ubo_buffers[ i ],
-      &memory_requirements
-    );
+  return MOSS_RESULT_SUCCESS;
+}
 
-    vkMapMemory (
-      engine->device,
-      engine->camera_ubo_memories[ i ],
-      0,
-      memory_requirements.size,
-      0,
-      &engine->camera_ubo_buffer_mapped_memory_blocks[ i ]
-    );
+inline static void moss__destroy_command_recorders (MossEngine *const engine)
+{
+  for (uint32_t i = 0; i <= MOSS_MAX_COMMAND_RECORDER_COUNT; ++i)
+  {
+    MossCommandRecorder *const recorder =
+      i == 0 ? &engine->main_recorder : &engine->command_recorders[ i - 1 ];
+
+    moss__destroy_draw_queue (&recorder->draw_queue);
+
+    for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
+    {
+      if (recorder->command_pools[ frame ] == VK_NULL_HANDLE) { continue; }
+
+      // Command buffers are freed along with their pool
+      vkDestroyCommandPool (
+        engine->device,
+        recorder->command_pools[ frame ],
+        &engine->vk_allocation_callbacks
+      );
+      recorder->command_pools[ frame ]   = VK_NULL_HANDLE;
+      recorder->command_buffers[ frame ] = VK_NULL_HANDLE;
+    }
+  }
+}
+
+inline static MossResult
+moss__begin_command_recorder_commands (MossCommandRecorder *const recorder)
+{
+  MossEngine *const   engine       = recorder->engine;
+  const VkCommandPool command_pool = recorder->command_pools[ engine->current_frame ];
+
+  if (command_pool == VK_NULL_HANDLE)
+  {
+    // Inline recording goes straight into the frame command buffer
+    recorder->command_buffer = engine->general_command_buffers[ engine->current_frame ];
+  }
+  else {
+    recorder->command_buffer = recorder->command_buffers[ engine->current_frame ];
+
+    // Frame fence is already waited, so the previous recording has completed
+    vkResetCommandPool (engine->device, command_pool, 0);
+
+    const VkCommandBufferInheritanceInfo inheritance_info = {
+      .sType       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+      .renderPass  = engine->render_pass,
+      .subpass     = 0,
+      .framebuffer = engine->swapchain_framebuffers[ engine->current_image_index ],
+    };
+
+    const VkCommandBufferBeginInfo begin_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+               VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+      .pInheritanceInfo = &inheritance_info,
+    };
+
+    if (vkBeginCommandBuffer (recorder->command_buffer, &begin_info) != VK_SUCCESS)
+    {
+      moss__error ("Failed to begin recording recorder command buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  const VkCommandBuffer command_buffer = recorder->command_buffer;
+
+  const VkPipeline default_pipeline =
+    engine->graphics_pipelines[ MOSS_SPRITE_BATCH_MATERIAL_ALPHA_TEST ];
+  vkCmdBindPipeline (command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, default_pipeline);
+  recorder->bound_pipeline = default_pipeline;
+
+  const VkViewport viewport = {
+    .x        = 0.0F,
+    .y        = 0.0F,
+    .width    = (float)engine->swapchain_extent.width,
+    .height   = (float)engine->swapchain_extent.height,
+    .minDepth = 0.0F,
+    .maxDepth = 1.0F,
+  };
+
+  const VkRect2D scissor = {
+    .offset = { 0, 0 },
+    .extent = engine->swapchain_extent,
+  };
+
+  vkCmdSetViewport (command_buffer, 0, 1, &viewport);
+  vkCmdSetScissor (command_buffer, 0, 1, &scissor);
+
+  vkCmdBindDescriptorSets (
+    command_buffer,
+    VK_PIPELINE_BIND_POINT_GRAPHICS,
+    engine->pipeline_layout,
+    1,
+    1,
+    &engine->animation_descriptor_set,
+    0,
+    NULL
+  );
+  vkCmdPushConstants (
+    command_buffer,
+    engine->pipeline_layout,
+    VK_SHADER_STAGE_VERTEX_BIT,
+    MOSS__ANIMATION_TIME_PUSH_CONSTANT_OFFSET,
+    sizeof (engine->animation_time),
+    &engine->animation_time
+  );
+
+  recorder->bound_texture_descriptor_set = VK_NULL_HANDLE;
+  recorder->bound_vertex_buffer          = VK_NULL_HANDLE;
+  recorder->bound_vertex_buffer_offset   = 0;
+  recorder->bound_index_buffer           = VK_NULL_HANDLE;
+  recorder->is_camera_bound              = false;
+  recorder->draw_queue.draw_count        = 0;
+
+  recorder->is_recording    = true;
+  recorder->is_recorded     = false;
+  recorder->draw_call_count = 0;
+  recorder->sprite_count    = 0;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult
+moss__end_command_recorder_commands (MossCommandRecorder *const recorder)
+{
+  recorder->is_recording = false;
+  recorder->is_recorded  = true;
+
+  const bool is_secondary =
+    recorder->command_pools[ recorder->engine->current_frame ] != VK_NULL_HANDLE;
+  if (is_secondary && vkEndCommandBuffer (recorder->command_buffer) != VK_SUCCESS)
+  {
+    moss__error ("Failed to end recording recorder command buffer.\n");
+    return MOSS_RESULT_ERROR;
   }
 
   return MOSS_RESULT_SUCCESS;
 }
 
-inline static MossResult moss__create_general_command_buffers (MossEngine *const engine)
+inline static MossResult moss__execute_command_recorders (MossEngine *const engine)
 {
-  const VkCommandBufferAllocateInfo alloc_info = {
-    .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-    .commandPool        = engine->general_command_pool,
-    .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-    .commandBufferCount = MAX_FRAMES_IN_FLIGHT,
-  };
+  if (moss__end_command_recorder_commands (&engine->main_recorder) !=
+      MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
 
-  const VkResult result = vkAllocateCommandBuffers (
-    engine->device,
-    &alloc_info,
-    engine->general_command_buffers
+  VkCommandBuffer command_buffers[ MOSS_MAX_COMMAND_RECORDER_COUNT + 1 ];
+  uint32_t        command_buffer_count = 0;
+
+  command_buffers[ command_buffer_count++ ] = engine->main_recorder.command_buffer;
+
+  for (uint32_t i = 0; i < engine->command_recorder_count; ++i)
+  {
+    const MossCommandRecorder *const recorder = &engine->command_recorders[ i ];
+    if (recorder->is_recording)
+    {
+      moss__error ("Command recorder %u wasn't ended before the frame end.\n", i);
+      return MOSS_RESULT_ERROR;
+    }
+
+    if (recorder->is_recorded)
+    {
+      command_buffers[ command_buffer_count++ ] = recorder->command_buffer;
+    }
+  }
+
+  vkCmdExecuteCommands (
+    engine->general_command_buffers[ engine->current_frame ],
+    command_buffer_count,
+    command_buffers
   );
-  if (result != VK_SUCCESS)
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult
+moss__record_frame_upload_command_buffer (MossEngine *const engine)
+{
+  const VkCommandBuffer command_buffer =
+    engine->upload_command_buffers[ engine->current_frame ];
+
+  // Frame fence is already waited, so the previous recording has completed
+  vkResetCommandBuffer (command_buffer, 0);
+
+  const VkCommandBufferBeginInfo begin_info = {
+    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+    .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+
+  if (vkBeginCommandBuffer (command_buffer, &begin_info) != VK_SUCCESS)
   {
-    moss__error ("Failed to allocate command buffers. Error code: %d.\n", result);
+    moss__error ("Failed to begin recording frame upload command buffer.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  moss__record_frame_upload_copies (&engine->frame_upload_queue, command_buffer);
+
+  if (vkEndCommandBuffer (command_buffer) != VK_SUCCESS)
+  {
+    moss__error ("Failed to end recording frame upload command buffer.\n");
     return MOSS_RESULT_ERROR;
   }
 
@@ -1989,7 +3608,11 @@ inline static void moss__cleanup_swapchain_framebuffers (MossEngine *const engin
   {
     if (engine->swapchain_framebuffers[ i ] == VK_NULL_HANDLE) { continue; }
 
-    vkDestroyFramebuffer (engine->device, engine->swapchain_framebuffers[ i ], NULL);
+    vkDestroyFramebuffer (
+      engine->device,
+      engine->swapchain_framebuffers[ i ],
+      &engine->vk_allocation_callbacks
+    );
     engine->swapchain_framebuffers[ i ] = VK_NULL_HANDLE;
   }
 }
@@ -2000,16 +3623,38 @@ inline static void moss__cleanup_swapchain_image_views (MossEngine *const engine
   {
     if (engine->swapchain_image_views[ i ] == VK_NULL_HANDLE) { continue; }
 
-    vkDestroyImageView (engine->device, engine->swapchain_image_views[ i ], NULL);
+    vkDestroyImageView (
+      engine->device,
+      engine->swapchain_image_views[ i ],
+      &engine->vk_allocation_callbacks
+    );
     engine->swapchain_image_views[ i ] = VK_NULL_HANDLE;
   }
 }
 
 inline static void moss__cleanup_swapchain_handle (MossEngine *const engine)
 {
+  if (engine->is_headless)
+  {
+    for (uint32_t i = 0; i < engine->swapchain_image_count; ++i)
+    {
+      moss_vk__free_memory (&engine->allocator, &engine->headless_image_allocations[ i ]);
+      vkDestroyImage (
+        engine->device,
+        engine->swapchain_images[ i ],
+        &engine->vk_allocation_callbacks
+      );
+      engine->swapchain_images[ i ] = VK_NULL_HANDLE;
+    }
+  }
+
   if (engine->swapchain != VK_NULL_HANDLE)
   {
-    vkDestroySwapchainKHR (engine->device, engine->swapchain, NULL);
+    vkDestroySwapchainKHR (
+      engine->device,
+      engine->swapchain,
+      &engine->vk_allocation_callbacks
+    );
     engine->swapchain = VK_NULL_HANDLE;
   }
 }
@@ -2018,19 +3663,23 @@ inline static void moss__cleanup_depth_resources (MossEngine *const engine)
 {
   if (engine->depth_image_view != VK_NULL_HANDLE)
   {
-    vkDestroyImageView (engine->device, engine->depth_image_view, NULL);
+    vkDestroyImageView (
+      engine->device,
+      engine->depth_image_view,
+      &engine->vk_allocation_callbacks
+    );
     engine->depth_image_view = VK_NULL_HANDLE;
   }
 
-  if (engine->depth_image_memory != VK_NULL_HANDLE)
-  {
-    vkFreeMemory (engine->device, engine->depth_image_memory, NULL);
-    engine->depth_image_memory = VK_NULL_HANDLE;
-  }
+  moss_vk__free_memory (&engine->allocator, &engine->depth_image_allocation);
 
   if (engine->depth_image != VK_NULL_HANDLE)
   {
-    vkDestroyImage (engine->device, engine->depth_image, NULL);
+    vkDestroyImage (
+      engine->device,
+      engine->depth_image,
+      &engine->vk_allocation_callbacks
+    );
     engine->depth_image = VK_NULL_HANDLE;
   }
 }
@@ -2053,10 +3702,24 @@ inline static MossResult moss__recreate_swapchain (
   const uint32_t    height
 )
 {
-  vkDeviceWaitIdle (engine->device);
+  // Frames in flight still render into the old images, so instead of waiting for
+  // the device their views and framebuffers are destroyed once those frames finish
+  for (uint32_t i = 0; i < engine->swapchain_image_count; ++i)
+  {
+    const Moss__DeletionQueueEntry entry = {
+      .framebuffer = engine->swapchain_framebuffers[ i ],
+      .image_view  = engine->swapchain_image_views[ i ],
+    };
+    moss__defer_deletion (engine, &entry, 0);
 
-  moss__cleanup_swapchain (engine);
+    engine->swapchain_framebuffers[ i ] = VK_NULL_HANDLE;
+    engine->swapchain_image_views[ i ]  = VK_NULL_HANDLE;
+  }
+
+  // Present ids of the old swap chain can't be waited on the new one
+  engine->last_present_id = 0;
 
+  // Old swap chain is passed as oldSwapchain and retired by moss__create_swapchain
   if (moss__create_swapchain (engine, width, height) != MOSS_RESULT_SUCCESS)
   {
     return MOSS_RESULT_ERROR;
@@ -2065,10 +3728,31 @@ inline static MossResult moss__recreate_swapchain (
   {
     return MOSS_RESULT_ERROR;
   }
-  if (moss__create_depth_resources (engine) != MOSS_RESULT_SUCCESS)
+
+  // Depth image is kept if the new extent fits, framebuffers may be smaller than it
+  const bool does_depth_image_fit =
+    engine->depth_image != VK_NULL_HANDLE &&
+    engine->swapchain_extent.width <= engine->depth_image_extent.width &&
+    engine->swapchain_extent.height <= engine->depth_image_extent.height;
+  if (!does_depth_image_fit)
   {
-    return MOSS_RESULT_ERROR;
+    const Moss__DeletionQueueEntry entry = {
+      .image_view = engine->depth_image_view,
+      .image      = engine->depth_image,
+      .allocation = engine->depth_image_allocation,
+    };
+    moss__defer_deletion (engine, &entry, 0);
+
+    engine->depth_image            = VK_NULL_HANDLE;
+    engine->depth_image_view       = VK_NULL_HANDLE;
+    engine->depth_image_allocation = (Moss__VkAllocation) { 0 };
+
+    if (moss__create_depth_resources (engine) != MOSS_RESULT_SUCCESS)
+    {
+      return MOSS_RESULT_ERROR;
+    }
   }
+
   if (moss__create_framebuffers (engine) != MOSS_RESULT_SUCCESS)
   {
     return MOSS_RESULT_ERROR;
@@ -2077,15 +3761,6 @@ inline static MossResult moss__recreate_swapchain (
   return MOSS_RESULT_SUCCESS;
 }
 
-inline static void moss__update_camera_ubo_data (MossEngine *const engine)
-{
-  memcpy (
-    engine->camera_ubo_buffer_mapped_memory_blocks[ engine->current_frame ],
-    &engine->camera,
-    sizeof (engine->camera)
-  );
-}
-
 inline static MossResult
 moss__create_image_available_semaphores (MossEngine *const engine)
 {
@@ -2095,12 +3770,12 @@ moss__create_image_available_semaphores (MossEngine *const engine)
     .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
   };
 
-  for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+  for (uint32_t i = 0; i < engine->frames_in_flight_count; ++i)
   {
     const VkResult result = vkCreateSemaphore (
       engine->device,
       &semaphore_info,
-      NULL,
+      &engine->vk_allocation_callbacks,
       &engine->image_available_semaphores[ i ]
     );
     if (result == VK_SUCCESS) { continue; }
@@ -2121,12 +3796,12 @@ moss__create_render_finished_semaphores (MossEngine *const engine)
     .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
   };
 
-  for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+  for (uint32_t i = 0; i < engine->frames_in_flight_count; ++i)
   {
     const VkResult result = vkCreateSemaphore (
       engine->device,
       &semaphore_info,
-      NULL,
+      &engine->vk_allocation_callbacks,
       &engine->render_finished_semaphores[ i ]
     );
     if (result == VK_SUCCESS) { continue; }
@@ -2147,10 +3822,14 @@ inline static MossResult moss__create_in_flight_fences (MossEngine *const engine
     .flags = VK_FENCE_CREATE_SIGNALED_BIT,
   };
 
-  for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+  for (uint32_t i = 0; i < engine->frames_in_flight_count; ++i)
   {
-    const VkResult result =
-      vkCreateFence (engine->device, &fence_info, NULL, &engine->in_flight_fences[ i ]);
+    const VkResult result = vkCreateFence (
+      engine->device,
+      &fence_info,
+      &engine->vk_allocation_callbacks,
+      &engine->in_flight_fences[ i ]
+    );
     if (result == VK_SUCCESS) { continue; }
 
     moss__error ("Failed to create in-flight fence for frame %u.\n", i);
@@ -2187,7 +3866,11 @@ moss__cleanup_semaphores (MossEngine *const engine, VkSemaphore *semaphores)
   {
     if (semaphores[ i ] == VK_NULL_HANDLE) { continue; }
 
-    vkDestroySemaphore (engine->device, semaphores[ i ], NULL);
+    vkDestroySemaphore (
+      engine->device,
+      semaphores[ i ],
+      &engine->vk_allocation_callbacks
+    );
     semaphores[ i ] = VK_NULL_HANDLE;
   }
 }
@@ -2198,7 +3881,7 @@ inline static void moss__cleanup_fences (MossEngine *const engine, VkFence *fenc
   {
     if (fences[ i ] == VK_NULL_HANDLE) { continue; }
 
-    vkDestroyFence (engine->device, fences[ i ], NULL);
+    vkDestroyFence (engine->device, fences[ i ], &engine->vk_allocation_callbacks);
     fences[ i ] = VK_NULL_HANDLE;
   }
 }
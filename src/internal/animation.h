@@ -0,0 +1,259 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/animation.h
+  @brief GPU resources of sprite animation clips.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Frame and clip tables are device-local storage buffers sized for
+           MAX_ANIMATION_FRAME_COUNT frames and MAX_ANIMATION_CLIP_COUNT clips.
+           They are never reallocated, so the single animation set is written once
+           and stays bound to set 1 of every graphics pipeline.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/result.h"
+
+#include "src/internal/camera.h"
+#include "src/internal/config.h"
+#include "src/internal/engine.h"
+#include "src/internal/log.h"
+#include "src/internal/vulkan/utils/buffer.h"
+
+/* Offset of the animation time in graphics push constants, right after the camera. */
+#define MOSS__ANIMATION_TIME_PUSH_CONSTANT_OFFSET \
+  (uint32_t)(sizeof (Moss__CameraPushConstants))
+
+/*
+  @brief Animation clip record as read by the instanced vertex shader.
+  @warning Layout must match AnimationClips buffer of sprite_instanced.vert.
+*/
+typedef struct
+{
+  uint32_t first_frame;    /* Index of the first clip frame in the frame buffer. */
+  uint32_t frame_count;    /* Number of clip frames. */
+  float    frame_duration; /* Seconds every frame is shown for. */
+  uint32_t is_looped;      /* Whether the clip loops, 1 or 0. */
+} Moss__AnimationClip;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Creates animation buffers, descriptor set layout, pool and set.
+  @param engine Engine handle, device and allocator must be created.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_animation_resources (MossEngine *const engine)
+{
+  const VkDeviceSize frame_buffer_size =
+    (VkDeviceSize)(MAX_ANIMATION_FRAME_COUNT * 4 * sizeof (float));
+  const VkDeviceSize clip_buffer_size =
+    (VkDeviceSize)(MAX_ANIMATION_CLIP_COUNT * sizeof (Moss__AnimationClip));
+
+  {  // Create device-local frame and clip buffers
+    Moss__CreateVkBufferInfo create_info = {
+      .allocator       = &engine->allocator,
+      .device          = engine->device,
+      .size            = frame_buffer_size,
+      .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      .memory_properties               = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+      .sharing_mode                    = engine->buffer_sharing_mode,
+      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+    };
+    if (moss_vk__create_buffer (
+          &create_info,
+          &engine->animation_frame_buffer,
+          &engine->animation_frame_buffer_allocation
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create animation frame buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    create_info.size = clip_buffer_size;
+    if (moss_vk__create_buffer (
+          &create_info,
+          &engine->animation_clip_buffer,
+          &engine->animation_clip_buffer_allocation
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create animation clip buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Create descriptor set layout
+    const VkDescriptorSetLayoutBinding layout_bindings[] = {
+      {
+        .binding         = 0,
+        .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = 1,
+        .stageFlags      = VK_SHADER_STAGE_VERTEX_BIT,
+      },
+      {
+        .binding         = 1,
+        .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = 1,
+        .stageFlags      = VK_SHADER_STAGE_VERTEX_BIT,
+      },
+    };
+
+    const VkDescriptorSetLayoutCreateInfo create_info = {
+      .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .bindingCount = sizeof (layout_bindings) / sizeof (layout_bindings[ 0 ]),
+      .pBindings    = layout_bindings,
+    };
+
+    const VkResult result = vkCreateDescriptorSetLayout (
+      engine->device,
+      &create_info,
+      &engine->vk_allocation_callbacks,
+      &engine->animation_descriptor_set_layout
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to create animation descriptor layout: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Create descriptor pool
+    const VkDescriptorPoolSize pool_size = {
+      .type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      .descriptorCount = 2,
+    };
+
+    const VkDescriptorPoolCreateInfo pool_info = {
+      .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .poolSizeCount = 1,
+      .pPoolSizes    = &pool_size,
+      .maxSets       = 1,
+    };
+
+    const VkResult result = vkCreateDescriptorPool (
+      engine->device,
+      &pool_info,
+      &engine->vk_allocation_callbacks,
+      &engine->animation_descriptor_pool
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to create animation descriptor pool: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Allocate and write descriptor set
+    const VkDescriptorSetAllocateInfo alloc_info = {
+      .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .descriptorPool     = engine->animation_descriptor_pool,
+      .descriptorSetCount = 1,
+      .pSetLayouts        = &engine->animation_descriptor_set_layout,
+    };
+
+    if (vkAllocateDescriptorSets (
+          engine->device,
+          &alloc_info,
+          &engine->animation_descriptor_set
+        ) != VK_SUCCESS)
+    {
+      moss__error ("Failed to allocate animation descriptor set.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    const VkDescriptorBufferInfo buffer_infos[] = {
+      {
+        .buffer = engine->animation_frame_buffer,
+        .offset = 0,
+        .range  = frame_buffer_size,
+      },
+      {
+        .buffer = engine->animation_clip_buffer,
+        .offset = 0,
+        .range  = clip_buffer_size,
+      },
+    };
+
+    VkWriteDescriptorSet writes[ 2 ];
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+      writes[ i ] = (VkWriteDescriptorSet) {
+        .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet          = engine->animation_descriptor_set,
+        .dstBinding      = i,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .pBufferInfo     = &buffer_infos[ i ],
+      };
+    }
+
+    vkUpdateDescriptorSets (engine->device, 2, writes, 0, NULL);
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Destroys animation buffers and descriptor objects.
+  @param engine Engine handle, device must be idle.
+*/
+inline static void moss__destroy_animation_resources (MossEngine *const engine)
+{
+  // Set is freed with the pool
+  if (engine->animation_descriptor_pool != VK_NULL_HANDLE)
+  {
+    vkDestroyDescriptorPool (
+      engine->device,
+      engine->animation_descriptor_pool,
+      &engine->vk_allocation_callbacks
+    );
+  }
+
+  if (engine->animation_descriptor_set_layout != VK_NULL_HANDLE)
+  {
+    vkDestroyDescriptorSetLayout (
+      engine->device,
+      engine->animation_descriptor_set_layout,
+      &engine->vk_allocation_callbacks
+    );
+  }
+
+  moss_vk__destroy_buffer (
+    &engine->allocator,
+    engine->animation_frame_buffer,
+    &engine->animation_frame_buffer_allocation
+  );
+  moss_vk__destroy_buffer (
+    &engine->allocator,
+    engine->animation_clip_buffer,
+    &engine->animation_clip_buffer_allocation
+  );
+
+  engine->animation_descriptor_pool       = VK_NULL_HANDLE;
+  engine->animation_descriptor_set_layout = VK_NULL_HANDLE;
+  engine->animation_descriptor_set        = VK_NULL_HANDLE;
+  engine->animation_frame_buffer          = VK_NULL_HANDLE;
+  engine->animation_clip_buffer           = VK_NULL_HANDLE;
+  engine->animation_frame_count           = 0;
+  engine->animation_clip_count            = 0;
+}
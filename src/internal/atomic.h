@@ -0,0 +1,116 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/atomic.h
+  @brief Atomic operation wrappers.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Library is built as C99, which has no <stdatomic.h>, so compiler
+           builtins are used instead.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#  error "Atomic operations are only implemented for GCC and Clang."
+#endif
+
+/*
+  @brief Atomically loads value with acquire ordering.
+  @param value Pointer to the value.
+  @return Loaded value.
+*/
+inline static uint32_t moss__atomic_load_u32 (const uint32_t *const value)
+{
+  return __atomic_load_n (value, __ATOMIC_ACQUIRE);
+}
+
+/*
+  @brief Atomically stores value with release ordering.
+  @param value Pointer to the value.
+  @param desired Value to store.
+*/
+inline static void moss__atomic_store_u32 (uint32_t *const value, const uint32_t desired)
+{
+  __atomic_store_n (value, desired, __ATOMIC_RELEASE);
+}
+
+/*
+  @brief Atomically replaces value with desired one if it equals expected one.
+  @param value Pointer to the value.
+  @param expected Expected value, receives the current value on failure.
+  @param desired Value to store.
+  @return Returns true if value was replaced, false otherwise.
+*/
+inline static bool moss__atomic_compare_exchange_u32 (
+  uint32_t *const value,
+  uint32_t *const expected,
+  const uint32_t  desired
+)
+{
+  return __atomic_compare_exchange_n (
+    value,
+    expected,
+    desired,
+    true,
+    __ATOMIC_ACQ_REL,
+    __ATOMIC_ACQUIRE
+  );
+}
+
+/*
+  @brief Atomically loads 64-bit value with relaxed ordering.
+  @param value Pointer to the value.
+  @return Loaded value.
+*/
+inline static uint64_t moss__atomic_load_u64 (const uint64_t *const value)
+{
+  return __atomic_load_n (value, __ATOMIC_RELAXED);
+}
+
+/*
+  @brief Atomically adds to 64-bit value with relaxed ordering.
+  @param value Pointer to the value.
+  @param addend Value to add, wraps around to subtract.
+  @return Value after the addition.
+*/
+inline static uint64_t
+moss__atomic_add_u64 (uint64_t *const value, const uint64_t addend)
+{
+  return __atomic_add_fetch (value, addend, __ATOMIC_RELAXED);
+}
+
+/*
+  @brief Atomically raises 64-bit value to candidate one if it's lower.
+  @param value Pointer to the value.
+  @param candidate Value to raise to.
+*/
+inline static void moss__atomic_max_u64 (uint64_t *const value, const uint64_t candidate)
+{
+  uint64_t current = __atomic_load_n (value, __ATOMIC_RELAXED);
+  while (current < candidate &&
+         !__atomic_compare_exchange_n (
+           value,
+           &current,
+           candidate,
+           true,
+           __ATOMIC_RELAXED,
+           __ATOMIC_RELAXED
+         ))
+  {
+  }
+}
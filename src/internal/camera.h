@@ -22,8 +22,75 @@
 
 #include <cglm/cglm.h>
 
+#include "moss/camera.h"
+
+#include "src/internal/host_allocator.h"
+
 struct MossCamera
 {
-  vec2 scale;  /* Camera scale applied to verticies. */
-  vec2 offset; /* Camera offset applied to verticies. */
+  vec2 scale;             /* Camera scale applied to verticies. */
+  vec2 offset;            /* Camera offset applied to verticies. */
+  vec2 viewport_position; /* Viewport top left corner, normalized to framebuffer. */
+  vec2 viewport_size;     /* Viewport size, normalized to framebuffer. */
+  /* Host allocator camera is allocated with, NULL for the engine's camera. */
+  Moss__HostAllocator *host_allocator;
 };
+
+/*
+  @brief Push constants of sprite vertex shaders.
+*/
+typedef struct
+{
+  float scale[ 2 ];  /* Camera scale applied to vertices. */
+  float offset[ 2 ]; /* Camera offset applied to vertices. */
+} Moss__CameraPushConstants;
+
+/*
+  @brief Initialize camera state to default values.
+  @details Camera covers the [-1, 1] clip space range and the whole framebuffer.
+  @param camera Camera.
+*/
+inline static void moss__init_camera_state (MossCamera *const camera)
+{
+  *camera = (MossCamera){
+    .scale             = { 1.0F, 1.0F },
+    .offset            = { 0.0F, 0.0F },
+    .viewport_position = { 0.0F, 0.0F },
+    .viewport_size     = { 1.0F, 1.0F },
+    .host_allocator    = NULL,
+  };
+}
+
+/*
+  @brief Returns push constants of the camera.
+  @param camera Camera.
+  @return Push constants to pass to sprite shaders.
+*/
+inline static Moss__CameraPushConstants
+moss__get_camera_push_constants (const MossCamera *const camera)
+{
+  return (Moss__CameraPushConstants){
+    .scale  = { camera->scale[ 0 ], camera->scale[ 1 ] },
+    .offset = { camera->offset[ 0 ], camera->offset[ 1 ] },
+  };
+}
+
+/*
+  @brief Computes world space rect visible through the camera.
+  @param camera Camera.
+  @param out_min Output rect minimum corner.
+  @param out_max Output rect maximum corner.
+*/
+inline static void
+moss__get_camera_view_rect (const MossCamera *const camera, vec2 out_min, vec2 out_max)
+{
+  // Clip space spans [-1, 1], scale is negative on the flipped Y axis
+  for (int i = 0; i < 2; ++i)
+  {
+    const float a = (-1.0F - camera->offset[ i ]) / camera->scale[ i ];
+    const float b = (1.0F - camera->offset[ i ]) / camera->scale[ i ];
+
+    out_min[ i ] = a < b ? a : b;
+    out_max[ i ] = a < b ? b : a;
+  }
+}
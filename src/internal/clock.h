@@ -0,0 +1,62 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/clock.h
+  @brief Monotonic clock for CPU timings.
+  @author Ilya Buravov (ilburale@gmail.com)
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __APPLE__
+#  include <mach/mach_time.h>
+#endif
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Returns monotonic clock time.
+  @return Time in nanoseconds since an unspecified point.
+*/
+inline static uint64_t moss__get_time_ns (void)
+{
+#ifdef __APPLE__
+  // Timebase is constant, a racy first read only repeats the query
+  static mach_timebase_info_data_t timebase_info = { 0, 0 };
+  if (timebase_info.denom == 0) { mach_timebase_info (&timebase_info); }
+
+  return mach_absolute_time ( ) * timebase_info.numer / timebase_info.denom;
+#else
+  struct timespec time;
+  clock_gettime (CLOCK_MONOTONIC, &time);
+
+  return (uint64_t)time.tv_sec * UINT64_C (1000000000) + (uint64_t)time.tv_nsec;
+#endif
+}
+
+/*
+  @brief Converts nanoseconds to milliseconds.
+  @param nanoseconds Time in nanoseconds.
+  @return Time in milliseconds.
+*/
+inline static double moss__ns_to_ms (const uint64_t nanoseconds)
+{
+  return (double)nanoseconds / 1000000.0;
+}
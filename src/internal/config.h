@@ -20,8 +20,79 @@
 
 #pragma once
 
-/* Max frames in flight. */
-#define MAX_FRAMES_IN_FLIGHT (size_t)(2)
+#include "moss/engine.h"
+
+/* Max frames in flight, per-frame arrays are sized for it. */
+#define MAX_FRAMES_IN_FLIGHT (size_t)(MOSS_MAX_FRAMES_IN_FLIGHT)
+
+/* Frames in flight if the engine config leaves the count zero. */
+#define DEFAULT_FRAMES_IN_FLIGHT_COUNT (uint32_t)(2)
+
+/* Nanoseconds low-latency mode waits for a frame to be displayed at most. It bounds
+   the wait if a present is dropped, e.g. while the window is hidden. */
+#define LOW_LATENCY_PRESENT_WAIT_TIMEOUT (uint64_t)(100000000)
 
 /* Max image count in swapchain. */
 #define MAX_SWAPCHAIN_IMAGE_COUNT (size_t)(4)
+
+/* Number of engine-owned images headless frames are rendered into. */
+#define HEADLESS_IMAGE_COUNT (uint32_t)(3)
+
+/* Maximum number of frame readbacks requested and not released at the same time. */
+#define MAX_FRAME_READBACK_COUNT (size_t)(4)
+
+/* Number of sprites the shared quad index buffer is created for. */
+#define QUAD_INDEX_BUFFER_INITIAL_CAPACITY (size_t)(16384)
+
+/* Number of reusable command buffers in the upload queue ring. */
+#define UPLOAD_QUEUE_COMMAND_BUFFER_COUNT (size_t)(4)
+
+/* Size of per-frame staging buffer small buffer updates are copied from. It grows
+   when updates of a single frame don't fit. */
+#define FRAME_UPLOAD_BUFFER_INITIAL_SIZE (size_t)(1024 * 1024)
+
+/* Size of device memory blocks resources are sub-allocated from. */
+#define MEMORY_BLOCK_SIZE (size_t)(32 * 1024 * 1024)
+
+/* Maximum number of textures alive at the same time. */
+#define MAX_TEXTURE_COUNT (size_t)(1024)
+
+/* Maximum number of texture mip levels, enough for 32768x32768 textures. */
+#define MAX_TEXTURE_MIP_LEVEL_COUNT (size_t)(16)
+
+/* Maximum number of sprite batches with GPU culling alive at the same time. */
+#define MAX_CULLED_SPRITE_BATCH_COUNT (size_t)(256)
+
+/* Sprites tested per culling workgroup, the cull shader is specialized with it. */
+#define SPRITE_CULL_WORKGROUP_SIZE (uint32_t)(64)
+
+/* Decoded texture bytes uploaded per frame once the loader thread finishes them. */
+#define TEXTURE_STREAMING_BYTES_PER_FRAME (size_t)(16 * 1024 * 1024)
+
+/* Maximum number of grid cells a chunked sprite batch buckets sprites into. */
+#define MAX_SPRITE_BATCH_CHUNK_COUNT (size_t)(4096)
+
+/* Maximum number of separate updated ranges a static sprite batch tracks, closest
+   ranges are merged once it's exceeded. */
+#define MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT (size_t)(32)
+
+/* Maximum number of animation clips registered with an engine. */
+#define MAX_ANIMATION_CLIP_COUNT (size_t)(1024)
+
+/* Maximum number of frames of all animation clips registered with an engine. */
+#define MAX_ANIMATION_FRAME_COUNT (size_t)(16384)
+
+/* Maximum number of tilemaps alive at the same time. */
+#define MAX_TILEMAP_COUNT (size_t)(256)
+
+/* Width and height in tiles of a tilemap chunk, every visible chunk is one quad. */
+#define TILEMAP_CHUNK_SIZE (uint32_t)(32)
+
+/* Maximum number of particle systems alive at the same time. */
+#define MAX_PARTICLE_SYSTEM_COUNT (size_t)(64)
+
+/* Particles simulated per workgroup, the particle shader is specialized with it. */
+#define PARTICLE_WORKGROUP_SIZE (uint32_t)(64)
+
+/* Longest time step particles are simulated with, longer frames slow them down. */
+#define MAX_PARTICLE_TIME_STEP (float)(0.1F)
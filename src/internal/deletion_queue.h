@@ -0,0 +1,265 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/deletion_queue.h
+  @brief Deferred destruction of device resources.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Resources that may still be used by frames in flight or by pending
+           uploads are pushed to the queue instead of being destroyed right away.
+           The queue is collected at the start of every frame, once the frame fence
+           proves the frames that could use them are finished.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/result.h"
+
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+#include "src/internal/texture_index_pool.h"
+#include "src/internal/vulkan/utils/allocator.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Resources waiting for the device to stop using them.
+  @details Every handle is optional, VK_NULL_HANDLE ones are skipped.
+*/
+typedef struct
+{
+  uint64_t           frame_count;           /* Frames that must be completed. */
+  uint64_t           upload_value;          /* Upload value that must be reached. */
+  VkSwapchainKHR     swapchain;             /* Retired swap chain to destroy. */
+  VkFramebuffer      framebuffer;           /* Framebuffer to destroy. */
+  VkImageView        image_view;            /* Image view to destroy. */
+  VkImage            image;                 /* Image to destroy. */
+  VkBuffer           buffer;                /* Buffer to destroy. */
+  Moss__VkAllocation allocation;            /* Memory to free. */
+  VkDescriptorPool   descriptor_pool;       /* Pool descriptor set is allocated from. */
+  VkDescriptorSet    descriptor_set;        /* Descriptor set to free. */
+  bool               release_texture_index; /* Whether texture index is released. */
+  uint32_t           texture_index;         /* Bindless texture slot to release. */
+} Moss__DeletionQueueEntry;
+
+/*
+  @brief Deletion queue state.
+*/
+typedef struct
+{
+  /* Logical device. */
+  VkDevice device;
+  /* Allocator memory of the resources is freed with. */
+  Moss__VkAllocator *allocator;
+  /* Pool bindless texture indices are released to. */
+  Moss__TextureIndexPool *texture_index_pool;
+  /* Pending entries. */
+  Moss__DeletionQueueEntry *entries;
+  /* Number of pending entries. */
+  size_t entry_count;
+  /* Capacity of entry array. */
+  size_t entry_capacity;
+} Moss__DeletionQueue;
+
+/*
+  @brief Required info to create deletion queue.
+*/
+typedef struct
+{
+  VkDevice                device;             /* Logical device. */
+  Moss__VkAllocator      *allocator;          /* Allocator to free memory with. */
+  Moss__TextureIndexPool *texture_index_pool; /* Pool to release indices to. */
+  Moss__DeletionQueue    *out_deletion_queue; /* Deletion queue to initialize. */
+} Moss__CreateDeletionQueueInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Initializes deletion queue with empty state.
+  @param deletion_queue Deletion queue to initialize.
+*/
+inline static void
+moss__init_deletion_queue_state (Moss__DeletionQueue *const deletion_queue)
+{
+  memset (deletion_queue, 0, sizeof (*deletion_queue));
+  deletion_queue->device = VK_NULL_HANDLE;
+}
+
+/*
+  @brief Creates deletion queue.
+  @param info Required info to create deletion queue.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__create_deletion_queue (const Moss__CreateDeletionQueueInfo *const info)
+{
+  Moss__DeletionQueue *const deletion_queue = info->out_deletion_queue;
+
+  moss__init_deletion_queue_state (deletion_queue);
+  deletion_queue->device             = info->device;
+  deletion_queue->allocator          = info->allocator;
+  deletion_queue->texture_index_pool = info->texture_index_pool;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Destroys resources of the entry.
+  @param deletion_queue Deletion queue entry belongs to.
+  @param entry Entry to destroy resources of.
+*/
+inline static void moss__destroy_deletion_queue_entry (
+  Moss__DeletionQueue *const deletion_queue,
+  Moss__DeletionQueueEntry  *entry
+)
+{
+  const VkDevice                     device = deletion_queue->device;
+  const VkAllocationCallbacks *const callbacks =
+    deletion_queue->allocator->allocation_callbacks;
+
+  if (entry->descriptor_set != VK_NULL_HANDLE)
+  {
+    vkFreeDescriptorSets (device, entry->descriptor_pool, 1, &entry->descriptor_set);
+  }
+
+  if (entry->framebuffer != VK_NULL_HANDLE)
+  {
+    vkDestroyFramebuffer (device, entry->framebuffer, callbacks);
+  }
+
+  if (entry->image_view != VK_NULL_HANDLE)
+  {
+    vkDestroyImageView (device, entry->image_view, callbacks);
+  }
+
+  // Images of the swap chain are destroyed along with it
+  if (entry->swapchain != VK_NULL_HANDLE)
+  {
+    vkDestroySwapchainKHR (device, entry->swapchain, callbacks);
+  }
+
+  if (entry->image != VK_NULL_HANDLE)
+  {
+    vkDestroyImage (device, entry->image, callbacks);
+  }
+
+  if (entry->buffer != VK_NULL_HANDLE)
+  {
+    vkDestroyBuffer (device, entry->buffer, callbacks);
+  }
+
+  moss_vk__free_memory (deletion_queue->allocator, &entry->allocation);
+
+  if (entry->release_texture_index)
+  {
+    moss__release_texture_index (
+      deletion_queue->texture_index_pool,
+      entry->texture_index
+    );
+  }
+}
+
+/*
+  @brief Pushes entry to the deletion queue.
+  @param deletion_queue Deletion queue.
+  @param entry Entry to push.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__push_deletion_queue_entry (
+  Moss__DeletionQueue *const            deletion_queue,
+  const Moss__DeletionQueueEntry *const entry
+)
+{
+  if (deletion_queue->entry_count == deletion_queue->entry_capacity)
+  {
+    const size_t capacity =
+      deletion_queue->entry_capacity == 0 ? 16 : deletion_queue->entry_capacity * 2;
+
+    Moss__DeletionQueueEntry *const entries = moss__reallocate (
+      deletion_queue->allocator->host_allocator,
+      deletion_queue->entries,
+      capacity * sizeof (Moss__DeletionQueueEntry),
+      MOSS_ALLOCATION_CATEGORY_ENGINE
+    );
+    if (entries == NULL)
+    {
+      moss__error ("Failed to allocate memory for deletion queue entries.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    deletion_queue->entries        = entries;
+    deletion_queue->entry_capacity = capacity;
+  }
+
+  deletion_queue->entries[ deletion_queue->entry_count++ ] = *entry;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Destroys resources of entries the device no longer uses.
+  @param deletion_queue Deletion queue.
+  @param completed_frame_count Number of frames known to be completed.
+  @param completed_upload_value Upload timeline value known to be reached.
+*/
+inline static void moss__collect_deletion_queue (
+  Moss__DeletionQueue *const deletion_queue,
+  const uint64_t             completed_frame_count,
+  const uint64_t             completed_upload_value
+)
+{
+  size_t kept_count = 0;
+  for (size_t i = 0; i < deletion_queue->entry_count; ++i)
+  {
+    Moss__DeletionQueueEntry entry = deletion_queue->entries[ i ];
+
+    if (entry.frame_count <= completed_frame_count &&
+        entry.upload_value <= completed_upload_value)
+    {
+      moss__destroy_deletion_queue_entry (deletion_queue, &entry);
+    }
+    else {
+      deletion_queue->entries[ kept_count++ ] = entry;
+    }
+  }
+
+  deletion_queue->entry_count = kept_count;
+}
+
+/*
+  @brief Destroys deletion queue and resources of all pending entries.
+  @details Device must be idle.
+  @param deletion_queue Deletion queue to destroy.
+*/
+inline static void
+moss__destroy_deletion_queue (Moss__DeletionQueue *const deletion_queue)
+{
+  if (deletion_queue->device == VK_NULL_HANDLE) { return; }
+
+  moss__collect_deletion_queue (deletion_queue, UINT64_MAX, UINT64_MAX);
+  moss__free (deletion_queue->allocator->host_allocator, deletion_queue->entries);
+
+  moss__init_deletion_queue_state (deletion_queue);
+}
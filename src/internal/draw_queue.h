@@ -0,0 +1,235 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/draw_queue.h
+  @brief Queue of sprite batch draws sorted before they are recorded.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Queued draws are sorted by layer first. Within a layer opaque draws go
+           first, then alpha tested and translucent ones. Draws that write depth are
+           grouped by pipeline, texture and batch, so the recorder skips redundant
+           binds, and go front-to-back. Translucent draws keep back-to-front order
+           and are never regrouped.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/result.h"
+#include "moss/sprite_batch.h"
+
+#include "src/internal/camera.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Sprite batch draw waiting in the queue.
+*/
+typedef struct
+{
+  MossSpriteBatch *sprite_batch;           /* Sprite batch to draw. */
+  MossCamera       camera;                 /* Camera the draw was queued with. */
+  VkPipeline       pipeline;               /* Pipeline the batch is drawn with. */
+  VkDescriptorSet  texture_descriptor_set; /* Texture set the batch is drawn with. */
+  uint32_t         layer;                  /* Layer the draw was queued to. */
+  uint32_t         material_order;         /* Position of the material within a layer. */
+  float            depth;                  /* Depth the draw was queued with. */
+  uint32_t         index;                  /* Index of the draw in queue order. */
+} Moss__QueuedDraw;
+
+/*
+  @brief Draw queue state.
+*/
+typedef struct
+{
+  /* Host allocator draws are allocated with. */
+  Moss__HostAllocator *host_allocator;
+  /* Queued draws. */
+  Moss__QueuedDraw *draws;
+  /* Number of queued draws. */
+  size_t draw_count;
+  /* Number of draws memory is allocated for. */
+  size_t draw_capacity;
+} Moss__DrawQueue;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Returns position of a material among the draws of a layer.
+  @details Opaque draws go first so the depth test rejects alpha tested texels
+           behind them, translucent draws go last to blend over everything else.
+  @param material Sprite batch material.
+  @return Position of the material.
+*/
+inline static uint32_t
+moss__get_material_draw_order (const MossSpriteBatchMaterial material)
+{
+  switch (material)
+  {
+    case MOSS_SPRITE_BATCH_MATERIAL_OPAQUE: return 0;
+    case MOSS_SPRITE_BATCH_MATERIAL_ALPHA_TEST: return 1;
+    case MOSS_SPRITE_BATCH_MATERIAL_TRANSLUCENT: return 2;
+  }
+
+  return 2;
+}
+
+/*
+  @brief Compares queued draws.
+  @param a First draw.
+  @param b Second draw.
+  @return Negative, zero or positive value as qsort expects.
+*/
+inline static int moss__compare_queued_draws (const void *const a, const void *const b)
+{
+  const Moss__QueuedDraw *const draw_a = a;
+  const Moss__QueuedDraw *const draw_b = b;
+
+  if (draw_a->layer != draw_b->layer) { return draw_a->layer < draw_b->layer ? -1 : 1; }
+
+  if (draw_a->material_order != draw_b->material_order)
+  {
+    return draw_a->material_order < draw_b->material_order ? -1 : 1;
+  }
+
+  const uint32_t translucent_order =
+    moss__get_material_draw_order (MOSS_SPRITE_BATCH_MATERIAL_TRANSLUCENT);
+  if (draw_a->material_order == translucent_order)
+  {
+    // Blending depends on order, so only depth may reorder translucent draws
+    if (draw_a->depth > draw_b->depth) { return -1; }
+    if (draw_a->depth < draw_b->depth) { return 1; }
+  }
+  else {
+    if (draw_a->pipeline != draw_b->pipeline)
+    {
+      return (uintptr_t)draw_a->pipeline < (uintptr_t)draw_b->pipeline ? -1 : 1;
+    }
+
+    if (draw_a->texture_descriptor_set != draw_b->texture_descriptor_set)
+    {
+      return (uintptr_t)draw_a->texture_descriptor_set <
+                 (uintptr_t)draw_b->texture_descriptor_set
+               ? -1
+               : 1;
+    }
+
+    // Consecutive draws of the same batch keep its buffers bound
+    if (draw_a->sprite_batch != draw_b->sprite_batch)
+    {
+      return (uintptr_t)draw_a->sprite_batch < (uintptr_t)draw_b->sprite_batch ? -1 : 1;
+    }
+
+    if (draw_a->depth < draw_b->depth) { return -1; }
+    if (draw_a->depth > draw_b->depth) { return 1; }
+  }
+
+  // Queue order breaks ties, so qsort behaves as a stable sort
+  return (draw_a->index > draw_b->index) - (draw_a->index < draw_b->index);
+}
+
+/*
+  @brief Initialize draw queue state to default values.
+  @param draw_queue Draw queue to initialize.
+  @param host_allocator Host allocator to allocate draws with.
+*/
+inline static void moss__init_draw_queue_state (
+  Moss__DrawQueue *const     draw_queue,
+  Moss__HostAllocator *const host_allocator
+)
+{
+  *draw_queue = (Moss__DrawQueue){
+    .host_allocator = host_allocator,
+    .draws          = NULL,
+    .draw_count     = 0,
+    .draw_capacity  = 0,
+  };
+}
+
+/*
+  @brief Pushes draw to the queue.
+  @details Index of the draw is assigned by the queue.
+  @param draw_queue Draw queue.
+  @param draw Draw to push.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__push_queued_draw (
+  Moss__DrawQueue *const        draw_queue,
+  const Moss__QueuedDraw *const draw
+)
+{
+  if (draw_queue->draw_count == draw_queue->draw_capacity)
+  {
+    const size_t capacity =
+      draw_queue->draw_capacity == 0 ? 64 : draw_queue->draw_capacity * 2;
+
+    Moss__QueuedDraw *const draws = moss__reallocate (
+      draw_queue->host_allocator,
+      draw_queue->draws,
+      capacity * sizeof (Moss__QueuedDraw),
+      MOSS_ALLOCATION_CATEGORY_ENGINE
+    );
+    if (draws == NULL)
+    {
+      moss__error ("Failed to allocate memory for queued draws.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    draw_queue->draws         = draws;
+    draw_queue->draw_capacity = capacity;
+  }
+
+  Moss__QueuedDraw *const queued_draw = &draw_queue->draws[ draw_queue->draw_count ];
+
+  *queued_draw       = *draw;
+  queued_draw->index = (uint32_t)draw_queue->draw_count;
+
+  ++draw_queue->draw_count;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Sorts queued draws in the order they are recorded in.
+  @param draw_queue Draw queue.
+*/
+inline static void moss__sort_draw_queue (Moss__DrawQueue *const draw_queue)
+{
+  qsort (
+    draw_queue->draws,
+    draw_queue->draw_count,
+    sizeof (draw_queue->draws[ 0 ]),
+    moss__compare_queued_draws
+  );
+}
+
+/*
+  @brief Destroys draw queue.
+  @param draw_queue Draw queue to destroy.
+*/
+inline static void moss__destroy_draw_queue (Moss__DrawQueue *const draw_queue)
+{
+  moss__free (draw_queue->host_allocator, draw_queue->draws);
+  moss__init_draw_queue_state (draw_queue, draw_queue->host_allocator);
+}
@@ -20,15 +20,106 @@
 
 #pragma once
 
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
 #include <vulkan/vulkan.h>
 
 #include "moss/camera.h"
 #include "moss/engine.h"
+#include "moss/particle_system.h"
+#include "moss/sprite_batch.h"
+#include "moss/texture.h"
 
 #include "src/internal/camera.h"
 #include "src/internal/config.h"
+#include "src/internal/deletion_queue.h"
+#include "src/internal/draw_queue.h"
+#include "src/internal/frame_upload_queue.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+#include "src/internal/texture_index_pool.h"
+#include "src/internal/texture_loader.h"
+#include "src/internal/upload_queue.h"
+#include "src/internal/vulkan/utils/allocator.h"
 #include "src/internal/vulkan/utils/physical_device.h"
 
+/* Number of sprite batch materials, each has its own pipeline per batch mode. */
+#define MOSS__SPRITE_BATCH_MATERIAL_COUNT (size_t)(3)
+
+/*
+  @brief Command recorder state.
+  @details Main recorder of the engine records into the frame command buffer when
+           there are no other recorders, and into its own secondary buffer otherwise.
+*/
+struct MossCommandRecorder
+{
+  /* Engine the recorder belongs to. */
+  MossEngine *engine;
+  /* Command pools per frame in flight, VK_NULL_HANDLE for inline recording. */
+  VkCommandPool command_pools[ MAX_FRAMES_IN_FLIGHT ];
+  /* Secondary command buffers per frame in flight. */
+  VkCommandBuffer command_buffers[ MAX_FRAMES_IN_FLIGHT ];
+  /* Command buffer being recorded. */
+  VkCommandBuffer command_buffer;
+  /* Graphics pipeline currently bound to the command buffer. */
+  VkPipeline bound_pipeline;
+  /* Texture descriptor set currently bound to the command buffer. */
+  VkDescriptorSet bound_texture_descriptor_set;
+  /* Vertex buffer currently bound to the command buffer. */
+  VkBuffer bound_vertex_buffer;
+  /* Offset the vertex buffer is bound at. */
+  VkDeviceSize bound_vertex_buffer_offset;
+  /* Index buffer currently bound to the command buffer. */
+  VkBuffer bound_index_buffer;
+  /* Camera following draws are recorded with. */
+  const MossCamera *camera;
+  /* Copy of the camera viewport and view were last set from. */
+  MossCamera bound_camera;
+  /* Camera push constants last pushed to the command buffer. */
+  Moss__CameraPushConstants bound_push_constants;
+  /* Whether bound camera was pushed since recording began. */
+  bool is_camera_bound;
+  /* Whether draws are being recorded. */
+  bool is_recording;
+  /* Whether draws were recorded this frame and must be executed. */
+  bool is_recorded;
+  /* Number of draw calls recorded this frame. */
+  uint32_t draw_call_count;
+  /* Number of sprites drawn this frame. */
+  uint64_t sprite_count;
+  /* Draws sorted and recorded when recording ends. */
+  Moss__DrawQueue draw_queue;
+};
+
+/*
+  @brief Frame readback state.
+  @details Copy of the headless frame image is submitted right after the frame and
+           signals its own fence, so it's polled independently of later frames.
+*/
+struct MossFrameReadback
+{
+  /* Engine the readback belongs to. */
+  MossEngine *engine;
+  /* Host-visible buffer the frame image is copied to. */
+  VkBuffer buffer;
+  /* Memory allocation of the buffer. */
+  Moss__VkAllocation allocation;
+  /* Command buffer the copy is recorded into. */
+  VkCommandBuffer command_buffer;
+  /* Fence signaled once the copy completes. */
+  VkFence fence;
+  /* Index of the frame the image is copied from. */
+  uint64_t frame_index;
+  /* Index of the headless image the frame is rendered into. */
+  uint32_t image_index;
+  /* Whether the readback is requested and not released yet. */
+  bool is_in_use;
+  /* Whether the copy is submitted. */
+  bool is_submitted;
+};
+
 /*
   @brief Engine state.
 */
@@ -44,6 +135,12 @@ struct MossEngine
   /* Callback to get window framebuffer size. */
   MossGetWindowFramebufferSizeCallback get_window_framebuffer_size;
 
+  /* === Host memory === */
+  /* Host allocator every CPU allocation is made with. */
+  Moss__HostAllocator host_allocator;
+  /* Callbacks forwarding Vulkan host allocations to the host allocator. */
+  VkAllocationCallbacks vk_allocation_callbacks;
+
   /* === Vulkan instance and surface === */
   /* Vulkan instance. */
   VkInstance api_instance;
@@ -64,6 +161,10 @@ struct MossEngine
   /* Transfer queue. */
   VkQueue transfer_queue;
 
+  /* === Device memory === */
+  /* Allocator buffers and images are sub-allocated with. */
+  Moss__VkAllocator allocator;
+
   /* === Buffer sharing mode and queue family indices === */
   /* Buffer sharing mode for buffers shared between graphics and transfer queues. */
   VkSharingMode buffer_sharing_mode;
@@ -87,52 +188,175 @@ struct MossEngine
   VkImageView swapchain_image_views[ MAX_SWAPCHAIN_IMAGE_COUNT ];
   /* Swap chain framebuffers. */
   VkFramebuffer swapchain_framebuffers[ MAX_SWAPCHAIN_IMAGE_COUNT ];
+  /* Whether frames are rendered into engine-owned images instead of a surface.
+     Swap chain images, views and framebuffers refer to these images then. */
+  bool is_headless;
+  /* Memory allocations of headless images. */
+  Moss__VkAllocation headless_image_allocations[ MAX_SWAPCHAIN_IMAGE_COUNT ];
+  /* Present mode swap chains are created with if the surface supports it. */
+  VkPresentModeKHR preferred_present_mode;
+
+  /* === Frame pacing === */
+  /* Number of frames in flight, per-frame resources are created for these slots. */
+  uint32_t frames_in_flight_count;
+  /* Whether moss_begin_frame waits for the previous frame before recording. */
+  bool is_low_latency;
+  /* Whether present id and present wait extensions are enabled. */
+  bool is_present_wait_enabled;
+  /* vkWaitForPresentKHR loaded from the device, NULL without present wait. */
+  PFN_vkWaitForPresentKHR wait_for_present;
+  /* Present id of the last frame presented to the current swap chain, zero if none. */
+  uint64_t last_present_id;
+
+  /* === Frame readbacks === */
+  /* Readbacks of headless frame images. */
+  MossFrameReadback frame_readbacks[ MAX_FRAME_READBACK_COUNT ];
 
   /* === Render pipeline === */
   /* Render pass. */
   VkRenderPass render_pass;
-  /* Descriptor pool. */
-  VkDescriptorPool descriptor_pool;
-  /* Descriptor set. */
-  VkDescriptorSet descriptor_sets[ MAX_FRAMES_IN_FLIGHT ];
-  /* Descriptor set layout. */
-  VkDescriptorSetLayout descriptor_set_layout;
+  /* Descriptor pool texture descriptor sets are allocated from. */
+  VkDescriptorPool texture_descriptor_pool;
+  /* Layout of per-texture descriptor sets, or of the bindless texture array. */
+  VkDescriptorSetLayout texture_descriptor_set_layout;
+  /* Descriptor set holding the bindless texture array. */
+  VkDescriptorSet bindless_descriptor_set;
   /* Pipeline layout. */
   VkPipelineLayout pipeline_layout;
-  /* Graphics pipeline. */
-  VkPipeline graphics_pipeline;
+  /* Graphics pipelines per sprite batch material. */
+  VkPipeline graphics_pipelines[ MOSS__SPRITE_BATCH_MATERIAL_COUNT ];
+  /* Graphics pipelines for instanced sprite batches per material. */
+  VkPipeline instanced_graphics_pipelines[ MOSS__SPRITE_BATCH_MATERIAL_COUNT ];
+  /* Graphics pipelines for compact sprite batches per material. */
+  VkPipeline compact_graphics_pipelines[ MOSS__SPRITE_BATCH_MATERIAL_COUNT ];
+  /* Pipeline cache every pipeline is created through. */
+  VkPipelineCache pipeline_cache;
+  /* Path the pipeline cache is loaded from and saved to, NULL if not persisted. */
+  char *pipeline_cache_path;
+
+  /* === Sprite culling === */
+  /* Descriptor pool sprite batch culling sets are allocated from. */
+  VkDescriptorPool cull_descriptor_pool;
+  /* Layout of per-batch culling sets: sprites, visible sprites and draw command. */
+  VkDescriptorSetLayout cull_descriptor_set_layout;
+  /* Pipeline layout of culling compute pipelines. */
+  VkPipelineLayout cull_pipeline_layout;
+  /* Compute pipeline culling indexed sprite batches. */
+  VkPipeline cull_pipeline;
+  /* Compute pipeline culling instanced sprite batches. */
+  VkPipeline instanced_cull_pipeline;
+
+  /* === Sprite animation === */
+  /* Storage buffer of UV rects of all animation frames. */
+  VkBuffer animation_frame_buffer;
+  /* Animation frame buffer memory. */
+  Moss__VkAllocation animation_frame_buffer_allocation;
+  /* Storage buffer of animation clip records. */
+  VkBuffer animation_clip_buffer;
+  /* Animation clip buffer memory. */
+  Moss__VkAllocation animation_clip_buffer_allocation;
+  /* Number of registered animation frames. */
+  uint32_t animation_frame_count;
+  /* Number of registered animation clips. */
+  uint32_t animation_clip_count;
+  /* Descriptor pool the animation set is allocated from. */
+  VkDescriptorPool animation_descriptor_pool;
+  /* Layout of the animation set: frames and clips. */
+  VkDescriptorSetLayout animation_descriptor_set_layout;
+  /* Descriptor set bound to set 1 of every graphics pipeline. */
+  VkDescriptorSet animation_descriptor_set;
+  /* Clock time animation time is counted from, in nanoseconds. */
+  uint64_t animation_time_origin;
+  /* Animation time of the current frame in seconds. */
+  float animation_time;
+
+  /* === Tilemaps === */
+  /* Descriptor pool tilemap sets are allocated from. */
+  VkDescriptorPool tilemap_descriptor_pool;
+  /* Layout of per-tilemap sets holding the tile buffer. */
+  VkDescriptorSetLayout tilemap_descriptor_set_layout;
+  /* Graphics pipeline drawing tilemap chunks. */
+  VkPipeline tilemap_graphics_pipeline;
+
+  /* === Particle systems === */
+  /* Descriptor pool particle system sets are allocated from. */
+  VkDescriptorPool particle_descriptor_pool;
+  /* Layout of per-system sets: particles, instances and draw command. */
+  VkDescriptorSetLayout particle_descriptor_set_layout;
+  /* Pipeline layout of the particle compute pipeline. */
+  VkPipelineLayout particle_pipeline_layout;
+  /* Compute pipeline emitting and simulating particles. */
+  VkPipeline particle_pipeline;
+  /* Particle systems simulated in moss_begin_frame. */
+  MossParticleSystem *particle_systems;
 
   /* === Depth buffering === */
   /* Depth image. */
   VkImage depth_image;
   /* Depth image view. */
   VkImageView depth_image_view;
-  /* Depth image. */
-  VkDeviceMemory depth_image_memory;
-
-  /* === Texture image :3 === */
-  /* Texture image. */
-  VkImage texture_image;
-  /* Texture image view. */
-  VkImageView texture_image_view;
-  /* Texture image memory. */
-  VkDeviceMemory texture_image_memory;
-  /* Sampler. */
+  /* Depth image memory. */
+  Moss__VkAllocation depth_image_allocation;
+  /* Depth image extent, may exceed the swap chain extent after it shrinks. */
+  VkExtent2D depth_image_extent;
+
+  /* === Textures :3 === */
+  /* Whether textures are sampled from the bindless texture array. */
+  bool is_bindless;
+  /* Free slots of the bindless texture array. */
+  Moss__TextureIndexPool texture_index_pool;
+  /* Sampler shared by all textures. */
   VkSampler sampler;
-  /* Uniform buffers. */
-  VkBuffer       camera_ubo_buffers[ MAX_FRAMES_IN_FLIGHT ];
-  VkDeviceMemory camera_ubo_memories[ MAX_FRAMES_IN_FLIGHT ];
-  /* Uniform buffer mapped memory blocks. */
-  void *camera_ubo_buffer_mapped_memory_blocks[ MAX_FRAMES_IN_FLIGHT ];
+  /* 1x1 white texture used by sprite batches without a texture. */
+  MossTexture *default_texture;
+  /* Thread decoding asynchronously loaded textures. */
+  Moss__TextureLoader texture_loader;
+
+  /* === Shared quad index buffers === */
+  /* Index buffers with the quad index pattern shared by sprite batches,
+     16-bit one first and 32-bit one second. */
+  VkBuffer quad_index_buffers[ 2 ];
+  /* Quad index buffer memory. */
+  Moss__VkAllocation quad_index_buffer_allocations[ 2 ];
+  /* Number of sprites every quad index buffer holds indices for. */
+  size_t quad_index_capacities[ 2 ];
 
   /* === Command buffers === */
   /* General command pool. */
   VkCommandPool general_command_pool;
   /* Command buffers. */
   VkCommandBuffer general_command_buffers[ MAX_FRAMES_IN_FLIGHT ];
+  /* Command buffers culling is recorded to, submitted ahead of the frame ones. */
+  VkCommandBuffer cull_command_buffers[ MAX_FRAMES_IN_FLIGHT ];
+  /* Command buffers frame upload copies are recorded to, submitted first. */
+  VkCommandBuffer upload_command_buffers[ MAX_FRAMES_IN_FLIGHT ];
   /* Transfer command pool. */
   VkCommandPool transfer_command_pool;
 
+  /* === Command recorders === */
+  /* Recorder of moss_draw_sprite_batch. */
+  MossCommandRecorder main_recorder;
+  /* Recorders handed to worker threads. */
+  MossCommandRecorder command_recorders[ MOSS_MAX_COMMAND_RECORDER_COUNT ];
+  /* Number of recorders handed to worker threads. */
+  uint32_t command_recorder_count;
+  /* Guards cull command buffer, draws of different recorders may record culling. */
+  pthread_mutex_t cull_mutex;
+  /* Whether cull mutex is initialized. */
+  bool is_cull_mutex_initialized;
+
+  /* === Upload queue === */
+  /* Queue that batches transfers and signals a timeline semaphore. */
+  Moss__UploadQueue upload_queue;
+  /* Static sprite batches with sprite ranges updated since the last upload. */
+  MossSpriteBatch *updated_sprite_batches;
+  /* Buffer copies recorded ahead of the draws of the next submitted frame. */
+  Moss__FrameUploadQueue frame_upload_queue;
+
+  /* === Deletion queue === */
+  /* Resources waiting for frames in flight to stop using them. */
+  Moss__DeletionQueue deletion_queue;
+
   /* === Synchronization objects === */
   /* Image available semaphores. */
   VkSemaphore image_available_semaphores[ MAX_FRAMES_IN_FLIGHT ];
@@ -141,24 +365,96 @@ struct MossEngine
   /* In-flight fences. */
   VkFence in_flight_fences[ MAX_FRAMES_IN_FLIGHT ];
 
+  /* === Frame statistics === */
+  /* Render pass begin and end timestamps per frame slot, VK_NULL_HANDLE if the
+     graphics queue doesn't support timestamps. */
+  VkQueryPool timestamp_query_pool;
+  /* Nanoseconds per timestamp tick. */
+  float timestamp_period;
+  /* Mask of valid timestamp bits. */
+  uint64_t timestamp_mask;
+  /* Whether timestamps of each frame slot are written and not read back yet. */
+  bool are_timestamps_pending[ MAX_FRAMES_IN_FLIGHT ];
+  /* Statistics of the last ended frame. */
+  MossFrameStats frame_stats;
+  /* Statistics of the frame being recorded. */
+  MossFrameStats recording_frame_stats;
+  /* Upload byte counter at the previous frame end. */
+  uint64_t frame_upload_bytes_mark;
+
   /* === Frame state === */
   /* Current frame index. */
   uint32_t current_frame;
   /* Current swap chain image index (set by moss_begin_frame). */
   uint32_t current_image_index;
+  /* Number of submitted frames. */
+  uint64_t frame_count;
+  /* Frame count after the last submit of each frame slot. */
+  uint64_t in_flight_frame_counts[ MAX_FRAMES_IN_FLIGHT ];
+  /* Whether the frame is begun and its command buffer is being recorded. */
+  bool is_frame_begun;
+  /* Whether the frame cull command buffer is being recorded. */
+  bool is_cull_recording;
 };
 
+/*
+  @brief Initialize command recorder state to default values.
+  @param engine Engine the recorder belongs to.
+  @param recorder Command recorder.
+*/
+inline static void
+moss__init_command_recorder_state (MossEngine *engine, MossCommandRecorder *recorder)
+{
+  *recorder = (MossCommandRecorder){
+    .engine                       = engine,
+    .command_pools                = { VK_NULL_HANDLE, VK_NULL_HANDLE },
+    .command_buffers              = { VK_NULL_HANDLE, VK_NULL_HANDLE },
+    .command_buffer               = VK_NULL_HANDLE,
+    .bound_pipeline               = VK_NULL_HANDLE,
+    .bound_texture_descriptor_set = VK_NULL_HANDLE,
+    .bound_vertex_buffer          = VK_NULL_HANDLE,
+    .bound_vertex_buffer_offset   = 0,
+    .bound_index_buffer           = VK_NULL_HANDLE,
+    .camera                       = &engine->camera,
+    .bound_camera                 = { { 0 } },
+    .bound_push_constants         = { { 0 } },
+    .is_camera_bound              = false,
+    .is_recording                 = false,
+    .is_recorded                  = false,
+    .draw_call_count              = 0,
+    .sprite_count                 = 0,
+  };
+
+  moss__init_draw_queue_state (&recorder->draw_queue, &engine->host_allocator);
+}
+
+/*
+  @brief Initialize frame readback state to default values.
+  @param engine Engine the readback belongs to.
+  @param readback Frame readback.
+*/
+inline static void
+moss__init_frame_readback_state (MossEngine *engine, MossFrameReadback *readback)
+{
+  *readback = (MossFrameReadback){
+    .engine         = engine,
+    .buffer         = VK_NULL_HANDLE,
+    .allocation     = { 0 },
+    .command_buffer = VK_NULL_HANDLE,
+    .fence          = VK_NULL_HANDLE,
+    .frame_index    = 0,
+    .image_index    = 0,
+    .is_in_use      = false,
+    .is_submitted   = false,
+  };
+}
+
 /*
   @brief Initialize engine state to default values.
 */
 inline static void moss__init_engine_state (MossEngine *engine)
 {
   *engine = (MossEngine){
-    .camera = {
-      .scale  = {1, 1},
-      .offset = {0, 0},
-    },
-
     /* Metal layer. */
     .metal_layer = NULL,
     /* Framebuffer size callback. */
@@ -194,36 +490,389 @@ inline static void moss__init_engine_state (MossEngine *engine)
     .swapchain_extent            = (VkExtent2D) { .width = 0, .height = 0 },
     .swapchain_image_views       = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE },
     .swapchain_framebuffers      = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE },
+    .is_headless                 = false,
+    .headless_image_allocations  = { { 0 } },
+    .preferred_present_mode      = VK_PRESENT_MODE_MAILBOX_KHR,
+
+    /* Frame pacing. */
+    .frames_in_flight_count  = DEFAULT_FRAMES_IN_FLIGHT_COUNT,
+    .is_low_latency          = false,
+    .is_present_wait_enabled = false,
+    .wait_for_present        = NULL,
+    .last_present_id         = 0,
 
     /* Render pipeline. */
     .render_pass           = VK_NULL_HANDLE,
-    .descriptor_pool       = VK_NULL_HANDLE,
-    .descriptor_sets       = {VK_NULL_HANDLE, VK_NULL_HANDLE},
-    .descriptor_set_layout = VK_NULL_HANDLE,
+    .texture_descriptor_pool       = VK_NULL_HANDLE,
+    .texture_descriptor_set_layout = VK_NULL_HANDLE,
+    .bindless_descriptor_set       = VK_NULL_HANDLE,
     .pipeline_layout       = VK_NULL_HANDLE,
-    .graphics_pipeline     = VK_NULL_HANDLE,
+    .graphics_pipelines    = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE },
+    .instanced_graphics_pipelines = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE },
+    .compact_graphics_pipelines   = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE },
+    .pipeline_cache               = VK_NULL_HANDLE,
+    .pipeline_cache_path          = NULL,
+
+    /* Sprite culling. */
+    .cull_descriptor_pool       = VK_NULL_HANDLE,
+    .cull_descriptor_set_layout = VK_NULL_HANDLE,
+    .cull_pipeline_layout       = VK_NULL_HANDLE,
+    .cull_pipeline              = VK_NULL_HANDLE,
+    .instanced_cull_pipeline    = VK_NULL_HANDLE,
+
+    /* Sprite animation. */
+    .animation_frame_buffer            = VK_NULL_HANDLE,
+    .animation_frame_buffer_allocation = { 0 },
+    .animation_clip_buffer             = VK_NULL_HANDLE,
+    .animation_clip_buffer_allocation  = { 0 },
+    .animation_frame_count             = 0,
+    .animation_clip_count              = 0,
+    .animation_descriptor_pool         = VK_NULL_HANDLE,
+    .animation_descriptor_set_layout   = VK_NULL_HANDLE,
+    .animation_descriptor_set          = VK_NULL_HANDLE,
+    .animation_time_origin             = 0,
+    .animation_time                    = 0.0F,
+
+    /* Tilemaps. */
+    .tilemap_descriptor_pool       = VK_NULL_HANDLE,
+    .tilemap_descriptor_set_layout = VK_NULL_HANDLE,
+    .tilemap_graphics_pipeline     = VK_NULL_HANDLE,
+
+    /* Particle systems. */
+    .particle_descriptor_pool       = VK_NULL_HANDLE,
+    .particle_descriptor_set_layout = VK_NULL_HANDLE,
+    .particle_pipeline_layout       = VK_NULL_HANDLE,
+    .particle_pipeline              = VK_NULL_HANDLE,
+    .particle_systems               = NULL,
 
     /* Depth resources */
-    .depth_image        = VK_NULL_HANDLE,
-    .depth_image_view   = VK_NULL_HANDLE,
-    .depth_image_memory = VK_NULL_HANDLE,
+    .depth_image            = VK_NULL_HANDLE,
+    .depth_image_view       = VK_NULL_HANDLE,
+    .depth_image_allocation = { 0 },
+    .depth_image_extent     = (VkExtent2D) { .width = 0, .height = 0 },
+
+    /* Textures. */
+    .is_bindless     = false,
+    .sampler         = VK_NULL_HANDLE,
+    .default_texture = NULL,
 
-    /* Uniform buffers. */
-    .camera_ubo_buffers   = { VK_NULL_HANDLE, VK_NULL_HANDLE },
-    .camera_ubo_memories  = { VK_NULL_HANDLE, VK_NULL_HANDLE },
-    .camera_ubo_buffer_mapped_memory_blocks = { NULL, NULL },
+    /* Shared quad index buffers. */
+    .quad_index_buffers            = { VK_NULL_HANDLE, VK_NULL_HANDLE },
+    .quad_index_buffer_allocations = { { 0 }, { 0 } },
+    .quad_index_capacities         = { 0, 0 },
 
     /* Command buffers. */
     .general_command_pool    = VK_NULL_HANDLE,
     .general_command_buffers = { VK_NULL_HANDLE, VK_NULL_HANDLE },
+    .cull_command_buffers    = { VK_NULL_HANDLE, VK_NULL_HANDLE },
+    .upload_command_buffers  = { VK_NULL_HANDLE, VK_NULL_HANDLE },
+    .transfer_command_pool   = VK_NULL_HANDLE,
+
+    /* Command recorders. */
+    .command_recorder_count    = 0,
+    .is_cull_mutex_initialized = false,
+
+    /* Upload queue. */
+    .updated_sprite_batches = NULL,
 
     /* Synchronization objects. */
     .image_available_semaphores = { VK_NULL_HANDLE, VK_NULL_HANDLE },
     .render_finished_semaphores = { VK_NULL_HANDLE, VK_NULL_HANDLE },
     .in_flight_fences           = { VK_NULL_HANDLE, VK_NULL_HANDLE },
 
+    /* Frame statistics. */
+    .timestamp_query_pool    = VK_NULL_HANDLE,
+    .timestamp_period        = 0.0F,
+    .timestamp_mask          = 0,
+    .are_timestamps_pending  = { false, false },
+    .frame_stats             = { 0 },
+    .recording_frame_stats   = { 0 },
+    .frame_upload_bytes_mark = 0,
+
     /* Frame state. */
-    .current_frame      = 0,
+    .current_frame       = 0,
     .current_image_index = 0,
+    .frame_count         = 0,
+    .in_flight_frame_counts = { 0, 0 },
+    .is_frame_begun      = false,
+    .is_cull_recording   = false,
   };
+
+  moss__init_camera_state (&engine->camera);
+  moss_vk__init_allocator_state (&engine->allocator);
+  moss__init_upload_queue_state (&engine->upload_queue);
+  moss__init_frame_upload_queue_state (&engine->frame_upload_queue);
+  moss__init_deletion_queue_state (&engine->deletion_queue);
+  moss__init_texture_index_pool_state (&engine->texture_index_pool);
+  moss__init_texture_loader_state (&engine->texture_loader);
+
+  moss__init_command_recorder_state (engine, &engine->main_recorder);
+  for (uint32_t i = 0; i < MOSS_MAX_COMMAND_RECORDER_COUNT; ++i)
+  {
+    moss__init_command_recorder_state (engine, &engine->command_recorders[ i ]);
+  }
+
+  for (size_t i = 0; i < MAX_FRAME_READBACK_COUNT; ++i)
+  {
+    moss__init_frame_readback_state (engine, &engine->frame_readbacks[ i ]);
+  }
+}
+
+/*
+  @brief Binds graphics pipeline to the recorder command buffer.
+  @details Does nothing if the pipeline is already bound.
+  @param recorder Command recorder.
+  @param pipeline Graphics pipeline to bind.
+*/
+inline static void
+moss__bind_graphics_pipeline (MossCommandRecorder *recorder, VkPipeline pipeline)
+{
+  if (recorder->bound_pipeline == pipeline) { return; }
+
+  vkCmdBindPipeline (recorder->command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+  recorder->bound_pipeline = pipeline;
+}
+
+/*
+  @brief Binds texture descriptor set to the recorder command buffer.
+  @details Does nothing if the descriptor set is already bound. In bindless mode
+           every texture refers to the bindless set, so it's bound once per frame.
+  @param recorder Command recorder.
+  @param descriptor_set Texture descriptor set to bind.
+*/
+inline static void moss__bind_texture_descriptor_set (
+  MossCommandRecorder *recorder,
+  VkDescriptorSet      descriptor_set
+)
+{
+  if (recorder->bound_texture_descriptor_set == descriptor_set) { return; }
+
+  vkCmdBindDescriptorSets (
+    recorder->command_buffer,
+    VK_PIPELINE_BIND_POINT_GRAPHICS,
+    recorder->engine->pipeline_layout,
+    0,
+    1,
+    &descriptor_set,
+    0,
+    NULL
+  );
+  recorder->bound_texture_descriptor_set = descriptor_set;
+}
+
+/*
+  @brief Binds vertex buffer to the recorder command buffer.
+  @details Does nothing if the buffer is already bound at the same offset.
+  @param recorder Command recorder.
+  @param buffer Vertex buffer to bind.
+  @param offset Offset of vertex data in the buffer.
+*/
+inline static void moss__bind_vertex_buffer (
+  MossCommandRecorder *recorder,
+  VkBuffer             buffer,
+  VkDeviceSize         offset
+)
+{
+  if (recorder->bound_vertex_buffer == buffer &&
+      recorder->bound_vertex_buffer_offset == offset)
+  {
+    return;
+  }
+
+  vkCmdBindVertexBuffers (recorder->command_buffer, 0, 1, &buffer, &offset);
+  recorder->bound_vertex_buffer        = buffer;
+  recorder->bound_vertex_buffer_offset = offset;
+}
+
+/*
+  @brief Binds index buffer to the recorder command buffer.
+  @details Does nothing if the buffer is already bound. Every index buffer is only
+           ever bound with a single index type.
+  @param recorder Command recorder.
+  @param buffer Index buffer to bind.
+  @param index_type Type of indices in the buffer.
+*/
+inline static void moss__bind_index_buffer (
+  MossCommandRecorder *recorder,
+  VkBuffer             buffer,
+  VkIndexType          index_type
+)
+{
+  if (recorder->bound_index_buffer == buffer) { return; }
+
+  vkCmdBindIndexBuffer (recorder->command_buffer, buffer, 0, index_type);
+  recorder->bound_index_buffer = buffer;
+}
+
+/*
+  @brief Pushes camera of the recorder to its command buffer.
+  @details Does nothing if the same camera state is already pushed. Viewport and
+           scissor are set from the camera viewport whenever it changes.
+  @param recorder Command recorder.
+  @param push_constants Push constants derived from the recorder camera, NULL to
+                        push the camera as is.
+*/
+inline static void moss__bind_camera (
+  MossCommandRecorder             *recorder,
+  const Moss__CameraPushConstants *push_constants
+)
+{
+  const MossCamera *const camera = recorder->camera;
+
+  const bool is_viewport_changed =
+    !recorder->is_camera_bound ||
+    memcmp (
+      recorder->bound_camera.viewport_position,
+      camera->viewport_position,
+      sizeof (camera->viewport_position)
+    ) != 0 ||
+    memcmp (
+      recorder->bound_camera.viewport_size,
+      camera->viewport_size,
+      sizeof (camera->viewport_size)
+    ) != 0;
+
+  const Moss__CameraPushConstants camera_push_constants =
+    push_constants != NULL ? *push_constants : moss__get_camera_push_constants (camera);
+  const bool is_view_changed =
+    !recorder->is_camera_bound ||
+    memcmp (
+      &recorder->bound_push_constants,
+      &camera_push_constants,
+      sizeof (camera_push_constants)
+    ) != 0;
+
+  if (!is_viewport_changed && !is_view_changed) { return; }
+
+  const VkCommandBuffer command_buffer = recorder->command_buffer;
+  const VkExtent2D      extent         = recorder->engine->swapchain_extent;
+
+  if (is_viewport_changed)
+  {
+    const VkViewport viewport = {
+      .x        = camera->viewport_position[ 0 ] * (float)extent.width,
+      .y        = camera->viewport_position[ 1 ] * (float)extent.height,
+      .width    = camera->viewport_size[ 0 ] * (float)extent.width,
+      .height   = camera->viewport_size[ 1 ] * (float)extent.height,
+      .minDepth = 0.0F,
+      .maxDepth = 1.0F,
+    };
+
+    // Scissor keeps draws inside the viewport even when sprites leave clip space
+    const float min_x = viewport.x > 0.0F ? viewport.x : 0.0F;
+    const float min_y = viewport.y > 0.0F ? viewport.y : 0.0F;
+    const float max_x = viewport.x + viewport.width < (float)extent.width
+                          ? viewport.x + viewport.width
+                          : (float)extent.width;
+    const float max_y = viewport.y + viewport.height < (float)extent.height
+                          ? viewport.y + viewport.height
+                          : (float)extent.height;
+
+    const VkRect2D scissor = {
+      .offset = { (int32_t)min_x, (int32_t)min_y },
+      .extent = {
+        .width  = max_x > min_x ? (uint32_t)(max_x - min_x) : 0,
+        .height = max_y > min_y ? (uint32_t)(max_y - min_y) : 0,
+      },
+    };
+
+    vkCmdSetViewport (command_buffer, 0, 1, &viewport);
+    vkCmdSetScissor (command_buffer, 0, 1, &scissor);
+  }
+
+  if (is_view_changed)
+  {
+    vkCmdPushConstants (
+      command_buffer,
+      recorder->engine->pipeline_layout,
+      VK_SHADER_STAGE_VERTEX_BIT,
+      0,
+      sizeof (camera_push_constants),
+      &camera_push_constants
+    );
+  }
+
+  recorder->bound_camera         = *camera;
+  recorder->bound_push_constants = camera_push_constants;
+  recorder->is_camera_bound      = true;
+}
+
+/*
+  @brief Destroys resources once frames in flight and pending uploads stop using them.
+  @param engine Engine handle.
+  @param entry Resources to destroy, frame count and upload value are filled in.
+  @param upload_value Upload timeline value of the last upload that uses resources.
+*/
+inline static void moss__defer_deletion (
+  MossEngine *const                     engine,
+  const Moss__DeletionQueueEntry *const entry,
+  const uint64_t                        upload_value
+)
+{
+  Moss__DeletionQueueEntry deferred_entry = *entry;
+
+  // Frame being recorded may refer to the resources as well
+  deferred_entry.frame_count  = engine->frame_count + (engine->is_frame_begun ? 1 : 0);
+  deferred_entry.upload_value = upload_value;
+
+  // Upload that is not submitted yet would never complete otherwise
+  if (upload_value > engine->upload_queue.submitted_value)
+  {
+    moss__flush_upload_queue (&engine->upload_queue);
+  }
+
+  if (moss__push_deletion_queue_entry (&engine->deletion_queue, &deferred_entry) !=
+      MOSS_RESULT_SUCCESS)
+  {
+    moss__warning ("Failed to defer resource deletion, waiting for device.\n");
+    vkDeviceWaitIdle (engine->device);
+    moss__destroy_deletion_queue_entry (&engine->deletion_queue, &deferred_entry);
+  }
+}
+
+/*
+  @brief Takes staging memory for a copy recorded with the next submitted frame.
+  @details Staging of the current frame slot is reused only once the frame that
+           used the slot last time is finished, moss_begin_frame has already
+           waited for it if the frame is begun.
+  @param engine Engine handle.
+  @param size Size of the data in bytes.
+  @param out_buffer Output staging buffer to copy from.
+  @param out_offset Output offset of the data in staging buffer.
+  @param out_mapped_memory Output mapped memory to write the data to.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__allocate_frame_upload (
+  MossEngine *const   engine,
+  const VkDeviceSize  size,
+  VkBuffer *const     out_buffer,
+  VkDeviceSize *const out_offset,
+  void **const        out_mapped_memory
+)
+{
+  Moss__FrameUploadQueue *const frame_upload_queue = &engine->frame_upload_queue;
+
+  if (!frame_upload_queue->is_slot_ready)
+  {
+    if (!engine->is_frame_begun)
+    {
+      vkWaitForFences (
+        engine->device,
+        1,
+        &engine->in_flight_fences[ engine->current_frame ],
+        VK_TRUE,
+        UINT64_MAX
+      );
+    }
+
+    moss__begin_frame_upload_slot (frame_upload_queue, engine->current_frame);
+  }
+
+  return moss__allocate_frame_upload_memory (
+    frame_upload_queue,
+    size,
+    out_buffer,
+    out_offset,
+    out_mapped_memory
+  );
 }
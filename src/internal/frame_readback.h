@@ -0,0 +1,279 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/frame_readback.h
+  @brief Copies of headless frame images to host-visible memory.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Every readback owns a buffer sized for the headless extent, a command
+           buffer and a fence. Requested copies are submitted to the graphics queue
+           right after the frame they read, the render pass leaves headless images
+           in transfer source layout for them.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/engine.h"
+#include "moss/result.h"
+
+#include "src/internal/config.h"
+#include "src/internal/engine.h"
+#include "src/internal/log.h"
+#include "src/internal/memory_utils.h"
+#include "src/internal/vulkan/utils/buffer.h"
+
+/* Bytes per pixel of headless images. */
+#define MOSS__FRAME_READBACK_PIXEL_SIZE (uint32_t)(4)
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Creates buffers, command buffers and fences of frame readbacks.
+  @param engine Engine handle, headless images and general command pool must be
+                created.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_frame_readbacks (MossEngine *const engine)
+{
+  const VkDeviceSize size = (VkDeviceSize)engine->swapchain_extent.width *
+                            engine->swapchain_extent.height *
+                            MOSS__FRAME_READBACK_PIXEL_SIZE;
+
+  const VkMemoryPropertyFlags host_memory_properties =
+    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  const VkMemoryPropertyFlags cached_memory_properties =
+    host_memory_properties | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+
+  // Pixels are read by the CPU, cached memory makes that much faster
+  uint32_t   memory_type_index;
+  const bool has_cached_memory =
+    moss__select_suitable_memory_type (
+      engine->physical_device,
+      UINT32_MAX,
+      cached_memory_properties,
+      &memory_type_index
+    ) == MOSS_RESULT_SUCCESS;
+
+  const Moss__CreateVkBufferInfo buffer_info = {
+    .allocator         = &engine->allocator,
+    .device            = engine->device,
+    .size              = size,
+    .usage             = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+    .memory_properties = has_cached_memory ? cached_memory_properties
+                                           : host_memory_properties,
+    .sharing_mode                    = VK_SHARING_MODE_EXCLUSIVE,
+    .shared_queue_family_index_count = 0,
+    .shared_queue_family_indices     = NULL,
+  };
+
+  const VkCommandBufferAllocateInfo command_buffer_info = {
+    .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+    .commandPool        = engine->general_command_pool,
+    .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+    .commandBufferCount = 1,
+  };
+
+  const VkFenceCreateInfo fence_info = {
+    .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+  };
+
+  for (size_t i = 0; i < MAX_FRAME_READBACK_COUNT; ++i)
+  {
+    MossFrameReadback *const readback = &engine->frame_readbacks[ i ];
+
+    if (moss_vk__create_buffer (&buffer_info, &readback->buffer, &readback->allocation) !=
+        MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create frame readback buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    if (vkAllocateCommandBuffers (
+          engine->device,
+          &command_buffer_info,
+          &readback->command_buffer
+        ) != VK_SUCCESS)
+    {
+      moss__error ("Failed to allocate frame readback command buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    if (vkCreateFence (
+          engine->device,
+          &fence_info,
+          &engine->vk_allocation_callbacks,
+          &readback->fence
+        ) != VK_SUCCESS)
+    {
+      moss__error ("Failed to create frame readback fence.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Destroys buffers and fences of frame readbacks.
+  @details Command buffers are freed with the general command pool.
+  @param engine Engine handle, device must be idle.
+*/
+inline static void moss__destroy_frame_readbacks (MossEngine *const engine)
+{
+  for (size_t i = 0; i < MAX_FRAME_READBACK_COUNT; ++i)
+  {
+    MossFrameReadback *const readback = &engine->frame_readbacks[ i ];
+
+    if (readback->fence != VK_NULL_HANDLE)
+    {
+      vkDestroyFence (engine->device, readback->fence, &engine->vk_allocation_callbacks);
+    }
+
+    moss_vk__destroy_buffer (&engine->allocator, readback->buffer, &readback->allocation);
+
+    moss__init_frame_readback_state (engine, readback);
+  }
+}
+
+/*
+  @brief Records frame readback copy.
+  @param engine Engine handle.
+  @param readback Frame readback to record the copy of.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__record_frame_readback (
+  const MossEngine *const  engine,
+  MossFrameReadback *const readback
+)
+{
+  const VkCommandBuffer command_buffer = readback->command_buffer;
+
+  vkResetCommandBuffer (command_buffer, 0);
+
+  const VkCommandBufferBeginInfo begin_info = {
+    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+    .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  if (vkBeginCommandBuffer (command_buffer, &begin_info) != VK_SUCCESS)
+  {
+    moss__error ("Failed to begin frame readback command buffer.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Render pass dependency orders the copy after color writes of the frame
+  const VkBufferImageCopy copy_region = {
+    .bufferOffset      = 0,
+    .bufferRowLength   = 0,
+    .bufferImageHeight = 0,
+    .imageSubresource  = {
+      .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+      .mipLevel       = 0,
+      .baseArrayLayer = 0,
+      .layerCount     = 1,
+    },
+    .imageOffset = { 0, 0, 0 },
+    .imageExtent = {
+      .width  = engine->swapchain_extent.width,
+      .height = engine->swapchain_extent.height,
+      .depth  = 1,
+    },
+  };
+  vkCmdCopyImageToBuffer (
+    command_buffer,
+    engine->swapchain_images[ readback->image_index ],
+    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+    readback->buffer,
+    1,
+    &copy_region
+  );
+
+  // Make the copy visible to host reads after the fence is signaled
+  const VkBufferMemoryBarrier barrier = {
+    .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+    .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+    .dstAccessMask       = VK_ACCESS_HOST_READ_BIT,
+    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+    .buffer              = readback->buffer,
+    .offset              = 0,
+    .size                = VK_WHOLE_SIZE,
+  };
+  vkCmdPipelineBarrier (
+    command_buffer,
+    VK_PIPELINE_STAGE_TRANSFER_BIT,
+    VK_PIPELINE_STAGE_HOST_BIT,
+    0,
+    0,
+    NULL,
+    1,
+    &barrier,
+    0,
+    NULL
+  );
+
+  if (vkEndCommandBuffer (command_buffer) != VK_SUCCESS)
+  {
+    moss__error ("Failed to end frame readback command buffer.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Submits copies of readbacks requested in the current frame.
+  @param engine Engine handle, frame commands must be submitted already.
+  @param frame_index Index of the submitted frame.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__submit_frame_readbacks (MossEngine *const engine, const uint64_t frame_index)
+{
+  for (size_t i = 0; i < MAX_FRAME_READBACK_COUNT; ++i)
+  {
+    MossFrameReadback *const readback = &engine->frame_readbacks[ i ];
+    if (!readback->is_in_use || readback->is_submitted) { continue; }
+    if (readback->frame_index != frame_index) { continue; }
+
+    if (moss__record_frame_readback (engine, readback) != MOSS_RESULT_SUCCESS)
+    {
+      return MOSS_RESULT_ERROR;
+    }
+
+    vkResetFences (engine->device, 1, &readback->fence);
+
+    const VkSubmitInfo submit_info = {
+      .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .commandBufferCount = 1,
+      .pCommandBuffers    = &readback->command_buffer,
+    };
+    if (vkQueueSubmit (engine->graphics_queue, 1, &submit_info, readback->fence) !=
+        VK_SUCCESS)
+    {
+      moss__error ("Failed to submit frame readback.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    readback->is_submitted = true;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
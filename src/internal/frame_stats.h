@@ -0,0 +1,208 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/frame_stats.h
+  @brief GPU timestamps and counters of frame statistics.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Every frame slot owns two timestamp queries written around the render
+           pass. They are read back once the slot fence is waited in
+           moss_begin_frame, so reading never stalls and lags frames in flight
+           count frames behind.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/engine.h"
+#include "moss/result.h"
+
+#include "src/internal/clock.h"
+#include "src/internal/config.h"
+#include "src/internal/engine.h"
+#include "src/internal/log.h"
+
+/* Number of timestamp queries per frame slot. */
+#define MOSS__FRAME_TIMESTAMP_COUNT (uint32_t)(2)
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Creates timestamp query pool if the graphics queue supports timestamps.
+  @details Missing support isn't an error, GPU time is just never reported then.
+  @param engine Engine handle, logical device must be created.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_timestamp_query_pool (MossEngine *const engine)
+{
+  uint32_t queue_family_count = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties (
+    engine->physical_device,
+    &queue_family_count,
+    NULL
+  );
+
+  VkQueueFamilyProperties queue_families[ queue_family_count ];
+  vkGetPhysicalDeviceQueueFamilyProperties (
+    engine->physical_device,
+    &queue_family_count,
+    queue_families
+  );
+
+  const uint32_t valid_bits =
+    queue_families[ engine->queue_family_indices.graphics_family ].timestampValidBits;
+  if (valid_bits == 0)
+  {
+    moss__info ("Graphics queue doesn't support timestamps, GPU time isn't reported.\n");
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  VkPhysicalDeviceProperties device_properties;
+  vkGetPhysicalDeviceProperties (engine->physical_device, &device_properties);
+
+  engine->timestamp_period = device_properties.limits.timestampPeriod;
+  engine->timestamp_mask =
+    valid_bits >= 64 ? UINT64_MAX : (UINT64_C (1) << valid_bits) - UINT64_C (1);
+
+  const VkQueryPoolCreateInfo create_info = {
+    .sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+    .queryType  = VK_QUERY_TYPE_TIMESTAMP,
+    .queryCount = MOSS__FRAME_TIMESTAMP_COUNT * engine->frames_in_flight_count,
+  };
+
+  const VkResult result = vkCreateQueryPool (
+    engine->device,
+    &create_info,
+    &engine->vk_allocation_callbacks,
+    &engine->timestamp_query_pool
+  );
+  if (result != VK_SUCCESS)
+  {
+    moss__error ("Failed to create timestamp query pool. Error code: %d.\n", result);
+    return MOSS_RESULT_ERROR;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Reads back timestamps the frame slot wrote last time.
+  @details Slot fence must be waited, results are available then and reading them
+           doesn't wait. GPU time of the stats is kept if there is nothing to read.
+  @param engine Engine handle.
+  @param stats Frame statistics to store GPU time to.
+*/
+inline static void
+moss__read_frame_timestamps (MossEngine *const engine, MossFrameStats *const stats)
+{
+  const uint32_t slot = engine->current_frame;
+  if (!engine->are_timestamps_pending[ slot ]) { return; }
+
+  engine->are_timestamps_pending[ slot ] = false;
+
+  uint64_t timestamps[ MOSS__FRAME_TIMESTAMP_COUNT ];
+  const VkResult result = vkGetQueryPoolResults (
+    engine->device,
+    engine->timestamp_query_pool,
+    slot * MOSS__FRAME_TIMESTAMP_COUNT,
+    MOSS__FRAME_TIMESTAMP_COUNT,
+    sizeof (timestamps),
+    timestamps,
+    sizeof (timestamps[ 0 ]),
+    VK_QUERY_RESULT_64_BIT
+  );
+  if (result != VK_SUCCESS) { return; }
+
+  // Masked difference stays correct when the counter wraps around
+  const uint64_t ticks = (timestamps[ 1 ] - timestamps[ 0 ]) & engine->timestamp_mask;
+
+  stats->has_gpu_time    = true;
+  stats->gpu_frame_index = engine->in_flight_frame_counts[ slot ];
+  stats->gpu_render_ms   = (double)ticks * (double)engine->timestamp_period / 1000000.0;
+}
+
+/*
+  @brief Records render pass begin timestamp of the current frame.
+  @param engine Engine handle.
+  @param command_buffer Frame command buffer, render pass must not be begun yet.
+*/
+inline static void moss__write_frame_begin_timestamp (
+  MossEngine *const     engine,
+  const VkCommandBuffer command_buffer
+)
+{
+  if (engine->timestamp_query_pool == VK_NULL_HANDLE) { return; }
+
+  const uint32_t first_query = engine->current_frame * MOSS__FRAME_TIMESTAMP_COUNT;
+
+  vkCmdResetQueryPool (
+    command_buffer,
+    engine->timestamp_query_pool,
+    first_query,
+    MOSS__FRAME_TIMESTAMP_COUNT
+  );
+  vkCmdWriteTimestamp (
+    command_buffer,
+    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+    engine->timestamp_query_pool,
+    first_query
+  );
+}
+
+/*
+  @brief Records render pass end timestamp of the current frame.
+  @param engine Engine handle.
+  @param command_buffer Frame command buffer, render pass must be ended.
+*/
+inline static void moss__write_frame_end_timestamp (
+  MossEngine *const     engine,
+  const VkCommandBuffer command_buffer
+)
+{
+  if (engine->timestamp_query_pool == VK_NULL_HANDLE) { return; }
+
+  vkCmdWriteTimestamp (
+    command_buffer,
+    VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+    engine->timestamp_query_pool,
+    engine->current_frame * MOSS__FRAME_TIMESTAMP_COUNT + 1
+  );
+}
+
+/*
+  @brief Sums draw counters of command recorders into frame statistics.
+  @param engine Engine handle.
+  @param stats Frame statistics to store counters to.
+*/
+inline static void
+moss__collect_recorder_counters (const MossEngine *const engine, MossFrameStats *stats)
+{
+  stats->draw_call_count = engine->main_recorder.draw_call_count;
+  stats->sprite_count    = engine->main_recorder.sprite_count;
+
+  for (uint32_t i = 0; i < engine->command_recorder_count; ++i)
+  {
+    const MossCommandRecorder *const recorder = &engine->command_recorders[ i ];
+    if (!recorder->is_recorded) { continue; }
+
+    stats->draw_call_count += recorder->draw_call_count;
+    stats->sprite_count += recorder->sprite_count;
+  }
+}
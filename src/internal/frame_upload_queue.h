@@ -0,0 +1,572 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/frame_upload_queue.h
+  @brief Per-frame buffer copies recorded ahead of the frame draws.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Small updates of buffers that frames in flight read are copied on the
+           graphics queue in the frame's own submit instead of the upload queue.
+           Barriers of the copy command buffer order the copies after earlier frames
+           and before the frame draws, so nothing waits for frames in flight.
+           Every frame slot has its own host-visible staging buffer, which is
+           reused once the slot fence proves its previous frame is finished.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/result.h"
+
+#include "src/internal/config.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+#include "src/internal/vulkan/utils/allocator.h"
+#include "src/internal/vulkan/utils/buffer.h"
+
+/* Alignment of staged data offsets, keeps vector stores into staging aligned. */
+#define MOSS__FRAME_UPLOAD_ALIGNMENT (VkDeviceSize)(16)
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Buffer copy recorded with the next submitted frame.
+*/
+typedef struct
+{
+  VkBuffer     source_buffer;      /* Buffer to copy from. */
+  VkBuffer     destination_buffer; /* Buffer to copy to. */
+  VkBufferCopy region;             /* Copied region. */
+} Moss__FrameUploadCopy;
+
+/*
+  @brief Staging buffer outgrown while its frame slot was being filled.
+*/
+typedef struct
+{
+  uint32_t           slot;       /* Frame slot whose next reuse frees the buffer. */
+  VkBuffer           buffer;     /* Staging buffer. */
+  Moss__VkAllocation allocation; /* Staging buffer memory. */
+} Moss__FrameUploadRetiredBuffer;
+
+/*
+  @brief Frame upload queue state.
+*/
+typedef struct
+{
+  /* Logical device. */
+  VkDevice device;
+  /* Allocator staging buffers are allocated with. */
+  Moss__VkAllocator *allocator;
+  /* Staging buffer of every frame slot. */
+  VkBuffer buffers[ MAX_FRAMES_IN_FLIGHT ];
+  /* Staging buffer memory of every frame slot. */
+  Moss__VkAllocation allocations[ MAX_FRAMES_IN_FLIGHT ];
+  /* Size of staging buffer of every frame slot. */
+  VkDeviceSize capacities[ MAX_FRAMES_IN_FLIGHT ];
+  /* Frame slot data is currently staged for. */
+  uint32_t slot;
+  /* Whether previous frame of the slot is finished and its staging is reset. */
+  bool is_slot_ready;
+  /* Bytes of the slot staging buffer taken by staged data. */
+  VkDeviceSize used_size;
+  /* Copies waiting for the next submitted frame. */
+  Moss__FrameUploadCopy *copies;
+  /* Number of waiting copies. */
+  size_t copy_count;
+  /* Capacity of copy array. */
+  size_t copy_capacity;
+  /* Outgrown staging buffers waiting for their slot to be reused. */
+  Moss__FrameUploadRetiredBuffer *retired_buffers;
+  /* Number of outgrown staging buffers. */
+  size_t retired_buffer_count;
+  /* Capacity of outgrown staging buffer array. */
+  size_t retired_buffer_capacity;
+} Moss__FrameUploadQueue;
+
+/*
+  @brief Required info to create frame upload queue.
+*/
+typedef struct
+{
+  VkDevice                device;                 /* Logical device. */
+  Moss__VkAllocator      *allocator;              /* Allocator for staging buffers. */
+  Moss__FrameUploadQueue *out_frame_upload_queue; /* Frame upload queue to initialize. */
+} Moss__CreateFrameUploadQueueInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Initializes frame upload queue with empty state.
+  @param frame_upload_queue Frame upload queue to initialize.
+*/
+inline static void
+moss__init_frame_upload_queue_state (Moss__FrameUploadQueue *const frame_upload_queue)
+{
+  memset (frame_upload_queue, 0, sizeof (*frame_upload_queue));
+  frame_upload_queue->device = VK_NULL_HANDLE;
+}
+
+/*
+  @brief Creates frame upload queue.
+  @details Staging buffers are created on the first staged data of every slot.
+  @param info Required info to create frame upload queue.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__create_frame_upload_queue (const Moss__CreateFrameUploadQueueInfo *const info)
+{
+  Moss__FrameUploadQueue *const frame_upload_queue = info->out_frame_upload_queue;
+
+  moss__init_frame_upload_queue_state (frame_upload_queue);
+  frame_upload_queue->device    = info->device;
+  frame_upload_queue->allocator = info->allocator;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Starts staging data for a frame slot.
+  @details Frees staging buffers the slot outgrew during its previous frame.
+  @param frame_upload_queue Frame upload queue.
+  @param slot Frame slot, its previous frame must be finished.
+*/
+inline static void moss__begin_frame_upload_slot (
+  Moss__FrameUploadQueue *const frame_upload_queue,
+  const uint32_t                slot
+)
+{
+  size_t kept_count = 0;
+  for (size_t i = 0; i < frame_upload_queue->retired_buffer_count; ++i)
+  {
+    Moss__FrameUploadRetiredBuffer retired = frame_upload_queue->retired_buffers[ i ];
+    if (retired.slot == slot)
+    {
+      moss_vk__destroy_buffer (
+        frame_upload_queue->allocator,
+        retired.buffer,
+        &retired.allocation
+      );
+    }
+    else {
+      frame_upload_queue->retired_buffers[ kept_count++ ] = retired;
+    }
+  }
+  frame_upload_queue->retired_buffer_count = kept_count;
+
+  frame_upload_queue->slot          = slot;
+  frame_upload_queue->used_size     = 0;
+  frame_upload_queue->is_slot_ready = true;
+}
+
+/*
+  @brief Retires staging buffer of the current slot until the slot is reused.
+  @param frame_upload_queue Frame upload queue.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__retire_frame_upload_buffer (Moss__FrameUploadQueue *const frame_upload_queue)
+{
+  const uint32_t slot = frame_upload_queue->slot;
+
+  if (frame_upload_queue->retired_buffer_count ==
+      frame_upload_queue->retired_buffer_capacity)
+  {
+    const size_t capacity = frame_upload_queue->retired_buffer_capacity == 0
+                              ? 4
+                              : frame_upload_queue->retired_buffer_capacity * 2;
+
+    Moss__FrameUploadRetiredBuffer *const retired_buffers = moss__reallocate (
+      frame_upload_queue->allocator->host_allocator,
+      frame_upload_queue->retired_buffers,
+      capacity * sizeof (Moss__FrameUploadRetiredBuffer),
+      MOSS_ALLOCATION_CATEGORY_ENGINE
+    );
+    if (retired_buffers == NULL)
+    {
+      moss__error ("Failed to allocate memory for retired frame upload buffers.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    frame_upload_queue->retired_buffers         = retired_buffers;
+    frame_upload_queue->retired_buffer_capacity = capacity;
+  }
+
+  frame_upload_queue->retired_buffers[ frame_upload_queue->retired_buffer_count++ ] =
+    (Moss__FrameUploadRetiredBuffer) {
+      .slot       = slot,
+      .buffer     = frame_upload_queue->buffers[ slot ],
+      .allocation = frame_upload_queue->allocations[ slot ],
+    };
+
+  frame_upload_queue->buffers[ slot ]     = VK_NULL_HANDLE;
+  frame_upload_queue->allocations[ slot ] = (Moss__VkAllocation) { 0 };
+  frame_upload_queue->capacities[ slot ]  = 0;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Takes staging memory of the current slot.
+  @details Staging buffer that can't fit the data is retired and replaced with one
+           at least twice as large, data staged before stays where it is.
+  @param frame_upload_queue Frame upload queue, current slot must be ready.
+  @param size Size of the data in bytes.
+  @param out_buffer Output staging buffer to copy from.
+  @param out_offset Output offset of the data in staging buffer.
+  @param out_mapped_memory Output mapped memory to write the data to.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__allocate_frame_upload_memory (
+  Moss__FrameUploadQueue *const frame_upload_queue,
+  const VkDeviceSize            size,
+  VkBuffer *const               out_buffer,
+  VkDeviceSize *const           out_offset,
+  void **const                  out_mapped_memory
+)
+{
+  const uint32_t slot = frame_upload_queue->slot;
+
+  VkDeviceSize offset =
+    (frame_upload_queue->used_size + MOSS__FRAME_UPLOAD_ALIGNMENT - 1) &
+    ~(MOSS__FRAME_UPLOAD_ALIGNMENT - 1);
+
+  if (offset + size > frame_upload_queue->capacities[ slot ])
+  {
+    if (frame_upload_queue->buffers[ slot ] != VK_NULL_HANDLE &&
+        moss__retire_frame_upload_buffer (frame_upload_queue) != MOSS_RESULT_SUCCESS)
+    {
+      return MOSS_RESULT_ERROR;
+    }
+
+    VkDeviceSize capacity = frame_upload_queue->capacities[ slot ] * 2;
+    if (capacity < FRAME_UPLOAD_BUFFER_INITIAL_SIZE)
+    {
+      capacity = FRAME_UPLOAD_BUFFER_INITIAL_SIZE;
+    }
+    while (capacity < size) { capacity *= 2; }
+
+    // Copies run on the graphics queue only
+    const Moss__CreateVkBufferInfo create_info = {
+      .allocator       = frame_upload_queue->allocator,
+      .device          = frame_upload_queue->device,
+      .size            = capacity,
+      .usage           = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      .memory_properties =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      .sharing_mode                    = VK_SHARING_MODE_EXCLUSIVE,
+      .shared_queue_family_index_count = 0,
+      .shared_queue_family_indices     = NULL,
+    };
+    if (moss_vk__create_buffer (
+          &create_info,
+          &frame_upload_queue->buffers[ slot ],
+          &frame_upload_queue->allocations[ slot ]
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create frame upload staging buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    frame_upload_queue->capacities[ slot ] = capacity;
+    offset                                 = 0;
+  }
+
+  frame_upload_queue->used_size = offset + size;
+
+  *out_buffer        = frame_upload_queue->buffers[ slot ];
+  *out_offset        = offset;
+  *out_mapped_memory = (char *)frame_upload_queue->allocations[ slot ].mapped_memory +
+                       (size_t)offset;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Pushes copy recorded with the next submitted frame.
+  @param frame_upload_queue Frame upload queue.
+  @param copy Copy to push.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__push_frame_upload_copy (
+  Moss__FrameUploadQueue *const      frame_upload_queue,
+  const Moss__FrameUploadCopy *const copy
+)
+{
+  if (frame_upload_queue->copy_count == frame_upload_queue->copy_capacity)
+  {
+    const size_t capacity = frame_upload_queue->copy_capacity == 0
+                              ? 16
+                              : frame_upload_queue->copy_capacity * 2;
+
+    Moss__FrameUploadCopy *const copies = moss__reallocate (
+      frame_upload_queue->allocator->host_allocator,
+      frame_upload_queue->copies,
+      capacity * sizeof (Moss__FrameUploadCopy),
+      MOSS_ALLOCATION_CATEGORY_ENGINE
+    );
+    if (copies == NULL)
+    {
+      moss__error ("Failed to allocate memory for frame upload copies.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    frame_upload_queue->copies        = copies;
+    frame_upload_queue->copy_capacity = capacity;
+  }
+
+  frame_upload_queue->copies[ frame_upload_queue->copy_count++ ] = *copy;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Drops waiting copies into a buffer that is about to be destroyed.
+  @param frame_upload_queue Frame upload queue.
+  @param destination_buffer Destination buffer of copies to drop.
+*/
+inline static void moss__discard_frame_upload_copies (
+  Moss__FrameUploadQueue *const frame_upload_queue,
+  const VkBuffer                destination_buffer
+)
+{
+  size_t kept_count = 0;
+  for (size_t i = 0; i < frame_upload_queue->copy_count; ++i)
+  {
+    if (frame_upload_queue->copies[ i ].destination_buffer != destination_buffer)
+    {
+      frame_upload_queue->copies[ kept_count++ ] = frame_upload_queue->copies[ i ];
+    }
+  }
+  frame_upload_queue->copy_count = kept_count;
+}
+
+/*
+  @brief Checks whether a waiting copy writes bytes an earlier one writes as well.
+  @details Copies recorded without a barrier in between run in any order, so a
+           copy that overlaps one of them must wait for it to keep the newer data.
+  @param copies Waiting copies in push order.
+  @param first_copy Index of the first copy recorded after the last barrier.
+  @param copy_index Index of the copy to check.
+  @return Returns true if the copy overlaps any copy in [first_copy, copy_index)
+          with the same destination buffer, false otherwise.
+*/
+inline static bool moss__does_frame_upload_copy_overlap (
+  const Moss__FrameUploadCopy *const copies,
+  const size_t                       first_copy,
+  const size_t                       copy_index
+)
+{
+  const Moss__FrameUploadCopy *const copy = &copies[ copy_index ];
+  for (size_t i = first_copy; i < copy_index; ++i)
+  {
+    if (copies[ i ].destination_buffer != copy->destination_buffer) { continue; }
+
+    const VkBufferCopy *const region = &copies[ i ].region;
+    if (region->dstOffset < copy->region.dstOffset + copy->region.size &&
+        copy->region.dstOffset < region->dstOffset + region->size)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*
+  @brief Records waiting copies along with the barriers that order them.
+  @details First barrier makes copies wait until earlier frames stop reading and
+           writing copied buffers, the last one makes copied data visible to vertex
+           input, shaders and culling of the frame. Copies that overwrite bytes of
+           earlier copies of the frame are recorded behind a barrier, so the newest
+           data lands last.
+  @param frame_upload_queue Frame upload queue.
+  @param command_buffer Command buffer in recording state, submitted ahead of the
+                        frame command buffers.
+*/
+inline static void moss__record_frame_upload_copies (
+  Moss__FrameUploadQueue *const frame_upload_queue,
+  const VkCommandBuffer         command_buffer
+)
+{
+  static const VkPipelineStageFlags read_stages =
+    VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+    VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+  // Copies of earlier frames write the same buffers
+  const VkMemoryBarrier start_barrier = {
+    .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+    .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+    .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+  };
+
+  vkCmdPipelineBarrier (
+    command_buffer,
+    read_stages | VK_PIPELINE_STAGE_TRANSFER_BIT,
+    VK_PIPELINE_STAGE_TRANSFER_BIT,
+    0,
+    1,
+    &start_barrier,
+    0,
+    NULL,
+    0,
+    NULL
+  );
+
+  // Full refill followed by an update of the same batch, or overlapping tile rects,
+  // write the same bytes within a frame
+  const VkMemoryBarrier overwrite_barrier = {
+    .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+    .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+    .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+  };
+
+  // Consecutive copies between the same buffers go in a single command
+  const Moss__FrameUploadCopy *const copies = frame_upload_queue->copies;
+  const size_t                       copy_count   = frame_upload_queue->copy_count;
+  VkBufferCopy                       regions[ 16 ];
+  uint32_t                           region_count = 0;
+  size_t                             first_copy   = 0;
+  for (size_t i = 0; i < copy_count; ++i)
+  {
+    const bool is_overlapping =
+      moss__does_frame_upload_copy_overlap (copies, first_copy, i);
+
+    if (region_count > 0 &&
+        (is_overlapping || region_count == sizeof (regions) / sizeof (regions[ 0 ]) ||
+         copies[ i ].source_buffer != copies[ i - 1 ].source_buffer ||
+         copies[ i ].destination_buffer != copies[ i - 1 ].destination_buffer))
+    {
+      vkCmdCopyBuffer (
+        command_buffer,
+        copies[ i - 1 ].source_buffer,
+        copies[ i - 1 ].destination_buffer,
+        region_count,
+        regions
+      );
+      region_count = 0;
+    }
+
+    if (is_overlapping)
+    {
+      vkCmdPipelineBarrier (
+        command_buffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        1,
+        &overwrite_barrier,
+        0,
+        NULL,
+        0,
+        NULL
+      );
+      first_copy = i;
+    }
+
+    regions[ region_count++ ] = copies[ i ].region;
+  }
+
+  if (region_count > 0)
+  {
+    vkCmdCopyBuffer (
+      command_buffer,
+      copies[ copy_count - 1 ].source_buffer,
+      copies[ copy_count - 1 ].destination_buffer,
+      region_count,
+      regions
+    );
+  }
+
+  const VkMemoryBarrier end_barrier = {
+    .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+    .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+    .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT |
+                     VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+  };
+
+  vkCmdPipelineBarrier (
+    command_buffer,
+    VK_PIPELINE_STAGE_TRANSFER_BIT,
+    read_stages,
+    0,
+    1,
+    &end_barrier,
+    0,
+    NULL,
+    0,
+    NULL
+  );
+
+  frame_upload_queue->copy_count = 0;
+}
+
+/*
+  @brief Ends staging data for the current slot.
+  @details Called once the frame of the slot is submitted, the slot is reset again
+           when its fence proves that frame is finished.
+  @param frame_upload_queue Frame upload queue.
+*/
+inline static void
+moss__end_frame_upload_slot (Moss__FrameUploadQueue *const frame_upload_queue)
+{
+  frame_upload_queue->is_slot_ready = false;
+}
+
+/*
+  @brief Destroys frame upload queue and its staging buffers.
+  @details Device must be idle.
+  @param frame_upload_queue Frame upload queue to destroy.
+*/
+inline static void
+moss__destroy_frame_upload_queue (Moss__FrameUploadQueue *const frame_upload_queue)
+{
+  if (frame_upload_queue->device == VK_NULL_HANDLE) { return; }
+
+  for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+  {
+    moss_vk__destroy_buffer (
+      frame_upload_queue->allocator,
+      frame_upload_queue->buffers[ i ],
+      &frame_upload_queue->allocations[ i ]
+    );
+  }
+
+  for (size_t i = 0; i < frame_upload_queue->retired_buffer_count; ++i)
+  {
+    moss_vk__destroy_buffer (
+      frame_upload_queue->allocator,
+      frame_upload_queue->retired_buffers[ i ].buffer,
+      &frame_upload_queue->retired_buffers[ i ].allocation
+    );
+  }
+
+  Moss__HostAllocator *const host_allocator =
+    frame_upload_queue->allocator->host_allocator;
+  moss__free (host_allocator, frame_upload_queue->copies);
+  moss__free (host_allocator, frame_upload_queue->retired_buffers);
+
+  moss__init_frame_upload_queue_state (frame_upload_queue);
+}
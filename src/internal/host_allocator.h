@@ -0,0 +1,500 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/host_allocator.h
+  @brief Host memory allocation through the user allocator with counters.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Every allocation is prefixed with a header holding its size, category
+           and offset from the memory the user allocator returned. Frees and
+           reallocations read sizes back from it, so counters stay exact even for
+           Vulkan, whose free callback doesn't pass a size. Alignments stricter
+           than malloc one are made by over-allocating.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/engine.h"
+
+#include "src/internal/atomic.h"
+
+/* Alignment of memory the user allocator returns, also size of the header slot. */
+#define MOSS__HOST_ALLOCATION_ALIGNMENT (size_t)(16)
+
+/*
+  @brief Header stored right before every host allocation.
+*/
+typedef struct
+{
+  size_t   size;     /* Requested size in bytes. */
+  uint32_t category; /* Allocation category. */
+  uint32_t offset;   /* Offset from the memory returned by the user allocator. */
+} Moss__HostAllocationHeader;
+
+/*
+  @brief Host allocator.
+  @details Counters are updated atomically, allocations are made from the texture
+           loader and recorder threads too.
+*/
+typedef struct
+{
+  MossAllocator          allocator; /* User allocator or the malloc based one. */
+  MossAllocationCounters total;     /* Counters of all categories together. */
+  MossAllocationCounters categories[ MOSS_ALLOCATION_CATEGORY_COUNT ];
+} Moss__HostAllocator;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Allocates memory with malloc.
+  @param user_data Unused.
+  @param size Size in bytes.
+  @return Allocated memory or NULL.
+*/
+inline static void *moss__default_allocate (void *const user_data, const size_t size)
+{
+  (void)user_data;
+  return malloc (size);
+}
+
+/*
+  @brief Reallocates memory with realloc.
+  @param user_data Unused.
+  @param memory Memory to reallocate.
+  @param size New size in bytes.
+  @return Reallocated memory or NULL.
+*/
+inline static void *
+moss__default_reallocate (void *const user_data, void *const memory, const size_t size)
+{
+  (void)user_data;
+  return realloc (memory, size);
+}
+
+/*
+  @brief Frees memory with free.
+  @param user_data Unused.
+  @param memory Memory to free.
+*/
+inline static void moss__default_free (void *const user_data, void *const memory)
+{
+  (void)user_data;
+  free (memory);
+}
+
+/*
+  @brief Initializes host allocator.
+  @param host_allocator Host allocator to initialize.
+  @param allocator User allocator, NULL to use malloc, realloc and free.
+*/
+inline static void moss__init_host_allocator (
+  Moss__HostAllocator *const host_allocator,
+  const MossAllocator *const allocator
+)
+{
+  memset (host_allocator, 0, sizeof (*host_allocator));
+
+  if (allocator != NULL)
+  {
+    host_allocator->allocator = *allocator;
+    return;
+  }
+
+  host_allocator->allocator = (MossAllocator) {
+    .allocate   = moss__default_allocate,
+    .reallocate = moss__default_reallocate,
+    .free       = moss__default_free,
+    .user_data  = NULL,
+  };
+}
+
+/*
+  @brief Adds size change of live allocations to counters.
+  @param counters Counters to update.
+  @param size_delta Change of live bytes, wraps around for decrease.
+  @param count_delta Change of live allocation count, wraps around for decrease.
+  @param is_allocation Whether an allocation or reallocation is made.
+*/
+inline static void moss__update_allocation_counters (
+  MossAllocationCounters *const counters,
+  const uint64_t                size_delta,
+  const uint64_t                count_delta,
+  const bool                    is_allocation
+)
+{
+  const uint64_t live_bytes = moss__atomic_add_u64 (&counters->live_bytes, size_delta);
+  moss__atomic_add_u64 (&counters->live_allocation_count, count_delta);
+
+  if (!is_allocation) { return; }
+
+  moss__atomic_add_u64 (&counters->allocation_count, 1);
+  moss__atomic_max_u64 (&counters->peak_bytes, live_bytes);
+}
+
+/*
+  @brief Counts live allocation change in the category and the total.
+  @param host_allocator Host allocator.
+  @param category Allocation category.
+  @param size_delta Change of live bytes, wraps around for decrease.
+  @param count_delta Change of live allocation count, wraps around for decrease.
+  @param is_allocation Whether an allocation or reallocation is made.
+*/
+inline static void moss__count_host_allocation (
+  Moss__HostAllocator *const host_allocator,
+  const uint32_t             category,
+  const uint64_t             size_delta,
+  const uint64_t             count_delta,
+  const bool                 is_allocation
+)
+{
+  moss__update_allocation_counters (
+    &host_allocator->categories[ category ],
+    size_delta,
+    count_delta,
+    is_allocation
+  );
+  moss__update_allocation_counters (
+    &host_allocator->total,
+    size_delta,
+    count_delta,
+    is_allocation
+  );
+}
+
+/*
+  @brief Returns header of host allocation.
+  @param memory Memory returned by a host allocation function.
+  @return Allocation header.
+*/
+inline static Moss__HostAllocationHeader *moss__get_host_allocation_header (void *memory)
+{
+  return (Moss__HostAllocationHeader *)((uint8_t *)memory -
+                                        MOSS__HOST_ALLOCATION_ALIGNMENT);
+}
+
+/*
+  @brief Allocates aligned host memory.
+  @param host_allocator Host allocator.
+  @param size Size in bytes.
+  @param alignment Power of two alignment.
+  @param category Category to count the allocation in.
+  @return Allocated memory or NULL.
+*/
+inline static void *moss__allocate_aligned (
+  Moss__HostAllocator *const   host_allocator,
+  const size_t                 size,
+  size_t                       alignment,
+  const MossAllocationCategory category
+)
+{
+  if (alignment < MOSS__HOST_ALLOCATION_ALIGNMENT)
+  {
+    alignment = MOSS__HOST_ALLOCATION_ALIGNMENT;
+  }
+
+  // Header slot plus padding up to the alignment never exceeds the alignment
+  if (size > SIZE_MAX - alignment) { return NULL; }
+
+  uint8_t *const base = host_allocator->allocator.allocate (
+    host_allocator->allocator.user_data,
+    size + alignment
+  );
+  if (base == NULL) { return NULL; }
+
+  const uintptr_t address = (uintptr_t)base + MOSS__HOST_ALLOCATION_ALIGNMENT;
+  uint8_t *const  memory =
+    base + (((address + alignment - 1) & ~(uintptr_t)(alignment - 1)) - (uintptr_t)base);
+
+  *moss__get_host_allocation_header (memory) = (Moss__HostAllocationHeader) {
+    .size     = size,
+    .category = (uint32_t)category,
+    .offset   = (uint32_t)(memory - base),
+  };
+
+  moss__count_host_allocation (host_allocator, (uint32_t)category, size, 1, true);
+
+  return memory;
+}
+
+/*
+  @brief Allocates host memory aligned like malloc one.
+  @param host_allocator Host allocator.
+  @param size Size in bytes.
+  @param category Category to count the allocation in.
+  @return Allocated memory or NULL.
+*/
+inline static void *moss__allocate (
+  Moss__HostAllocator *const   host_allocator,
+  const size_t                 size,
+  const MossAllocationCategory category
+)
+{
+  return moss__allocate_aligned (host_allocator, size, 0, category);
+}
+
+/*
+  @brief Allocates zeroed host memory for an array.
+  @param host_allocator Host allocator.
+  @param count Number of elements.
+  @param size Size of an element in bytes.
+  @param category Category to count the allocation in.
+  @return Allocated memory or NULL.
+*/
+inline static void *moss__allocate_zeroed (
+  Moss__HostAllocator *const   host_allocator,
+  const size_t                 count,
+  const size_t                 size,
+  const MossAllocationCategory category
+)
+{
+  if (size != 0 && count > SIZE_MAX / size) { return NULL; }
+
+  void *const memory = moss__allocate (host_allocator, count * size, category);
+  if (memory != NULL) { memset (memory, 0, count * size); }
+
+  return memory;
+}
+
+/*
+  @brief Frees host memory.
+  @param host_allocator Host allocator.
+  @param memory Memory returned by a host allocation function, may be NULL.
+*/
+inline static void
+moss__free (Moss__HostAllocator *const host_allocator, void *const memory)
+{
+  if (memory == NULL) { return; }
+
+  const Moss__HostAllocationHeader header = *moss__get_host_allocation_header (memory);
+
+  moss__count_host_allocation (
+    host_allocator,
+    header.category,
+    (uint64_t)0 - header.size,
+    (uint64_t)0 - 1,
+    false
+  );
+
+  host_allocator->allocator.free (
+    host_allocator->allocator.user_data,
+    (uint8_t *)memory - header.offset
+  );
+}
+
+/*
+  @brief Reallocates aligned host memory.
+  @details Memory keeps its category. Over-aligned memory is moved by allocating
+           and copying, as the user allocator only keeps malloc alignment.
+  @param host_allocator Host allocator.
+  @param memory Memory to reallocate, NULL to allocate.
+  @param size New size in bytes.
+  @param alignment Power of two alignment, must match the original one.
+  @param category Category to count the allocation in if memory is NULL.
+  @return Reallocated memory or NULL, original memory is kept then.
+*/
+inline static void *moss__reallocate_aligned (
+  Moss__HostAllocator *const   host_allocator,
+  void *const                  memory,
+  const size_t                 size,
+  const size_t                 alignment,
+  const MossAllocationCategory category
+)
+{
+  if (memory == NULL)
+  {
+    return moss__allocate_aligned (host_allocator, size, alignment, category);
+  }
+
+  const Moss__HostAllocationHeader header = *moss__get_host_allocation_header (memory);
+
+  if (alignment > MOSS__HOST_ALLOCATION_ALIGNMENT ||
+      header.offset != MOSS__HOST_ALLOCATION_ALIGNMENT)
+  {
+    void *const new_memory = moss__allocate_aligned (
+      host_allocator,
+      size,
+      alignment,
+      (MossAllocationCategory)header.category
+    );
+    if (new_memory == NULL) { return NULL; }
+
+    memcpy (new_memory, memory, header.size < size ? header.size : size);
+    moss__free (host_allocator, memory);
+
+    return new_memory;
+  }
+
+  if (size > SIZE_MAX - MOSS__HOST_ALLOCATION_ALIGNMENT) { return NULL; }
+
+  // Header offset is the slot size for malloc alignment, so it moves with the data
+  uint8_t *const base = host_allocator->allocator.reallocate (
+    host_allocator->allocator.user_data,
+    (uint8_t *)memory - header.offset,
+    size + MOSS__HOST_ALLOCATION_ALIGNMENT
+  );
+  if (base == NULL) { return NULL; }
+
+  uint8_t *const new_memory = base + MOSS__HOST_ALLOCATION_ALIGNMENT;
+  moss__get_host_allocation_header (new_memory)->size = size;
+
+  moss__count_host_allocation (
+    host_allocator,
+    header.category,
+    (uint64_t)size - header.size,
+    0,
+    true
+  );
+
+  return new_memory;
+}
+
+/*
+  @brief Reallocates host memory aligned like malloc one.
+  @param host_allocator Host allocator.
+  @param memory Memory to reallocate, NULL to allocate.
+  @param size New size in bytes.
+  @param category Category to count the allocation in if memory is NULL.
+  @return Reallocated memory or NULL, original memory is kept then.
+*/
+inline static void *moss__reallocate (
+  Moss__HostAllocator *const   host_allocator,
+  void *const                  memory,
+  const size_t                 size,
+  const MossAllocationCategory category
+)
+{
+  return moss__reallocate_aligned (host_allocator, memory, size, 0, category);
+}
+
+/*
+  @brief Duplicates string into host memory.
+  @param host_allocator Host allocator.
+  @param string String to duplicate.
+  @param category Category to count the allocation in.
+  @return Duplicated string or NULL.
+*/
+inline static char *moss__duplicate_string (
+  Moss__HostAllocator *const   host_allocator,
+  const char *const            string,
+  const MossAllocationCategory category
+)
+{
+  const size_t size   = strlen (string) + 1;
+  char *const  result = moss__allocate (host_allocator, size, category);
+  if (result != NULL) { memcpy (result, string, size); }
+
+  return result;
+}
+
+/*
+  @brief Vulkan allocation callback.
+*/
+inline static VKAPI_ATTR void *VKAPI_CALL moss__vk_allocate (
+  void *const                   user_data,
+  const size_t                  size,
+  const size_t                  alignment,
+  const VkSystemAllocationScope scope
+)
+{
+  (void)scope;
+  return moss__allocate_aligned (
+    (Moss__HostAllocator *)user_data,
+    size,
+    alignment,
+    MOSS_ALLOCATION_CATEGORY_VULKAN
+  );
+}
+
+/*
+  @brief Vulkan reallocation callback.
+*/
+inline static VKAPI_ATTR void *VKAPI_CALL moss__vk_reallocate (
+  void *const                   user_data,
+  void *const                   original,
+  const size_t                  size,
+  const size_t                  alignment,
+  const VkSystemAllocationScope scope
+)
+{
+  (void)scope;
+
+  // Zero size frees the original memory
+  if (size == 0)
+  {
+    moss__free ((Moss__HostAllocator *)user_data, original);
+    return NULL;
+  }
+
+  return moss__reallocate_aligned (
+    (Moss__HostAllocator *)user_data,
+    original,
+    size,
+    alignment,
+    MOSS_ALLOCATION_CATEGORY_VULKAN
+  );
+}
+
+/*
+  @brief Vulkan free callback.
+*/
+inline static VKAPI_ATTR void VKAPI_CALL
+moss__vk_free (void *const user_data, void *const memory)
+{
+  moss__free ((Moss__HostAllocator *)user_data, memory);
+}
+
+/*
+  @brief Returns Vulkan allocation callbacks forwarding to host allocator.
+  @param host_allocator Host allocator, must outlive every object created with the
+                        callbacks.
+  @return Allocation callbacks.
+*/
+inline static VkAllocationCallbacks
+moss__get_vk_allocation_callbacks (Moss__HostAllocator *const host_allocator)
+{
+  return (VkAllocationCallbacks) {
+    .pUserData             = host_allocator,
+    .pfnAllocation         = moss__vk_allocate,
+    .pfnReallocation       = moss__vk_reallocate,
+    .pfnFree               = moss__vk_free,
+    .pfnInternalAllocation = NULL,
+    .pfnInternalFree       = NULL,
+  };
+}
+
+/*
+  @brief Reads host allocation counters.
+  @param counters Counters to read.
+  @return Counters snapshot.
+*/
+inline static MossAllocationCounters
+moss__read_allocation_counters (const MossAllocationCounters *const counters)
+{
+  return (MossAllocationCounters) {
+    .live_bytes            = moss__atomic_load_u64 (&counters->live_bytes),
+    .peak_bytes            = moss__atomic_load_u64 (&counters->peak_bytes),
+    .allocation_count      = moss__atomic_load_u64 (&counters->allocation_count),
+    .live_allocation_count = moss__atomic_load_u64 (&counters->live_allocation_count),
+  };
+}
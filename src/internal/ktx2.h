@@ -0,0 +1,269 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/ktx2.h
+  @brief KTX2 container parsing.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Only 2D textures with a single layer and face and without
+           supercompression are supported, so level data can be copied to the
+           device as is. Basis Universal and Zstandard payloads must be transcoded
+           offline, e.g. with `ktx create --format BC7_SRGB_BLOCK`.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/result.h"
+
+#include "src/internal/config.h"
+#include "src/internal/log.h"
+#include "src/internal/mipmap.h"
+
+/* Size of KTX2 file identifier. */
+#define MOSS__KTX2_IDENTIFIER_SIZE 12
+
+/* Size of KTX2 header and index, up to the level index. */
+#define MOSS__KTX2_HEADER_SIZE 80
+
+/* Size of a single level index entry. */
+#define MOSS__KTX2_LEVEL_INDEX_ENTRY_SIZE 24
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Texel block parameters of a texture format.
+*/
+typedef struct
+{
+  VkFormat format;       /* Texture format. */
+  uint32_t block_width;  /* Block width in texels. */
+  uint32_t block_height; /* Block height in texels. */
+  uint32_t block_size;   /* Block size in bytes. */
+} Moss__TextureFormatInfo;
+
+/*
+  @brief Mip level data of a texture.
+*/
+typedef struct
+{
+  const uint8_t *data; /* Level data. */
+  size_t         size; /* Level data size in bytes. */
+} Moss__TextureLevel;
+
+/*
+  @brief Parsed KTX2 image.
+  @details Level data points into the parsed file memory.
+*/
+typedef struct
+{
+  Moss__TextureFormatInfo format_info;                           /* Texel format. */
+  uint32_t                width;                                 /* Level 0 width. */
+  uint32_t                height;                                /* Level 0 height. */
+  uint32_t                level_count;                           /* Mip levels. */
+  Moss__TextureLevel      levels[ MAX_TEXTURE_MIP_LEVEL_COUNT ]; /* Level data. */
+} Moss__Ktx2Image;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Returns texel block parameters of a format textures can be loaded in.
+  @param format Texture format.
+  @param out_info Output format info.
+  @return Returns true if format is supported, false otherwise.
+*/
+inline static bool
+moss__get_texture_format_info (const VkFormat format, Moss__TextureFormatInfo *out_info)
+{
+  static const Moss__TextureFormatInfo format_infos[] = {
+    { VK_FORMAT_R8G8B8A8_UNORM,       1, 1,  4 },
+    { VK_FORMAT_R8G8B8A8_SRGB,        1, 1,  4 },
+    { VK_FORMAT_BC7_UNORM_BLOCK,      4, 4, 16 },
+    { VK_FORMAT_BC7_SRGB_BLOCK,       4, 4, 16 },
+    { VK_FORMAT_ASTC_4x4_UNORM_BLOCK, 4, 4, 16 },
+    { VK_FORMAT_ASTC_4x4_SRGB_BLOCK,  4, 4, 16 },
+  };
+
+  for (size_t i = 0; i < sizeof (format_infos) / sizeof (format_infos[ 0 ]); ++i)
+  {
+    if (format_infos[ i ].format == format)
+    {
+      *out_info = format_infos[ i ];
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*
+  @brief Returns size of a mip level in bytes.
+  @param format_info Texel format.
+  @param width Level width.
+  @param height Level height.
+  @return Level size in bytes.
+*/
+inline static size_t moss__get_texture_level_size (
+  const Moss__TextureFormatInfo *const format_info,
+  const uint32_t                       width,
+  const uint32_t                       height
+)
+{
+  const size_t block_columns =
+    (width + format_info->block_width - 1) / format_info->block_width;
+  const size_t block_rows =
+    (height + format_info->block_height - 1) / format_info->block_height;
+
+  return block_columns * block_rows * format_info->block_size;
+}
+
+/*
+  @brief Checks whether memory starts with KTX2 file identifier.
+  @param data File data.
+  @param size File data size.
+  @return Returns true if data is a KTX2 file, false otherwise.
+*/
+inline static bool moss__is_ktx2 (const uint8_t *const data, const size_t size)
+{
+  static const uint8_t identifier[ MOSS__KTX2_IDENTIFIER_SIZE ] = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A,
+  };
+
+  return size >= MOSS__KTX2_IDENTIFIER_SIZE &&
+         memcmp (data, identifier, MOSS__KTX2_IDENTIFIER_SIZE) == 0;
+}
+
+/*
+  @brief Reads little-endian 32-bit value.
+*/
+inline static uint32_t moss__read_u32_le (const uint8_t *const data)
+{
+  return (uint32_t)data[ 0 ] | ((uint32_t)data[ 1 ] << 8) | ((uint32_t)data[ 2 ] << 16) |
+         ((uint32_t)data[ 3 ] << 24);
+}
+
+/*
+  @brief Reads little-endian 64-bit value.
+*/
+inline static uint64_t moss__read_u64_le (const uint8_t *const data)
+{
+  return (uint64_t)moss__read_u32_le (data) |
+         ((uint64_t)moss__read_u32_le (data + 4) << 32);
+}
+
+/*
+  @brief Parses KTX2 file.
+  @param data File data, must outlive parsed image.
+  @param size File data size.
+  @param out_image Output image.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__parse_ktx2 (
+  const uint8_t *const   data,
+  const size_t           size,
+  Moss__Ktx2Image *const out_image
+)
+{
+  if (!moss__is_ktx2 (data, size) || size < MOSS__KTX2_HEADER_SIZE)
+  {
+    moss__error ("File is not a valid KTX2 file.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  const VkFormat format           = (VkFormat)moss__read_u32_le (data + 12);
+  const uint32_t width            = moss__read_u32_le (data + 20);
+  const uint32_t height           = moss__read_u32_le (data + 24);
+  const uint32_t depth            = moss__read_u32_le (data + 28);
+  const uint32_t layer_count      = moss__read_u32_le (data + 32);
+  const uint32_t face_count       = moss__read_u32_le (data + 36);
+  const uint32_t level_count      = moss__read_u32_le (data + 40);
+  const uint32_t supercompression = moss__read_u32_le (data + 44);
+
+  if (!moss__get_texture_format_info (format, &out_image->format_info))
+  {
+    moss__error ("Unsupported KTX2 texture format: %u.\n", (uint32_t)format);
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (width == 0 || height == 0 || depth > 1 || layer_count > 1 || face_count != 1)
+  {
+    moss__error ("Only 2D KTX2 textures with a single layer are supported.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (supercompression != 0)
+  {
+    moss__error ("Supercompressed KTX2 textures are not supported.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Zero level count asks the loader to generate mips, which compressed formats
+  // can't do, so only the base level is used then
+  out_image->width       = width;
+  out_image->height      = height;
+  out_image->level_count = level_count > 0 ? level_count : 1;
+
+  if (out_image->level_count > MAX_TEXTURE_MIP_LEVEL_COUNT ||
+      out_image->level_count > moss__get_mip_level_count (width, height))
+  {
+    moss__error ("Invalid KTX2 mip level count: %u.\n", level_count);
+    return MOSS_RESULT_ERROR;
+  }
+
+  const size_t level_index_size =
+    (size_t)out_image->level_count * MOSS__KTX2_LEVEL_INDEX_ENTRY_SIZE;
+  if (size - MOSS__KTX2_HEADER_SIZE < level_index_size)
+  {
+    moss__error ("KTX2 file is truncated.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  for (uint32_t level = 0; level < out_image->level_count; ++level)
+  {
+    const uint8_t *const entry =
+      data + MOSS__KTX2_HEADER_SIZE + (size_t)level * MOSS__KTX2_LEVEL_INDEX_ENTRY_SIZE;
+
+    const uint64_t offset      = moss__read_u64_le (entry);
+    const uint64_t byte_length = moss__read_u64_le (entry + 8);
+
+    const size_t expected_size = moss__get_texture_level_size (
+      &out_image->format_info,
+      moss__get_mip_level_size (width, level),
+      moss__get_mip_level_size (height, level)
+    );
+
+    if (byte_length != expected_size || offset > size || size - offset < byte_length)
+    {
+      moss__error ("Invalid KTX2 mip level %u.\n", level);
+      return MOSS_RESULT_ERROR;
+    }
+
+    out_image->levels[ level ] = (Moss__TextureLevel) {
+      .data = data + offset,
+      .size = (size_t)byte_length,
+    };
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/mipmap.h
+  @brief Mip chain generation for 8-bit sRGB RGBA pixels.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Levels are downsampled with a 2x2 box filter in linear space. Colors
+           are weighted by alpha, so fully transparent texels don't darken edges
+           of sprites.
+*/
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Precision of the linear to sRGB lookup table. */
+#define MOSS__MIPMAP_LINEAR_STEPS 4096
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief sRGB conversion lookup tables.
+*/
+typedef struct
+{
+  float   to_linear[ 256 ];                          /* sRGB byte to linear. */
+  uint8_t from_linear[ MOSS__MIPMAP_LINEAR_STEPS ]; /* Linear step to sRGB byte. */
+} Moss__SrgbTables;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Returns number of mip levels in a full chain down to 1x1.
+  @param width Level 0 width.
+  @param height Level 0 height.
+  @return Number of mip levels.
+*/
+inline static uint32_t moss__get_mip_level_count (uint32_t width, uint32_t height)
+{
+  uint32_t level_count = 1;
+  while (width > 1 || height > 1)
+  {
+    width  = width > 1 ? width / 2 : 1;
+    height = height > 1 ? height / 2 : 1;
+    ++level_count;
+  }
+
+  return level_count;
+}
+
+/*
+  @brief Returns dimension of the mip level.
+  @param size Level 0 dimension.
+  @param level Mip level.
+  @return Level dimension, never less than 1.
+*/
+inline static uint32_t
+moss__get_mip_level_size (const uint32_t size, const uint32_t level)
+{
+  const uint32_t level_size = size >> level;
+  return level_size > 0 ? level_size : 1;
+}
+
+/*
+  @brief Fills sRGB conversion lookup tables.
+  @param tables Tables to fill.
+*/
+inline static void moss__init_srgb_tables (Moss__SrgbTables *const tables)
+{
+  for (size_t i = 0; i < 256; ++i)
+  {
+    const float value = (float)i / 255.0F;
+
+    tables->to_linear[ i ] = value <= 0.04045F
+                               ? value / 12.92F
+                               : powf ((value + 0.055F) / 1.055F, 2.4F);
+  }
+
+  for (size_t i = 0; i < MOSS__MIPMAP_LINEAR_STEPS; ++i)
+  {
+    const float value = (float)i / (float)(MOSS__MIPMAP_LINEAR_STEPS - 1);
+    const float srgb  = value <= 0.0031308F
+                          ? value * 12.92F
+                          : 1.055F * powf (value, 1.0F / 2.4F) - 0.055F;
+
+    tables->from_linear[ i ] = (uint8_t)(srgb * 255.0F + 0.5F);
+  }
+}
+
+/*
+  @brief Downsamples mip level into the next one.
+  @param tables sRGB conversion lookup tables.
+  @param src Source level pixels, tightly packed 8-bit sRGB RGBA.
+  @param src_width Source level width.
+  @param src_height Source level height.
+  @param dst Destination level pixels, half the source size rounded down, at least 1.
+*/
+inline static void moss__downsample_mip_level (
+  const Moss__SrgbTables *const tables,
+  const uint8_t *const          src,
+  const uint32_t                src_width,
+  const uint32_t                src_height,
+  uint8_t *const                dst
+)
+{
+  const uint32_t dst_width  = moss__get_mip_level_size (src_width, 1);
+  const uint32_t dst_height = moss__get_mip_level_size (src_height, 1);
+
+  for (uint32_t y = 0; y < dst_height; ++y)
+  {
+    // Odd and 1-texel sources reuse the last row or column
+    const uint32_t y0 = y * 2 < src_height ? y * 2 : src_height - 1;
+    const uint32_t y1 = y0 + 1 < src_height ? y0 + 1 : y0;
+
+    for (uint32_t x = 0; x < dst_width; ++x)
+    {
+      const uint32_t x0 = x * 2 < src_width ? x * 2 : src_width - 1;
+      const uint32_t x1 = x0 + 1 < src_width ? x0 + 1 : x0;
+
+      const uint8_t *const texels[ 4 ] = {
+        &src[ ((size_t)y0 * src_width + x0) * 4 ],
+        &src[ ((size_t)y0 * src_width + x1) * 4 ],
+        &src[ ((size_t)y1 * src_width + x0) * 4 ],
+        &src[ ((size_t)y1 * src_width + x1) * 4 ],
+      };
+
+      float color[ 3 ] = { 0.0F, 0.0F, 0.0F };
+      float alpha_sum  = 0.0F;
+      for (size_t i = 0; i < 4; ++i)
+      {
+        const float alpha = (float)texels[ i ][ 3 ] / 255.0F;
+        for (size_t c = 0; c < 3; ++c)
+        {
+          color[ c ] += tables->to_linear[ texels[ i ][ c ] ] * alpha;
+        }
+        alpha_sum += alpha;
+      }
+
+      uint8_t *const out = &dst[ ((size_t)y * dst_width + x) * 4 ];
+      for (size_t c = 0; c < 3; ++c)
+      {
+        const float linear = alpha_sum > 0.0F ? color[ c ] / alpha_sum : 0.0F;
+        out[ c ] = tables->from_linear[ (size_t)(
+          linear * (float)(MOSS__MIPMAP_LINEAR_STEPS - 1) + 0.5F
+        ) ];
+      }
+      out[ 3 ] = (uint8_t)(alpha_sum / 4.0F * 255.0F + 0.5F);
+    }
+  }
+}
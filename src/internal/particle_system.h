@@ -0,0 +1,65 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/particle_system.h
+  @brief Particle simulation push constants and functions shared with the engine.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Simulation is recorded to the cull command buffer of the frame, so it runs
+           before the render pass and the barrier the buffer ends with makes written
+           instances visible to indirect draws.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "moss/engine.h"
+#include "moss/result.h"
+
+/*
+  @brief Parameters pushed to the particle simulation shader.
+  @warning Layout must match push constants of the particle shader.
+*/
+typedef struct
+{
+  float    position[ 2 ];        /* World position particles are emitted around. */
+  float    position_spread[ 2 ]; /* World size of the emission rect. */
+  float    min_velocity[ 2 ];    /* Minimum initial velocity. */
+  float    max_velocity[ 2 ];    /* Maximum initial velocity. */
+  float    acceleration[ 2 ];    /* Acceleration of alive particles. */
+  float    start_size[ 2 ];      /* Size of emitted particles. */
+  float    end_size[ 2 ];        /* Size of particles at the end of lifetime. */
+  float    min_lifetime;         /* Minimum lifetime in seconds. */
+  float    max_lifetime;         /* Maximum lifetime in seconds. */
+  float    time_step;            /* Seconds simulated by the step. */
+  float    time;                 /* Animation time of the frame. */
+  uint32_t first_emitted;        /* First ring slot emitted into. */
+  uint32_t emitted_count;        /* Number of particles emitted by the step. */
+  uint32_t capacity;             /* Number of ring slots. */
+  uint32_t seed;                 /* Random seed of the step. */
+  uint16_t uv[ 4 ];              /* Normalized UV rect: top left u, v, bottom right. */
+  uint32_t texture_index;        /* Bindless texture index. */
+  uint32_t animation_clip;       /* Animation clip ID, 0 if not animated. */
+  float    animation_rate;       /* Animation playback speed. */
+  float    depth;                /* Depth particles are drawn at. */
+} Moss__ParticlePushConstants;
+
+/*
+  @brief Records emission and simulation of every particle system of the engine.
+  @details Called by moss_begin_frame before the render pass is begun.
+  @param engine Engine handle, frame slot fence must be waited.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+MossResult moss__simulate_particle_systems (MossEngine *engine);
@@ -0,0 +1,249 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/quad_index_buffer.h
+  @brief Shared quad index buffer utility functions.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Every indexed sprite uses the same 0,1,2,2,3,0 pattern, so the engine owns
+           device-local index buffers that all sprite batches bind. Batches that fit
+           into 16-bit indices bind the 16-bit buffer, larger ones bind the 32-bit
+           buffer, so a single large batch doesn't widen indices of small ones.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/engine.h"
+#include "moss/result.h"
+
+#include "src/internal/engine.h"
+#include "src/internal/log.h"
+#include "src/internal/upload_queue.h"
+#include "src/internal/vulkan/utils/buffer.h"
+
+/* Number of vertices every sprite quad consists of. */
+#define MOSS__QUAD_VERTEX_COUNT (size_t)(4)
+
+/* Number of indices every sprite quad consists of. */
+#define MOSS__QUAD_INDEX_COUNT (size_t)(6)
+
+/* Number of shared quad index buffers, one per index type. */
+#define MOSS__QUAD_INDEX_BUFFER_COUNT (size_t)(2)
+
+/* Maximum number of sprites that can be addressed by 16-bit indices. */
+#define MOSS__MAX_SPRITES_PER_UINT16_INDICES \
+  (size_t)((UINT16_MAX + 1) / MOSS__QUAD_VERTEX_COUNT)
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Returns index type a sprite batch of passed capacity is drawn with.
+  @param sprite_capacity Maximum number of sprites of the batch.
+  @return Returns VK_INDEX_TYPE_UINT16 if the batch fits into 16-bit indices,
+          otherwise returns VK_INDEX_TYPE_UINT32.
+*/
+inline static VkIndexType moss__get_quad_index_type (const size_t sprite_capacity)
+{
+  return sprite_capacity > MOSS__MAX_SPRITES_PER_UINT16_INDICES ? VK_INDEX_TYPE_UINT32
+                                                                 : VK_INDEX_TYPE_UINT16;
+}
+
+/*
+  @brief Returns slot of engine quad index buffer arrays for passed index type.
+  @param index_type Index type.
+  @return Returns 0 for 16-bit indices, 1 for 32-bit indices.
+*/
+inline static size_t moss__get_quad_index_slot (const VkIndexType index_type)
+{
+  return index_type == VK_INDEX_TYPE_UINT32 ? 1 : 0;
+}
+
+/*
+  @brief Returns shared quad index buffer of passed index type.
+  @param engine Engine handle.
+  @param index_type Index type.
+  @return Returns index buffer, VK_NULL_HANDLE if it wasn't reserved.
+*/
+inline static VkBuffer
+moss__get_quad_index_buffer (const MossEngine *const engine, const VkIndexType index_type)
+{
+  return engine->quad_index_buffers[ moss__get_quad_index_slot (index_type) ];
+}
+
+/*
+  @brief Destroys shared quad index buffers.
+  @details Device must be idle.
+  @param engine Engine handle.
+*/
+inline static void moss__destroy_quad_index_buffers (MossEngine *const engine)
+{
+  for (size_t i = 0; i < MOSS__QUAD_INDEX_BUFFER_COUNT; ++i)
+  {
+    moss_vk__destroy_buffer (
+      &engine->allocator,
+      engine->quad_index_buffers[ i ],
+      &engine->quad_index_buffer_allocations[ i ]
+    );
+
+    engine->quad_index_buffers[ i ]    = VK_NULL_HANDLE;
+    engine->quad_index_capacities[ i ] = 0;
+  }
+}
+
+/*
+  @brief Makes sure shared quad index buffer used by batches of passed capacity
+         holds indices for at least that many sprites.
+  @details Buffer is recreated with at least twice the previous capacity when it's
+           too small, 16-bit buffer never grows past what 16-bit indices address.
+           Previous buffer is retired through the deletion queue.
+  @param engine Engine handle.
+  @param sprite_count Required number of sprites.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+  @warning Must not be called while a frame is being recorded, because growing
+           the buffer invalidates the previously bound one.
+*/
+inline static MossResult
+moss__reserve_quad_indices (MossEngine *const engine, const size_t sprite_count)
+{
+  const VkIndexType index_type = moss__get_quad_index_type (sprite_count);
+  const size_t      slot       = moss__get_quad_index_slot (index_type);
+
+  if (sprite_count <= engine->quad_index_capacities[ slot ])
+  {
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  if (engine->is_frame_begun)
+  {
+    moss__error ("Quad index buffer can't grow while a frame is being recorded.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  size_t capacity = engine->quad_index_capacities[ slot ] * 2;
+  if (capacity < QUAD_INDEX_BUFFER_INITIAL_CAPACITY)
+  {
+    capacity = QUAD_INDEX_BUFFER_INITIAL_CAPACITY;
+  }
+  if (capacity < sprite_count) { capacity = sprite_count; }
+
+  const bool use_uint32_indices = index_type == VK_INDEX_TYPE_UINT32;
+  if (!use_uint32_indices && capacity > MOSS__MAX_SPRITES_PER_UINT16_INDICES)
+  {
+    capacity = MOSS__MAX_SPRITES_PER_UINT16_INDICES;
+  }
+
+  const size_t index_size = use_uint32_indices ? sizeof (uint32_t) : sizeof (uint16_t);
+  const VkDeviceSize buffer_size =
+    (VkDeviceSize)(capacity * MOSS__QUAD_INDEX_COUNT * index_size);
+
+  // Generate indices: two triangles (0,1,2) and (2,3,0) per quad
+  void *const indices = moss__allocate (
+    &engine->host_allocator,
+    (size_t)buffer_size,
+    MOSS_ALLOCATION_CATEGORY_TEMPORARY
+  );
+  if (indices == NULL)
+  {
+    moss__error ("Failed to allocate memory for quad indices.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  static const uint32_t quad_pattern[ MOSS__QUAD_INDEX_COUNT ] = { 0, 1, 2, 2, 3, 0 };
+  for (size_t i = 0; i < capacity; ++i)
+  {
+    const uint32_t base_vertex = (uint32_t)(i * MOSS__QUAD_VERTEX_COUNT);
+    for (size_t j = 0; j < MOSS__QUAD_INDEX_COUNT; ++j)
+    {
+      const size_t index = i * MOSS__QUAD_INDEX_COUNT + j;
+      if (use_uint32_indices)
+      {
+        ((uint32_t *)indices)[ index ] = base_vertex + quad_pattern[ j ];
+      }
+      else {
+        ((uint16_t *)indices)[ index ] = (uint16_t)(base_vertex + quad_pattern[ j ]);
+      }
+    }
+  }
+
+  VkBuffer           buffer;
+  Moss__VkAllocation buffer_allocation;
+  {  // Create device-local index buffer
+    const Moss__CreateVkBufferInfo create_info = {
+      .allocator       = &engine->allocator,
+      .device          = engine->device,
+      .size            = buffer_size,
+      .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+      .memory_properties               = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+      .sharing_mode                    = engine->buffer_sharing_mode,
+      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+    };
+    if (moss_vk__create_buffer (&create_info, &buffer, &buffer_allocation) !=
+        MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create quad index buffer.\n");
+      moss__free (&engine->host_allocator, indices);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Record indices upload
+    const Moss__UploadQueueFillBufferInfo fill_info = {
+      .destination_buffer              = buffer,
+      .destination_offset              = 0,
+      .source_data                     = indices,
+      .data_size                       = buffer_size,
+      .sharing_mode                    = engine->buffer_sharing_mode,
+      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+    };
+    const MossResult result =
+      moss__upload_queue_fill_buffer (&engine->upload_queue, &fill_info);
+    moss__free (&engine->host_allocator, indices);
+    if (result != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to upload quad indices.\n");
+      moss_vk__destroy_buffer (&engine->allocator, buffer, &buffer_allocation);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  // Previous buffer may still be referenced by frames in flight or by pending uploads
+  if (engine->quad_index_buffers[ slot ] != VK_NULL_HANDLE)
+  {
+    const Moss__DeletionQueueEntry entry = {
+      .buffer     = engine->quad_index_buffers[ slot ],
+      .allocation = engine->quad_index_buffer_allocations[ slot ],
+    };
+    moss__defer_deletion (
+      engine,
+      &entry,
+      moss__get_upload_queue_pending_value (&engine->upload_queue)
+    );
+  }
+
+  engine->quad_index_buffers[ slot ]            = buffer;
+  engine->quad_index_buffer_allocations[ slot ] = buffer_allocation;
+  engine->quad_index_capacities[ slot ]         = capacity;
+
+  return MOSS_RESULT_SUCCESS;
+}
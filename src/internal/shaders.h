@@ -14,24 +14,114 @@
   limitations under the License.
 
   @file src/internal/shaders.h
-  @brief Shader file paths for triangle rendering
+  @brief SPIR-V code of engine shaders
   @author Ilya Buravov (ilburale@gmail.com)
-  @details This file contains paths to SPIR-V shader files used for rendering.
-           Shader source files are located in example/shaders/ directory.
+  @details Shader sources are located in src/shaders/ directory. They are compiled by
+           the build and linked into the library, see src/shaders.c. Variants are
+           made with specialization constants instead of separate shaders.
 */
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  @brief Specialization constant of fragment shaders that enables alpha test.
+*/
+#define MOSS__ALPHA_TEST_CONSTANT_ID (uint32_t)(0)
+
+/*
+  @brief Specialization constant of the cull shader that selects instanced sprites.
+*/
+#define MOSS__CULL_INSTANCED_CONSTANT_ID (uint32_t)(0)
+
+/*
+  @brief Specialization constant of the cull shader that sets workgroup size.
+*/
+#define MOSS__CULL_WORKGROUP_SIZE_CONSTANT_ID (uint32_t)(1)
+
+/*
+  @brief Specialization constant of the particle shader that sets workgroup size.
+*/
+#define MOSS__PARTICLE_WORKGROUP_SIZE_CONSTANT_ID (uint32_t)(0)
+
+/*
+  @brief SPIR-V code of a shader.
+*/
+typedef struct
+{
+  const uint32_t *code;      /* SPIR-V words. */
+  size_t          code_size; /* Size of SPIR-V code in bytes. */
+} Moss__ShaderCode;
+
+/*
+  @brief Vertex shader of indexed sprite batches.
+  @details Transforms sprite vertices with the camera.
+           Shader source: src/shaders/shader.vert
+*/
+extern const Moss__ShaderCode moss__vert_shader_code;
+
+/*
+  @brief Vertex shader of instanced sprite batches.
+  @details Builds sprite quad corners from gl_VertexIndex and per-instance data.
+           Shader source: src/shaders/sprite_instanced.vert
+*/
+extern const Moss__ShaderCode moss__instanced_vert_shader_code;
+
+/*
+  @brief Vertex shader of compact sprite batches.
+  @details Expands quantized vertices, batch bounds are folded into the camera.
+           Shader source: src/shaders/sprite_compact.vert
+*/
+extern const Moss__ShaderCode moss__compact_vert_shader_code;
+
+/*
+  @brief Fragment shader sampling per-batch texture.
+  @details Shader source: src/shaders/shader.frag
+*/
+extern const Moss__ShaderCode moss__frag_shader_code;
+
+/*
+  @brief Fragment shader sampling bindless texture array.
+  @details Samples the bindless texture array with per-vertex texture index. Kept
+           apart from the per-batch shader, as runtime descriptor arrays must be
+           supported by the device even if a specialization never reads them.
+           Shader source: src/shaders/shader_bindless.frag
+*/
+extern const Moss__ShaderCode moss__bindless_frag_shader_code;
+
+/*
+  @brief Sprite culling compute shader.
+  @details Writes quad indices of indexed sprites or compacts instances of instanced
+           sprites inside the camera rect, selected with a specialization constant.
+           Shader source: src/shaders/sprite_cull.comp
+*/
+extern const Moss__ShaderCode moss__cull_comp_shader_code;
+
+/*
+  @brief Vertex shader of tilemaps.
+  @details Builds one quad per chunk from gl_VertexIndex and gl_InstanceIndex.
+           Shader source: src/shaders/tilemap.vert
+*/
+extern const Moss__ShaderCode moss__tilemap_vert_shader_code;
+
+/*
+  @brief Fragment shader of tilemaps sampling per-tilemap atlas.
+  @details Looks up the tile under the fragment and samples its atlas cell.
+           Shader source: src/shaders/tilemap.frag
+*/
+extern const Moss__ShaderCode moss__tilemap_frag_shader_code;
+
 /*
-  @brief Path to vertex shader SPIR-V file.
-  @details Simple vertex shader that outputs a triangle with positions and colors.
-           Shader source: example/shaders/shader.vert
+  @brief Fragment shader of tilemaps sampling bindless texture array.
+  @details Shader source: src/shaders/tilemap_bindless.frag
 */
-#define MOSS__VERT_SHADER_PATH "shaders/shader.vert.spv"
+extern const Moss__ShaderCode moss__bindless_tilemap_frag_shader_code;
 
 /*
-  @brief Path to fragment shader SPIR-V file.
-  @details Simple fragment shader that outputs the interpolated color.
-           Shader source: example/shaders/shader.frag
+  @brief Particle simulation compute shader.
+  @details Emits and moves particles and writes sprite instances of alive ones.
+           Shader source: src/shaders/particle_simulate.comp
 */
-#define MOSS__FRAG_SHADER_PATH "shaders/shader.frag.spv"
+extern const Moss__ShaderCode moss__particle_comp_shader_code;
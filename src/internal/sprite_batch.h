@@ -0,0 +1,41 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/sprite_batch.h
+  @brief Internal sprite batch functions shared with the engine.
+  @author Ilya Buravov (ilburale@gmail.com)
+*/
+
+#pragma once
+
+#include "moss/engine.h"
+#include "moss/result.h"
+
+/*
+  @brief Stages sprite ranges updated since the last upload for the frame uploads.
+  @details Called by moss_end_frame before frame uploads are recorded, so the frame
+           draws updated sprites. Ranges of every batch are packed into a single
+           staging region of the frame slot.
+  @param engine Engine handle.
+*/
+void moss__upload_sprite_batch_updates (MossEngine *engine);
+
+/*
+  @brief Sorts draws queued with the recorder and records them.
+  @details Called when recording of the recorder ends, the queue is empty after it.
+  @param recorder Command recorder, must be begun.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+MossResult moss__flush_draw_queue (MossCommandRecorder *recorder);
@@ -0,0 +1,171 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/sprite_batch_snapshot.h
+  @brief Sprite batch snapshot file format and mapping functions.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Snapshot is a header followed by chunks and sprite vertex data exactly as
+           they are laid out in batch staging memory. Fields are stored in native
+           byte order, files of another byte order fail the magic check. Loading
+           maps the file and copies vertex data straight to the staging buffer.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "moss/result.h"
+
+#include "src/internal/log.h"
+#include "src/internal/sprite_chunks.h"
+
+/* Snapshot file magic, reads as "MSBS" in a little-endian file. */
+#define MOSS__SPRITE_BATCH_SNAPSHOT_MAGIC (uint32_t)(0x5342534DU)
+
+/* Snapshot format version, bumped whenever the header or sprite data changes. */
+#define MOSS__SPRITE_BATCH_SNAPSHOT_VERSION (uint32_t)(1)
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Sprite batch snapshot header.
+  @details Chunks follow the header, sprite data follows the chunks.
+*/
+typedef struct
+{
+  uint32_t magic;                /* MOSS__SPRITE_BATCH_SNAPSHOT_MAGIC. */
+  uint32_t version;              /* MOSS__SPRITE_BATCH_SNAPSHOT_VERSION. */
+  uint32_t header_size;          /* Size of the header in bytes. */
+  uint32_t mode;                 /* Sprite batch mode. */
+  uint32_t material;             /* Sprite batch material. */
+  uint32_t sprite_data_size;     /* Size of a single sprite data in bytes. */
+  uint32_t chunk_record_size;    /* Size of a single chunk in bytes. */
+  uint32_t sprite_count;         /* Number of sprites. */
+  uint32_t chunk_count;          /* Number of chunks, 0 if not chunked. */
+  float    chunk_size;           /* Chunk size, 0 if not chunked. */
+  float    bounds_position[ 2 ]; /* Center of compact bounds. */
+  float    bounds_size[ 2 ];     /* Size of compact bounds. */
+} Moss__SpriteBatchSnapshotHeader;
+
+/*
+  @brief Read-only mapping of a file.
+*/
+typedef struct
+{
+  const void *data; /* Mapped file data. */
+  size_t      size; /* File size in bytes. */
+} Moss__MappedFile;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Maps file to memory for reading.
+  @param file_path Path to the file.
+  @param out_file Output mapped file, must be unmapped with moss__unmap_file.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__map_file (const char *const file_path, Moss__MappedFile *const out_file)
+{
+  const int file = open (file_path, O_RDONLY);
+  if (file < 0)
+  {
+    moss__error ("Failed to open file: %s\n", file_path);
+    return MOSS_RESULT_ERROR;
+  }
+
+  struct stat file_stat;
+  if (fstat (file, &file_stat) != 0 || file_stat.st_size <= 0)
+  {
+    moss__error ("Failed to get size of file: %s\n", file_path);
+    close (file);
+    return MOSS_RESULT_ERROR;
+  }
+
+  const size_t size = (size_t)file_stat.st_size;
+  void *const  data = mmap (NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+  // Mapping keeps its own reference to the file
+  close (file);
+
+  if (data == MAP_FAILED)
+  {
+    moss__error ("Failed to map file: %s\n", file_path);
+    return MOSS_RESULT_ERROR;
+  }
+
+  // File is read once from start to end, let the kernel read ahead
+  madvise (data, size, MADV_SEQUENTIAL);
+
+  *out_file = (Moss__MappedFile) {
+    .data = data,
+    .size = size,
+  };
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Unmaps file mapped with moss__map_file.
+  @param file Mapped file.
+*/
+inline static void moss__unmap_file (const Moss__MappedFile *const file)
+{
+  munmap ((void *)file->data, file->size);
+}
+
+/*
+  @brief Returns size of a snapshot file.
+  @param header Snapshot header.
+  @return Size of the snapshot in bytes.
+*/
+inline static uint64_t
+moss__get_sprite_batch_snapshot_size (const Moss__SpriteBatchSnapshotHeader *const header)
+{
+  return (uint64_t)header->header_size +
+         (uint64_t)header->chunk_count * header->chunk_record_size +
+         (uint64_t)header->sprite_count * header->sprite_data_size;
+}
+
+/*
+  @brief Checks whether file holds a snapshot this build can read.
+  @param file Mapped file.
+  @return Returns true if the header matches the format and file size, false
+          otherwise.
+*/
+inline static bool
+moss__is_sprite_batch_snapshot_valid (const Moss__MappedFile *const file)
+{
+  if (file->size < sizeof (Moss__SpriteBatchSnapshotHeader)) { return false; }
+
+  const Moss__SpriteBatchSnapshotHeader *const header = file->data;
+
+  return header->magic == MOSS__SPRITE_BATCH_SNAPSHOT_MAGIC &&
+         header->version == MOSS__SPRITE_BATCH_SNAPSHOT_VERSION &&
+         header->header_size == sizeof (Moss__SpriteBatchSnapshotHeader) &&
+         header->chunk_record_size == sizeof (Moss__SpriteChunk) &&
+         moss__get_sprite_batch_snapshot_size (header) == (uint64_t)file->size;
+}
@@ -0,0 +1,287 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/sprite_chunks.h
+  @brief Spatial chunking of static sprite batches.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Sprites are bucketed into a uniform grid by their centers and reordered,
+           so every non-empty cell becomes a contiguous range of the batch buffer.
+           Chunks are built from a cached host copy of sprite data, staging memory
+           is only written with the reordered sprites afterwards.
+           Chunk bounds cover every sprite of the chunk, sprites crossing cell
+           borders included, so testing chunks against the view is conservative.
+*/
+
+#pragma once
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cglm/vec2.h>
+
+#include "moss/result.h"
+
+#include "src/internal/config.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+#include "src/internal/vertex.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Contiguous range of sprites that lie in the same grid cell.
+*/
+typedef struct
+{
+  vec2     min;          /* Bounds minimum corner. */
+  vec2     max;          /* Bounds maximum corner. */
+  uint32_t first_sprite; /* Index of the first sprite of the chunk. */
+  uint32_t sprite_count; /* Number of sprites in the chunk. */
+} Moss__SpriteChunk;
+
+/*
+  @brief Sprite chunks build info.
+*/
+typedef struct
+{
+  const void *sprite_data;      /* Vertices or instances of sprites in host memory. */
+  uint32_t    sprite_count;     /* Number of sprites. */
+  size_t      sprite_data_size; /* Size of a single sprite data in bytes. */
+  bool        is_instanced;     /* Whether sprite data holds instances. */
+  float       chunk_size;       /* Desired world size of a grid cell. */
+  /* Host allocator to allocate chunks and temporary buffers with. */
+  Moss__HostAllocator *host_allocator;
+} Moss__BuildSpriteChunksInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Computes world space bounds of sprite data.
+  @param sprite_data Sprite vertices or instance.
+  @param is_instanced Whether sprite data is an instance.
+  @param out_min Output bounds minimum corner.
+  @param out_max Output bounds maximum corner.
+*/
+inline static void moss__get_sprite_data_bounds (
+  const void *const sprite_data,
+  const bool        is_instanced,
+  vec2              out_min,
+  vec2              out_max
+)
+{
+  if (is_instanced)
+  {
+    const Moss__SpriteInstance *const instance = sprite_data;
+    for (int i = 0; i < 2; ++i)
+    {
+      const float half_size = fabsf (instance->size[ i ]) * 0.5F;
+      out_min[ i ]          = instance->position[ i ] - half_size;
+      out_max[ i ]          = instance->position[ i ] + half_size;
+    }
+    return;
+  }
+
+  const Moss__Vertex *const vertices = sprite_data;
+  glm_vec2_copy (vertices[ 0 ].position, out_min);
+  glm_vec2_copy (vertices[ 0 ].position, out_max);
+  for (size_t v = 1; v < 4; ++v)
+  {
+    glm_vec2_minv (out_min, vertices[ v ].position, out_min);
+    glm_vec2_maxv (out_max, vertices[ v ].position, out_max);
+  }
+}
+
+/*
+  @brief Buckets sprites into grid chunks.
+  @details Grid covers sprite centers, cell size is doubled until the grid fits
+           into MAX_SPRITE_BATCH_CHUNK_COUNT cells. Order of sprites within a chunk
+           is preserved.
+  @param info Required operation info.
+  @param out_chunks Output chunks in grid row order, must be freed with moss__free.
+  @param out_chunk_count Output number of chunks.
+  @param out_sprite_order Output indices of sprites in chunk order, must hold
+                          sprite_count entries.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__build_sprite_chunks (
+  const Moss__BuildSpriteChunksInfo *const info,
+  Moss__SpriteChunk **const                out_chunks,
+  uint32_t *const                          out_chunk_count,
+  uint32_t *const                          out_sprite_order
+)
+{
+  *out_chunks      = NULL;
+  *out_chunk_count = 0;
+
+  if (info->sprite_count == 0) { return MOSS_RESULT_SUCCESS; }
+
+  const char *const sprite_data = info->sprite_data;
+
+  vec2 grid_min = { INFINITY, INFINITY };
+  vec2 grid_max = { -INFINITY, -INFINITY };
+  for (uint32_t i = 0; i < info->sprite_count; ++i)
+  {
+    vec2 min, max, center;
+    moss__get_sprite_data_bounds (
+      sprite_data + (size_t)i * info->sprite_data_size,
+      info->is_instanced,
+      min,
+      max
+    );
+    glm_vec2_add (min, max, center);
+    glm_vec2_scale (center, 0.5F, center);
+    glm_vec2_minv (grid_min, center, grid_min);
+    glm_vec2_maxv (grid_max, center, grid_max);
+  }
+
+  vec2 span;
+  glm_vec2_sub (grid_max, grid_min, span);
+  if (!isfinite (span[ 0 ]) || !isfinite (span[ 1 ]) || !(info->chunk_size > 0.0F))
+  {
+    moss__error ("Sprite batch can't be chunked, sprite positions aren't finite.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Grid is kept small enough for the cell counters, cells merge on huge maps
+  float cell_size = info->chunk_size;
+  float columns, rows;
+  while (true)
+  {
+    columns = floorf (span[ 0 ] / cell_size) + 1.0F;
+    rows    = floorf (span[ 1 ] / cell_size) + 1.0F;
+    if (columns * rows <= (float)MAX_SPRITE_BATCH_CHUNK_COUNT) { break; }
+    cell_size *= 2.0F;
+  }
+
+  const uint32_t column_count = (uint32_t)columns;
+  const uint32_t cell_count   = column_count * (uint32_t)rows;
+
+  uint32_t *const sprite_cells = moss__allocate (
+    info->host_allocator,
+    sizeof (uint32_t) * info->sprite_count,
+    MOSS_ALLOCATION_CATEGORY_TEMPORARY
+  );
+  uint32_t *const cell_offsets = moss__allocate_zeroed (
+    info->host_allocator,
+    (size_t)cell_count + 1,
+    sizeof (uint32_t),
+    MOSS_ALLOCATION_CATEGORY_TEMPORARY
+  );
+  if (sprite_cells == NULL || cell_offsets == NULL)
+  {
+    moss__error ("Failed to allocate memory for sprite batch chunks.\n");
+    moss__free (info->host_allocator, sprite_cells);
+    moss__free (info->host_allocator, cell_offsets);
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Counting sort by cell keeps sprites of every cell in their original order
+  for (uint32_t i = 0; i < info->sprite_count; ++i)
+  {
+    vec2 min, max, center;
+    moss__get_sprite_data_bounds (
+      sprite_data + (size_t)i * info->sprite_data_size,
+      info->is_instanced,
+      min,
+      max
+    );
+    glm_vec2_add (min, max, center);
+    glm_vec2_scale (center, 0.5F, center);
+
+    uint32_t column = (uint32_t)((center[ 0 ] - grid_min[ 0 ]) / cell_size);
+    uint32_t row    = (uint32_t)((center[ 1 ] - grid_min[ 1 ]) / cell_size);
+    if (column >= column_count) { column = column_count - 1; }
+    if (row >= (uint32_t)rows) { row = (uint32_t)rows - 1; }
+
+    sprite_cells[ i ] = row * column_count + column;
+    ++cell_offsets[ sprite_cells[ i ] + 1 ];
+  }
+
+  uint32_t chunk_count = 0;
+  for (uint32_t cell = 0; cell < cell_count; ++cell)
+  {
+    if (cell_offsets[ cell + 1 ] > 0) { ++chunk_count; }
+    cell_offsets[ cell + 1 ] += cell_offsets[ cell ];
+  }
+
+  Moss__SpriteChunk *const chunks = moss__allocate (
+    info->host_allocator,
+    sizeof (Moss__SpriteChunk) * chunk_count,
+    MOSS_ALLOCATION_CATEGORY_SPRITE_BATCH
+  );
+  if (chunks == NULL)
+  {
+    moss__error ("Failed to allocate memory for sprite batch chunks.\n");
+    moss__free (info->host_allocator, sprite_cells);
+    moss__free (info->host_allocator, cell_offsets);
+    return MOSS_RESULT_ERROR;
+  }
+
+  for (uint32_t i = 0; i < info->sprite_count; ++i)
+  {
+    const uint32_t slot      = cell_offsets[ sprite_cells[ i ] ]++;
+    out_sprite_order[ slot ] = i;
+  }
+
+  // Offsets now point at cell ends, so cell ranges are read back from them
+  uint32_t chunk_index = 0;
+  uint32_t cell_start  = 0;
+  for (uint32_t cell = 0; cell < cell_count; ++cell)
+  {
+    const uint32_t cell_end = cell_offsets[ cell ];
+    if (cell_end == cell_start) { continue; }
+
+    Moss__SpriteChunk *const chunk = &chunks[ chunk_index++ ];
+    chunk->first_sprite            = cell_start;
+    chunk->sprite_count            = cell_end - cell_start;
+
+    moss__get_sprite_data_bounds (
+      sprite_data + (size_t)out_sprite_order[ cell_start ] * info->sprite_data_size,
+      info->is_instanced,
+      chunk->min,
+      chunk->max
+    );
+    for (uint32_t i = cell_start + 1; i < cell_end; ++i)
+    {
+      vec2 min, max;
+      moss__get_sprite_data_bounds (
+        sprite_data + (size_t)out_sprite_order[ i ] * info->sprite_data_size,
+        info->is_instanced,
+        min,
+        max
+      );
+      glm_vec2_minv (chunk->min, min, chunk->min);
+      glm_vec2_maxv (chunk->max, max, chunk->max);
+    }
+
+    cell_start = cell_end;
+  }
+
+  moss__free (info->host_allocator, sprite_cells);
+  moss__free (info->host_allocator, cell_offsets);
+
+  *out_chunks      = chunks;
+  *out_chunk_count = chunk_count;
+
+  return MOSS_RESULT_SUCCESS;
+}
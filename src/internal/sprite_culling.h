@@ -0,0 +1,149 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/sprite_culling.h
+  @brief GPU sprite culling command recording.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Culling dispatches can't be recorded inside the render pass, so they go
+           to a separate command buffer of the frame. It's submitted right before
+           the frame command buffer in the same batch and ends with a barrier that
+           makes culling results visible to indirect draws.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/result.h"
+
+#include "src/internal/engine.h"
+#include "src/internal/log.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Push constants of culling compute shaders.
+*/
+typedef struct
+{
+  float    camera_scale[ 2 ];  /* Scale of the camera sprites are tested against. */
+  float    camera_offset[ 2 ]; /* Offset of the camera sprites are tested against. */
+  uint32_t first_sprite;       /* First sprite of the batch region in the buffer. */
+  uint32_t sprite_count;       /* Number of sprites to test. */
+} Moss__SpriteCullPushConstants;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Returns cull command buffer of the current frame, begins it if needed.
+  @param engine Engine handle, frame must be begun.
+  @return Returns command buffer in recording state, VK_NULL_HANDLE on failure.
+*/
+inline static VkCommandBuffer moss__get_cull_command_buffer (MossEngine *const engine)
+{
+  const VkCommandBuffer command_buffer =
+    engine->cull_command_buffers[ engine->current_frame ];
+  if (engine->is_cull_recording) { return command_buffer; }
+
+  // Frame fence is already waited, so the previous recording has completed
+  vkResetCommandBuffer (command_buffer, 0);
+
+  const VkCommandBufferBeginInfo begin_info = {
+    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+    .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+
+  if (vkBeginCommandBuffer (command_buffer, &begin_info) != VK_SUCCESS)
+  {
+    moss__error ("Failed to begin recording cull command buffer.\n");
+    return VK_NULL_HANDLE;
+  }
+
+  // Culling results are shared by frames in flight, draws of the previous frame must
+  // stop reading them before they are rewritten. Compute writes of the previous frame,
+  // such as particle state and alive counters, must also be visible to this frame's
+  // compute reads and transfer rewrites
+  const VkMemoryBarrier barrier = {
+    .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+    .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+    .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                     VK_ACCESS_TRANSFER_WRITE_BIT,
+  };
+
+  vkCmdPipelineBarrier (
+    command_buffer,
+    VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+    VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+    0,
+    1,
+    &barrier,
+    0,
+    NULL,
+    0,
+    NULL
+  );
+
+  engine->is_cull_recording = true;
+
+  return command_buffer;
+}
+
+/*
+  @brief Ends cull command buffer of the current frame.
+  @param engine Engine handle, cull command buffer must be recording.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__end_cull_command_buffer (MossEngine *const engine)
+{
+  const VkCommandBuffer command_buffer =
+    engine->cull_command_buffers[ engine->current_frame ];
+
+  const VkMemoryBarrier barrier = {
+    .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+    .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+    .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                     VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+  };
+
+  vkCmdPipelineBarrier (
+    command_buffer,
+    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+    VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+    0,
+    1,
+    &barrier,
+    0,
+    NULL,
+    0,
+    NULL
+  );
+
+  engine->is_cull_recording = false;
+
+  if (vkEndCommandBuffer (command_buffer) != VK_SUCCESS)
+  {
+    moss__error ("Failed to end recording cull command buffer.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
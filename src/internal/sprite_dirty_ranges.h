@@ -0,0 +1,113 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/sprite_dirty_ranges.h
+  @brief Dirty sprite ranges of static sprite batches.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Ranges are kept sorted and disjoint, with gaps between neighbours.
+           Their number is bounded by MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT, so the
+           upload of a batch is a fixed number of copy regions at most.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include "moss/sprite_batch.h"
+
+#include "src/internal/config.h"
+
+/*
+  @brief Merges sprite range into sorted dirty ranges.
+  @details Overlapping and adjacent ranges are joined. If there are too many ranges,
+           the two closest ones are merged, so some clean sprites are copied too.
+  @param ranges Dirty ranges, must have room for MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT
+                plus one ranges.
+  @param range_count Number of dirty ranges, updated on return.
+  @param first_sprite Index of the first updated sprite.
+  @param sprite_count Number of updated sprites, must be greater than zero.
+*/
+inline static void moss__merge_sprite_dirty_range (
+  MossSpriteBatchRange *const ranges,
+  uint32_t *const             range_count,
+  const uint32_t              first_sprite,
+  const uint32_t              sprite_count
+)
+{
+  uint32_t count = *range_count;
+
+  uint32_t begin = first_sprite;
+  uint32_t end   = first_sprite + sprite_count;
+
+  // Ranges that end before the new one and don't touch it stay as they are
+  uint32_t first = 0;
+  while (first < count &&
+         ranges[ first ].first_sprite + ranges[ first ].sprite_count < begin)
+  {
+    ++first;
+  }
+
+  // Overlapping and adjacent ranges are absorbed by the new one
+  uint32_t last = first;
+  while (last < count && ranges[ last ].first_sprite <= end)
+  {
+    const uint32_t range_end = ranges[ last ].first_sprite + ranges[ last ].sprite_count;
+
+    begin = ranges[ last ].first_sprite < begin ? ranges[ last ].first_sprite : begin;
+    end   = range_end > end ? range_end : end;
+    ++last;
+  }
+
+  memmove (
+    &ranges[ first + 1 ],
+    &ranges[ last ],
+    (count - last) * sizeof (MossSpriteBatchRange)
+  );
+  ranges[ first ] = (MossSpriteBatchRange) {
+    .first_sprite = begin,
+    .sprite_count = end - begin,
+  };
+  count = count - (last - first) + 1;
+
+  if (count > MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT)
+  {
+    // Merge neighbours with the smallest gap, it copies the fewest clean sprites
+    uint32_t closest     = 0;
+    uint32_t closest_gap = UINT32_MAX;
+    for (uint32_t i = 0; i + 1 < count; ++i)
+    {
+      const uint32_t gap = ranges[ i + 1 ].first_sprite -
+                           (ranges[ i ].first_sprite + ranges[ i ].sprite_count);
+      if (gap < closest_gap)
+      {
+        closest     = i;
+        closest_gap = gap;
+      }
+    }
+
+    ranges[ closest ].sprite_count = ranges[ closest + 1 ].first_sprite +
+                                     ranges[ closest + 1 ].sprite_count -
+                                     ranges[ closest ].first_sprite;
+    memmove (
+      &ranges[ closest + 1 ],
+      &ranges[ closest + 2 ],
+      (count - closest - 2) * sizeof (MossSpriteBatchRange)
+    );
+    --count;
+  }
+
+  *range_count = count;
+}
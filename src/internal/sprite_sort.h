@@ -0,0 +1,140 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/sprite_sort.h
+  @brief Depth sorting of sprite batch data.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Depth test passes for smaller depth, so front-to-back order is ascending
+           depth. Sorting is stable, sprites of equal depth keep fill order. Only
+           sprite indices are sorted, depths are read from a cached host copy of
+           sprite data, so staging memory is never read.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "moss/result.h"
+
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+#include "src/internal/vertex.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Sort key of a single sprite.
+*/
+typedef struct
+{
+  float    depth; /* Sprite depth, negated for back-to-front order. */
+  uint32_t index; /* Index of the sprite in sprite data. */
+} Moss__SpriteSortKey;
+
+/*
+  @brief Sprite depth sort info.
+*/
+typedef struct
+{
+  const void *sprite_data;      /* Vertices or instances of sprites in host memory. */
+  uint32_t   *sprite_order;     /* Indices of sprites in sprite data, sorted in place. */
+  uint32_t    sprite_count;     /* Number of indices in sprite order. */
+  size_t      sprite_data_size; /* Size of a single sprite data in bytes. */
+  bool        is_instanced;     /* Whether sprite data holds instances. */
+  bool        is_compact;       /* Whether sprite data holds compact vertices. */
+  bool        is_back_to_front; /* Whether far sprites go first. */
+  /* Host allocator to allocate temporary sort buffers with. */
+  Moss__HostAllocator *host_allocator;
+} Moss__SortSpritesByDepthInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Compares sprite sort keys.
+  @param a First key.
+  @param b Second key.
+  @return Negative, zero or positive value as qsort expects.
+*/
+inline static int
+moss__compare_sprite_sort_keys (const void *const a, const void *const b)
+{
+  const Moss__SpriteSortKey *const key_a = a;
+  const Moss__SpriteSortKey *const key_b = b;
+
+  if (key_a->depth < key_b->depth) { return -1; }
+  if (key_a->depth > key_b->depth) { return 1; }
+
+  // Sprite index breaks ties, so qsort behaves as a stable sort
+  return (key_a->index > key_b->index) - (key_a->index < key_b->index);
+}
+
+/*
+  @brief Sorts sprite indices by depth of the sprites they refer to.
+  @details Indices must be ascending, so ties keep the order they came in.
+  @param info Required operation info.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__sort_sprites_by_depth (const Moss__SortSpritesByDepthInfo *const info)
+{
+  if (info->sprite_count < 2) { return MOSS_RESULT_SUCCESS; }
+
+  Moss__SpriteSortKey *const keys = moss__allocate (
+    info->host_allocator,
+    sizeof (Moss__SpriteSortKey) * info->sprite_count,
+    MOSS_ALLOCATION_CATEGORY_TEMPORARY
+  );
+  if (keys == NULL)
+  {
+    moss__error ("Failed to allocate memory for sprite depth sorting.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  const char *const sprite_data = info->sprite_data;
+  for (uint32_t i = 0; i < info->sprite_count; ++i)
+  {
+    // Packed compact depth keeps the order of the original one
+    const uint32_t    index = info->sprite_order[ i ];
+    const void *const data  = sprite_data + (size_t)index * info->sprite_data_size;
+    const float       depth = info->is_instanced
+                                ? ((const Moss__SpriteInstance *)data)->depth
+                              : info->is_compact
+                                ? (float)((const Moss__CompactVertex *)data)->depth
+                                : ((const Moss__Vertex *)data)->position[ 2 ];
+
+    keys[ i ] = (Moss__SpriteSortKey) {
+      .depth = info->is_back_to_front ? -depth : depth,
+      .index = index,
+    };
+  }
+
+  qsort (keys, info->sprite_count, sizeof (keys[ 0 ]), moss__compare_sprite_sort_keys);
+
+  for (uint32_t i = 0; i < info->sprite_count; ++i)
+  {
+    info->sprite_order[ i ] = keys[ i ].index;
+  }
+
+  moss__free (info->host_allocator, keys);
+
+  return MOSS_RESULT_SUCCESS;
+}
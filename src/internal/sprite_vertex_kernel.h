@@ -0,0 +1,362 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/sprite_vertex_kernel.h
+  @brief Sprite to quad vertex conversion kernels.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Kernel is selected at build time. SSE2 is used on x86-64 and NEON on
+           AArch64, both convert four sprites per iteration by transposing sprite
+           records into lanes and back into vertex records. SSE2 kernel writes
+           with non-temporal stores when the destination is 16-byte aligned, since
+           the destination is write-combined mapped memory that is never read back.
+           Define MOSS_DISABLE_SIMD to force the scalar kernel.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "moss/sprite.h"
+
+#include "src/internal/vertex.h"
+
+#if !defined(MOSS_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#  define MOSS__SPRITE_VERTEX_KERNEL_SSE2
+#  include <emmintrin.h>
+#elif !defined(MOSS_DISABLE_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#  define MOSS__SPRITE_VERTEX_KERNEL_NEON
+#  include <arm_neon.h>
+#endif
+
+#if defined(MOSS__SPRITE_VERTEX_KERNEL_SSE2) || defined(MOSS__SPRITE_VERTEX_KERNEL_NEON)
+#  define MOSS__SPRITE_VERTEX_KERNEL_SIMD
+#endif
+
+/* Number of 32-bit words in the four vertices generated from a sprite. */
+#define MOSS__SPRITE_VERTEX_FLOAT_COUNT (4 * sizeof (Moss__Vertex) / sizeof (float))
+
+/* Compile-time assertion, marked as an extension since the library is built as C99. */
+#if defined(__GNUC__)
+#  define MOSS__STATIC_ASSERT(condition, message) \
+    __extension__ _Static_assert (condition, message)
+#else
+#  define MOSS__STATIC_ASSERT(condition, message) _Static_assert (condition, message)
+#endif
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Generates verticies from sprite.
+  @param sprite Sprite to generate vertex data from.
+  @param out_vertices Output verticies.
+*/
+inline static void moss__generate_verticies_from_sprite (
+  const MossSprite *const sprite,
+  Moss__Vertex            out_vertices[ 4 ]
+)
+{
+  const float half_width  = sprite->size[ 0 ] * 0.5F;
+  const float half_height = sprite->size[ 1 ] * 0.5F;
+
+  const float bbox_left   = sprite->position[ 0 ] - half_width;
+  const float bbox_right  = sprite->position[ 0 ] + half_width;
+  const float bbox_bottom = sprite->position[ 1 ] - half_height;
+  const float bbox_top    = sprite->position[ 1 ] + half_height;
+
+  out_vertices[ 0 ] = (Moss__Vertex) {
+    .position       = { bbox_left, bbox_top, sprite->depth },
+    .texture_coords = { sprite->uv.top_left[ 0 ], sprite->uv.top_left[ 1 ] },
+    .texture_index  = sprite->texture_index,
+  };
+  out_vertices[ 1 ] = (Moss__Vertex) {
+    .position       = { bbox_right, bbox_top, sprite->depth },
+    .texture_coords = { sprite->uv.bottom_right[ 0 ], sprite->uv.top_left[ 1 ] },
+    .texture_index  = sprite->texture_index,
+  };
+  out_vertices[ 2 ] = (Moss__Vertex) {
+    .position       = { bbox_right, bbox_bottom, sprite->depth },
+    .texture_coords = { sprite->uv.bottom_right[ 0 ], sprite->uv.bottom_right[ 1 ] },
+    .texture_index  = sprite->texture_index,
+  };
+  out_vertices[ 3 ] = (Moss__Vertex) {
+    .position       = { bbox_left, bbox_bottom, sprite->depth },
+    .texture_coords = { sprite->uv.top_left[ 0 ], sprite->uv.bottom_right[ 1 ] },
+    .texture_index  = sprite->texture_index,
+  };
+}
+
+#ifdef MOSS__SPRITE_VERTEX_KERNEL_SIMD
+
+#  ifdef MOSS__SPRITE_VERTEX_KERNEL_SSE2
+
+/* Four float lanes. */
+typedef __m128 Moss__Float4;
+
+#    define moss__float4_load(ptr)           _mm_loadu_ps (ptr)
+#    define moss__float4_set(a, b, c, d)     _mm_set_ps ((d), (c), (b), (a))
+#    define moss__float4_set_bits(a, b, c, d) \
+      _mm_castsi128_ps (_mm_set_epi32 ((int)(d), (int)(c), (int)(b), (int)(a)))
+#    define moss__float4_splat(value)        _mm_set1_ps (value)
+#    define moss__float4_add(a, b)           _mm_add_ps ((a), (b))
+#    define moss__float4_sub(a, b)           _mm_sub_ps ((a), (b))
+#    define moss__float4_mul(a, b)           _mm_mul_ps ((a), (b))
+#    define moss__float4_store(ptr, value)   _mm_storeu_ps ((ptr), (value))
+#    define moss__float4_stream(ptr, value)  _mm_stream_ps ((ptr), (value))
+#    define moss__float4_stream_fence( )     _mm_sfence ( )
+
+/* Non-temporal stores require 16-byte aligned destination. */
+#    define MOSS__FLOAT4_HAS_STREAM 1
+
+/*
+  @brief Transposes 4x4 matrix stored as four rows of lanes in place.
+*/
+inline static void moss__float4_transpose (
+  Moss__Float4 *const a,
+  Moss__Float4 *const b,
+  Moss__Float4 *const c,
+  Moss__Float4 *const d
+)
+{
+  _MM_TRANSPOSE4_PS (*a, *b, *c, *d);
+}
+
+#  else
+
+/* Four float lanes. */
+typedef float32x4_t Moss__Float4;
+
+/*
+  @brief Packs four floats into lanes.
+  @return Lanes holding a, b, c, d in order.
+*/
+inline static Moss__Float4
+moss__float4_set (const float a, const float b, const float c, const float d)
+{
+  const float values[ 4 ] = { a, b, c, d };
+  return vld1q_f32 (values);
+}
+
+/*
+  @brief Packs bit patterns of four 32-bit integers into lanes.
+  @return Lanes holding a, b, c, d in order.
+*/
+inline static Moss__Float4 moss__float4_set_bits (
+  const uint32_t a,
+  const uint32_t b,
+  const uint32_t c,
+  const uint32_t d
+)
+{
+  const uint32_t values[ 4 ] = { a, b, c, d };
+  return vreinterpretq_f32_u32 (vld1q_u32 (values));
+}
+
+/*
+  @brief Transposes 4x4 matrix stored as four rows of lanes in place.
+*/
+inline static void moss__float4_transpose (
+  Moss__Float4 *const a,
+  Moss__Float4 *const b,
+  Moss__Float4 *const c,
+  Moss__Float4 *const d
+)
+{
+  const float32x4x2_t ab = vtrnq_f32 (*a, *b);
+  const float32x4x2_t cd = vtrnq_f32 (*c, *d);
+
+  *a = vcombine_f32 (vget_low_f32 (ab.val[ 0 ]), vget_low_f32 (cd.val[ 0 ]));
+  *b = vcombine_f32 (vget_low_f32 (ab.val[ 1 ]), vget_low_f32 (cd.val[ 1 ]));
+  *c = vcombine_f32 (vget_high_f32 (ab.val[ 0 ]), vget_high_f32 (cd.val[ 0 ]));
+  *d = vcombine_f32 (vget_high_f32 (ab.val[ 1 ]), vget_high_f32 (cd.val[ 1 ]));
+}
+
+#    define moss__float4_load(ptr)          vld1q_f32 (ptr)
+#    define moss__float4_splat(value)       vdupq_n_f32 (value)
+#    define moss__float4_add(a, b)          vaddq_f32 ((a), (b))
+#    define moss__float4_sub(a, b)          vsubq_f32 ((a), (b))
+#    define moss__float4_mul(a, b)          vmulq_f32 ((a), (b))
+#    define moss__float4_store(ptr, value)  vst1q_f32 ((ptr), (value))
+#    define moss__float4_stream(ptr, value) vst1q_f32 ((ptr), (value))
+#    define moss__float4_stream_fence( )    ((void)0)
+
+/* NEON has no non-temporal store intrinsic, regular stores are used. */
+#    define MOSS__FLOAT4_HAS_STREAM 0
+
+#  endif
+
+/* Kernel loads sprites and stores vertices as 32-bit words at fixed offsets. */
+MOSS__STATIC_ASSERT (sizeof (float) == 4, "Kernel loads 32-bit float words.");
+MOSS__STATIC_ASSERT (offsetof (MossSprite, depth) == 0, "Sprite depth is word 0.");
+MOSS__STATIC_ASSERT (
+  offsetof (MossSprite, position) == 1 * sizeof (float),
+  "Sprite position is words 1-2."
+);
+MOSS__STATIC_ASSERT (
+  offsetof (MossSprite, size) == 3 * sizeof (float),
+  "Sprite size is words 3-4."
+);
+MOSS__STATIC_ASSERT (
+  offsetof (MossSprite, uv.top_left) == 5 * sizeof (float),
+  "Sprite top left UV is words 5-6."
+);
+MOSS__STATIC_ASSERT (
+  offsetof (MossSprite, uv.bottom_right) == 7 * sizeof (float),
+  "Sprite bottom right UV is words 7-8."
+);
+MOSS__STATIC_ASSERT (
+  offsetof (MossSprite, texture_index) == 9 * sizeof (float) &&
+    sizeof (((MossSprite *)0)->texture_index) == sizeof (float),
+  "Sprite texture index is word 9."
+);
+MOSS__STATIC_ASSERT (
+  offsetof (Moss__Vertex, position) == 0 &&
+    offsetof (Moss__Vertex, texture_coords) == 3 * sizeof (float) &&
+    offsetof (Moss__Vertex, texture_index) == 5 * sizeof (float),
+  "Vertex is position, texture coordinates and texture index words."
+);
+MOSS__STATIC_ASSERT (
+  sizeof (Moss__Vertex) == 6 * sizeof (float),
+  "Vertex is six 32-bit words."
+);
+
+/*
+  @brief Converts four sprites into sixteen vertices.
+  @param sprites Four sprites to convert.
+  @param out Output vertex data, 4 * MOSS__SPRITE_VERTEX_FLOAT_COUNT floats.
+  @param is_streaming Whether to write with non-temporal stores, requires out
+                      to be 16-byte aligned.
+  @note Relies on MossSprite being laid out as depth, position, size, top left
+        and bottom right UV, all floats, followed by texture index, and
+        Moss__Vertex as position, texture coordinates and texture index, all
+        32-bit. Layout is checked by the assertions above.
+*/
+inline static void moss__generate_verticies_from_sprites_x4 (
+  const MossSprite *const sprites,
+  float *const            out,
+  const bool              is_streaming
+)
+{
+  const float *const s0 = &sprites[ 0 ].depth;
+  const float *const s1 = &sprites[ 1 ].depth;
+  const float *const s2 = &sprites[ 2 ].depth;
+  const float *const s3 = &sprites[ 3 ].depth;
+
+  // Transpose sprite records so each lane holds a field of one sprite
+  Moss__Float4 depth      = moss__float4_load (s0);
+  Moss__Float4 position_x = moss__float4_load (s1);
+  Moss__Float4 position_y = moss__float4_load (s2);
+  Moss__Float4 size_x     = moss__float4_load (s3);
+  moss__float4_transpose (&depth, &position_x, &position_y, &size_x);
+
+  Moss__Float4 size_y  = moss__float4_load (s0 + 4);
+  Moss__Float4 left_u  = moss__float4_load (s1 + 4);
+  Moss__Float4 top_v   = moss__float4_load (s2 + 4);
+  Moss__Float4 right_u = moss__float4_load (s3 + 4);
+  moss__float4_transpose (&size_y, &left_u, &top_v, &right_u);
+
+  const Moss__Float4 bottom_v = moss__float4_set (s0[ 8 ], s1[ 8 ], s2[ 8 ], s3[ 8 ]);
+
+  // Texture index is copied as is, lanes only carry its bits
+  const Moss__Float4 texture_index = moss__float4_set_bits (
+    sprites[ 0 ].texture_index,
+    sprites[ 1 ].texture_index,
+    sprites[ 2 ].texture_index,
+    sprites[ 3 ].texture_index
+  );
+
+  const Moss__Float4 half        = moss__float4_splat (0.5F);
+  const Moss__Float4 half_width  = moss__float4_mul (size_x, half);
+  const Moss__Float4 half_height = moss__float4_mul (size_y, half);
+
+  const Moss__Float4 bbox_left   = moss__float4_sub (position_x, half_width);
+  const Moss__Float4 bbox_right  = moss__float4_add (position_x, half_width);
+  const Moss__Float4 bbox_bottom = moss__float4_sub (position_y, half_height);
+  const Moss__Float4 bbox_top    = moss__float4_add (position_y, half_height);
+
+  // A sprite produces 24 words, which are six groups of four:
+  // [l t d u0] [v0 T r t] [d u1 v0 T] [r b d u1] [v1 T l b] [d u0 v1 T]
+  Moss__Float4 groups[ 6 ][ 4 ] = {
+    { bbox_left, bbox_top, depth, left_u },
+    { top_v, texture_index, bbox_right, bbox_top },
+    { depth, right_u, top_v, texture_index },
+    { bbox_right, bbox_bottom, depth, right_u },
+    { bottom_v, texture_index, bbox_left, bbox_bottom },
+    { depth, left_u, bottom_v, texture_index },
+  };
+
+  for (size_t i = 0; i < 6; ++i)
+  {
+    // After transposition row k holds the group of sprite k
+    moss__float4_transpose (
+      &groups[ i ][ 0 ],
+      &groups[ i ][ 1 ],
+      &groups[ i ][ 2 ],
+      &groups[ i ][ 3 ]
+    );
+
+    for (size_t k = 0; k < 4; ++k)
+    {
+      float *const dst = out + k * MOSS__SPRITE_VERTEX_FLOAT_COUNT + i * 4;
+      if (is_streaming) { moss__float4_stream (dst, groups[ i ][ k ]); }
+      else { moss__float4_store (dst, groups[ i ][ k ]); }
+    }
+  }
+}
+
+#endif /* MOSS__SPRITE_VERTEX_KERNEL_SIMD */
+
+/*
+  @brief Generates verticies for a range of sprites.
+  @param sprites Sprites to generate vertex data from.
+  @param sprite_count Number of sprites.
+  @param out_vertices Output verticies, 4 per sprite.
+*/
+inline static void moss__generate_verticies_from_sprites (
+  const MossSprite *const sprites,
+  const size_t            sprite_count,
+  Moss__Vertex *const     out_vertices
+)
+{
+  size_t i = 0;
+
+#ifdef MOSS__SPRITE_VERTEX_KERNEL_SIMD
+  float *const out = (float *)out_vertices;
+
+  // Quad vertex data is 96 bytes, so alignment of the first sprite holds for all
+  const bool is_streaming =
+    MOSS__FLOAT4_HAS_STREAM && ((uintptr_t)out & (uintptr_t)15) == 0;
+
+  for (; i + 4 <= sprite_count; i += 4)
+  {
+    moss__generate_verticies_from_sprites_x4 (
+      &sprites[ i ],
+      out + i * MOSS__SPRITE_VERTEX_FLOAT_COUNT,
+      is_streaming
+    );
+  }
+
+  // Make non-temporal stores visible before the memory is handed to the device
+  if (is_streaming) { moss__float4_stream_fence ( ); }
+#endif
+
+  for (; i < sprite_count; ++i)
+  {
+    moss__generate_verticies_from_sprite (&sprites[ i ], &out_vertices[ i * 4 ]);
+  }
+}
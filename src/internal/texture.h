@@ -0,0 +1,56 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/texture.h
+  @brief Private texture struct body declaration.
+  @author Ilya Buravov (ilburale@gmail.com)
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/engine.h"
+#include "moss/texture.h"
+
+#include "src/internal/texture_loader.h"
+#include "src/internal/vulkan/utils/allocator.h"
+
+struct MossTexture
+{
+  MossEngine           *original_engine;  /* Engine where this texture was created on. */
+  VkImage               image;            /* Texture image. */
+  VkImageView           image_view;       /* Texture image view. */
+  Moss__VkAllocation    image_allocation; /* Texture image memory. */
+  VkDescriptorSet       descriptor_set;   /* Descriptor set texture is bound with. */
+  uint32_t              index;            /* Slot in the bindless texture array. */
+  VkFormat              format;           /* Texture image format. */
+  uint32_t              width;            /* Texture width in pixels. */
+  uint32_t              height;           /* Texture height in pixels. */
+  uint32_t              mip_level_count;  /* Number of texture image mip levels. */
+  uint64_t              upload_value;     /* Upload timeline value of the pixel copy. */
+  MossTextureState      state;            /* Loading state. */
+  Moss__TextureLoadJob *load_job;         /* Job loading the texture, NULL once done. */
+};
+
+/*
+  @brief Uploads textures the loader thread finished decoding.
+  @details Called by moss_begin_frame. Uploads stop once a frame's streaming budget
+           is spent, the rest are picked up by the next frames.
+  @param engine Engine handle.
+*/
+void moss__finish_texture_loads (MossEngine *engine);
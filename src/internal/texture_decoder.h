@@ -0,0 +1,347 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/texture_decoder.h
+  @brief Host side texture decoding.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Decoding touches no Vulkan objects, so it runs on the texture loader
+           thread as well as on the calling thread of synchronous texture creation.
+*/
+
+#pragma once
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vulkan/vulkan.h>
+
+#include <src/internal/stb_image.h>
+
+#include "moss/result.h"
+
+#include "src/internal/config.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/ktx2.h"
+#include "src/internal/log.h"
+#include "src/internal/mipmap.h"
+
+/* Image format of textures created from 8-bit RGBA pixels. */
+#define MOSS__TEXTURE_FORMAT VK_FORMAT_R8G8B8A8_SRGB
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Texture image contents ready to be uploaded.
+  @details Levels point either into owned memory below or into caller memory.
+*/
+typedef struct
+{
+  VkFormat           format;                                /* Image format. */
+  uint32_t           width;                                 /* Level 0 width. */
+  uint32_t           height;                                /* Level 0 height. */
+  uint32_t           level_count;                           /* Mip levels. */
+  Moss__TextureLevel levels[ MAX_TEXTURE_MIP_LEVEL_COUNT ]; /* Level data. */
+  uint8_t           *file_data; /* Owned file contents, KTX2 levels point into it. */
+  stbi_uc           *pixels;    /* Owned decoded pixels of level 0. */
+  uint8_t           *mip_chain; /* Owned generated levels past level 0. */
+  /* Host allocator of owned file data and generated levels. */
+  Moss__HostAllocator *host_allocator;
+} Moss__DecodedTexture;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Initializes decoded texture with empty state.
+  @param decoded Decoded texture to initialize.
+  @param host_allocator Host allocator to allocate owned memory with.
+*/
+inline static void moss__init_decoded_texture_state (
+  Moss__DecodedTexture *const decoded,
+  Moss__HostAllocator *const  host_allocator
+)
+{
+  *decoded = (Moss__DecodedTexture) {
+    .format         = MOSS__TEXTURE_FORMAT,
+    .width          = 0,
+    .height         = 0,
+    .level_count    = 0,
+    .file_data      = NULL,
+    .pixels         = NULL,
+    .mip_chain      = NULL,
+    .host_allocator = host_allocator,
+  };
+}
+
+/*
+  @brief Frees memory owned by decoded texture.
+  @param decoded Decoded texture.
+*/
+inline static void moss__free_decoded_texture (Moss__DecodedTexture *const decoded)
+{
+  moss__free (decoded->host_allocator, decoded->file_data);
+  moss__free (decoded->host_allocator, decoded->mip_chain);
+  if (decoded->pixels != NULL) { stbi_image_free (decoded->pixels); }
+
+  moss__init_decoded_texture_state (decoded, decoded->host_allocator);
+}
+
+/*
+  @brief Returns total size of decoded texture levels.
+  @param decoded Decoded texture.
+  @return Size of every level in bytes.
+*/
+inline static size_t
+moss__get_decoded_texture_size (const Moss__DecodedTexture *const decoded)
+{
+  size_t size = 0;
+  for (uint32_t level = 0; level < decoded->level_count; ++level)
+  {
+    size += decoded->levels[ level ].size;
+  }
+
+  return size;
+}
+
+/*
+  @brief Fills mip levels of 8-bit sRGB RGBA texture.
+  @details Level 0 data and size must be set. Without generate_mipmaps only level 0
+           is kept.
+  @param decoded Decoded texture to fill.
+  @param generate_mipmaps Whether to generate a full mip chain.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__generate_texture_mip_chain (
+  Moss__DecodedTexture *const decoded,
+  const bool                  generate_mipmaps
+)
+{
+  uint32_t level_count =
+    generate_mipmaps ? moss__get_mip_level_count (decoded->width, decoded->height) : 1;
+  if (level_count > MAX_TEXTURE_MIP_LEVEL_COUNT)
+  {
+    level_count = MAX_TEXTURE_MIP_LEVEL_COUNT;
+  }
+
+  decoded->level_count = 1;
+  if (level_count == 1) { return MOSS_RESULT_SUCCESS; }
+
+  size_t mip_chain_size = 0;
+  for (uint32_t level = 1; level < level_count; ++level)
+  {
+    mip_chain_size += (size_t)moss__get_mip_level_size (decoded->width, level) *
+                      (size_t)moss__get_mip_level_size (decoded->height, level) * 4;
+  }
+
+  decoded->mip_chain = moss__allocate (
+    decoded->host_allocator,
+    mip_chain_size,
+    MOSS_ALLOCATION_CATEGORY_TEXTURE
+  );
+  if (decoded->mip_chain == NULL)
+  {
+    moss__error ("Failed to allocate memory for texture mip levels.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  Moss__SrgbTables srgb_tables;
+  moss__init_srgb_tables (&srgb_tables);
+
+  // Each level is downsampled from the previous one, all in host memory
+  uint8_t *level_data = decoded->mip_chain;
+  for (uint32_t level = 1; level < level_count; ++level)
+  {
+    const uint32_t level_width  = moss__get_mip_level_size (decoded->width, level);
+    const uint32_t level_height = moss__get_mip_level_size (decoded->height, level);
+
+    moss__downsample_mip_level (
+      &srgb_tables,
+      decoded->levels[ level - 1 ].data,
+      moss__get_mip_level_size (decoded->width, level - 1),
+      moss__get_mip_level_size (decoded->height, level - 1),
+      level_data
+    );
+
+    decoded->levels[ level ] = (Moss__TextureLevel) {
+      .data = level_data,
+      .size = (size_t)level_width * (size_t)level_height * 4,
+    };
+    level_data += decoded->levels[ level ].size;
+  }
+
+  decoded->level_count = level_count;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Reads the whole texture file into memory.
+  @param host_allocator Host allocator to allocate file data with.
+  @param file_path Path to the file.
+  @param out_data Output file data, must be freed with moss__free.
+  @param out_size Output file size.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__read_texture_file (
+  Moss__HostAllocator *const host_allocator,
+  const char *const          file_path,
+  uint8_t **const            out_data,
+  size_t *const              out_size
+)
+{
+  FILE *const file = fopen (file_path, "rb");
+  if (file == NULL)
+  {
+    moss__error ("Failed to open texture file: %s\n", file_path);
+    return MOSS_RESULT_ERROR;
+  }
+
+  fseek (file, 0, SEEK_END);
+  const long file_size = ftell (file);
+  fseek (file, 0, SEEK_SET);
+
+  if (file_size <= 0)
+  {
+    moss__error ("Invalid texture file size: %s\n", file_path);
+    fclose (file);
+    return MOSS_RESULT_ERROR;
+  }
+
+  const size_t   data_size = (size_t)file_size;
+  uint8_t *const data =
+    moss__allocate (host_allocator, data_size, MOSS_ALLOCATION_CATEGORY_TEXTURE);
+  if (data == NULL)
+  {
+    moss__error ("Failed to allocate memory for texture file: %s\n", file_path);
+    fclose (file);
+    return MOSS_RESULT_ERROR;
+  }
+
+  const size_t read_size = fread (data, 1, data_size, file);
+  fclose (file);
+
+  if (read_size != data_size)
+  {
+    moss__error ("Failed to read texture file: %s\n", file_path);
+    moss__free (host_allocator, data);
+    return MOSS_RESULT_ERROR;
+  }
+
+  *out_data = data;
+  *out_size = data_size;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Reads and decodes texture file.
+  @details KTX2 files are only parsed, their blocks are uploaded directly. Other
+           files are decoded with stb_image, which allocates decoded pixels
+           with malloc.
+  @param host_allocator Host allocator to allocate owned memory with.
+  @param file_path Path to the file.
+  @param generate_mipmaps Whether to generate mips, ignored for KTX2.
+  @param out_decoded Output decoded texture, must be freed with
+                     moss__free_decoded_texture.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__decode_texture_file (
+  Moss__HostAllocator *const  host_allocator,
+  const char *const           file_path,
+  const bool                  generate_mipmaps,
+  Moss__DecodedTexture *const out_decoded
+)
+{
+  moss__init_decoded_texture_state (out_decoded, host_allocator);
+
+  size_t file_size;
+  if (moss__read_texture_file (
+        host_allocator,
+        file_path,
+        &out_decoded->file_data,
+        &file_size
+      ) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (moss__is_ktx2 (out_decoded->file_data, file_size))
+  {
+    Moss__Ktx2Image image;
+    if (moss__parse_ktx2 (out_decoded->file_data, file_size, &image) !=
+        MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to load \"%s\".\n", file_path);
+      moss__free_decoded_texture (out_decoded);
+      return MOSS_RESULT_ERROR;
+    }
+
+    out_decoded->format      = image.format_info.format;
+    out_decoded->width       = image.width;
+    out_decoded->height      = image.height;
+    out_decoded->level_count = image.level_count;
+    for (uint32_t level = 0; level < image.level_count; ++level)
+    {
+      out_decoded->levels[ level ] = image.levels[ level ];
+    }
+
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  int texture_width, texture_height, texture_channels;  // NOLINT
+
+  out_decoded->pixels = file_size <= INT_MAX ? stbi_load_from_memory (
+                                                 out_decoded->file_data,
+                                                 (int)file_size,
+                                                 &texture_width,
+                                                 &texture_height,
+                                                 &texture_channels,
+                                                 STBI_rgb_alpha
+                                               )
+                                             : NULL;
+
+  // Encoded file is no longer needed once pixels are decoded
+  moss__free (host_allocator, out_decoded->file_data);
+  out_decoded->file_data = NULL;
+
+  if (out_decoded->pixels == NULL)
+  {
+    moss__error ("Failed to load texture \"%s\".\n", file_path);
+    return MOSS_RESULT_ERROR;
+  }
+
+  out_decoded->width       = (uint32_t)texture_width;
+  out_decoded->height      = (uint32_t)texture_height;
+  out_decoded->levels[ 0 ] = (Moss__TextureLevel) {
+    .data = out_decoded->pixels,
+    .size = (size_t)out_decoded->width * (size_t)out_decoded->height * 4,
+  };
+
+  if (moss__generate_texture_mip_chain (out_decoded, generate_mipmaps) !=
+      MOSS_RESULT_SUCCESS)
+  {
+    moss__free_decoded_texture (out_decoded);
+    return MOSS_RESULT_ERROR;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/texture_index_pool.h
+  @brief Allocator of slots in the bindless texture array.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Slots are handed out in increasing order until the array is full, then
+           released slots are reused. Slots are released through the deletion
+           queue, so a reused slot is never sampled by a frame in flight.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "moss/result.h"
+
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Texture index pool state.
+*/
+typedef struct
+{
+  /* Host allocator free index array is allocated with. */
+  Moss__HostAllocator *host_allocator;
+  /* Released indices ready to be reused. */
+  uint32_t *free_indices;
+  /* Number of released indices. */
+  uint32_t free_count;
+  /* Lowest index that was never handed out. */
+  uint32_t next_index;
+  /* Number of slots in the texture array. */
+  uint32_t capacity;
+} Moss__TextureIndexPool;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Initializes texture index pool with empty state.
+  @param pool Texture index pool to initialize.
+*/
+inline static void
+moss__init_texture_index_pool_state (Moss__TextureIndexPool *const pool)
+{
+  *pool = (Moss__TextureIndexPool) {
+    .host_allocator = NULL,
+    .free_indices   = NULL,
+    .free_count     = 0,
+    .next_index     = 0,
+    .capacity       = 0,
+  };
+}
+
+/*
+  @brief Creates texture index pool.
+  @param pool Texture index pool to initialize.
+  @param host_allocator Host allocator to allocate free index array with.
+  @param capacity Number of slots in the texture array.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_texture_index_pool (
+  Moss__TextureIndexPool *const pool,
+  Moss__HostAllocator *const    host_allocator,
+  const uint32_t                capacity
+)
+{
+  moss__init_texture_index_pool_state (pool);
+
+  pool->host_allocator = host_allocator;
+  pool->free_indices   = moss__allocate (
+    host_allocator,
+    capacity * sizeof (uint32_t),
+    MOSS_ALLOCATION_CATEGORY_TEXTURE
+  );
+  if (pool->free_indices == NULL)
+  {
+    moss__error ("Failed to allocate memory for texture index pool.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  pool->capacity = capacity;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Acquires a free texture index.
+  @param pool Texture index pool.
+  @param out_index Output texture index.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR if every slot
+          is taken.
+*/
+inline static MossResult moss__acquire_texture_index (
+  Moss__TextureIndexPool *const pool,
+  uint32_t *const               out_index
+)
+{
+  if (pool->next_index < pool->capacity)
+  {
+    *out_index = pool->next_index++;
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  if (pool->free_count == 0)
+  {
+    moss__error ("Texture array is full, %u textures are alive.\n", pool->capacity);
+    return MOSS_RESULT_ERROR;
+  }
+
+  *out_index = pool->free_indices[ --pool->free_count ];
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Releases texture index.
+  @param pool Texture index pool.
+  @param index Texture index acquired from the pool.
+*/
+inline static void
+moss__release_texture_index (Moss__TextureIndexPool *const pool, const uint32_t index)
+{
+  pool->free_indices[ pool->free_count++ ] = index;
+}
+
+/*
+  @brief Destroys texture index pool.
+  @param pool Texture index pool to destroy.
+*/
+inline static void moss__destroy_texture_index_pool (Moss__TextureIndexPool *const pool)
+{
+  // Pool that was never created has no allocator and nothing to free
+  if (pool->host_allocator != NULL)
+  {
+    moss__free (pool->host_allocator, pool->free_indices);
+  }
+  moss__init_texture_index_pool_state (pool);
+}
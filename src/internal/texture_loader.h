@@ -0,0 +1,329 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/texture_loader.h
+  @brief Background texture loader thread.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Loader thread reads and decodes texture files, mips included, and hands
+           decoded jobs back through the completed list. Vulkan objects are only
+           created by the thread that begins frames, the loader never touches them.
+*/
+
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "moss/result.h"
+#include "moss/texture.h"
+
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+#include "src/internal/texture_decoder.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Texture load job.
+*/
+typedef struct Moss__TextureLoadJob Moss__TextureLoadJob;
+struct Moss__TextureLoadJob
+{
+  /* Next job in the list. */
+  Moss__TextureLoadJob *next;
+  /* Host allocator job and its decoded data are allocated with. */
+  Moss__HostAllocator *host_allocator;
+  /* Texture to fill, NULL if it was destroyed while loading. Main thread only. */
+  MossTexture *texture;
+  /* Callback to invoke once the texture is finished. */
+  MossTextureLoadCallback callback;
+  /* User data passed to the callback. */
+  void *user_data;
+  /* Owned copy of the file path. */
+  char *file_path;
+  /* Whether to generate mips. */
+  bool generate_mipmaps;
+  /* Decoding result, written by the loader thread. */
+  MossResult result;
+  /* Decoded texture, written by the loader thread. */
+  Moss__DecodedTexture decoded;
+};
+
+/*
+  @brief Texture loader state.
+*/
+typedef struct
+{
+  /* Loader thread. */
+  pthread_t thread;
+  /* Mutex guarding job lists and the stop flag. */
+  pthread_mutex_t mutex;
+  /* Condition loader thread waits for jobs on. */
+  pthread_cond_t condition;
+  /* Jobs waiting to be decoded. */
+  Moss__TextureLoadJob *pending_head;
+  /* Last pending job. */
+  Moss__TextureLoadJob *pending_tail;
+  /* Decoded jobs waiting to be uploaded. */
+  Moss__TextureLoadJob *completed_head;
+  /* Last completed job. */
+  Moss__TextureLoadJob *completed_tail;
+  /* Whether loader thread must exit. */
+  bool should_stop;
+  /* Whether loader thread is started. */
+  bool is_running;
+} Moss__TextureLoader;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Initializes texture loader with empty state.
+  @param loader Texture loader to initialize.
+*/
+inline static void moss__init_texture_loader_state (Moss__TextureLoader *const loader)
+{
+  memset (loader, 0, sizeof (*loader));
+  loader->pending_head   = NULL;
+  loader->pending_tail   = NULL;
+  loader->completed_head = NULL;
+  loader->completed_tail = NULL;
+  loader->should_stop    = false;
+  loader->is_running     = false;
+}
+
+/*
+  @brief Creates texture load job.
+  @param host_allocator Host allocator to allocate job with.
+  @param file_path Path to the texture file, copied.
+  @param generate_mipmaps Whether to generate mips.
+  @return Returns a valid pointer to a job on success, otherwise returns NULL.
+*/
+inline static Moss__TextureLoadJob *moss__create_texture_load_job (
+  Moss__HostAllocator *const host_allocator,
+  const char *const          file_path,
+  const bool                 generate_mipmaps
+)
+{
+  Moss__TextureLoadJob *const job = moss__allocate (
+    host_allocator,
+    sizeof (Moss__TextureLoadJob),
+    MOSS_ALLOCATION_CATEGORY_TEXTURE
+  );
+  if (job == NULL)
+  {
+    moss__error ("Failed to allocate memory for texture load job.\n");
+    return NULL;
+  }
+
+  *job = (Moss__TextureLoadJob) {
+    .next             = NULL,
+    .host_allocator   = host_allocator,
+    .texture          = NULL,
+    .callback         = NULL,
+    .user_data        = NULL,
+    .file_path        = moss__duplicate_string (
+      host_allocator,
+      file_path,
+      MOSS_ALLOCATION_CATEGORY_TEXTURE
+    ),
+    .generate_mipmaps = generate_mipmaps,
+    .result           = MOSS_RESULT_ERROR,
+  };
+  moss__init_decoded_texture_state (&job->decoded, host_allocator);
+
+  if (job->file_path == NULL)
+  {
+    moss__error ("Failed to allocate memory for texture load job.\n");
+    moss__free (host_allocator, job);
+    return NULL;
+  }
+
+  return job;
+}
+
+/*
+  @brief Destroys texture load job and its decoded data.
+  @param job Job to destroy.
+*/
+inline static void moss__destroy_texture_load_job (Moss__TextureLoadJob *const job)
+{
+  moss__free_decoded_texture (&job->decoded);
+  moss__free (job->host_allocator, job->file_path);
+  moss__free (job->host_allocator, job);
+}
+
+/*
+  @brief Texture loader thread routine.
+  @param arg Texture loader.
+  @return Always NULL.
+*/
+inline static void *moss__texture_loader_thread (void *const arg)
+{
+  Moss__TextureLoader *const loader = arg;
+
+  pthread_mutex_lock (&loader->mutex);
+  while (true)
+  {
+    while (loader->pending_head == NULL && !loader->should_stop)
+    {
+      pthread_cond_wait (&loader->condition, &loader->mutex);
+    }
+
+    if (loader->should_stop) { break; }
+
+    Moss__TextureLoadJob *const job = loader->pending_head;
+    loader->pending_head            = job->next;
+    if (loader->pending_head == NULL) { loader->pending_tail = NULL; }
+
+    // Decoding is the slow part, other threads may queue and collect jobs meanwhile
+    pthread_mutex_unlock (&loader->mutex);
+    job->result = moss__decode_texture_file (
+      job->host_allocator,
+      job->file_path,
+      job->generate_mipmaps,
+      &job->decoded
+    );
+    pthread_mutex_lock (&loader->mutex);
+
+    job->next = NULL;
+    if (loader->completed_tail != NULL) { loader->completed_tail->next = job; }
+    else {
+      loader->completed_head = job;
+    }
+    loader->completed_tail = job;
+  }
+  pthread_mutex_unlock (&loader->mutex);
+
+  return NULL;
+}
+
+/*
+  @brief Starts texture loader thread.
+  @param loader Texture loader.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__start_texture_loader (Moss__TextureLoader *const loader)
+{
+  moss__init_texture_loader_state (loader);
+
+  if (pthread_mutex_init (&loader->mutex, NULL) != 0)
+  {
+    moss__error ("Failed to create texture loader mutex.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (pthread_cond_init (&loader->condition, NULL) != 0)
+  {
+    moss__error ("Failed to create texture loader condition.\n");
+    pthread_mutex_destroy (&loader->mutex);
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (pthread_create (&loader->thread, NULL, moss__texture_loader_thread, loader) != 0)
+  {
+    moss__error ("Failed to create texture loader thread.\n");
+    pthread_cond_destroy (&loader->condition);
+    pthread_mutex_destroy (&loader->mutex);
+    return MOSS_RESULT_ERROR;
+  }
+
+  loader->is_running = true;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Queues job to be decoded by the loader thread.
+  @param loader Running texture loader.
+  @param job Job to queue, owned by the loader from now on.
+*/
+inline static void moss__push_texture_load_job (
+  Moss__TextureLoader *const  loader,
+  Moss__TextureLoadJob *const job
+)
+{
+  job->next = NULL;
+
+  pthread_mutex_lock (&loader->mutex);
+  if (loader->pending_tail != NULL) { loader->pending_tail->next = job; }
+  else {
+    loader->pending_head = job;
+  }
+  loader->pending_tail = job;
+  pthread_cond_signal (&loader->condition);
+  pthread_mutex_unlock (&loader->mutex);
+}
+
+/*
+  @brief Takes the oldest decoded job.
+  @param loader Texture loader.
+  @return Returns decoded job owned by the caller, NULL if there are none.
+*/
+inline static Moss__TextureLoadJob *
+moss__pop_completed_texture_load_job (Moss__TextureLoader *const loader)
+{
+  if (!loader->is_running) { return NULL; }
+
+  pthread_mutex_lock (&loader->mutex);
+  Moss__TextureLoadJob *const job = loader->completed_head;
+  if (job != NULL)
+  {
+    loader->completed_head = job->next;
+    if (loader->completed_head == NULL) { loader->completed_tail = NULL; }
+  }
+  pthread_mutex_unlock (&loader->mutex);
+
+  return job;
+}
+
+/*
+  @brief Stops texture loader thread and destroys every queued job.
+  @details Job being decoded is finished first.
+  @param loader Texture loader.
+*/
+inline static void moss__stop_texture_loader (Moss__TextureLoader *const loader)
+{
+  if (!loader->is_running) { return; }
+
+  pthread_mutex_lock (&loader->mutex);
+  loader->should_stop = true;
+  pthread_cond_signal (&loader->condition);
+  pthread_mutex_unlock (&loader->mutex);
+
+  pthread_join (loader->thread, NULL);
+
+  Moss__TextureLoadJob *const lists[] = { loader->pending_head, loader->completed_head };
+  for (size_t i = 0; i < sizeof (lists) / sizeof (lists[ 0 ]); ++i)
+  {
+    Moss__TextureLoadJob *job = lists[ i ];
+    while (job != NULL)
+    {
+      Moss__TextureLoadJob *const next = job->next;
+      moss__destroy_texture_load_job (job);
+      job = next;
+    }
+  }
+
+  pthread_cond_destroy (&loader->condition);
+  pthread_mutex_destroy (&loader->mutex);
+
+  moss__init_texture_loader_state (loader);
+}
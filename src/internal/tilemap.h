@@ -0,0 +1,152 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/tilemap.h
+  @brief Tilemap push constants and descriptor objects.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Tilemaps are drawn with the sprite pipeline layout. Set 2 holds the tile
+           buffer of a tilemap and its parameters are pushed after the animation
+           time, so texture and animation sets stay bound across tilemap draws.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/result.h"
+
+#include "src/internal/animation.h"
+#include "src/internal/config.h"
+#include "src/internal/engine.h"
+#include "src/internal/log.h"
+
+/* Offset of tilemap push constants, animation time rounded up to vec2 alignment. */
+#define MOSS__TILEMAP_PUSH_CONSTANT_OFFSET \
+  (uint32_t)((MOSS__ANIMATION_TIME_PUSH_CONSTANT_OFFSET + sizeof (float) + 7) & ~7U)
+
+/*
+  @brief Tilemap parameters pushed to tilemap shaders.
+  @warning Layout must match push constants of tilemap shaders.
+*/
+typedef struct
+{
+  float    position[ 2 ];   /* World position of the top left map corner. */
+  float    tile_size[ 2 ];  /* World size of a single tile. */
+  uint32_t map_size[ 2 ];   /* Map width and height in tiles. */
+  uint32_t atlas_size[ 2 ]; /* Atlas cell columns and rows. */
+  float    depth;           /* Depth tiles are drawn at. */
+  uint32_t texture_index;   /* Bindless atlas texture index. */
+  uint32_t chunk_size;      /* Chunk width and height in tiles. */
+} Moss__TilemapPushConstants;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Creates tilemap descriptor set layout and pool.
+  @param engine Engine handle, device must be created.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__create_tilemap_descriptor_objects (MossEngine *const engine)
+{
+  {  // Create descriptor set layout
+    const VkDescriptorSetLayoutBinding layout_binding = {
+      .binding         = 0,
+      .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      .descriptorCount = 1,
+      .stageFlags      = VK_SHADER_STAGE_FRAGMENT_BIT,
+    };
+
+    const VkDescriptorSetLayoutCreateInfo create_info = {
+      .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .bindingCount = 1,
+      .pBindings    = &layout_binding,
+    };
+
+    const VkResult result = vkCreateDescriptorSetLayout (
+      engine->device,
+      &create_info,
+      &engine->vk_allocation_callbacks,
+      &engine->tilemap_descriptor_set_layout
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to create tilemap descriptor layout: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Create descriptor pool
+    const VkDescriptorPoolSize pool_size = {
+      .type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      .descriptorCount = (uint32_t)MAX_TILEMAP_COUNT,
+    };
+
+    // Tilemaps free their sets on destruction
+    const VkDescriptorPoolCreateInfo pool_info = {
+      .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+      .poolSizeCount = 1,
+      .pPoolSizes    = &pool_size,
+      .maxSets       = (uint32_t)MAX_TILEMAP_COUNT,
+    };
+
+    const VkResult result = vkCreateDescriptorPool (
+      engine->device,
+      &pool_info,
+      &engine->vk_allocation_callbacks,
+      &engine->tilemap_descriptor_pool
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to create tilemap descriptor pool: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Destroys tilemap descriptor set layout and pool.
+  @param engine Engine handle, device must be idle.
+*/
+inline static void moss__destroy_tilemap_descriptor_objects (MossEngine *const engine)
+{
+  if (engine->tilemap_descriptor_pool != VK_NULL_HANDLE)
+  {
+    vkDestroyDescriptorPool (
+      engine->device,
+      engine->tilemap_descriptor_pool,
+      &engine->vk_allocation_callbacks
+    );
+  }
+
+  if (engine->tilemap_descriptor_set_layout != VK_NULL_HANDLE)
+  {
+    vkDestroyDescriptorSetLayout (
+      engine->device,
+      engine->tilemap_descriptor_set_layout,
+      &engine->vk_allocation_callbacks
+    );
+  }
+
+  engine->tilemap_descriptor_pool       = VK_NULL_HANDLE;
+  engine->tilemap_descriptor_set_layout = VK_NULL_HANDLE;
+}
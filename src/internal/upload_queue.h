@@ -0,0 +1,689 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/upload_queue.h
+  @brief Transfer upload queue utility functions.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Transfers are recorded into a ring of reusable command buffers and
+           submitted in one go. Every submit signals the next value of a timeline
+           semaphore, so consumers wait for uploads on the GPU and staging buffers
+           are released once their value is reached. Frame submits signal their
+           frame count on a second timeline semaphore, so the host can wait for
+           frames that copy from persistent staging buffers.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/result.h"
+
+#include "src/internal/config.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+#include "src/internal/vulkan/utils/allocator.h"
+#include "src/internal/vulkan/utils/buffer.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Staging buffer waiting for its upload to complete.
+*/
+typedef struct
+{
+  VkBuffer           buffer;         /* Staging buffer. */
+  Moss__VkAllocation allocation;     /* Staging buffer memory. */
+  uint64_t           timeline_value; /* Timeline value after which buffer can be freed. */
+} Moss__UploadQueueStagingBuffer;
+
+/*
+  @brief Upload queue state.
+*/
+typedef struct
+{
+  /* Logical device. */
+  VkDevice device;
+  /* Allocator staging buffers are allocated with. */
+  Moss__VkAllocator *allocator;
+  /* Queue uploads are submitted to. */
+  VkQueue queue;
+  /* Command pool upload command buffers are allocated in. */
+  VkCommandPool command_pool;
+  /* Timeline semaphore signaled by every upload submit. */
+  VkSemaphore timeline_semaphore;
+  /* Timeline semaphore signaled with the frame count by every frame submit. */
+  VkSemaphore frame_semaphore;
+  /* Ring of reusable upload command buffers. */
+  VkCommandBuffer command_buffers[ UPLOAD_QUEUE_COMMAND_BUFFER_COUNT ];
+  /* Timeline values signaled by the last submit of every ring command buffer. */
+  uint64_t command_buffer_values[ UPLOAD_QUEUE_COMMAND_BUFFER_COUNT ];
+  /* Index of the current command buffer in the ring. */
+  uint32_t command_buffer_index;
+  /* Whether current command buffer is being recorded. */
+  bool is_recording;
+  /* Last submitted timeline value. */
+  uint64_t submitted_value;
+  /* Bytes recorded for upload since creation, reported by frame statistics. */
+  uint64_t recorded_bytes;
+  /* Staging buffers waiting for their uploads to complete. */
+  Moss__UploadQueueStagingBuffer *staging_buffers;
+  /* Number of staging buffers in flight. */
+  size_t staging_buffer_count;
+  /* Capacity of staging buffer array. */
+  size_t staging_buffer_capacity;
+} Moss__UploadQueue;
+
+/*
+  @brief Required info to create upload queue.
+*/
+typedef struct
+{
+  VkDevice           device;           /* Logical device. */
+  VkQueue            queue;            /* Queue to submit uploads to. */
+  VkCommandPool      command_pool;     /* Command pool to allocate command buffers in,
+                                          must allow command buffer reset. */
+  Moss__VkAllocator *allocator;        /* Allocator to allocate staging buffers with. */
+  Moss__UploadQueue *out_upload_queue; /* Upload queue to initialize. */
+} Moss__CreateUploadQueueInfo;
+
+/*
+  @brief Required info to upload data into a buffer.
+*/
+typedef struct
+{
+  VkBuffer         destination_buffer; /* Buffer to upload data to. */
+  VkDeviceSize     destination_offset; /* Offset in destination buffer. */
+  const void      *source_data;        /* Data to upload. */
+  VkDeviceSize     data_size;          /* Size of the data in bytes. */
+  VkSharingMode    sharing_mode;       /* Staging buffer sharing mode. */
+  uint32_t         shared_queue_family_index_count; /* Number of shared queue family
+                                                       indices. */
+  const uint32_t *shared_queue_family_indices; /* Shared queue family indices. */
+} Moss__UploadQueueFillBufferInfo;
+
+/*
+  @brief Required info to allocate upload staging buffer.
+*/
+typedef struct
+{
+  VkDeviceSize   size;                            /* Size of the buffer in bytes. */
+  VkSharingMode  sharing_mode;                    /* Staging buffer sharing mode. */
+  uint32_t       shared_queue_family_index_count; /* Number of shared queue family
+                                                     indices. */
+  const uint32_t *shared_queue_family_indices;    /* Shared queue family indices. */
+} Moss__UploadQueueStagingBufferInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Initializes upload queue with null handles.
+  @param upload_queue Upload queue to initialize.
+*/
+inline static void moss__init_upload_queue_state (Moss__UploadQueue *const upload_queue)
+{
+  *upload_queue = (Moss__UploadQueue) {
+    .device                  = VK_NULL_HANDLE,
+    .allocator               = NULL,
+    .queue                   = VK_NULL_HANDLE,
+    .command_pool            = VK_NULL_HANDLE,
+    .timeline_semaphore      = VK_NULL_HANDLE,
+    .frame_semaphore         = VK_NULL_HANDLE,
+    .command_buffer_index    = 0,
+    .is_recording            = false,
+    .submitted_value         = 0,
+    .recorded_bytes          = 0,
+    .staging_buffers         = NULL,
+    .staging_buffer_count    = 0,
+    .staging_buffer_capacity = 0,
+  };
+}
+
+/*
+  @brief Creates timeline semaphore starting at zero.
+  @param info Required info to create upload queue.
+  @param out_semaphore Output semaphore, VK_NULL_HANDLE on failure.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_upload_queue_timeline_semaphore (
+  const Moss__CreateUploadQueueInfo *const info,
+  VkSemaphore *const                       out_semaphore
+)
+{
+  const VkSemaphoreTypeCreateInfo type_info = {
+    .sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+    .pNext         = NULL,
+    .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+    .initialValue  = 0,
+  };
+  const VkSemaphoreCreateInfo create_info = {
+    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+    .pNext = &type_info,
+  };
+
+  const VkResult result = vkCreateSemaphore (
+    info->device,
+    &create_info,
+    info->allocator->allocation_callbacks,
+    out_semaphore
+  );
+  if (result != VK_SUCCESS)
+  {
+    moss__error ("Failed to create upload timeline semaphore. Error code: %d.\n", result);
+    *out_semaphore = VK_NULL_HANDLE;
+    return MOSS_RESULT_ERROR;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Creates upload queue timeline semaphores and command buffers.
+  @param info Required info to create upload queue.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__create_upload_queue (const Moss__CreateUploadQueueInfo *const info)
+{
+  Moss__UploadQueue *const upload_queue = info->out_upload_queue;
+
+  moss__init_upload_queue_state (upload_queue);
+  upload_queue->device       = info->device;
+  upload_queue->allocator    = info->allocator;
+  upload_queue->queue        = info->queue;
+  upload_queue->command_pool = info->command_pool;
+
+  if (moss__create_upload_queue_timeline_semaphore (
+        info,
+        &upload_queue->timeline_semaphore
+      ) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (moss__create_upload_queue_timeline_semaphore (
+        info,
+        &upload_queue->frame_semaphore
+      ) != MOSS_RESULT_SUCCESS)
+  {
+    vkDestroySemaphore (
+      info->device,
+      upload_queue->timeline_semaphore,
+      info->allocator->allocation_callbacks
+    );
+    upload_queue->timeline_semaphore = VK_NULL_HANDLE;
+    return MOSS_RESULT_ERROR;
+  }
+
+  {  // Allocate command buffers
+    const VkCommandBufferAllocateInfo alloc_info = {
+      .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .pNext              = NULL,
+      .commandPool        = info->command_pool,
+      .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = UPLOAD_QUEUE_COMMAND_BUFFER_COUNT,
+    };
+
+    const VkResult result =
+      vkAllocateCommandBuffers (info->device, &alloc_info, upload_queue->command_buffers);
+    if (result != VK_SUCCESS)
+    {
+      moss__error (
+        "Failed to allocate upload command buffers. Error code: %d.\n",
+        result
+      );
+      vkDestroySemaphore (
+        info->device,
+        upload_queue->timeline_semaphore,
+        info->allocator->allocation_callbacks
+      );
+      vkDestroySemaphore (
+        info->device,
+        upload_queue->frame_semaphore,
+        info->allocator->allocation_callbacks
+      );
+      upload_queue->timeline_semaphore = VK_NULL_HANDLE;
+      upload_queue->frame_semaphore    = VK_NULL_HANDLE;
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  for (size_t i = 0; i < UPLOAD_QUEUE_COMMAND_BUFFER_COUNT; ++i)
+  {
+    upload_queue->command_buffer_values[ i ] = 0;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Returns the timeline value the current recording will signal.
+  @param upload_queue Upload queue.
+  @return Timeline value of the next submit.
+*/
+inline static uint64_t
+moss__get_upload_queue_pending_value (const Moss__UploadQueue *const upload_queue)
+{
+  return upload_queue->submitted_value + 1;
+}
+
+/*
+  @brief Returns the last timeline value reached by the GPU.
+  @param upload_queue Upload queue.
+  @return Completed timeline value.
+*/
+inline static uint64_t
+moss__get_upload_queue_completed_value (const Moss__UploadQueue *const upload_queue)
+{
+  uint64_t value = 0;
+  vkGetSemaphoreCounterValue (
+    upload_queue->device,
+    upload_queue->timeline_semaphore,
+    &value
+  );
+  return value;
+}
+
+/*
+  @brief Blocks until the GPU reaches passed timeline value.
+  @details Value must already be submitted.
+  @param upload_queue Upload queue.
+  @param value Timeline value to wait for.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__wait_upload_queue_value (
+  const Moss__UploadQueue *const upload_queue,
+  const uint64_t                 value
+)
+{
+  const VkSemaphoreWaitInfo wait_info = {
+    .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+    .pNext          = NULL,
+    .flags          = 0,
+    .semaphoreCount = 1,
+    .pSemaphores    = &upload_queue->timeline_semaphore,
+    .pValues        = &value,
+  };
+
+  const VkResult result = vkWaitSemaphores (upload_queue->device, &wait_info, UINT64_MAX);
+  if (result != VK_SUCCESS)
+  {
+    moss__error ("Failed to wait for upload timeline value. Error code: %d.\n", result);
+    return MOSS_RESULT_ERROR;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Returns command buffer to record upload commands into.
+  @details Begins next command buffer of the ring if nothing is being recorded.
+           Blocks only when every command buffer of the ring is still in flight.
+  @param upload_queue Upload queue.
+  @return Returns command buffer in recording state on success,
+          otherwise returns VK_NULL_HANDLE.
+*/
+inline static VkCommandBuffer
+moss__get_upload_command_buffer (Moss__UploadQueue *const upload_queue)
+{
+  const uint32_t index = upload_queue->command_buffer_index;
+  if (upload_queue->is_recording) { return upload_queue->command_buffers[ index ]; }
+
+  const VkCommandBuffer command_buffer = upload_queue->command_buffers[ index ];
+
+  // Ring is exhausted, command buffer is still executing its previous submit
+  if (moss__get_upload_queue_completed_value (upload_queue) <
+      upload_queue->command_buffer_values[ index ])
+  {
+    const MossResult result = moss__wait_upload_queue_value (
+      upload_queue,
+      upload_queue->command_buffer_values[ index ]
+    );
+    if (result != MOSS_RESULT_SUCCESS) { return VK_NULL_HANDLE; }
+  }
+
+  vkResetCommandBuffer (command_buffer, 0);
+
+  static const VkCommandBufferBeginInfo begin_info = {
+    .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+    .pNext            = NULL,
+    .flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    .pInheritanceInfo = NULL,
+  };
+
+  const VkResult result = vkBeginCommandBuffer (command_buffer, &begin_info);
+  if (result != VK_SUCCESS)
+  {
+    moss__error ("Failed to begin upload command buffer. Error code: %d.\n", result);
+    return VK_NULL_HANDLE;
+  }
+
+  upload_queue->is_recording = true;
+
+  return command_buffer;
+}
+
+/*
+  @brief Submits recorded upload commands.
+  @details Submit signals @ref moss__get_upload_queue_pending_value on the timeline
+           semaphore. Does nothing if nothing was recorded.
+  @param upload_queue Upload queue.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__flush_upload_queue (Moss__UploadQueue *const upload_queue)
+{
+  if (!upload_queue->is_recording) { return MOSS_RESULT_SUCCESS; }
+
+  const uint32_t        index          = upload_queue->command_buffer_index;
+  const VkCommandBuffer command_buffer = upload_queue->command_buffers[ index ];
+  const uint64_t signal_value = moss__get_upload_queue_pending_value (upload_queue);
+
+  upload_queue->is_recording = false;
+
+  {  // End command buffer
+    const VkResult result = vkEndCommandBuffer (command_buffer);
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to end upload command buffer. Error code: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  const VkTimelineSemaphoreSubmitInfo timeline_info = {
+    .sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+    .pNext                     = NULL,
+    .waitSemaphoreValueCount   = 0,
+    .pWaitSemaphoreValues      = NULL,
+    .signalSemaphoreValueCount = 1,
+    .pSignalSemaphoreValues    = &signal_value,
+  };
+
+  const VkSubmitInfo submit_info = {
+    .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+    .pNext                = &timeline_info,
+    .waitSemaphoreCount   = 0,
+    .pWaitSemaphores      = NULL,
+    .commandBufferCount   = 1,
+    .pCommandBuffers      = &command_buffer,
+    .signalSemaphoreCount = 1,
+    .pSignalSemaphores    = &upload_queue->timeline_semaphore,
+  };
+
+  {  // Submit without fence, completion is tracked by the timeline semaphore
+    const VkResult result =
+      vkQueueSubmit (upload_queue->queue, 1, &submit_info, VK_NULL_HANDLE);
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to submit upload command buffer. Error code: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  upload_queue->command_buffer_values[ index ] = signal_value;
+  upload_queue->submitted_value                = signal_value;
+  upload_queue->command_buffer_index =
+    (uint32_t)((index + 1) % UPLOAD_QUEUE_COMMAND_BUFFER_COUNT);
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Hands staging buffer over to the upload queue.
+  @details Buffer is destroyed once the current recording completes on the GPU.
+  @param upload_queue Upload queue.
+  @param buffer Staging buffer.
+  @param allocation Staging buffer memory, ownership is moved to the upload queue.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__release_upload_staging_buffer (
+  Moss__UploadQueue *const        upload_queue,
+  const VkBuffer                  buffer,
+  const Moss__VkAllocation *const allocation
+)
+{
+  if (upload_queue->staging_buffer_count == upload_queue->staging_buffer_capacity)
+  {
+    const size_t capacity = upload_queue->staging_buffer_capacity == 0
+                            ? 16
+                            : upload_queue->staging_buffer_capacity * 2;
+
+    Moss__UploadQueueStagingBuffer *const staging_buffers = moss__reallocate (
+      upload_queue->allocator->host_allocator,
+      upload_queue->staging_buffers,
+      capacity * sizeof (Moss__UploadQueueStagingBuffer),
+      MOSS_ALLOCATION_CATEGORY_ENGINE
+    );
+    if (staging_buffers == NULL)
+    {
+      moss__error ("Failed to allocate memory for upload staging buffer list.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    upload_queue->staging_buffers         = staging_buffers;
+    upload_queue->staging_buffer_capacity = capacity;
+  }
+
+  const Moss__UploadQueueStagingBuffer staging_buffer = {
+    .buffer         = buffer,
+    .allocation     = *allocation,
+    .timeline_value = moss__get_upload_queue_pending_value (upload_queue),
+  };
+  upload_queue->staging_buffers[ upload_queue->staging_buffer_count++ ] = staging_buffer;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Destroys staging buffers whose uploads are completed.
+  @param upload_queue Upload queue.
+*/
+inline static void
+moss__collect_upload_staging_buffers (Moss__UploadQueue *const upload_queue)
+{
+  if (upload_queue->staging_buffer_count == 0) { return; }
+
+  const uint64_t completed_value = moss__get_upload_queue_completed_value (upload_queue);
+
+  size_t kept_count = 0;
+  for (size_t i = 0; i < upload_queue->staging_buffer_count; ++i)
+  {
+    Moss__UploadQueueStagingBuffer staging_buffer = upload_queue->staging_buffers[ i ];
+
+    if (staging_buffer.timeline_value <= completed_value)
+    {
+      moss_vk__destroy_buffer (
+        upload_queue->allocator,
+        staging_buffer.buffer,
+        &staging_buffer.allocation
+      );
+    }
+    else {
+      upload_queue->staging_buffers[ kept_count++ ] = staging_buffer;
+    }
+  }
+
+  upload_queue->staging_buffer_count = kept_count;
+}
+
+/*
+  @brief Allocates temporary staging buffer for copies of the current recording.
+  @details Buffer is owned by the upload queue and destroyed once the current
+           recording completes on the GPU. Upload command buffer is begun, so copies
+           from the buffer can be recorded right away.
+  @param upload_queue Upload queue.
+  @param info Required info to allocate staging buffer.
+  @param out_buffer Output staging buffer.
+  @param out_mapped_memory Output persistently mapped staging memory.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__allocate_upload_staging_buffer (
+  Moss__UploadQueue *const                        upload_queue,
+  const Moss__UploadQueueStagingBufferInfo *const info,
+  VkBuffer *const                                 out_buffer,
+  void **const                                    out_mapped_memory
+)
+{
+  VkBuffer           staging_buffer;
+  Moss__VkAllocation staging_allocation;
+  {  // Create staging buffer
+    const Moss__CreateVkBufferInfo create_info = {
+      .allocator       = upload_queue->allocator,
+      .device          = upload_queue->device,
+      .size            = info->size,
+      .usage           = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      .memory_properties =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      .sharing_mode                    = info->sharing_mode,
+      .shared_queue_family_index_count = info->shared_queue_family_index_count,
+      .shared_queue_family_indices     = info->shared_queue_family_indices,
+    };
+    if (moss_vk__create_buffer (&create_info, &staging_buffer, &staging_allocation) !=
+        MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create upload staging buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  // Begun before the release, so the buffer is tied to the recording it's used in
+  if (moss__get_upload_command_buffer (upload_queue) == VK_NULL_HANDLE)
+  {
+    moss_vk__destroy_buffer (
+      upload_queue->allocator,
+      staging_buffer,
+      &staging_allocation
+    );
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (moss__release_upload_staging_buffer (
+        upload_queue,
+        staging_buffer,
+        &staging_allocation
+      ) != MOSS_RESULT_SUCCESS)
+  {
+    moss_vk__destroy_buffer (
+      upload_queue->allocator,
+      staging_buffer,
+      &staging_allocation
+    );
+    return MOSS_RESULT_ERROR;
+  }
+
+  *out_buffer        = staging_buffer;
+  *out_mapped_memory = staging_allocation.mapped_memory;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Records buffer upload through a temporary staging buffer.
+  @param upload_queue Upload queue.
+  @param info Required info to upload data.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__upload_queue_fill_buffer (
+  Moss__UploadQueue *const                     upload_queue,
+  const Moss__UploadQueueFillBufferInfo *const info
+)
+{
+  const Moss__UploadQueueStagingBufferInfo staging_info = {
+    .size                            = info->data_size,
+    .sharing_mode                    = info->sharing_mode,
+    .shared_queue_family_index_count = info->shared_queue_family_index_count,
+    .shared_queue_family_indices     = info->shared_queue_family_indices,
+  };
+
+  VkBuffer staging_buffer;
+  void    *staging_memory;
+  if (moss__allocate_upload_staging_buffer (
+        upload_queue,
+        &staging_info,
+        &staging_buffer,
+        &staging_memory
+      ) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  memcpy (staging_memory, info->source_data, (size_t)info->data_size);
+
+  const VkBufferCopy copy_region = {
+    .srcOffset = 0,
+    .dstOffset = info->destination_offset,
+    .size      = info->data_size,
+  };
+  vkCmdCopyBuffer (
+    moss__get_upload_command_buffer (upload_queue),
+    staging_buffer,
+    info->destination_buffer,
+    1,
+    &copy_region
+  );
+
+  upload_queue->recorded_bytes += (uint64_t)info->data_size;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Destroys upload queue.
+  @details Device must be idle. Commands recorded but not submitted are discarded.
+  @param upload_queue Upload queue to destroy.
+*/
+inline static void moss__destroy_upload_queue (Moss__UploadQueue *const upload_queue)
+{
+  if (upload_queue->device == VK_NULL_HANDLE) { return; }
+
+  for (size_t i = 0; i < upload_queue->staging_buffer_count; ++i)
+  {
+    moss_vk__destroy_buffer (
+      upload_queue->allocator,
+      upload_queue->staging_buffers[ i ].buffer,
+      &upload_queue->staging_buffers[ i ].allocation
+    );
+  }
+  moss__free (upload_queue->allocator->host_allocator, upload_queue->staging_buffers);
+
+  if (upload_queue->timeline_semaphore != VK_NULL_HANDLE)
+  {
+    vkFreeCommandBuffers (
+      upload_queue->device,
+      upload_queue->command_pool,
+      UPLOAD_QUEUE_COMMAND_BUFFER_COUNT,
+      upload_queue->command_buffers
+    );
+    vkDestroySemaphore (
+      upload_queue->device,
+      upload_queue->timeline_semaphore,
+      upload_queue->allocator->allocation_callbacks
+    );
+    vkDestroySemaphore (
+      upload_queue->device,
+      upload_queue->frame_semaphore,
+      upload_queue->allocator->allocation_callbacks
+    );
+  }
+
+  moss__init_upload_queue_state (upload_queue);
+}
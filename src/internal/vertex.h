@@ -37,10 +37,45 @@
 */
 typedef struct
 {
-  vec3 position;       /* Vertex position. */
-  vec2 texture_coords; /* Texture coordinates. */
+  vec3     position;       /* Vertex position. */
+  vec2     texture_coords; /* Texture coordinates. */
+  uint32_t texture_index;  /* Bindless texture index. */
 } Moss__Vertex;
 
+/*
+  @brief Compact vertex.
+  @details Quantized vertex of compact sprite batches. Position is normalized to
+           the batch bounds, so precision is the bounds size over 65535.
+  @warning Whenever you change this struct, please adjust compact binding and
+           attribute descriptions.
+*/
+typedef struct
+{
+  int16_t  position[ 2 ];       /* Position within batch bounds, snorm16. */
+  uint16_t texture_coords[ 2 ]; /* Texture coordinates, unorm16. */
+  uint16_t depth;               /* Vertex depth, unorm16. */
+  uint16_t texture_index;       /* Bindless texture index. */
+} Moss__CompactVertex;
+
+/*
+  @brief Sprite instance.
+  @details Packed per-sprite record used by instanced sprite batches. Quad corners
+           are generated in the vertex shader from gl_VertexIndex.
+  @warning Whenever you change this struct, please adjust instance binding and
+           attribute descriptions.
+*/
+typedef struct
+{
+  vec2     position;             /* Sprite center position. */
+  vec2     size;                 /* Sprite size. */
+  float    depth;                /* Sprite depth. */
+  uint16_t uv[ 4 ];              /* Normalized UV rect: top left u, v, bottom right. */
+  uint32_t texture_index;        /* Bindless texture index. */
+  float    animation_start_time; /* Animation time the clip starts playing at. */
+  float    animation_rate;       /* Animation playback speed. */
+  uint32_t animation_clip;       /* Animation clip ID, 0 if not animated. */
+} Moss__SpriteInstance;
+
 /* VkVertexBindingDescription pack. */
 typedef struct
 {
@@ -104,6 +139,170 @@ moss__get_vk_vertex_input_attribute_description (void)
      .location = 1,
      .format   = VK_FORMAT_R32G32_SFLOAT,
      .offset   = offsetof (Moss__Vertex, texture_coords),
+     },
+    {
+     .binding  = 0,
+     .location = 2,
+     .format   = VK_FORMAT_R32_UINT,
+     .offset   = offsetof (Moss__Vertex,  texture_index),
+     }
+  };
+
+  static const Moss__VkVertexInputAttributeDescriptionPack descriptions_pack = {
+    .descriptions = attribute_descriptions,
+    .count = sizeof (attribute_descriptions) / sizeof (attribute_descriptions[ 0 ]),
+  };
+
+  return descriptions_pack;
+}
+
+/*
+  @brief Returns Vulkan input binding description that corresponds to the
+         @ref Moss__CompactVertex.
+  @return Vulkan input binding description.
+*/
+inline static Moss__VkVertexInputBindingDescriptionPack
+moss__get_vk_compact_vertex_input_binding_description (void)
+{
+  static const VkVertexInputBindingDescription binding_descriptions[] = {
+    {
+     .binding   = 0,
+     .stride    = sizeof (Moss__CompactVertex),
+     .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+     },
+  };
+
+  static const Moss__VkVertexInputBindingDescriptionPack descriptions_pack = {
+    .count        = sizeof (binding_descriptions) / sizeof (binding_descriptions[ 0 ]),
+    .descriptions = binding_descriptions,
+  };
+
+  return descriptions_pack;
+}
+
+/*
+  @brief Returns Vulkan input attribute descipritions that corresponds to the
+         @ref Moss__CompactVertex fields.
+  @return Vulkan input attribute descriptions.
+*/
+inline static Moss__VkVertexInputAttributeDescriptionPack
+moss__get_vk_compact_vertex_input_attribute_description (void)
+{
+  static const VkVertexInputAttributeDescription attribute_descriptions[] = {
+    {
+     .binding  = 0,
+     .location = 0,
+     .format   = VK_FORMAT_R16G16_SNORM,
+     .offset   = offsetof (Moss__CompactVertex,       position),
+     },
+    {
+     .binding  = 0,
+     .location = 1,
+     .format   = VK_FORMAT_R16G16_UNORM,
+     .offset   = offsetof (Moss__CompactVertex, texture_coords),
+     },
+    {
+     .binding  = 0,
+     .location = 2,
+     .format   = VK_FORMAT_R16_UNORM,
+     .offset   = offsetof (Moss__CompactVertex,          depth),
+     },
+    {
+     .binding  = 0,
+     .location = 3,
+     .format   = VK_FORMAT_R16_UINT,
+     .offset   = offsetof (Moss__CompactVertex,  texture_index),
+     }
+  };
+
+  static const Moss__VkVertexInputAttributeDescriptionPack descriptions_pack = {
+    .descriptions = attribute_descriptions,
+    .count = sizeof (attribute_descriptions) / sizeof (attribute_descriptions[ 0 ]),
+  };
+
+  return descriptions_pack;
+}
+
+/*
+  @brief Returns Vulkan input binding description that corresponds to the
+         @ref Moss__SpriteInstance.
+  @return Vulkan input binding description.
+*/
+inline static Moss__VkVertexInputBindingDescriptionPack
+moss__get_vk_instance_input_binding_description (void)
+{
+  static const VkVertexInputBindingDescription binding_descriptions[] = {
+    {
+     .binding   = 0,
+     .stride    = sizeof (Moss__SpriteInstance),
+     .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE,
+     },
+  };
+
+  static const Moss__VkVertexInputBindingDescriptionPack descriptions_pack = {
+    .count        = sizeof (binding_descriptions) / sizeof (binding_descriptions[ 0 ]),
+    .descriptions = binding_descriptions,
+  };
+
+  return descriptions_pack;
+}
+
+/*
+  @brief Returns Vulkan input attribute descipritions that corresponds to the
+         @ref Moss__SpriteInstance fields.
+  @return Vulkan input attribute descriptions.
+*/
+inline static Moss__VkVertexInputAttributeDescriptionPack
+moss__get_vk_instance_input_attribute_description (void)
+{
+  static const VkVertexInputAttributeDescription attribute_descriptions[] = {
+    {
+     .binding  = 0,
+     .location = 0,
+     .format   = VK_FORMAT_R32G32_SFLOAT,
+     .offset   = offsetof (Moss__SpriteInstance, position),
+     },
+    {
+     .binding  = 0,
+     .location = 1,
+     .format   = VK_FORMAT_R32G32_SFLOAT,
+     .offset   = offsetof (Moss__SpriteInstance,     size),
+     },
+    {
+     .binding  = 0,
+     .location = 2,
+     .format   = VK_FORMAT_R32_SFLOAT,
+     .offset   = offsetof (Moss__SpriteInstance,    depth),
+     },
+    {
+     .binding  = 0,
+     .location = 3,
+     .format   = VK_FORMAT_R16G16B16A16_UNORM,
+     .offset   = offsetof (Moss__SpriteInstance,       uv),
+     },
+    {
+     .binding  = 0,
+     .location = 4,
+     .format   = VK_FORMAT_R32_UINT,
+     .offset   = offsetof (Moss__SpriteInstance, texture_index),
+     },
+    {
+     .binding  = 0,
+     .location = 5,
+     .format   = VK_FORMAT_R32_SFLOAT,
+     .offset   = offsetof (Moss__SpriteInstance, animation_start_time),
+     },
+    {
+     .binding  = 0,
+     .location = 6,
+     .format   = VK_FORMAT_R32_SFLOAT,
+     .offset   = offsetof (Moss__SpriteInstance, animation_rate),
+     },
+    {
+     .binding  = 0,
+     .location = 7,
+     .format   = VK_FORMAT_R32_UINT,
+     .offset   = offsetof (Moss__SpriteInstance, animation_clip),
      }
   };
 
@@ -114,3 +313,16 @@ moss__get_vk_vertex_input_attribute_description (void)
 
   return descriptions_pack;
 }
+
+/*
+  @brief Packs normalized coordinate into 16-bit unsigned normalized integer.
+  @param value Value to pack.
+  @return Packed value.
+*/
+inline static uint16_t moss__pack_unorm16 (const float value)
+{
+  if (value <= 0.0F) { return 0; }
+  if (value >= 1.0F) { return UINT16_MAX; }
+
+  return (uint16_t)(value * (float)UINT16_MAX + 0.5F);
+}
@@ -0,0 +1,669 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/vulkan/utils/allocator.h
+  @brief Vulkan device memory sub-allocator.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Resources are carved out of large VkDeviceMemory blocks, one list of blocks
+           per memory type. Blocks keep a sorted list of free ranges and allocate
+           with first fit. When bufferImageGranularity is larger than one, linear
+           and optimal resources never share a block, so they can't alias within
+           a granularity page. Host-visible blocks are mapped once on creation.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/result.h"
+
+#include "src/internal/config.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Kind of resource memory is allocated for.
+*/
+typedef enum
+{
+  MOSS__VK_RESOURCE_TILING_LINEAR,  /* Buffers and linear images. */
+  MOSS__VK_RESOURCE_TILING_OPTIMAL, /* Optimal tiling images. */
+} Moss__VkResourceTiling;
+
+/*
+  @brief Free range inside of a memory block.
+*/
+typedef struct
+{
+  VkDeviceSize offset; /* Range offset in the block. */
+  VkDeviceSize size;   /* Range size. */
+} Moss__VkMemoryRange;
+
+/*
+  @brief Device memory block resources are sub-allocated from.
+*/
+typedef struct
+{
+  VkDeviceMemory         memory;              /* Device memory. */
+  VkDeviceSize           size;                /* Block size. */
+  void                  *mapped_memory;       /* Mapped memory, NULL if not mapped. */
+  uint32_t               memory_type_index;   /* Memory type of the block. */
+  Moss__VkResourceTiling tiling;              /* Kind of resources block holds. */
+  Moss__VkMemoryRange   *free_ranges;         /* Free ranges sorted by offset. */
+  size_t                 free_range_count;    /* Number of free ranges. */
+  size_t                 free_range_capacity; /* Capacity of free range array. */
+  size_t                 allocation_count;    /* Number of live allocations. */
+} Moss__VkMemoryBlock;
+
+/*
+  @brief Sub-allocation of a memory block.
+*/
+typedef struct
+{
+  Moss__VkMemoryBlock *block;         /* Block allocation belongs to. */
+  VkDeviceMemory       memory;        /* Device memory of the block. */
+  VkDeviceSize         offset;        /* Offset in device memory. */
+  VkDeviceSize         size;          /* Allocation size. */
+  void                *mapped_memory; /* Mapped memory, NULL if not host-visible. */
+} Moss__VkAllocation;
+
+/*
+  @brief Device memory allocator state.
+*/
+typedef struct
+{
+  /* Logical device memory is allocated on. */
+  VkDevice device;
+  /* Host allocator bookkeeping is allocated with. */
+  Moss__HostAllocator *host_allocator;
+  /* Callbacks of Vulkan host allocations. */
+  const VkAllocationCallbacks *allocation_callbacks;
+  /* Memory properties of the physical device. */
+  VkPhysicalDeviceMemoryProperties memory_properties;
+  /* Granularity linear and optimal resources must be separated with. */
+  VkDeviceSize buffer_image_granularity;
+  /* Memory blocks. */
+  Moss__VkMemoryBlock **blocks;
+  /* Number of memory blocks. */
+  size_t block_count;
+  /* Capacity of memory block array. */
+  size_t block_capacity;
+  /* Number of live allocations. */
+  size_t allocation_count;
+  /* Total size of memory blocks in bytes. */
+  VkDeviceSize block_bytes;
+  /* Total size of live allocations in bytes. */
+  VkDeviceSize allocation_bytes;
+} Moss__VkAllocator;
+
+/*
+  @brief Required info to create device memory allocator.
+*/
+typedef struct
+{
+  VkPhysicalDevice   physical_device; /* Physical device to query memory properties. */
+  VkDevice           device;          /* Logical device to allocate memory on. */
+  /* Host allocator bookkeeping is allocated with. */
+  Moss__HostAllocator *host_allocator;
+  /* Callbacks of Vulkan host allocations. */
+  const VkAllocationCallbacks *allocation_callbacks;
+  Moss__VkAllocator           *out_allocator; /* Allocator to initialize. */
+} Moss__CreateVkAllocatorInfo;
+
+/*
+  @brief Required info to allocate device memory.
+*/
+typedef struct
+{
+  VkMemoryRequirements   requirements; /* Resource memory requirements. */
+  VkMemoryPropertyFlags  properties;   /* Required memory properties. */
+  Moss__VkResourceTiling tiling;       /* Kind of resource memory is allocated for. */
+} Moss__VkAllocateMemoryInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Initializes allocator with empty state.
+  @param allocator Allocator to initialize.
+*/
+inline static void moss_vk__init_allocator_state (Moss__VkAllocator *const allocator)
+{
+  memset (allocator, 0, sizeof (*allocator));
+  allocator->device = VK_NULL_HANDLE;
+}
+
+/*
+  @brief Creates device memory allocator.
+  @param info Required info to create allocator.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss_vk__create_allocator (const Moss__CreateVkAllocatorInfo *const info)
+{
+  Moss__VkAllocator *const allocator = info->out_allocator;
+
+  moss_vk__init_allocator_state (allocator);
+  allocator->device               = info->device;
+  allocator->host_allocator       = info->host_allocator;
+  allocator->allocation_callbacks = info->allocation_callbacks;
+
+  vkGetPhysicalDeviceMemoryProperties (
+    info->physical_device,
+    &allocator->memory_properties
+  );
+
+  VkPhysicalDeviceProperties device_properties;
+  vkGetPhysicalDeviceProperties (info->physical_device, &device_properties);
+  allocator->buffer_image_granularity = device_properties.limits.bufferImageGranularity;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Frees memory block and its device memory.
+  @param allocator Allocator block belongs to.
+  @param block Block to free.
+*/
+inline static void moss_vk__free_memory_block (
+  Moss__VkAllocator *const   allocator,
+  Moss__VkMemoryBlock *const block
+)
+{
+  if (block->mapped_memory != NULL) { vkUnmapMemory (allocator->device, block->memory); }
+  vkFreeMemory (allocator->device, block->memory, allocator->allocation_callbacks);
+
+  allocator->block_bytes -= block->size;
+
+  moss__free (allocator->host_allocator, block->free_ranges);
+  moss__free (allocator->host_allocator, block);
+}
+
+/*
+  @brief Destroys device memory allocator and frees all of its blocks.
+  @param allocator Allocator to destroy.
+*/
+inline static void moss_vk__destroy_allocator (Moss__VkAllocator *const allocator)
+{
+  if (allocator->device == VK_NULL_HANDLE) { return; }
+
+  if (allocator->allocation_count != 0)
+  {
+    moss__warning (
+      "Destroying allocator with %zu live allocations.\n",
+      allocator->allocation_count
+    );
+  }
+
+  for (size_t i = 0; i < allocator->block_count; ++i)
+  {
+    moss_vk__free_memory_block (allocator, allocator->blocks[ i ]);
+  }
+  moss__free (allocator->host_allocator, allocator->blocks);
+
+  moss_vk__init_allocator_state (allocator);
+}
+
+/*
+  @brief Inserts free range into block free range list at passed position.
+  @param allocator Allocator block belongs to.
+  @param block Memory block.
+  @param index Position to insert range at.
+  @param range Range to insert.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss_vk__insert_free_range (
+  Moss__VkAllocator *const   allocator,
+  Moss__VkMemoryBlock *const block,
+  const size_t               index,
+  const Moss__VkMemoryRange  range
+)
+{
+  if (block->free_range_count == block->free_range_capacity)
+  {
+    const size_t capacity =
+      block->free_range_capacity == 0 ? 8 : block->free_range_capacity * 2;
+
+    Moss__VkMemoryRange *const free_ranges = moss__reallocate (
+      allocator->host_allocator,
+      block->free_ranges,
+      capacity * sizeof (Moss__VkMemoryRange),
+      MOSS_ALLOCATION_CATEGORY_DEVICE_MEMORY
+    );
+    if (free_ranges == NULL)
+    {
+      moss__error ("Failed to allocate memory for memory block free ranges.\n");
+      return MOSS_RESULT_ERROR;
+    }
+
+    block->free_ranges         = free_ranges;
+    block->free_range_capacity = capacity;
+  }
+
+  memmove (
+    &block->free_ranges[ index + 1 ],
+    &block->free_ranges[ index ],
+    (block->free_range_count - index) * sizeof (Moss__VkMemoryRange)
+  );
+  block->free_ranges[ index ] = range;
+  ++block->free_range_count;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Removes free range from block free range list.
+  @param block Memory block.
+  @param index Position of the range to remove.
+*/
+inline static void
+moss_vk__remove_free_range (Moss__VkMemoryBlock *const block, const size_t index)
+{
+  memmove (
+    &block->free_ranges[ index ],
+    &block->free_ranges[ index + 1 ],
+    (block->free_range_count - index - 1) * sizeof (Moss__VkMemoryRange)
+  );
+  --block->free_range_count;
+}
+
+/*
+  @brief Tries to sub-allocate memory from block using first fit.
+  @param allocator Allocator block belongs to.
+  @param block Memory block.
+  @param size Required size.
+  @param alignment Required alignment.
+  @param out_offset Output offset of the allocation in the block.
+  @return Returns true if memory was allocated, otherwise false.
+*/
+inline static bool moss_vk__allocate_from_block (
+  Moss__VkAllocator *const   allocator,
+  Moss__VkMemoryBlock *const block,
+  const VkDeviceSize         size,
+  const VkDeviceSize         alignment,
+  VkDeviceSize *const        out_offset
+)
+{
+  for (size_t i = 0; i < block->free_range_count; ++i)
+  {
+    Moss__VkMemoryRange *const range = &block->free_ranges[ i ];
+
+    const VkDeviceSize offset =
+      (range->offset + alignment - 1) / alignment * alignment;
+    const VkDeviceSize range_end = range->offset + range->size;
+    const VkDeviceSize end       = offset + size;
+    if (end > range_end) { continue; }
+
+    const bool has_head = offset > range->offset;
+    const bool has_tail = end < range_end;
+
+    if (has_head && has_tail)
+    {
+      const Moss__VkMemoryRange tail = { .offset = end, .size = range_end - end };
+      if (moss_vk__insert_free_range (allocator, block, i + 1, tail) !=
+          MOSS_RESULT_SUCCESS)
+      {
+        return false;
+      }
+      block->free_ranges[ i ].size = offset - block->free_ranges[ i ].offset;
+    }
+    else if (has_head) { range->size = offset - range->offset; }
+    else if (has_tail)
+    {
+      range->offset = end;
+      range->size   = range_end - end;
+    }
+    else {
+      moss_vk__remove_free_range (block, i);
+    }
+
+    *out_offset = offset;
+    return true;
+  }
+
+  return false;
+}
+
+/*
+  @brief Returns memory range back to the block, merging it with adjacent ranges.
+  @param allocator Allocator block belongs to.
+  @param block Memory block.
+  @param offset Offset of the range.
+  @param size Size of the range.
+*/
+inline static void moss_vk__free_block_range (
+  Moss__VkAllocator *const   allocator,
+  Moss__VkMemoryBlock *const block,
+  const VkDeviceSize         offset,
+  const VkDeviceSize         size
+)
+{
+  size_t index = 0;
+  while (index < block->free_range_count && block->free_ranges[ index ].offset < offset)
+  {
+    ++index;
+  }
+
+  const bool merges_previous =
+    index > 0 && block->free_ranges[ index - 1 ].offset +
+                     block->free_ranges[ index - 1 ].size ==
+                   offset;
+  const bool merges_next = index < block->free_range_count &&
+                           offset + size == block->free_ranges[ index ].offset;
+
+  if (merges_previous && merges_next)
+  {
+    block->free_ranges[ index - 1 ].size += size + block->free_ranges[ index ].size;
+    moss_vk__remove_free_range (block, index);
+  }
+  else if (merges_previous) { block->free_ranges[ index - 1 ].size += size; }
+  else if (merges_next)
+  {
+    block->free_ranges[ index ].offset = offset;
+    block->free_ranges[ index ].size += size;
+  }
+  else {
+    const Moss__VkMemoryRange range = { .offset = offset, .size = size };
+    if (moss_vk__insert_free_range (allocator, block, index, range) !=
+        MOSS_RESULT_SUCCESS)
+    {
+      // Range is leaked until the block is freed
+      moss__warning ("Failed to return memory range to the block.\n");
+    }
+  }
+}
+
+/*
+  @brief Creates new memory block and adds it to the allocator.
+  @param allocator Allocator.
+  @param size Block size.
+  @param memory_type_index Memory type of the block.
+  @param tiling Kind of resources block holds.
+  @return Returns valid block pointer on success, otherwise returns NULL.
+*/
+inline static Moss__VkMemoryBlock *moss_vk__create_memory_block (
+  Moss__VkAllocator *const     allocator,
+  const VkDeviceSize           size,
+  const uint32_t               memory_type_index,
+  const Moss__VkResourceTiling tiling
+)
+{
+  if (allocator->block_count == allocator->block_capacity)
+  {
+    const size_t capacity =
+      allocator->block_capacity == 0 ? 8 : allocator->block_capacity * 2;
+
+    Moss__VkMemoryBlock **const blocks = moss__reallocate (
+      allocator->host_allocator,
+      allocator->blocks,
+      capacity * sizeof (Moss__VkMemoryBlock *),
+      MOSS_ALLOCATION_CATEGORY_DEVICE_MEMORY
+    );
+    if (blocks == NULL)
+    {
+      moss__error ("Failed to allocate memory for memory block list.\n");
+      return NULL;
+    }
+
+    allocator->blocks         = blocks;
+    allocator->block_capacity = capacity;
+  }
+
+  Moss__VkMemoryBlock *const block = moss__allocate (
+    allocator->host_allocator,
+    sizeof (Moss__VkMemoryBlock),
+    MOSS_ALLOCATION_CATEGORY_DEVICE_MEMORY
+  );
+  if (block == NULL)
+  {
+    moss__error ("Failed to allocate memory for memory block.\n");
+    return NULL;
+  }
+
+  *block = (Moss__VkMemoryBlock) {
+    .memory              = VK_NULL_HANDLE,
+    .size                = size,
+    .mapped_memory       = NULL,
+    .memory_type_index   = memory_type_index,
+    .tiling              = tiling,
+    .free_ranges         = NULL,
+    .free_range_count    = 0,
+    .free_range_capacity = 0,
+    .allocation_count    = 0,
+  };
+
+  const Moss__VkMemoryRange whole_range = { .offset = 0, .size = size };
+  if (moss_vk__insert_free_range (allocator, block, 0, whole_range) !=
+      MOSS_RESULT_SUCCESS)
+  {
+    moss__free (allocator->host_allocator, block);
+    return NULL;
+  }
+
+  {  // Allocate device memory
+    const VkMemoryAllocateInfo alloc_info = {
+      .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .pNext           = NULL,
+      .allocationSize  = size,
+      .memoryTypeIndex = memory_type_index,
+    };
+
+    const VkResult result = vkAllocateMemory (
+      allocator->device,
+      &alloc_info,
+      allocator->allocation_callbacks,
+      &block->memory
+    );
+    if (result != VK_SUCCESS)
+    {
+      // Caller falls back to the next compatible memory type
+      moss__warning (
+        "Failed to allocate memory block of type %u. Error code: %d.\n",
+        memory_type_index,
+        result
+      );
+      moss__free (allocator->host_allocator, block->free_ranges);
+      moss__free (allocator->host_allocator, block);
+      return NULL;
+    }
+  }
+
+  // Host-visible blocks stay mapped for their whole lifetime, allocations from them
+  // get a pointer into this mapping and callers write through it without mapping
+  const VkMemoryPropertyFlags property_flags =
+    allocator->memory_properties.memoryTypes[ memory_type_index ].propertyFlags;
+  if (property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+  {
+    const VkResult result = vkMapMemory (
+      allocator->device,
+      block->memory,
+      0,
+      VK_WHOLE_SIZE,
+      0,
+      &block->mapped_memory
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to map memory block. Error code: %d.\n", result);
+      vkFreeMemory (allocator->device, block->memory, allocator->allocation_callbacks);
+      moss__free (allocator->host_allocator, block->free_ranges);
+      moss__free (allocator->host_allocator, block);
+      return NULL;
+    }
+  }
+
+  allocator->blocks[ allocator->block_count++ ] = block;
+  allocator->block_bytes += size;
+
+  return block;
+}
+
+/*
+  @brief Sub-allocates device memory.
+  @details Compatible memory types are tried in order, a type whose new block can't
+           be allocated is skipped in favor of the next one.
+  @param allocator Allocator.
+  @param info Required info to allocate memory.
+  @param out_allocation Output allocation.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss_vk__allocate_memory (
+  Moss__VkAllocator *const                allocator,
+  const Moss__VkAllocateMemoryInfo *const info,
+  Moss__VkAllocation *const               out_allocation
+)
+{
+  const VkDeviceSize size      = info->requirements.size;
+  const VkDeviceSize alignment =
+    info->requirements.alignment == 0 ? 1 : info->requirements.alignment;
+
+  // Resources of any tiling can share blocks if granularity doesn't matter
+  const Moss__VkResourceTiling tiling = allocator->buffer_image_granularity > 1
+                                        ? info->tiling
+                                        : MOSS__VK_RESOURCE_TILING_LINEAR;
+
+  bool has_compatible_type = false;
+  for (uint32_t type = 0; type < allocator->memory_properties.memoryTypeCount; ++type)
+  {
+    const VkMemoryPropertyFlags property_flags =
+      allocator->memory_properties.memoryTypes[ type ].propertyFlags;
+
+    if (!(info->requirements.memoryTypeBits & (1U << type))) { continue; }
+    if ((property_flags & info->properties) != info->properties) { continue; }
+
+    has_compatible_type = true;
+
+    Moss__VkMemoryBlock *block  = NULL;
+    VkDeviceSize         offset = 0;
+
+    // Look for a block of this type with enough free space
+    for (size_t i = 0; i < allocator->block_count; ++i)
+    {
+      Moss__VkMemoryBlock *const candidate = allocator->blocks[ i ];
+      if (candidate->memory_type_index != type || candidate->tiling != tiling)
+      {
+        continue;
+      }
+
+      if (moss_vk__allocate_from_block (allocator, candidate, size, alignment, &offset))
+      {
+        block = candidate;
+        break;
+      }
+    }
+
+    // Big resources get a block of their own
+    if (block == NULL)
+    {
+      const VkDeviceSize block_size =
+        size > MEMORY_BLOCK_SIZE / 2 ? size : MEMORY_BLOCK_SIZE;
+
+      // Heap of this type may be exhausted while a later compatible type has room
+      block = moss_vk__create_memory_block (allocator, block_size, type, tiling);
+      if (block == NULL) { continue; }
+
+      if (!moss_vk__allocate_from_block (allocator, block, size, alignment, &offset))
+      {
+        moss__error ("Failed to sub-allocate memory from a new block.\n");
+        return MOSS_RESULT_ERROR;
+      }
+    }
+
+    ++block->allocation_count;
+    ++allocator->allocation_count;
+    allocator->allocation_bytes += size;
+
+    *out_allocation = (Moss__VkAllocation) {
+      .block  = block,
+      .memory = block->memory,
+      .offset = offset,
+      .size   = size,
+      .mapped_memory =
+        block->mapped_memory == NULL ? NULL : (char *)block->mapped_memory + offset,
+    };
+
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  if (has_compatible_type)
+  {
+    moss__error ("Failed to allocate memory of any suitable memory type.\n");
+  }
+  else {
+    moss__error ("Failed to find suitable memory type.\n");
+  }
+  return MOSS_RESULT_ERROR;
+}
+
+/*
+  @brief Frees sub-allocated device memory.
+  @details Empty blocks are freed unless it's the only block of their memory type,
+           which is kept to avoid reallocating it on the next allocation.
+  @param allocator Allocator.
+  @param allocation Allocation to free, reset to empty state. Empty allocations
+                    are ignored.
+*/
+inline static void moss_vk__free_memory (
+  Moss__VkAllocator *const  allocator,
+  Moss__VkAllocation *const allocation
+)
+{
+  Moss__VkMemoryBlock *const block = allocation->block;
+  if (block == NULL) { return; }
+
+  moss_vk__free_block_range (allocator, block, allocation->offset, allocation->size);
+
+  --block->allocation_count;
+  --allocator->allocation_count;
+  allocator->allocation_bytes -= allocation->size;
+
+  memset (allocation, 0, sizeof (*allocation));
+
+  if (block->allocation_count != 0) { return; }
+
+  // Keep a single empty block of standard size per memory type and tiling
+  size_t block_index = 0;
+  bool   has_sibling = false;
+  for (size_t i = 0; i < allocator->block_count; ++i)
+  {
+    const Moss__VkMemoryBlock *const other = allocator->blocks[ i ];
+    if (other == block)
+    {
+      block_index = i;
+      continue;
+    }
+
+    if (other->memory_type_index == block->memory_type_index &&
+        other->tiling == block->tiling)
+    {
+      has_sibling = true;
+    }
+  }
+
+  if (!has_sibling && block->size == MEMORY_BLOCK_SIZE) { return; }
+
+  allocator->blocks[ block_index ] = allocator->blocks[ --allocator->block_count ];
+  moss_vk__free_memory_block (allocator, block);
+}
@@ -28,7 +28,7 @@
 #include "moss/result.h"
 
 #include "src/internal/log.h"
-#include "src/internal/memory_utils.h"
+#include "src/internal/vulkan/utils/allocator.h"
 #include "src/internal/vulkan/utils/command_buffer.h"
 
 /*=============================================================================
@@ -40,7 +40,7 @@
 */
 typedef struct
 {
-  VkPhysicalDevice      physical_device;
+  Moss__VkAllocator    *allocator;
   VkDevice              device;
   VkDeviceSize          size;
   VkBufferUsageFlags    usage;
@@ -68,17 +68,17 @@ typedef struct
 */
 typedef struct
 {
-  VkPhysicalDevice physical_device;
-  VkDevice         device;
-  VkBuffer         destination_buffer;
-  VkDeviceSize     buffer_size;
-  const void      *source_data;
-  VkDeviceSize     data_size;
-  VkCommandPool    command_pool;
-  VkQueue          transfer_queue;
-  VkSharingMode    sharing_mode;
-  uint32_t         shared_queue_family_index_count;
-  const uint32_t  *shared_queue_family_indices;
+  Moss__VkAllocator *allocator;
+  VkDevice           device;
+  VkBuffer           destination_buffer;
+  VkDeviceSize       buffer_size;
+  const void        *source_data;
+  VkDeviceSize       data_size;
+  VkCommandPool      command_pool;
+  VkQueue            transfer_queue;
+  VkSharingMode      sharing_mode;
+  uint32_t           shared_queue_family_index_count;
+  const uint32_t    *shared_queue_family_indices;
 } Moss__FillVkBufferInfo;
 
 /*
@@ -101,16 +101,18 @@ typedef struct
   =============================================================================*/
 
 /*
-  @brief Creates a Vulkan buffer and allocates its memory.
+  @brief Creates a Vulkan buffer and sub-allocates its memory.
   @param info Buffer creation info.
   @param out_buffer Output parameter for the created buffer.
-  @param out_buffer_memory Output parameter for the allocated buffer memory.
+  @param out_allocation Output parameter for the buffer memory allocation.
   @return MOSS_RESULT_SUCCESS on success, otherwise MOSS_RESULT_ERROR.
+  @note Host-visible allocations are persistently mapped, see
+        Moss__VkAllocation::mapped_memory.
 */
 inline static MossResult moss_vk__create_buffer (
   const Moss__CreateVkBufferInfo *const info,
   VkBuffer                             *out_buffer,
-  VkDeviceMemory                       *out_buffer_memory
+  Moss__VkAllocation                   *out_allocation
 )
 {
   {  // Create buffer
@@ -123,7 +125,12 @@ inline static MossResult moss_vk__create_buffer (
       .pQueueFamilyIndices   = info->shared_queue_family_indices,
     };
 
-    const VkResult result = vkCreateBuffer (info->device, &buffer_info, NULL, out_buffer);
+    const VkResult result = vkCreateBuffer (
+      info->device,
+      &buffer_info,
+      info->allocator->allocation_callbacks,
+      out_buffer
+    );
     if (result != VK_SUCCESS)
     {
       moss__error ("Failed to create buffer: %d.\n", result);
@@ -131,63 +138,60 @@ inline static MossResult moss_vk__create_buffer (
     }
   }
 
-  // Get memory requirements
-  VkMemoryRequirements memory_requirements;
-  vkGetBufferMemoryRequirements (info->device, *out_buffer, &memory_requirements);
+  {  // Allocate memory
+    Moss__VkAllocateMemoryInfo alloc_info = {
+      .properties = info->memory_properties,
+      .tiling     = MOSS__VK_RESOURCE_TILING_LINEAR,
+    };
+    vkGetBufferMemoryRequirements (info->device, *out_buffer, &alloc_info.requirements);
 
-  // Find suitable memory type
-  uint32_t memory_type_index;
-  {
-    const MossResult result = moss__select_suitable_memory_type (
-      info->physical_device,
-      memory_requirements.memoryTypeBits,
-      info->memory_properties,
-      &memory_type_index
-    );
+    const MossResult result =
+      moss_vk__allocate_memory (info->allocator, &alloc_info, out_allocation);
     if (result != MOSS_RESULT_SUCCESS)
     {
-      vkDestroyBuffer (info->device, *out_buffer, NULL);
-      moss__error ("Failed to find suitable memory type for buffer.\n");
+      vkDestroyBuffer (info->device, *out_buffer, info->allocator->allocation_callbacks);
+      moss__error ("Failed to allocate buffer memory.\n");
       return MOSS_RESULT_ERROR;
     }
   }
 
-
-  {  // Allocate memory
-    const VkMemoryAllocateInfo alloc_info = {
-      .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-      .allocationSize  = memory_requirements.size,
-      .memoryTypeIndex = memory_type_index,
-    };
-
-    const VkResult result =
-      vkAllocateMemory (info->device, &alloc_info, NULL, out_buffer_memory);
+  {  // Bind memory to buffer
+    const VkResult result = vkBindBufferMemory (
+      info->device,
+      *out_buffer,
+      out_allocation->memory,
+      out_allocation->offset
+    );
     if (result != VK_SUCCESS)
     {
-      vkDestroyBuffer (info->device, *out_buffer, NULL);
-      moss__error ("Failed to allocate buffer memory: %d.\n", result);
+      moss_vk__free_memory (info->allocator, out_allocation);
+      vkDestroyBuffer (info->device, *out_buffer, info->allocator->allocation_callbacks);
+      moss__error ("Failed to bind buffer memory: %d.\n", result);
       return MOSS_RESULT_ERROR;
     }
   }
 
-  // Bind memory to buffer
-  vkBindBufferMemory (info->device, *out_buffer, *out_buffer_memory, 0);
-
   return MOSS_RESULT_SUCCESS;
 }
 
 /*
   @brief Destroys a Vulkan buffer and frees its memory.
-  @param device Logical device.
+  @param allocator Allocator buffer memory was allocated with.
   @param buffer Buffer to destroy.
-  @param buffer_memory Memory to free.
+  @param allocation Memory allocation to free.
 */
-inline static void
-moss_vk__destroy_buffer (VkDevice device, VkBuffer buffer, VkDeviceMemory buffer_memory)
+inline static void moss_vk__destroy_buffer (
+  Moss__VkAllocator *const  allocator,
+  const VkBuffer            buffer,
+  Moss__VkAllocation *const allocation
+)
 {
-  if (buffer_memory != VK_NULL_HANDLE) { vkFreeMemory (device, buffer_memory, NULL); }
+  if (buffer != VK_NULL_HANDLE)
+  {
+    vkDestroyBuffer (allocator->device, buffer, allocator->allocation_callbacks);
+  }
 
-  if (buffer != VK_NULL_HANDLE) { vkDestroyBuffer (device, buffer, NULL); }
+  moss_vk__free_memory (allocator, allocation);
 }
 
 /*
@@ -253,11 +257,11 @@ inline static MossResult moss_vk__copy_buffer (const Moss__CopyVkBufferInfo *con
 inline static MossResult moss_vk__fill_buffer (const Moss__FillVkBufferInfo *const info)
 {
   // Create staging buffer
-  VkBuffer       staging_buffer;
-  VkDeviceMemory staging_buffer_memory;
+  VkBuffer           staging_buffer;
+  Moss__VkAllocation staging_allocation;
 
   const Moss__CreateVkBufferInfo staging_create_info = {
-    .physical_device = info->physical_device,
+    .allocator       = info->allocator,
     .device          = info->device,
     .size            = info->data_size,
     .usage           = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
@@ -271,7 +275,7 @@ inline static MossResult moss_vk__fill_buffer (const Moss__FillVkBufferInfo *con
   MossResult result = moss_vk__create_buffer (
     &staging_create_info,
     &staging_buffer,
-    &staging_buffer_memory
+    &staging_allocation
   );
   if (result != MOSS_RESULT_SUCCESS)
   {
@@ -279,18 +283,7 @@ inline static MossResult moss_vk__fill_buffer (const Moss__FillVkBufferInfo *con
     return MOSS_RESULT_ERROR;
   }
 
-  // Map staging buffer memory and copy data
-  void *mapped_memory;
-  vkMapMemory (
-    info->device,
-    staging_buffer_memory,
-    0,
-    info->data_size,
-    0,
-    &mapped_memory
-  );
-  memcpy (mapped_memory, info->source_data, info->data_size);
-  vkUnmapMemory (info->device, staging_buffer_memory);
+  memcpy (staging_allocation.mapped_memory, info->source_data, info->data_size);
 
   // Copy from staging buffer to destination buffer
   const Moss__CopyVkBufferInfo copy_info = {
@@ -305,17 +298,57 @@ inline static MossResult moss_vk__fill_buffer (const Moss__FillVkBufferInfo *con
   result = moss_vk__copy_buffer (&copy_info);
   if (result != MOSS_RESULT_SUCCESS)
   {
-    moss_vk__destroy_buffer (info->device, staging_buffer, staging_buffer_memory);
+    moss_vk__destroy_buffer (info->allocator, staging_buffer, &staging_allocation);
     moss__error ("Failed to copy buffer data.\n");
     return MOSS_RESULT_ERROR;
   }
 
   // Cleanup staging buffer
-  moss_vk__destroy_buffer (info->device, staging_buffer, staging_buffer_memory);
+  moss_vk__destroy_buffer (info->allocator, staging_buffer, &staging_allocation);
 
   return MOSS_RESULT_SUCCESS;
 }
 
+/*
+  @brief Records copy from Vulkan buffer to image into command buffer.
+  @param command_buffer Command buffer in recording state.
+  @param buffer Source buffer to copy data from.
+  @param image Destination image in transfer destination layout.
+  @param width Image width.
+  @param height Image height.
+*/
+inline static void moss_vk__cmd_copy_buffer_to_image (
+  const VkCommandBuffer command_buffer,
+  const VkBuffer        buffer,
+  const VkImage         image,
+  const uint32_t        width,
+  const uint32_t        height
+)
+{
+  const VkBufferImageCopy region = {
+    .bufferOffset      = 0,
+    .bufferRowLength   = 0,
+    .bufferImageHeight = 0,
+
+    .imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+    .imageSubresource.mipLevel       = 0,
+    .imageSubresource.baseArrayLayer = 0,
+    .imageSubresource.layerCount     = 1,
+
+    .imageOffset = (VkOffset3D) {     0,      0, 0 },
+    .imageExtent = (VkExtent3D) { width, height, 1 },
+  };
+
+  vkCmdCopyBufferToImage (
+    command_buffer,
+    buffer,
+    image,
+    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    1,
+    &region
+  );
+}
+
 /*
   @brief Copies data from Vulkan buffer to image.
   @param info Required info to perform copy.
@@ -339,27 +372,12 @@ moss_vk__copy_buffer_to_image (const Moss__CopyVkBufferToImageInfo *const info)
     }
   }
 
-  const VkBufferImageCopy region = {
-    .bufferOffset      = 0,
-    .bufferRowLength   = 0,
-    .bufferImageHeight = 0,
-
-    .imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-    .imageSubresource.mipLevel       = 0,
-    .imageSubresource.baseArrayLayer = 0,
-    .imageSubresource.layerCount     = 1,
-
-    .imageOffset = (VkOffset3D) {           0,            0, 0 },
-    .imageExtent = (VkExtent3D) { info->width, info->height, 1 },
-  };
-
-  vkCmdCopyBufferToImage (
+  moss_vk__cmd_copy_buffer_to_image (
     command_buffer,
     info->buffer,
     info->image,
-    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-    1,
-    &region
+    info->width,
+    info->height
   );
 
   {  // End one time Vulkan command buffer
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <vulkan/vulkan.h>
 
 #include "moss/result.h"
@@ -48,6 +50,8 @@ typedef struct
   VkCommandPool   command_pool;   /* Command pool to create command buffer in. */
   VkCommandBuffer command_buffer; /* One time command buffer to end. */
   VkQueue         queue;          /* Queue to submit command buffer to. */
+  /* Callbacks of Vulkan host allocations. */
+  const VkAllocationCallbacks *allocation_callbacks;
 } Moss__EndOneTimeVkCommandBufferInfo;
 
 /*=============================================================================
@@ -142,10 +146,35 @@ inline static MossResult moss_vk__end_one_time_command_buffer (
     .pSignalSemaphores    = NULL,
   };
 
+  // Wait for this submit only instead of draining the whole queue
+  VkFence fence;
+  {  // Create fence
+    const VkFenceCreateInfo fence_info = {
+      .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+      .pNext = NULL,
+      .flags = 0,
+    };
+    const VkResult result = vkCreateFence (
+      info->device,
+      &fence_info,
+      info->allocation_callbacks,
+      &fence
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error (
+        "Failed to create one time command buffer fence. Error code: %d.\n",
+        result
+      );
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
   {  // Submit queue
-    const VkResult result = vkQueueSubmit (info->queue, 1, &submitInfo, VK_NULL_HANDLE);
+    const VkResult result = vkQueueSubmit (info->queue, 1, &submitInfo, fence);
     if (result != VK_SUCCESS)
     {
+      vkDestroyFence (info->device, fence, info->allocation_callbacks);
       moss__error (
         "Failed to submit one time command buffer (%p). Error code: %d.\n",
         (void *)info->command_buffer,
@@ -155,13 +184,15 @@ inline static MossResult moss_vk__end_one_time_command_buffer (
     }
   }
 
-  {  // Wait queue idle
-    const VkResult result = vkQueueWaitIdle (info->queue);
+  {  // Wait for submit to complete
+    const VkResult result =
+      vkWaitForFences (info->device, 1, &fence, VK_TRUE, UINT64_MAX);
+    vkDestroyFence (info->device, fence, info->allocation_callbacks);
     if (result != VK_SUCCESS)
     {
       moss__error (
-        "Failed to wait idle one time command buffer queue (%p). Error code: %d.\n",
-        (void *)info->queue,
+        "Failed to wait for one time command buffer (%p). Error code: %d.\n",
+        (void *)info->command_buffer,
         result
       );
       return MOSS_RESULT_ERROR;
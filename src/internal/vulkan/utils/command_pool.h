@@ -41,6 +41,8 @@ typedef struct
   uint32_t       queue_family_index; /* Queue family index to assign command pool to. */
   VkCommandPool *out_command_pool;  /* Output variable that created command pool handle
                                         will be written to. */
+  /* Callbacks of Vulkan host allocations. */
+  const VkAllocationCallbacks *allocation_callbacks;
 } Moss__CreateVkCommandPoolInfo;
 
 /*=============================================================================
@@ -62,8 +64,12 @@ moss_vk__create_command_pool (const Moss__CreateVkCommandPoolInfo *const info)
     .queueFamilyIndex = info->queue_family_index,
   };
 
-  const VkResult result =
-    vkCreateCommandPool (info->device, &pool_info, NULL, info->out_command_pool);
+  const VkResult result = vkCreateCommandPool (
+    info->device,
+    &pool_info,
+    info->allocation_callbacks,
+    info->out_command_pool
+  );
 
   if (result != VK_SUCCESS)
   {
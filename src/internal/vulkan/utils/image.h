@@ -27,7 +27,7 @@
 #include "moss/result.h"
 
 #include "src/internal/log.h"
-#include "src/internal/memory_utils.h"
+#include "src/internal/vulkan/utils/allocator.h"
 #include "src/internal/vulkan/utils/command_buffer.h"
 #include "vulkan/vulkan_core.h"
 
@@ -44,11 +44,14 @@ typedef struct
   VkFormat          format;                  /* Image format. */
   uint32_t          image_width;             /* Image width. */
   uint32_t          image_height;            /* Image height. */
+  uint32_t          mip_level_count;         /* Number of mip levels. */
   VkImageUsageFlags usage;                   /* Image usage flags. */
   VkSharingMode     sharing_mode;            /* Image sharing mode. */
   uint32_t  shared_queue_family_index_count; /* Number of shared queue family indices. */
   uint32_t *shared_queue_family_indices;     /* Indices of queue families that will share
                                                 image's memory. */
+  /* Callbacks of Vulkan host allocations. */
+  const VkAllocationCallbacks *allocation_callbacks;
 } MossVk__CreateImageInfo;
 
 /*
@@ -56,9 +59,9 @@ typedef struct
 */
 typedef struct
 {
-  VkPhysicalDevice physical_device; /* Physical device to allocate memory on. */
-  VkDevice         device;          /* Device where the image created on. */
-  VkImage          image;           /* Image to allocate memory for. */
+  Moss__VkAllocator *allocator; /* Allocator to sub-allocate memory with. */
+  VkDevice           device;    /* Device where the image created on. */
+  VkImage            image;     /* Image to allocate memory for. */
 } MossVk__AllocateImageMemoryInfo;
 
 /*
@@ -95,7 +98,7 @@ inline static VkImage moss_vk__create_image (const MossVk__CreateImageInfo *cons
     .sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
     .imageType             = VK_IMAGE_TYPE_2D,
     .extent                = image_extent,
-    .mipLevels             = 1,
+    .mipLevels             = info->mip_level_count,
     .arrayLayers           = 1,
     .format                = info->format,
     .tiling                = VK_IMAGE_TILING_OPTIMAL,
@@ -108,7 +111,12 @@ inline static VkImage moss_vk__create_image (const MossVk__CreateImageInfo *cons
   };
 
   VkImage        image;
-  const VkResult result = vkCreateImage (info->device, &create_info, NULL, &image);
+  const VkResult result = vkCreateImage (
+    info->device,
+    &create_info,
+    info->allocation_callbacks,
+    &image
+  );
   if (result != VK_SUCCESS)
   {
     moss__error ("Failed to create Vulkan image. Error code: %d.\n", result);
@@ -119,105 +127,88 @@ inline static VkImage moss_vk__create_image (const MossVk__CreateImageInfo *cons
 }
 
 /*
-  @brief Allocates device memory for Vulkan image.
+  @brief Sub-allocates device-local memory for Vulkan image and binds it.
   @param info Required info for allocating image memory.
-  @return On success returns a valid Vulkan device memory handle,
-          otherwise returns VK_NULL_HANDLE.
+  @param out_allocation Output image memory allocation.
+  @return Returns MOSS_RESULT_SUCCESS on success, otherwise returns MOSS_RESULT_ERROR.
 */
-inline static VkDeviceMemory
-moss_vk__allocate_image_memory (const MossVk__AllocateImageMemoryInfo *const info)
+inline static MossResult moss_vk__allocate_image_memory (
+  const MossVk__AllocateImageMemoryInfo *const info,
+  Moss__VkAllocation *const                    out_allocation
+)
 {
-  // Select suitable memory type
-  VkMemoryRequirements memory_requirements;
-  vkGetImageMemoryRequirements (info->device, info->image, &memory_requirements);
-
-  uint32_t suitable_memory_type;
-  if (moss__select_suitable_memory_type (
-        info->physical_device,
-        memory_requirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        &suitable_memory_type
-      ) != MOSS_RESULT_SUCCESS)
-  {
-    moss__error ("Failed to find suitable memory type.\n");
-    return VK_NULL_HANDLE;
-  }
-
-  VkDeviceMemory memory;
   {  // Allocate memory
-    const VkMemoryAllocateInfo alloc_info = {
-      .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-      .pNext           = NULL,
-      .allocationSize  = memory_requirements.size,
-      .memoryTypeIndex = suitable_memory_type,
+    Moss__VkAllocateMemoryInfo alloc_info = {
+      .properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+      .tiling     = MOSS__VK_RESOURCE_TILING_OPTIMAL,
     };
+    vkGetImageMemoryRequirements (info->device, info->image, &alloc_info.requirements);
 
-    const VkResult result = vkAllocateMemory (info->device, &alloc_info, NULL, &memory);
-    if (result != VK_SUCCESS)
+    const MossResult result =
+      moss_vk__allocate_memory (info->allocator, &alloc_info, out_allocation);
+    if (result != MOSS_RESULT_SUCCESS)
     {
-      moss__error ("Failed to allocate memory for the image. Error code: %d.\n", result);
-      return VK_NULL_HANDLE;
+      moss__error ("Failed to allocate memory for the image.\n");
+      return MOSS_RESULT_ERROR;
     }
   }
 
   {  // Bind image memory
-    const VkResult result = vkBindImageMemory (info->device, info->image, memory, 0);
+    const VkResult result = vkBindImageMemory (
+      info->device,
+      info->image,
+      out_allocation->memory,
+      out_allocation->offset
+    );
     if (result != VK_SUCCESS)
     {
-      vkFreeMemory (info->device, memory, NULL);
+      moss_vk__free_memory (info->allocator, out_allocation);
 
       moss__error ("Failed to bind image memory to the image. Error code: %d.\n", result);
-      return VK_NULL_HANDLE;
+      return MOSS_RESULT_ERROR;
     }
   }
 
-  return memory;
+  return MOSS_RESULT_SUCCESS;
 }
 
 
 /*
-  @brief Transitions image layout from one to another.
-  @param info Required info to perform transition.
+  @brief Records image layout transition barrier into command buffer.
+  @details Transitions every mip level of the image.
+  @param command_buffer Command buffer in recording state.
+  @param image Image to transition.
+  @param old_layout Current image layout.
+  @param new_layout Target image layout.
   @return Return MOSS_RESULT_SUCCESS on success, otherwise MOSS_RESULT_ERROR.
 */
-inline static MossResult
-moss_vk__transition_image_layout (const MossVk__TransitionImageLayoutInfo *const info)
+inline static MossResult moss_vk__cmd_transition_image_layout (
+  const VkCommandBuffer command_buffer,
+  const VkImage         image,
+  const VkImageLayout   old_layout,
+  const VkImageLayout   new_layout
+)
 {
-  VkCommandBuffer command_buffer;
-  {  // Begin one time command buffer
-    const Moss__BeginOneTimeVkCommandBufferInfo begin_info = {
-      .device       = info->device,
-      .command_pool = info->command_pool,
-    };
-    command_buffer = moss_vk__begin_one_time_command_buffer (&begin_info);
-
-    if (command_buffer == VK_NULL_HANDLE)
-    {
-      moss__error ("Failed to begin one time Vulkan command buffer.\n");
-      return MOSS_RESULT_ERROR;
-    }
-  }
-
   VkImageMemoryBarrier barrier = {
     .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-    .oldLayout           = info->old_layout,
-    .newLayout           = info->new_layout,
+    .oldLayout           = old_layout,
+    .newLayout           = new_layout,
     .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
     .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-    .image               = info->image,
+    .image               = image,
     .srcAccessMask       = 0,
     .dstAccessMask       = 0,
     .subresourceRange    = {
       .aspectMask     = VK_IMAGE_ASPECT_NONE,
       .baseMipLevel   = 0,
-      .levelCount     = 1,
+      .levelCount     = VK_REMAINING_MIP_LEVELS,
       .baseArrayLayer = 0,
       .layerCount     = 1,
     }
   };
 
   // Determine aspect mask
-  if (info->new_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+  if (new_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
   {
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
   }
@@ -229,8 +220,8 @@ moss_vk__transition_image_layout (const MossVk__TransitionImageLayoutInfo *const
   VkPipelineStageFlags sourceStage      = 0;
   VkPipelineStageFlags destinationStage = 0;
 
-  if (info->old_layout == VK_IMAGE_LAYOUT_UNDEFINED &&
-      info->new_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+  if (old_layout == VK_IMAGE_LAYOUT_UNDEFINED &&
+      new_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
   {
     barrier.srcAccessMask = 0;
     barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -238,17 +229,19 @@ moss_vk__transition_image_layout (const MossVk__TransitionImageLayoutInfo *const
     sourceStage      = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
     destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
   }
-  else if (info->old_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
-           info->new_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+  else if (old_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
+           new_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
   {
+    // Recorded on the transfer queue, which may lack shader stages. Sampling
+    // submits wait on the upload semaphore, which makes the writes visible.
     barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.dstAccessMask = 0;
 
     sourceStage      = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    destinationStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
   }
-  else if (info->old_layout == VK_IMAGE_LAYOUT_UNDEFINED &&
-           info->new_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+  else if (old_layout == VK_IMAGE_LAYOUT_UNDEFINED &&
+           new_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
   {
     barrier.srcAccessMask = 0;
     barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
@@ -260,8 +253,8 @@ moss_vk__transition_image_layout (const MossVk__TransitionImageLayoutInfo *const
   else {
     moss__error (
       "Unsupported image layout transition: %u -> %u.\n",
-      info->old_layout,
-      info->new_layout
+      old_layout,
+      new_layout
     );
     return MOSS_RESULT_ERROR;
   }
@@ -279,6 +272,46 @@ moss_vk__transition_image_layout (const MossVk__TransitionImageLayoutInfo *const
     &barrier
   );
 
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Transitions image layout from one to another.
+  @param info Required info to perform transition.
+  @return Return MOSS_RESULT_SUCCESS on success, otherwise MOSS_RESULT_ERROR.
+*/
+inline static MossResult
+moss_vk__transition_image_layout (const MossVk__TransitionImageLayoutInfo *const info)
+{
+  VkCommandBuffer command_buffer;
+  {  // Begin one time command buffer
+    const Moss__BeginOneTimeVkCommandBufferInfo begin_info = {
+      .device       = info->device,
+      .command_pool = info->command_pool,
+    };
+    command_buffer = moss_vk__begin_one_time_command_buffer (&begin_info);
+
+    if (command_buffer == VK_NULL_HANDLE)
+    {
+      moss__error ("Failed to begin one time Vulkan command buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Record transition
+    const MossResult result = moss_vk__cmd_transition_image_layout (
+      command_buffer,
+      info->image,
+      info->old_layout,
+      info->new_layout
+    );
+    if (result != MOSS_RESULT_SUCCESS)
+    {
+      vkFreeCommandBuffers (info->device, info->command_pool, 1, &command_buffer);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
   {  // End one time command buffer
     const Moss__EndOneTimeVkCommandBufferInfo end_info = {
       .device         = info->device,
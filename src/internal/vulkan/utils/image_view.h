@@ -38,6 +38,8 @@ typedef struct
   VkImage            image;  /* Image to create view for. */
   VkFormat           format; /* Image view format. */
   VkImageAspectFlags aspect; /* Image aspect. */
+  /* Callbacks of Vulkan host allocations. */
+  const VkAllocationCallbacks *allocation_callbacks;
 } Moss__VkImageViewCreateInfo;
 
 /*=============================================================================
@@ -46,6 +48,7 @@ typedef struct
 
 /*
   @brief Creates Vulkan image view instance.
+  @details View covers every mip level of the image.
   @param info Vulkan image view creation info.
   @return On success returns valid image view handler, otherwise VK_NULL_HANDLE.
 */
@@ -55,7 +58,7 @@ moss_vk__create_image_view (const Moss__VkImageViewCreateInfo *const info)
   const VkImageSubresourceRange subresource_range = {
     .aspectMask     = info->aspect,
     .baseMipLevel   = 0,
-    .levelCount     = 1,
+    .levelCount     = VK_REMAINING_MIP_LEVELS,
     .baseArrayLayer = 0,
     .layerCount     = 1,
   };
@@ -79,8 +82,12 @@ moss_vk__create_image_view (const Moss__VkImageViewCreateInfo *const info)
   };
 
   VkImageView    image_view;
-  const VkResult result =
-    vkCreateImageView (info->device, &create_info, NULL, &image_view);
+  const VkResult result = vkCreateImageView (
+    info->device,
+    &create_info,
+    info->allocation_callbacks,
+    &image_view
+  );
 
   if (result != VK_SUCCESS)
   {
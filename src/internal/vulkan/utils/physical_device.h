@@ -132,13 +132,18 @@ moss_vk__find_queue_families (const Moss__FindQueueFamiliesInfo *const info)
       indices.graphics_family_found = true;
     }
 
-    VkBool32 present_support = false;
-    vkGetPhysicalDeviceSurfaceSupportKHR (
-      info->device,
-      i,
-      info->surface,
-      &present_support
-    );
+    // Without a surface nothing is presented, graphics family stands in for present
+    VkBool32 present_support = info->surface == VK_NULL_HANDLE &&
+                               (queue_family_flags & VK_QUEUE_GRAPHICS_BIT);
+    if (info->surface != VK_NULL_HANDLE)
+    {
+      vkGetPhysicalDeviceSurfaceSupportKHR (
+        info->device,
+        i,
+        info->surface,
+        &present_support
+      );
+    }
 
     if (present_support)
     {
@@ -303,6 +308,9 @@ inline static bool moss_vk__check_device_format_support (
   const Moss__CheckDeviceFormatSupportInfo *const info
 )
 {
+  // Headless engine renders into its own images of a fixed format
+  if (info->surface == VK_NULL_HANDLE) { return true; }
+
   uint32_t format_count;
   vkGetPhysicalDeviceSurfaceFormatsKHR (info->device, info->surface, &format_count, NULL);
 
@@ -317,6 +325,134 @@ inline static bool moss_vk__check_device_format_support (
   return (format_count > 0) && (present_mode_count > 0);
 }
 
+/*
+  @brief Required info to check device feature support.
+*/
+typedef struct
+{
+  VkPhysicalDevice device; /* Physical device to check. */
+} Moss__CheckDeviceFeatureSupportInfo;
+
+/*
+  @brief Checks if device supports Vulkan 1.2 and required features.
+  @details Timeline semaphores are required by the upload queue.
+  @param info Required info to check device feature support.
+  @return True if all required features are supported, otherwise false.
+*/
+inline static bool moss_vk__check_device_feature_support (
+  const Moss__CheckDeviceFeatureSupportInfo *const info
+)
+{
+  VkPhysicalDeviceProperties device_properties;
+  vkGetPhysicalDeviceProperties (info->device, &device_properties);
+
+  if (device_properties.apiVersion < VK_API_VERSION_1_2)
+  {
+    moss__info (
+      "%s device doesn't support required Vulkan 1.2.\n",
+      device_properties.deviceName
+    );
+    return false;
+  }
+
+  VkPhysicalDeviceVulkan12Features vulkan12_features = {
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+    .pNext = NULL,
+  };
+  VkPhysicalDeviceFeatures2 features = {
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+    .pNext = &vulkan12_features,
+  };
+  vkGetPhysicalDeviceFeatures2 (info->device, &features);
+
+  if (!vulkan12_features.timelineSemaphore)
+  {
+    moss__info (
+      "%s device doesn't support required timeline semaphores.\n",
+      device_properties.deviceName
+    );
+    return false;
+  }
+
+  return true;
+}
+
+/*
+  @brief Checks if device supports descriptor indexing features bindless textures need.
+  @details Texture array is partially bound, indexed with non-uniform values and
+           updated while frames that don't use the new slots are in flight.
+  @param device Physical device to check.
+  @return True if all bindless texture features are supported, otherwise false.
+*/
+inline static bool moss_vk__check_device_bindless_support (const VkPhysicalDevice device)
+{
+  VkPhysicalDeviceVulkan12Features vulkan12_features = {
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+    .pNext = NULL,
+  };
+  VkPhysicalDeviceFeatures2 features = {
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+    .pNext = &vulkan12_features,
+  };
+  vkGetPhysicalDeviceFeatures2 (device, &features);
+
+  return vulkan12_features.shaderSampledImageArrayNonUniformIndexing &&
+         vulkan12_features.descriptorBindingSampledImageUpdateAfterBind &&
+         vulkan12_features.descriptorBindingUpdateUnusedWhilePending &&
+         vulkan12_features.descriptorBindingPartiallyBound &&
+         vulkan12_features.runtimeDescriptorArray;
+}
+
+/*
+  @brief Checks if device supports present id and present wait extensions.
+  @details Low-latency mode uses them to wait until a presented frame is displayed.
+  @param device Physical device to check.
+  @return True if both extensions and their features are supported, otherwise false.
+*/
+inline static bool
+moss_vk__check_device_present_wait_support (const VkPhysicalDevice device)
+{
+  uint32_t available_extension_count;
+  vkEnumerateDeviceExtensionProperties (device, NULL, &available_extension_count, NULL);
+
+  VkExtensionProperties available_extensions[ available_extension_count ];
+  vkEnumerateDeviceExtensionProperties (
+    device,
+    NULL,
+    &available_extension_count,
+    available_extensions
+  );
+
+  bool has_present_id = false, has_present_wait = false;
+  for (uint32_t i = 0; i < available_extension_count; ++i)
+  {
+    const char *const name = available_extensions[ i ].extensionName;
+    if (strcmp (name, VK_KHR_PRESENT_ID_EXTENSION_NAME) == 0) { has_present_id = true; }
+    if (strcmp (name, VK_KHR_PRESENT_WAIT_EXTENSION_NAME) == 0)
+    {
+      has_present_wait = true;
+    }
+  }
+
+  if (!has_present_id || !has_present_wait) { return false; }
+
+  VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features = {
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+    .pNext = NULL,
+  };
+  VkPhysicalDevicePresentIdFeaturesKHR present_id_features = {
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+    .pNext = &present_wait_features,
+  };
+  VkPhysicalDeviceFeatures2 features = {
+    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+    .pNext = &present_id_features,
+  };
+  vkGetPhysicalDeviceFeatures2 (device, &features);
+
+  return present_id_features.presentId && present_wait_features.presentWait;
+}
+
 /*
   @brief Required info to check if physical device is suitable.
 */
@@ -352,6 +488,11 @@ inline static bool moss_vk__is_physical_device_suitable (
   };
   if (!moss_vk__check_device_format_support (&format_info)) { return false; }
 
+  const Moss__CheckDeviceFeatureSupportInfo feature_info = {
+    .device = info->device,
+  };
+  if (!moss_vk__check_device_feature_support (&feature_info)) { return false; }
+
   return true;
 }
 
@@ -0,0 +1,305 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/internal/vulkan/utils/pipeline_cache.h
+  @brief Vulkan pipeline cache utility functions
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Cache files are only reused when their header matches the device, data
+           of another driver or GPU is dropped and the cache starts empty.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/result.h"
+
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+
+/* Size of the pipeline cache header version one in bytes. */
+#define MOSS_VK__PIPELINE_CACHE_HEADER_SIZE (size_t)(16 + VK_UUID_SIZE)
+
+/*=============================================================================
+    STRUCTURES
+  =============================================================================*/
+
+/*
+  @brief Required info to create pipeline cache.
+*/
+typedef struct
+{
+  VkPhysicalDevice physical_device;    /* Physical device cache data must match. */
+  VkDevice         device;             /* Logical device. */
+  const char      *file_path;          /* Path to the cache file, may be NULL. */
+  VkPipelineCache *out_pipeline_cache; /* Pointer to store created pipeline cache. */
+  /* Host allocator cache data is read with. */
+  Moss__HostAllocator *host_allocator;
+  /* Callbacks of Vulkan host allocations. */
+  const VkAllocationCallbacks *allocation_callbacks;
+} Moss__CreateVkPipelineCacheInfo;
+
+/*=============================================================================
+    FUNCTIONS
+  =============================================================================*/
+
+/*
+  @brief Reads 32-bit little-endian value, cache header fields are stored that way.
+  @param data Pointer to the value.
+  @return Read value.
+*/
+inline static uint32_t moss_vk__read_pipeline_cache_u32 (const uint8_t *const data)
+{
+  return (uint32_t)data[ 0 ] | ((uint32_t)data[ 1 ] << 8) | ((uint32_t)data[ 2 ] << 16) |
+         ((uint32_t)data[ 3 ] << 24);
+}
+
+/*
+  @brief Checks whether pipeline cache data was created by the device.
+  @param physical_device Physical device.
+  @param data Pipeline cache data.
+  @param size Pipeline cache data size in bytes.
+  @return Returns true if data can be passed to the device, false otherwise.
+*/
+inline static bool moss_vk__is_pipeline_cache_compatible (
+  const VkPhysicalDevice physical_device,
+  const uint8_t *const   data,
+  const size_t           size
+)
+{
+  if (size < MOSS_VK__PIPELINE_CACHE_HEADER_SIZE) { return false; }
+
+  VkPhysicalDeviceProperties device_properties;
+  vkGetPhysicalDeviceProperties (physical_device, &device_properties);
+
+  const uint32_t header_size    = moss_vk__read_pipeline_cache_u32 (&data[ 0 ]);
+  const uint32_t header_version = moss_vk__read_pipeline_cache_u32 (&data[ 4 ]);
+  const uint32_t vendor_id      = moss_vk__read_pipeline_cache_u32 (&data[ 8 ]);
+  const uint32_t device_id      = moss_vk__read_pipeline_cache_u32 (&data[ 12 ]);
+
+  return header_size >= MOSS_VK__PIPELINE_CACHE_HEADER_SIZE && header_size <= size &&
+         header_version == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         vendor_id == device_properties.vendorID &&
+         device_id == device_properties.deviceID &&
+         memcmp (&data[ 16 ], device_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+/*
+  @brief Reads pipeline cache file.
+  @param host_allocator Host allocator to allocate file data with.
+  @param file_path Path to the cache file.
+  @param out_data Output file data, must be freed with moss__free.
+  @param out_size Output file size.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR if there is no
+          readable file.
+*/
+inline static MossResult moss_vk__read_pipeline_cache_file (
+  Moss__HostAllocator *const host_allocator,
+  const char *const          file_path,
+  uint8_t **const            out_data,
+  size_t *const              out_size
+)
+{
+  FILE *const file = fopen (file_path, "rb");
+  if (file == NULL) { return MOSS_RESULT_ERROR; }
+
+  fseek (file, 0, SEEK_END);
+  const long file_size = ftell (file);
+  fseek (file, 0, SEEK_SET);
+
+  if (file_size <= 0)
+  {
+    fclose (file);
+    return MOSS_RESULT_ERROR;
+  }
+
+  const size_t   data_size = (size_t)file_size;
+  uint8_t *const data =
+    moss__allocate (host_allocator, data_size, MOSS_ALLOCATION_CATEGORY_TEMPORARY);
+  if (data == NULL)
+  {
+    moss__error ("Failed to allocate memory for pipeline cache: %s\n", file_path);
+    fclose (file);
+    return MOSS_RESULT_ERROR;
+  }
+
+  const size_t read_size = fread (data, 1, data_size, file);
+  fclose (file);
+
+  if (read_size != data_size)
+  {
+    moss__error ("Failed to read pipeline cache file: %s\n", file_path);
+    moss__free (host_allocator, data);
+    return MOSS_RESULT_ERROR;
+  }
+
+  *out_data = data;
+  *out_size = data_size;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Creates pipeline cache seeded from a file.
+  @details Missing or incompatible file isn't an error, the cache starts empty then.
+  @param info Required info to create pipeline cache.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss_vk__create_pipeline_cache (const Moss__CreateVkPipelineCacheInfo *const info)
+{
+  uint8_t *data = NULL;
+  size_t   size = 0;
+
+  if (info->file_path != NULL &&
+      moss_vk__read_pipeline_cache_file (
+        info->host_allocator,
+        info->file_path,
+        &data,
+        &size
+      ) == MOSS_RESULT_SUCCESS &&
+      !moss_vk__is_pipeline_cache_compatible (info->physical_device, data, size))
+  {
+    moss__info ("Pipeline cache doesn't match the device, it's rebuilt: %s\n",
+                info->file_path);
+    moss__free (info->host_allocator, data);
+    data = NULL;
+    size = 0;
+  }
+
+  const VkPipelineCacheCreateInfo create_info = {
+    .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+    .initialDataSize = size,
+    .pInitialData    = data,
+  };
+
+  VkResult result = vkCreatePipelineCache (
+    info->device,
+    &create_info,
+    info->allocation_callbacks,
+    info->out_pipeline_cache
+  );
+
+  // Driver may still reject data that passed the header check, start empty then
+  if (result != VK_SUCCESS && data != NULL)
+  {
+    const VkPipelineCacheCreateInfo empty_create_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+    };
+    result = vkCreatePipelineCache (
+      info->device,
+      &empty_create_info,
+      info->allocation_callbacks,
+      info->out_pipeline_cache
+    );
+  }
+
+  moss__free (info->host_allocator, data);
+
+  if (result != VK_SUCCESS)
+  {
+    moss__error ("Failed to create pipeline cache. Error code: %d.\n", result);
+    return MOSS_RESULT_ERROR;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*
+  @brief Writes pipeline cache data to a file.
+  @details Data is written to a temporary file first and renamed over the old one,
+           so an interrupted write never leaves a truncated cache behind.
+  @param host_allocator Host allocator to allocate temporary data with.
+  @param device Logical device.
+  @param pipeline_cache Pipeline cache.
+  @param file_path Path to the cache file.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss_vk__save_pipeline_cache (
+  Moss__HostAllocator *const host_allocator,
+  const VkDevice             device,
+  const VkPipelineCache      pipeline_cache,
+  const char *const          file_path
+)
+{
+  size_t size = 0;
+  if (vkGetPipelineCacheData (device, pipeline_cache, &size, NULL) != VK_SUCCESS ||
+      size == 0)
+  {
+    moss__error ("Failed to get pipeline cache size.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  const size_t path_length = strlen (file_path);
+  char *const  temp_path   = moss__allocate (
+    host_allocator,
+    path_length + sizeof (".tmp"),
+    MOSS_ALLOCATION_CATEGORY_TEMPORARY
+  );
+  void *const data =
+    moss__allocate (host_allocator, size, MOSS_ALLOCATION_CATEGORY_TEMPORARY);
+  if (temp_path == NULL || data == NULL)
+  {
+    moss__error ("Failed to allocate memory for pipeline cache data.\n");
+    moss__free (host_allocator, temp_path);
+    moss__free (host_allocator, data);
+    return MOSS_RESULT_ERROR;
+  }
+
+  memcpy (temp_path, file_path, path_length);
+  memcpy (temp_path + path_length, ".tmp", sizeof (".tmp"));
+
+  // Size may shrink between the calls, but never grow past the queried one
+  const VkResult result = vkGetPipelineCacheData (device, pipeline_cache, &size, data);
+  if (result != VK_SUCCESS)
+  {
+    moss__error ("Failed to get pipeline cache data. Error code: %d.\n", result);
+    moss__free (host_allocator, temp_path);
+    moss__free (host_allocator, data);
+    return MOSS_RESULT_ERROR;
+  }
+
+  FILE *const file = fopen (temp_path, "wb");
+  if (file == NULL)
+  {
+    moss__error ("Failed to open pipeline cache file: %s\n", temp_path);
+    moss__free (host_allocator, temp_path);
+    moss__free (host_allocator, data);
+    return MOSS_RESULT_ERROR;
+  }
+
+  const size_t written_size = fwrite (data, 1, size, file);
+  const int    close_result = fclose (file);
+  moss__free (host_allocator, data);
+
+  if (written_size != size || close_result != 0 || rename (temp_path, file_path) != 0)
+  {
+    moss__error ("Failed to write pipeline cache file: %s\n", file_path);
+    remove (temp_path);
+    moss__free (host_allocator, temp_path);
+    return MOSS_RESULT_ERROR;
+  }
+
+  moss__free (host_allocator, temp_path);
+
+  return MOSS_RESULT_SUCCESS;
+}
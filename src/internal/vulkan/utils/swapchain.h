@@ -167,18 +167,22 @@ inline static VkSurfaceFormatKHR moss_vk__choose_swap_surface_format (
 
 /*
   @brief Choose swap present mode.
+  @details Falls back to FIFO if the preferred mode isn't available, FIFO support is
+           required by the specification.
   @param available_present_modes Available present modes array.
   @param present_mode_count Number of available present modes.
+  @param preferred_present_mode Present mode to choose if it's available.
   @return Selected present mode.
 */
 inline static VkPresentModeKHR moss_vk__choose_swap_present_mode (
   const VkPresentModeKHR *available_present_modes,
-  uint32_t                present_mode_count
+  uint32_t                present_mode_count,
+  VkPresentModeKHR        preferred_present_mode
 )
 {
   for (uint32_t i = 0; i < present_mode_count; ++i)
   {
-    if (available_present_modes[ i ] == VK_PRESENT_MODE_MAILBOX_KHR)
+    if (available_present_modes[ i ] == preferred_present_mode)
     {
       return available_present_modes[ i ];
     }
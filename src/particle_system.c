@@ -0,0 +1,580 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/particle_system.c
+  @brief Particle system functions implementation.
+  @author Ilya Buravov (ilburale@gmail.com)
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cglm/vec2.h>
+
+#include "moss/engine.h"
+#include "moss/particle_system.h"
+#include "moss/result.h"
+#include "moss/texture.h"
+
+#include "src/internal/config.h"
+#include "src/internal/engine.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+#include "src/internal/particle_system.h"
+#include "src/internal/sprite_culling.h"
+#include "src/internal/texture.h"
+#include "src/internal/vertex.h"
+#include "src/internal/vulkan/utils/buffer.h"
+
+/* Number of vertices of a particle quad. */
+#define MOSS__VERTICIES_PER_PARTICLE (uint32_t)(6)
+
+/* Size of a particle in the particle buffer, matches the shader particle struct. */
+#define MOSS__PARTICLE_SIZE (VkDeviceSize)(6 * sizeof (float))
+
+/*=============================================================================
+    INTERNAL STRUCT DECLARATIONS
+  =============================================================================*/
+
+struct MossParticleSystem
+{
+  MossEngine             *original_engine; /* Engine this system was created on. */
+  MossTexture            *texture;         /* Texture, NULL for the default. */
+  MossSpriteBatchMaterial material;        /* Material particles are drawn with. */
+  float                   depth;           /* Depth particles are drawn at. */
+  uint16_t                uv[ 4 ];         /* Normalized UV rect of particles. */
+  uint32_t                animation_clip;  /* Animation clip ID, 0 if not animated. */
+  float                   animation_rate;  /* Animation playback speed. */
+  MossParticleEmitter     emitter;         /* Emitter parameters. */
+  uint32_t                capacity;        /* Number of particle slots. */
+
+  VkBuffer           particle_buffer;            /* Particle state buffer. */
+  Moss__VkAllocation particle_buffer_allocation; /* Particle state memory. */
+  VkBuffer           instance_buffer;            /* Instances of alive particles. */
+  Moss__VkAllocation instance_buffer_allocation; /* Instance buffer memory. */
+  VkBuffer           draw_command_buffer;        /* Indirect draw command. */
+  Moss__VkAllocation draw_command_allocation;    /* Draw command memory. */
+  VkDescriptorSet    descriptor_set;             /* Simulation set of the buffers. */
+
+  uint32_t next_particle;      /* Ring slot the next particle is emitted into. */
+  float    emission_remainder; /* Fraction of a particle carried to the next step. */
+  uint32_t burst_count;        /* Particles to emit on the next step. */
+  float    simulated_time;     /* Animation time of the last step. */
+  bool     is_simulated;       /* Whether the system was simulated at least once. */
+
+  MossParticleSystem *next_system; /* Next particle system of the engine. */
+};
+
+/*=============================================================================
+    PRIVATE FUNCTION DECLARATIONS
+  =============================================================================*/
+
+/*
+  @brief Creates particle, instance and draw command buffers and their set.
+  @param particle_system Particle system with capacity set.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__create_particle_buffers (MossParticleSystem *particle_system);
+
+/*
+  @brief Records emission and simulation step of a particle system.
+  @param particle_system Particle system handle.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__simulate_particle_system (MossParticleSystem *particle_system);
+
+/*=============================================================================
+    PUBLIC FUNCTIONS IMPLEMENTATION
+  =============================================================================*/
+
+MossParticleSystem *
+moss_create_particle_system (const MossParticleSystemCreateInfo *const info)
+{
+  if (info == NULL || info->engine == NULL || info->capacity == 0)
+  {
+    moss__error ("Invalid parameters to moss_create_particle_system.\n");
+    return NULL;
+  }
+
+  MossParticleSystem *const particle_system = moss__allocate (
+    &info->engine->host_allocator,
+    sizeof (MossParticleSystem),
+    MOSS_ALLOCATION_CATEGORY_ENGINE
+  );
+  if (particle_system == NULL)
+  {
+    moss__error ("Failed to allocate memory for particle system.\n");
+    return NULL;
+  }
+
+  *particle_system = (MossParticleSystem) {
+    .original_engine = info->engine,
+    .texture         = info->texture,
+    .material        = info->material,
+    .depth           = info->depth,
+    .uv              = {
+      moss__pack_unorm16 (info->uv.top_left[ 0 ]),
+      moss__pack_unorm16 (info->uv.top_left[ 1 ]),
+      moss__pack_unorm16 (info->uv.bottom_right[ 0 ]),
+      moss__pack_unorm16 (info->uv.bottom_right[ 1 ]),
+    },
+    .animation_clip             = info->animation_clip,
+    .animation_rate             = info->animation_rate,
+    .emitter                    = { { 0 } },
+    .capacity                   = info->capacity,
+    .particle_buffer            = VK_NULL_HANDLE,
+    .particle_buffer_allocation = { 0 },
+    .instance_buffer            = VK_NULL_HANDLE,
+    .instance_buffer_allocation = { 0 },
+    .draw_command_buffer        = VK_NULL_HANDLE,
+    .draw_command_allocation    = { 0 },
+    .descriptor_set             = VK_NULL_HANDLE,
+    .next_particle              = 0,
+    .emission_remainder         = 0.0F,
+    .burst_count                = 0,
+    .simulated_time             = 0.0F,
+    .is_simulated               = false,
+    .next_system                = info->engine->particle_systems,
+  };
+
+  if (info->emitter != NULL) { particle_system->emitter = *info->emitter; }
+
+  // Linked before buffers are created, so destruction unlinks it on failure too
+  info->engine->particle_systems = particle_system;
+
+  if (moss__create_particle_buffers (particle_system) != MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_particle_system (particle_system);
+    return NULL;
+  }
+
+  return particle_system;
+}
+
+void moss_destroy_particle_system (MossParticleSystem *const particle_system)
+{
+  if (particle_system == NULL) { return; }
+
+  MossEngine *const engine = particle_system->original_engine;
+
+  // Wait until device finishes all his work
+  vkDeviceWaitIdle (engine->device);
+
+  MossParticleSystem **link = &engine->particle_systems;
+  while (*link != NULL && *link != particle_system) { link = &(*link)->next_system; }
+  if (*link != NULL) { *link = particle_system->next_system; }
+
+  if (particle_system->descriptor_set != VK_NULL_HANDLE)
+  {
+    vkFreeDescriptorSets (
+      engine->device,
+      engine->particle_descriptor_pool,
+      1,
+      &particle_system->descriptor_set
+    );
+  }
+
+  moss_vk__destroy_buffer (
+    &engine->allocator,
+    particle_system->draw_command_buffer,
+    &particle_system->draw_command_allocation
+  );
+
+  moss_vk__destroy_buffer (
+    &engine->allocator,
+    particle_system->instance_buffer,
+    &particle_system->instance_buffer_allocation
+  );
+
+  moss_vk__destroy_buffer (
+    &engine->allocator,
+    particle_system->particle_buffer,
+    &particle_system->particle_buffer_allocation
+  );
+
+  moss__free (&engine->host_allocator, particle_system);
+}
+
+void moss_set_particle_system_emitter (
+  MossParticleSystem *const        particle_system,
+  const MossParticleEmitter *const emitter
+)
+{
+  if (particle_system == NULL || emitter == NULL)
+  {
+    moss__error ("Invalid parameters to moss_set_particle_system_emitter.\n");
+    return;
+  }
+
+  particle_system->emitter = *emitter;
+}
+
+void moss_emit_particles (
+  MossParticleSystem *const particle_system,
+  const uint32_t            particle_count
+)
+{
+  if (particle_system == NULL)
+  {
+    moss__error ("Invalid parameters to moss_emit_particles.\n");
+    return;
+  }
+
+  // Bursts past capacity would only overwrite particles of the same step
+  const uint32_t free_count = particle_system->capacity - particle_system->burst_count;
+  particle_system->burst_count +=
+    particle_count < free_count ? particle_count : free_count;
+}
+
+MossResult moss_draw_particle_system (
+  MossEngine *const         engine,
+  MossParticleSystem *const particle_system
+)
+{
+  if (engine == NULL || particle_system == NULL)
+  {
+    moss__error ("Invalid parameters to moss_draw_particle_system.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  return moss_record_particle_system (&engine->main_recorder, particle_system);
+}
+
+MossResult moss_record_particle_system (
+  MossCommandRecorder *const recorder,
+  MossParticleSystem *const  particle_system
+)
+{
+  if (recorder == NULL || particle_system == NULL)
+  {
+    moss__error ("Invalid parameters to moss_record_particle_system.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (!recorder->is_recording)
+  {
+    moss__error ("Command recorder isn't begun.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  MossEngine *const engine = recorder->engine;
+
+  if (particle_system->original_engine != engine)
+  {
+    moss__error ("Particle system created with different engine.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Instance buffer holds nothing until the first simulation step
+  if (!particle_system->is_simulated) { return MOSS_RESULT_SUCCESS; }
+
+  const MossTexture *const texture = particle_system->texture != NULL
+                                       ? particle_system->texture
+                                       : engine->default_texture;
+
+  moss__bind_graphics_pipeline (
+    recorder,
+    engine->instanced_graphics_pipelines[ particle_system->material ]
+  );
+  moss__bind_texture_descriptor_set (recorder, texture->descriptor_set);
+  moss__bind_camera (recorder, NULL);
+  moss__bind_vertex_buffer (recorder, particle_system->instance_buffer, 0);
+
+  // Alive particles are counted on the GPU, so only the draw is counted
+  vkCmdDrawIndirect (
+    recorder->command_buffer,
+    particle_system->draw_command_buffer,
+    0,
+    1,
+    0
+  );
+  ++recorder->draw_call_count;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*=============================================================================
+    INTERNAL FUNCTIONS IMPLEMENTATION
+  =============================================================================*/
+
+MossResult moss__simulate_particle_systems (MossEngine *const engine)
+{
+  for (MossParticleSystem *particle_system = engine->particle_systems;
+       particle_system != NULL;
+       particle_system = particle_system->next_system)
+  {
+    if (moss__simulate_particle_system (particle_system) != MOSS_RESULT_SUCCESS)
+    {
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*=============================================================================
+    PRIVATE FUNCTIONS IMPLEMENTATION
+  =============================================================================*/
+
+inline static MossResult
+moss__create_particle_buffers (MossParticleSystem *const particle_system)
+{
+  MossEngine *const engine = particle_system->original_engine;
+
+  const VkDeviceSize sizes[ 3 ] = {
+    (VkDeviceSize)particle_system->capacity * MOSS__PARTICLE_SIZE,
+    (VkDeviceSize)particle_system->capacity * sizeof (Moss__SpriteInstance),
+    sizeof (VkDrawIndirectCommand),
+  };
+
+  const VkBufferUsageFlags usages[ 3 ] = {
+    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+      VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+  };
+
+  VkBuffer *const buffers[ 3 ] = {
+    &particle_system->particle_buffer,
+    &particle_system->instance_buffer,
+    &particle_system->draw_command_buffer,
+  };
+
+  Moss__VkAllocation *const allocations[ 3 ] = {
+    &particle_system->particle_buffer_allocation,
+    &particle_system->instance_buffer_allocation,
+    &particle_system->draw_command_allocation,
+  };
+
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    const Moss__CreateVkBufferInfo create_info = {
+      .allocator                       = &engine->allocator,
+      .device                          = engine->device,
+      .size                            = sizes[ i ],
+      .usage                           = usages[ i ],
+      .memory_properties               = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+      .sharing_mode                    = engine->buffer_sharing_mode,
+      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+    };
+    if (moss_vk__create_buffer (&create_info, buffers[ i ], allocations[ i ]) !=
+        MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create particle system buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Allocate and write descriptor set
+    const VkDescriptorSetAllocateInfo alloc_info = {
+      .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .descriptorPool     = engine->particle_descriptor_pool,
+      .descriptorSetCount = 1,
+      .pSetLayouts        = &engine->particle_descriptor_set_layout,
+    };
+
+    if (vkAllocateDescriptorSets (
+          engine->device,
+          &alloc_info,
+          &particle_system->descriptor_set
+        ) != VK_SUCCESS)
+    {
+      moss__error ("Failed to allocate particle system descriptor set.\n");
+      particle_system->descriptor_set = VK_NULL_HANDLE;
+      return MOSS_RESULT_ERROR;
+    }
+
+    VkDescriptorBufferInfo buffer_infos[ 3 ];
+    VkWriteDescriptorSet   writes[ 3 ];
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+      buffer_infos[ i ] = (VkDescriptorBufferInfo) {
+        .buffer = *buffers[ i ],
+        .offset = 0,
+        .range  = sizes[ i ],
+      };
+
+      writes[ i ] = (VkWriteDescriptorSet) {
+        .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet          = particle_system->descriptor_set,
+        .dstBinding      = i,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .pBufferInfo     = &buffer_infos[ i ],
+      };
+    }
+
+    vkUpdateDescriptorSets (engine->device, 3, writes, 0, NULL);
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult
+moss__simulate_particle_system (MossParticleSystem *const particle_system)
+{
+  MossEngine *const     engine         = particle_system->original_engine;
+  const VkCommandBuffer command_buffer = moss__get_cull_command_buffer (engine);
+  if (command_buffer == VK_NULL_HANDLE) { return MOSS_RESULT_ERROR; }
+
+  // Device-local memory isn't zeroed, zero age and lifetime mark slots as dead
+  if (!particle_system->is_simulated)
+  {
+    vkCmdFillBuffer (
+      command_buffer,
+      particle_system->particle_buffer,
+      0,
+      VK_WHOLE_SIZE,
+      0
+    );
+  }
+
+  // Shader counts alive particles up from zero, the rest of the command is fixed
+  const VkDrawIndirectCommand draw_command = {
+    .vertexCount   = MOSS__VERTICIES_PER_PARTICLE,
+    .instanceCount = 0,
+    .firstVertex   = 0,
+    .firstInstance = 0,
+  };
+  vkCmdUpdateBuffer (
+    command_buffer,
+    particle_system->draw_command_buffer,
+    0,
+    sizeof (draw_command),
+    &draw_command
+  );
+
+  const VkMemoryBarrier barrier = {
+    .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+    .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+    .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+  };
+
+  vkCmdPipelineBarrier (
+    command_buffer,
+    VK_PIPELINE_STAGE_TRANSFER_BIT,
+    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+    0,
+    1,
+    &barrier,
+    0,
+    NULL,
+    0,
+    NULL
+  );
+
+  // Long stalls are clamped, so particles don't jump across the screen
+  float time_step = 0.0F;
+  if (particle_system->is_simulated)
+  {
+    time_step = engine->animation_time - particle_system->simulated_time;
+    if (time_step > MAX_PARTICLE_TIME_STEP) { time_step = MAX_PARTICLE_TIME_STEP; }
+    if (time_step < 0.0F) { time_step = 0.0F; }
+  }
+
+  const MossParticleEmitter *const emitter = &particle_system->emitter;
+
+  const float emission = emitter->emission_rate > 0.0F
+                           ? emitter->emission_rate * time_step +
+                               particle_system->emission_remainder
+                           : 0.0F;
+  const float emitted = floorf (emission);
+
+  // Emitting more than capacity would overwrite particles of the same step
+  const float emitted_count = emitted + (float)particle_system->burst_count;
+  const uint32_t emitted_particle_count =
+    emitted_count < (float)particle_system->capacity ? (uint32_t)emitted_count
+                                                     : particle_system->capacity;
+
+  const uint32_t first_emitted = particle_system->next_particle;
+
+  particle_system->emission_remainder = emission - emitted;
+  particle_system->burst_count        = 0;
+  particle_system->next_particle =
+    (uint32_t)(((uint64_t)first_emitted + emitted_particle_count) %
+               particle_system->capacity);
+
+  const MossTexture *const texture = particle_system->texture != NULL
+                                       ? particle_system->texture
+                                       : engine->default_texture;
+
+  const Moss__ParticlePushConstants push_constants = {
+    .position        = { emitter->position[ 0 ], emitter->position[ 1 ] },
+    .position_spread = { emitter->position_spread[ 0 ], emitter->position_spread[ 1 ] },
+    .min_velocity    = { emitter->min_velocity[ 0 ], emitter->min_velocity[ 1 ] },
+    .max_velocity    = { emitter->max_velocity[ 0 ], emitter->max_velocity[ 1 ] },
+    .acceleration    = { emitter->acceleration[ 0 ], emitter->acceleration[ 1 ] },
+    .start_size      = { emitter->start_size[ 0 ], emitter->start_size[ 1 ] },
+    .end_size        = { emitter->end_size[ 0 ], emitter->end_size[ 1 ] },
+    .min_lifetime    = emitter->min_lifetime,
+    .max_lifetime    = emitter->max_lifetime,
+    .time_step       = time_step,
+    .time            = engine->animation_time,
+    .first_emitted   = first_emitted,
+    .emitted_count   = emitted_particle_count,
+    .capacity        = particle_system->capacity,
+    .seed            = (uint32_t)engine->frame_count,
+    .uv              = {
+      particle_system->uv[ 0 ],
+      particle_system->uv[ 1 ],
+      particle_system->uv[ 2 ],
+      particle_system->uv[ 3 ],
+    },
+    .texture_index  = texture->index,
+    .animation_clip = particle_system->animation_clip,
+    .animation_rate = particle_system->animation_rate,
+    .depth          = particle_system->depth,
+  };
+
+  vkCmdBindPipeline (
+    command_buffer,
+    VK_PIPELINE_BIND_POINT_COMPUTE,
+    engine->particle_pipeline
+  );
+
+  vkCmdBindDescriptorSets (
+    command_buffer,
+    VK_PIPELINE_BIND_POINT_COMPUTE,
+    engine->particle_pipeline_layout,
+    0,
+    1,
+    &particle_system->descriptor_set,
+    0,
+    NULL
+  );
+
+  vkCmdPushConstants (
+    command_buffer,
+    engine->particle_pipeline_layout,
+    VK_SHADER_STAGE_COMPUTE_BIT,
+    0,
+    sizeof (push_constants),
+    &push_constants
+  );
+
+  const uint32_t group_count =
+    (particle_system->capacity + PARTICLE_WORKGROUP_SIZE - 1) / PARTICLE_WORKGROUP_SIZE;
+  vkCmdDispatch (command_buffer, group_count, 1, 1);
+
+  particle_system->simulated_time = engine->animation_time;
+  particle_system->is_simulated   = true;
+
+  return MOSS_RESULT_SUCCESS;
+}
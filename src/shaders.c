@@ -0,0 +1,123 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/shaders.c
+  @brief SPIR-V code of engine shaders.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Included files are comma separated SPIR-V words emitted by glslc at build
+           time, see CMakeShaders.txt.
+*/
+
+#include <stdint.h>
+
+#include "src/internal/shaders.h"
+
+/*=============================================================================
+    SHADER WORDS
+  =============================================================================*/
+
+static const uint32_t moss__vert_shader_words[] = {
+#include "shader.vert.inc"
+};
+
+static const uint32_t moss__instanced_vert_shader_words[] = {
+#include "sprite_instanced.vert.inc"
+};
+
+static const uint32_t moss__compact_vert_shader_words[] = {
+#include "sprite_compact.vert.inc"
+};
+
+static const uint32_t moss__frag_shader_words[] = {
+#include "shader.frag.inc"
+};
+
+static const uint32_t moss__bindless_frag_shader_words[] = {
+#include "shader_bindless.frag.inc"
+};
+
+static const uint32_t moss__cull_comp_shader_words[] = {
+#include "sprite_cull.comp.inc"
+};
+
+static const uint32_t moss__tilemap_vert_shader_words[] = {
+#include "tilemap.vert.inc"
+};
+
+static const uint32_t moss__tilemap_frag_shader_words[] = {
+#include "tilemap.frag.inc"
+};
+
+static const uint32_t moss__bindless_tilemap_frag_shader_words[] = {
+#include "tilemap_bindless.frag.inc"
+};
+
+static const uint32_t moss__particle_comp_shader_words[] = {
+#include "particle_simulate.comp.inc"
+};
+
+/*=============================================================================
+    SHADER CODE
+  =============================================================================*/
+
+const Moss__ShaderCode moss__vert_shader_code = {
+  .code      = moss__vert_shader_words,
+  .code_size = sizeof (moss__vert_shader_words),
+};
+
+const Moss__ShaderCode moss__instanced_vert_shader_code = {
+  .code      = moss__instanced_vert_shader_words,
+  .code_size = sizeof (moss__instanced_vert_shader_words),
+};
+
+const Moss__ShaderCode moss__compact_vert_shader_code = {
+  .code      = moss__compact_vert_shader_words,
+  .code_size = sizeof (moss__compact_vert_shader_words),
+};
+
+const Moss__ShaderCode moss__frag_shader_code = {
+  .code      = moss__frag_shader_words,
+  .code_size = sizeof (moss__frag_shader_words),
+};
+
+const Moss__ShaderCode moss__bindless_frag_shader_code = {
+  .code      = moss__bindless_frag_shader_words,
+  .code_size = sizeof (moss__bindless_frag_shader_words),
+};
+
+const Moss__ShaderCode moss__cull_comp_shader_code = {
+  .code      = moss__cull_comp_shader_words,
+  .code_size = sizeof (moss__cull_comp_shader_words),
+};
+
+const Moss__ShaderCode moss__tilemap_vert_shader_code = {
+  .code      = moss__tilemap_vert_shader_words,
+  .code_size = sizeof (moss__tilemap_vert_shader_words),
+};
+
+const Moss__ShaderCode moss__tilemap_frag_shader_code = {
+  .code      = moss__tilemap_frag_shader_words,
+  .code_size = sizeof (moss__tilemap_frag_shader_words),
+};
+
+const Moss__ShaderCode moss__bindless_tilemap_frag_shader_code = {
+  .code      = moss__bindless_tilemap_frag_shader_words,
+  .code_size = sizeof (moss__bindless_tilemap_frag_shader_words),
+};
+
+const Moss__ShaderCode moss__particle_comp_shader_code = {
+  .code      = moss__particle_comp_shader_words,
+  .code_size = sizeof (moss__particle_comp_shader_words),
+};
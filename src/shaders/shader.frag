@@ -0,0 +1,17 @@
+#version 450
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+// Disabled for opaque and translucent materials, see MossSpriteBatchMaterial
+layout(constant_id = 0) const bool alphaTest = true;
+
+layout(set = 0, binding = 0) uniform sampler2D texSampler;
+
+void main() {
+    outColor = texture(texSampler, fragTexCoord);
+
+    if (alphaTest && outColor.a < 0.01) { discard; }
+}
+
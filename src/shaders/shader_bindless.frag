@@ -0,0 +1,19 @@
+#version 450
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) flat in uint fragTextureIndex;
+
+layout(location = 0) out vec4 outColor;
+
+// Disabled for opaque and translucent materials, see MossSpriteBatchMaterial
+layout(constant_id = 0) const bool alphaTest = true;
+
+layout(set = 0, binding = 0) uniform sampler2D textures[];
+
+void main() {
+    outColor = texture(textures[nonuniformEXT(fragTextureIndex)], fragTexCoord);
+
+    if (alphaTest && outColor.a < 0.01) { discard; }
+}
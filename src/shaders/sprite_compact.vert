@@ -0,0 +1,23 @@
+#version 450
+
+// Camera is pushed per draw, already combined with the batch bounds compact
+// positions are normalized to
+layout(push_constant) uniform Camera {
+  vec2 scale;
+  vec2 offset;
+} camera;
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+layout(location = 2) in float inDepth;
+layout(location = 3) in uint inTextureIndex;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint fragTextureIndex;
+
+void main() {
+    vec2 clipPosition = inPosition * camera.scale + camera.offset;
+    gl_Position = vec4(clipPosition, inDepth, 1.0);
+    fragTexCoord = inTexCoord;
+    fragTextureIndex = inTextureIndex;
+}
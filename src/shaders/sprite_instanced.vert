@@ -0,0 +1,67 @@
+#version 450
+
+// Camera is pushed per draw, so every draw may use its own camera. Animation time
+// is pushed once per recording
+layout(push_constant) uniform Camera {
+  vec2 scale;
+  vec2 offset;
+  float animationTime;
+} camera;
+
+// UV rects of animation frames: top left and bottom right
+layout(set = 1, binding = 0) readonly buffer AnimationFrames {
+  vec4 frames[];
+} animationFrames;
+
+// Animation clips: first frame, frame count, frame duration bits and loop flag
+layout(set = 1, binding = 1) readonly buffer AnimationClips {
+  uvec4 clips[];
+} animationClips;
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inSize;
+layout(location = 2) in float inDepth;
+layout(location = 3) in vec4 inUV;
+layout(location = 4) in uint inTextureIndex;
+layout(location = 5) in float inAnimationStartTime;
+layout(location = 6) in float inAnimationRate;
+layout(location = 7) in uint inAnimationClip;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint fragTextureIndex;
+
+// Quad corners for two triangles: (top left, top right, bottom right)
+// and (bottom right, bottom left, top left).
+const vec2 corners[6] = vec2[](
+  vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+  vec2(1.0, 1.0), vec2(0.0, 1.0), vec2(0.0, 0.0)
+);
+
+// Returns UV rect of the current clip frame, or the sprite one if it isn't animated.
+vec4 animatedUV() {
+    if (inAnimationClip == 0u) {
+        return inUV;
+    }
+
+    uvec4 clip = animationClips.clips[inAnimationClip - 1u];
+
+    float elapsed = (camera.animationTime - inAnimationStartTime) * inAnimationRate;
+    elapsed = max(elapsed, 0.0);
+    uint  frame   = uint(elapsed / uintBitsToFloat(clip.z));
+    frame = clip.w != 0u ? frame % clip.y : min(frame, clip.y - 1u);
+
+    return animationFrames.frames[clip.x + frame];
+}
+
+void main() {
+    vec2 corner = corners[gl_VertexIndex];
+    vec4 uv     = animatedUV();
+
+    vec2 topLeft       = inPosition + vec2(-0.5, 0.5) * inSize;
+    vec2 worldPosition = topLeft + vec2(corner.x, -corner.y) * inSize;
+
+    vec2 clipPosition = worldPosition * camera.scale + camera.offset;
+    gl_Position = vec4(clipPosition.xy, inDepth, 1.0);
+    fragTexCoord = mix(uv.xy, uv.zw, corner);
+    fragTextureIndex = inTextureIndex;
+}
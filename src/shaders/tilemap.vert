@@ -0,0 +1,45 @@
+#version 450
+
+// Camera is pushed per draw, tilemap parameters follow the animation time
+layout(push_constant) uniform PushConstants {
+  vec2 cameraScale;
+  vec2 cameraOffset;
+  layout(offset = 24) vec2 position;
+  vec2 tileSize;
+  uvec2 mapSize;
+  uvec2 atlasSize;
+  float depth;
+  uint textureIndex;
+  uint chunkSize;
+} pc;
+
+layout(location = 0) out vec2 fragTilePosition;
+layout(location = 1) flat out uint fragTextureIndex;
+
+// Quad corners for two triangles: (top left, top right, bottom right)
+// and (bottom right, bottom left, top left).
+const vec2 corners[6] = vec2[](
+  vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+  vec2(1.0, 1.0), vec2(0.0, 1.0), vec2(0.0, 0.0)
+);
+
+void main() {
+    vec2 corner = corners[gl_VertexIndex];
+
+    // Every instance is a chunk, edge chunks are clamped to the map size
+    uint  instance     = uint(gl_InstanceIndex);
+    uint  chunkColumns = (pc.mapSize.x + pc.chunkSize - 1u) / pc.chunkSize;
+    uvec2 chunk        = uvec2(instance % chunkColumns, instance / chunkColumns);
+    uvec2 tileMin      = chunk * pc.chunkSize;
+    uvec2 tileMax      = min(tileMin + pc.chunkSize, pc.mapSize);
+
+    // Tile rows go down from the top left corner of the map
+    vec2 tilePosition  = mix(vec2(tileMin), vec2(tileMax), corner);
+    vec2 worldOffset   = vec2(tilePosition.x, -tilePosition.y) * pc.tileSize;
+    vec2 worldPosition = pc.position + worldOffset;
+
+    vec2 clipPosition = worldPosition * pc.cameraScale + pc.cameraOffset;
+    gl_Position = vec4(clipPosition.xy, pc.depth, 1.0);
+    fragTilePosition = tilePosition;
+    fragTextureIndex = pc.textureIndex;
+}
@@ -0,0 +1,45 @@
+#version 450
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec2 fragTilePosition;
+layout(location = 1) flat in uint fragTextureIndex;
+
+layout(location = 0) out vec4 outColor;
+
+// Disabled for opaque and translucent materials, see MossSpriteBatchMaterial
+layout(constant_id = 0) const bool alphaTest = true;
+
+layout(push_constant) uniform PushConstants {
+  layout(offset = 40) uvec2 mapSize;
+  uvec2 atlasSize;
+} pc;
+
+layout(set = 0, binding = 0) uniform sampler2D textures[];
+
+// Tile indices, two 16-bit tiles per word, 0 is an empty tile
+layout(set = 2, binding = 0) readonly buffer Tiles {
+  uint tiles[];
+} tilemap;
+
+void main() {
+    uvec2 tile  = min(uvec2(fragTilePosition), pc.mapSize - 1u);
+    uint  index = tile.y * pc.mapSize.x + tile.x;
+    uint  value = (tilemap.tiles[index >> 1u] >> ((index & 1u) * 16u)) & 0xFFFFu;
+    if (value == 0u) { discard; }
+
+    uint cell      = value - 1u;
+    vec2 atlasCell = vec2(cell % pc.atlasSize.x, cell / pc.atlasSize.x);
+    vec2 atlasSize = vec2(pc.atlasSize);
+    vec2 uv        = (atlasCell + fract(fragTilePosition)) / atlasSize;
+
+    // Gradients of the continuous tile position, fract jumps at tile edges
+    outColor = textureGrad(
+      textures[nonuniformEXT(fragTextureIndex)],
+      uv,
+      dFdx(fragTilePosition) / atlasSize,
+      dFdy(fragTilePosition) / atlasSize
+    );
+
+    if (alphaTest && outColor.a < 0.01) { discard; }
+}
@@ -19,8 +19,10 @@
   @author Ilya Buravov (ilburale@gmail.com)
 */
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -28,17 +30,36 @@
 #include "moss/result.h"
 #include "moss/sprite.h"
 #include "moss/sprite_batch.h"
+#include "moss/texture.h"
 
+#include "src/internal/atomic.h"
+#include "src/internal/camera.h"
+#include "src/internal/config.h"
+#include "src/internal/draw_queue.h"
 #include "src/internal/engine.h"
+#include "src/internal/frame_upload_queue.h"
+#include "src/internal/host_allocator.h"
 #include "src/internal/log.h"
+#include "src/internal/memory_utils.h"
+#include "src/internal/quad_index_buffer.h"
+#include "src/internal/sprite_chunks.h"
+#include "src/internal/sprite_batch.h"
+#include "src/internal/sprite_batch_snapshot.h"
+#include "src/internal/sprite_culling.h"
+#include "src/internal/sprite_dirty_ranges.h"
+#include "src/internal/sprite_sort.h"
+#include "src/internal/sprite_vertex_kernel.h"
+#include "src/internal/texture.h"
+#include "src/internal/upload_queue.h"
 #include "src/internal/vertex.h"
 #include "src/internal/vulkan/utils/buffer.h"
-#include "src/internal/vulkan/utils/command_buffer.h"
 #include "vulkan/vulkan_core.h"
 
-#define MOSS__VERTICIES_PER_SPRITE (size_t)(4)
+#define MOSS__VERTICIES_PER_SPRITE MOSS__QUAD_VERTEX_COUNT
 
-#define MOSS__INDICES_PER_SPRITE (size_t)(6)
+#define MOSS__INDICES_PER_SPRITE MOSS__QUAD_INDEX_COUNT
+
+#define MOSS__VERTICIES_PER_INSTANCE (uint32_t)(6)
 
 /*=============================================================================
     INTERNAL STRUCT DECLARATIONS
@@ -46,60 +67,307 @@
 
 struct MossSpriteBatch
 {
-  MossEngine    *original_engine;    /* Engine where this batch was created on. */
-  VkBuffer       buffer;             /* Combined vertex and index buffer. */
-  VkDeviceMemory buffer_memory;      /* Combined buffer memory. */
-  VkBuffer       staging_buffer;     /* Staging buffer. */
-  VkDeviceMemory staging_memory;     /* Staging buffer memory. */
-  void          *mapped_memory;      /* Mapped staging buffer memory. */
-  size_t         buffer_capacity;    /* Total buffer capacity in bytes. */
-  size_t         vertex_data_offset; /* Offset where vertex data starts in buffer. */
-  size_t         index_data_offset;  /* Offset where index data starts in buffer. */
-  size_t         vertex_data_size;   /* Current vertex data size in bytes. */
-  size_t         index_data_size;    /* Current index data size in bytes. */
-  size_t         vertex_capacity;    /* Maximum vertex capacity in bytes. */
-  size_t         index_capacity;     /* Maximum index capacity in bytes. */
-  uint32_t       index_count;        /* Number of indices. */
-  bool           is_begun;           /* Whether begin has been called. */
+  MossEngine             *original_engine;         /* Engine this batch was created on. */
+  MossSpriteBatchMode     mode;                    /* Storage and rendering mode. */
+  MossSpriteBatchUsage    usage;                   /* Update frequency. */
+  MossSpriteBatchMaterial material;                /* Blending and depth writes. */
+  MossTexture            *texture;                 /* Texture, NULL for the default. */
+  VkBuffer                buffer;                  /* Vertex buffer. */
+  Moss__VkAllocation      buffer_allocation;       /* Vertex buffer memory. */
+  VkBuffer                staging_buffer;          /* Staging buffer. */
+  Moss__VkAllocation      staging_allocation;      /* Staging buffer memory. */
+  void                   *mapped_memory;           /* Mapped staging or stream memory. */
+  void                   *host_sprite_data;        /* Cached fill of static batches. */
+  size_t                  buffer_capacity;         /* Total buffer capacity in bytes. */
+  size_t                  vertex_data_offset;      /* Offset of vertex data in buffer. */
+  size_t                  vertex_capacity;         /* Maximum vertex capacity in bytes. */
+  size_t                  sprite_data_size;        /* Size of a single sprite in bytes. */
+  uint32_t                sprite_capacity;         /* Maximum number of sprites. */
+  uint32_t                sprite_count;            /* Reserved sprites, atomic. */
+  uint64_t                staging_frame_count;     /* Frame copying from staging last. */
+  bool                    is_begun;                /* Whether begin has been called. */
+  bool                    is_culled;               /* Whether culled on the GPU. */
+  VkBuffer                culled_buffer;           /* Visible indices or instances. */
+  Moss__VkAllocation      culled_allocation;       /* Culled buffer memory. */
+  VkBuffer                draw_command_buffer;     /* Indirect draw command. */
+  Moss__VkAllocation      draw_command_allocation; /* Indirect draw command memory. */
+  VkDescriptorSet         cull_descriptor_set;     /* Culling buffers set. */
+  uint64_t                culled_frame_count;      /* Frame of the last culling. */
+  vec2                    culled_camera_scale;     /* Camera scale of last culling. */
+  vec2                    culled_camera_offset;    /* Camera offset of last culling. */
+  float                   chunk_size;              /* Chunk size, 0 if not chunked. */
+  Moss__SpriteChunk      *chunks;                  /* Chunks built by the last end. */
+  uint32_t                chunk_count;             /* Number of chunks. */
+  vec2                    bounds_position;         /* Center of compact bounds. */
+  vec2                    bounds_size;             /* Size of compact bounds. */
+  MossSpriteBatchRange   *dirty_ranges;            /* Updated ranges, sorted. */
+  uint32_t                dirty_range_count;       /* Number of updated ranges. */
+  MossSpriteBatch        *next_updated_batch;      /* Next batch with updates. */
 };
 
 /*
-  @brief Create combined buffer info.
+  @brief Create vertex buffer info.
 */
 typedef struct
 {
-  MossEngine *engine; /* Engine handle */
-  size_t      size;   /* Desired size of the buffer in bytes. */
-} Moss__CreateCombinedBufferInfo;
+  MossEngine        *engine;      /* Engine handle */
+  size_t             size;        /* Desired size of the buffer in bytes. */
+  VkBufferUsageFlags extra_usage; /* Usage on top of the vertex buffer one. */
+} Moss__CreateVertexBufferInfo;
 
 /*=============================================================================
     PRIVATE FUNCTION DECLARATIONS
   =============================================================================*/
 
 /*
-  @brief Creates combined vertex and index buffer.
+  @brief Creates device-local vertex buffer.
   @param info Required operation info.
   @param out_buffer Output buffer.
-  @param out_buffer_memory Output buffer memory.
+  @param out_buffer_allocation Output buffer memory allocation.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_vertex_buffer (
+  const Moss__CreateVertexBufferInfo *info,
+  VkBuffer                           *out_buffer,
+  Moss__VkAllocation                 *out_buffer_allocation
+);
+
+/*
+  @brief Creates device-local vertex buffer and persistently mapped staging buffer
+         for a static sprite batch.
+  @param info Required operation info.
+  @param sprite_batch Sprite batch to create buffers for.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_static_buffers (
+  const Moss__CreateVertexBufferInfo *info,
+  MossSpriteBatch                    *sprite_batch
+);
+
+/*
+  @brief Creates persistently mapped host-visible vertex buffer with a region
+         per frame in flight for a stream sprite batch.
+  @param info Required operation info, size is the size of a single region.
+  @param sprite_batch Sprite batch to create buffer for.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_stream_buffer (
+  const Moss__CreateVertexBufferInfo *info,
+  MossSpriteBatch                    *sprite_batch
+);
+
+/*
+  @brief Creates culling buffers and descriptor set of a sprite batch.
+  @param sprite_batch Sprite batch to create culling resources for, its vertex
+                      buffer must be created.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_cull_resources (MossSpriteBatch *sprite_batch);
+
+/*
+  @brief Destroys culling buffers and descriptor set of a sprite batch.
+  @param sprite_batch Sprite batch to destroy culling resources of.
+*/
+inline static void moss__destroy_cull_resources (MossSpriteBatch *sprite_batch);
+
+/*
+  @brief Records culling of sprite batch to the cull command buffer of the frame.
+  @param sprite_batch Sprite batch to cull.
+  @param camera Camera to cull the batch for.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__record_sprite_batch_culling (
+  MossSpriteBatch                 *sprite_batch,
+  const Moss__CameraPushConstants *camera
+);
+
+/*
+  @brief Chunks and depth sorts sprites of a static sprite batch.
+  @details Chunks and sprite order are built from the cached host copy of the fill,
+           reordered sprites are then written to staging memory in a single
+           sequential pass. Batches that are neither chunked nor sorted are copied
+           to staging as is.
+  @param sprite_batch Static sprite batch with a host copy of sprite data.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__reorder_sprite_batch (MossSpriteBatch *sprite_batch);
+
+/*
+  @brief Sorts sprite order of a static sprite batch by depth.
+  @details Opaque batches are sorted front-to-back, translucent ones back-to-front.
+           Chunked batches are sorted within every chunk.
+  @param sprite_batch Sprite batch to sort.
+  @param sprite_order Indices of sprites in the host copy, sorted in place.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__sort_sprite_batch (MossSpriteBatch *sprite_batch, uint32_t *sprite_order);
+
+/*
+  @brief Queues copy of the whole sprite data from staging to device-local buffer.
+  @details Copy is recorded ahead of the draws of the next submitted frame.
+  @param sprite_batch Static sprite batch with sprite data in staging memory.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__record_sprite_batch_upload (MossSpriteBatch *sprite_batch);
+
+/*
+  @brief Writes snapshot of a sprite batch to an open file.
+  @param sprite_batch Ended static sprite batch.
+  @param file File opened for writing.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__write_sprite_batch_snapshot (const MossSpriteBatch *sprite_batch, FILE *file);
+
+/*
+  @brief Replaces content of a sprite batch with a mapped snapshot.
+  @param sprite_batch Static sprite batch that isn't begun.
+  @param snapshot Mapped snapshot file, must be valid.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__read_sprite_batch_snapshot (
+  MossSpriteBatch        *sprite_batch,
+  const Moss__MappedFile *snapshot
+);
+
+/*
+  @brief Checks whether snapshot sprites only use indices of the bindless array.
+  @param sprite_batch Sprite batch the snapshot is loaded to.
+  @param vertex_data Snapshot sprite data laid out as the batch expects.
+  @param sprite_count Number of sprites in the snapshot.
+  @return Returns true if every texture index is in the bindless array or bindless
+          textures are disabled, false otherwise.
+*/
+inline static bool moss__are_snapshot_texture_indices_valid (
+  const MossSpriteBatch *sprite_batch,
+  const void            *vertex_data,
+  uint32_t               sprite_count
+);
+
+/*
+  @brief Checks whether sprite batch can be drawn with the recorder.
+  @param recorder Command recorder, must be begun.
+  @param sprite_batch Sprite batch to draw.
+  @return Returns MOSS_RESULT_SUCCESS if the batch is ended and belongs to the engine
+          of the recorder, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__check_sprite_batch_draw (
+  const MossCommandRecorder *recorder,
+  const MossSpriteBatch     *sprite_batch
+);
+
+/*
+  @brief Returns texture sprite batch is drawn with.
+  @param engine Engine handle.
+  @param sprite_batch Sprite batch.
+  @return Texture of the batch, or the default texture if the batch has none.
+*/
+inline static const MossTexture *moss__get_sprite_batch_draw_texture (
+  const MossEngine      *engine,
+  const MossSpriteBatch *sprite_batch
+);
+
+/*
+  @brief Returns graphics pipeline sprite batch is drawn with.
+  @param engine Engine handle.
+  @param sprite_batch Sprite batch.
+  @return Pipeline of the batch material and mode.
+*/
+inline static VkPipeline moss__get_sprite_batch_pipeline (
+  const MossEngine      *engine,
+  const MossSpriteBatch *sprite_batch
+);
+
+/*
+  @brief Records draw of a sprite batch.
+  @details Binds only the state that differs from the state bound by previous draws
+           of the recorder. Culling is recorded on the first draw in a frame.
+  @param recorder Command recorder, must be begun.
+  @param sprite_batch Sprite batch to draw, must have sprites.
+  @param texture_descriptor_set Texture set to draw the batch with.
   @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
 */
-inline static MossResult moss__create_combined_buffer (
-  const Moss__CreateCombinedBufferInfo *info,
-  VkBuffer                             *out_buffer,
-  VkDeviceMemory                       *out_buffer_memory
+inline static MossResult moss__record_sprite_batch_draw (
+  MossCommandRecorder *recorder,
+  MossSpriteBatch     *sprite_batch,
+  VkDescriptorSet      texture_descriptor_set
+);
+
+/*
+  @brief Records draw of a sprite range of the batch.
+  @param recorder Command recorder the batch pipeline and buffers are bound to.
+  @param sprite_batch Sprite batch.
+  @param first_sprite Index of the first sprite to draw.
+  @param sprite_count Number of sprites to draw.
+*/
+inline static void moss__draw_sprite_batch_range (
+  MossCommandRecorder   *recorder,
+  const MossSpriteBatch *sprite_batch,
+  uint32_t               first_sprite,
+  uint32_t               sprite_count
+);
+
+/*
+  @brief Generates instance from sprite.
+  @param sprite Sprite to generate instance data from.
+  @param out_instance Output instance.
+  @note UV coordinates are clamped to [0, 1] range.
+*/
+inline static void moss__generate_instance_from_sprite (
+  const MossSprite     *sprite,
+  Moss__SpriteInstance *out_instance
 );
 
 /*
-  @brief Generates verticies from sprite.
+  @brief Generates compact verticies from sprite.
+  @param sprite_batch Compact sprite batch positions are normalized to bounds of.
   @param sprite Sprite to generate vertex data from.
   @param out_vertices Output verticies.
-  @return Always returns a pack of verticies.
+  @note Positions are clamped to batch bounds, UV coordinates and depth to [0, 1].
+*/
+inline static void moss__generate_compact_verticies_from_sprite (
+  const MossSpriteBatch *sprite_batch,
+  const MossSprite      *sprite,
+  Moss__CompactVertex    out_vertices[ 4 ]
+);
+
+/*
+  @brief Packs value in [-1, 1] range into 16-bit signed normalized integer.
+  @param value Value to pack.
+  @return Packed value.
+*/
+inline static int16_t moss__pack_snorm16 (float value);
+
+/*
+  @brief Waits until submitted frames stop copying from staging buffer of the batch.
+  @details Copy that is not submitted yet picks up new data, so there is nothing to
+           wait for in that case.
+  @param sprite_batch Static sprite batch.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__wait_staging_buffer_reads (MossSpriteBatch *sprite_batch);
+
+/*
+  @brief Generates vertices or instances of sprites into the batch memory.
+  @param sprite_batch Sprite batch, memory must be mapped.
+  @param first_sprite Index of the first slot to write to.
+  @param sprites Sprites to write.
+  @param sprite_count Number of sprites to write.
 */
-inline static void moss__generate_verticies_from_sprite (
-  const MossSprite *sprite,
-  Moss__Vertex      out_vertices[ 4 ]
+inline static void moss__write_sprites (
+  MossSpriteBatch  *sprite_batch,
+  uint32_t          first_sprite,
+  const MossSprite *sprites,
+  size_t            sprite_count
 );
 
+/*
+  @brief Drops dirty ranges of the batch and unlinks it from engine updated batches.
+  @param sprite_batch Sprite batch.
+*/
+inline static void moss__discard_sprite_batch_updates (MossSpriteBatch *sprite_batch);
+
 
 /*=============================================================================
     PUBLIC FUNCTIONS IMPLEMENTATION
@@ -107,114 +375,154 @@ inline static void moss__generate_verticies_from_sprite (
 
 MossSpriteBatch *moss_create_sprite_batch (const MossSpriteBatchCreateInfo *const info)
 {
-  MossSpriteBatch *const sprite_batch = malloc (sizeof (MossSpriteBatch));
+  MossSpriteBatch *const sprite_batch = moss__allocate (
+    &info->engine->host_allocator,
+    sizeof (MossSpriteBatch),
+    MOSS_ALLOCATION_CATEGORY_SPRITE_BATCH
+  );
   if (sprite_batch == NULL)
   {
     moss__error ("Failed to allocate memory for a sprite batch.\n");
     return NULL;
   }
 
-  // Calculate buffer sizes
-  const size_t vertex_data_size =
-    info->capacity * sizeof (Moss__Vertex) * MOSS__VERTICIES_PER_SPRITE;
-  const size_t index_data_size =
-    info->capacity * sizeof (uint16_t) * MOSS__INDICES_PER_SPRITE;
-  const size_t total_buffer_size = vertex_data_size + index_data_size;
-
-  // Vertices come first, then indices
-  const size_t vertex_data_offset = 0;
-  const size_t index_data_offset  = vertex_data_size;
-
-  {  // Create combined buffer
-    const Moss__CreateCombinedBufferInfo buffer_info = {
-      .engine = info->engine,
-      .size   = total_buffer_size,
-    };
-    const MossResult result = moss__create_combined_buffer (
-      &buffer_info,
-      &sprite_batch->buffer,
-      &sprite_batch->buffer_memory
-    );
+  // Sprite slots are reserved with 32-bit atomics
+  if (info->capacity > UINT32_MAX)
+  {
+    moss__error ("Sprite batch capacity is too large.\n");
+    moss__free (&info->engine->host_allocator, sprite_batch);
+    return NULL;
+  }
 
-    if (result != MOSS_RESULT_SUCCESS)
-    {
-      moss__error ("Failed to create combined buffer for sprite batch.\n");
-      free (sprite_batch);
-      return NULL;
-    }
+  // Chunks are built from a host copy of the fill and culled against a single view
+  if (info->chunk_size > 0.0F &&
+      (info->usage != MOSS_SPRITE_BATCH_USAGE_STATIC || info->enable_culling))
+  {
+    moss__error ("Only static sprite batches without GPU culling can be chunked.\n");
+    moss__free (&info->engine->host_allocator, sprite_batch);
+    return NULL;
   }
 
-  {  // Create staging buffer
-    const Moss__CreateVkBufferInfo create_info = {
-      .physical_device = info->engine->physical_device,
-      .device          = info->engine->device,
-      .size            = (VkDeviceSize)total_buffer_size,
-      .usage           = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-      .memory_properties =
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-      .sharing_mode                    = info->engine->buffer_sharing_mode,
-      .shared_queue_family_index_count = info->engine->shared_queue_family_index_count,
-      .shared_queue_family_indices     = info->engine->shared_queue_family_indices,
-    };
+  // Culled sprites are drawn in arbitrary order, chunks are drawn in grid order
+  if (info->material == MOSS_SPRITE_BATCH_MATERIAL_TRANSLUCENT &&
+      (info->enable_culling || info->chunk_size > 0.0F))
+  {
+    moss__error ("Translucent sprite batches can't be culled or chunked.\n");
+    moss__free (&info->engine->host_allocator, sprite_batch);
+    return NULL;
+  }
 
-    const MossResult result = moss_vk__create_buffer (
-      &create_info,
-      &sprite_batch->staging_buffer,
-      &sprite_batch->staging_memory
-    );
+  // Culling and chunking read world positions of full vertices and instances
+  const bool is_compact = info->mode == MOSS_SPRITE_BATCH_MODE_COMPACT;
+  if (is_compact && (info->enable_culling || info->chunk_size > 0.0F))
+  {
+    moss__error ("Compact sprite batches can't be culled or chunked.\n");
+    moss__free (&info->engine->host_allocator, sprite_batch);
+    return NULL;
+  }
+
+  if (is_compact && (info->bounds_size[ 0 ] <= 0.0F || info->bounds_size[ 1 ] <= 0.0F))
+  {
+    moss__error ("Compact sprite batch bounds size must be positive.\n");
+    moss__free (&info->engine->host_allocator, sprite_batch);
+    return NULL;
+  }
+
+  // Indexed batches share the engine quad index buffer, so only vertex data is stored
+  const bool   is_instanced     = info->mode == MOSS_SPRITE_BATCH_MODE_INSTANCED;
+  const size_t sprite_data_size =
+    is_instanced ? sizeof (Moss__SpriteInstance)
+    : is_compact ? sizeof (Moss__CompactVertex) * MOSS__VERTICIES_PER_SPRITE
+                 : sizeof (Moss__Vertex) * MOSS__VERTICIES_PER_SPRITE;
+  const size_t total_buffer_size = info->capacity * sprite_data_size;
+
+  if (!is_instanced &&
+      moss__reserve_quad_indices (info->engine, info->capacity) != MOSS_RESULT_SUCCESS)
+  {
+    moss__error ("Failed to reserve quad indices for sprite batch.\n");
+    moss__free (&info->engine->host_allocator, sprite_batch);
+    return NULL;
+  }
+
+  {  // Create buffers
+    // Culling compute shader reads sprites straight from the vertex buffer
+    const Moss__CreateVertexBufferInfo buffer_info = {
+      .engine      = info->engine,
+      .size        = total_buffer_size,
+      .extra_usage = info->enable_culling ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT : 0,
+    };
+    const MossResult result = info->usage == MOSS_SPRITE_BATCH_USAGE_STREAM
+                              ? moss__create_stream_buffer (&buffer_info, sprite_batch)
+                              : moss__create_static_buffers (&buffer_info, sprite_batch);
     if (result != MOSS_RESULT_SUCCESS)
     {
-      moss__error ("Failed to create staging buffer.\n");
-      moss_vk__destroy_buffer (
-        info->engine->device,
-        sprite_batch->buffer,
-        sprite_batch->buffer_memory
-      );
-      free (sprite_batch);
+      moss__error ("Failed to create buffers for sprite batch.\n");
+      moss__free (&info->engine->host_allocator, sprite_batch);
       return NULL;
     }
   }
 
-  {  // Map staging buffer memory
-    const VkResult result = vkMapMemory (
-      info->engine->device,
-      sprite_batch->staging_memory,
-      0,
-      (VkDeviceSize)total_buffer_size,
-      0,
-      &sprite_batch->mapped_memory
+  // Save original engine
+  sprite_batch->original_engine = info->engine;
+  sprite_batch->mode            = info->mode;
+  sprite_batch->usage           = info->usage;
+  sprite_batch->material        = info->material;
+  sprite_batch->texture         = info->texture;
+  sprite_batch->bounds_position[ 0 ] = info->bounds_position[ 0 ];
+  sprite_batch->bounds_position[ 1 ] = info->bounds_position[ 1 ];
+  sprite_batch->bounds_size[ 0 ]     = info->bounds_size[ 0 ];
+  sprite_batch->bounds_size[ 1 ]     = info->bounds_size[ 1 ];
+
+  // Set default field values
+  sprite_batch->buffer_capacity         = total_buffer_size;
+  sprite_batch->vertex_data_offset      = 0;
+  sprite_batch->vertex_capacity         = total_buffer_size;
+  sprite_batch->sprite_data_size        = sprite_data_size;
+  sprite_batch->sprite_capacity         = (uint32_t)info->capacity;
+  sprite_batch->sprite_count            = 0;
+  sprite_batch->staging_frame_count     = 0;
+  sprite_batch->is_begun                = false;
+  sprite_batch->is_culled               = info->enable_culling;
+  sprite_batch->culled_buffer           = VK_NULL_HANDLE;
+  sprite_batch->culled_allocation       = (Moss__VkAllocation) { 0 };
+  sprite_batch->draw_command_buffer     = VK_NULL_HANDLE;
+  sprite_batch->draw_command_allocation = (Moss__VkAllocation) { 0 };
+  sprite_batch->cull_descriptor_set     = VK_NULL_HANDLE;
+  sprite_batch->culled_frame_count      = UINT64_MAX;
+  glm_vec2_zero (sprite_batch->culled_camera_scale);
+  glm_vec2_zero (sprite_batch->culled_camera_offset);
+  sprite_batch->chunk_size              = info->chunk_size;
+  sprite_batch->chunks                  = NULL;
+  sprite_batch->chunk_count             = 0;
+  sprite_batch->dirty_ranges            = NULL;
+  sprite_batch->dirty_range_count       = 0;
+  sprite_batch->next_updated_batch      = NULL;
+  sprite_batch->host_sprite_data        = NULL;
+
+  // Chunking, sorting and updates read sprites back, staging memory is write-combined
+  // and slow to read. Staging frames copy from is then written only by the end
+  if (info->usage == MOSS_SPRITE_BATCH_USAGE_STATIC)
+  {
+    sprite_batch->host_sprite_data = moss__allocate (
+      &info->engine->host_allocator,
+      total_buffer_size,
+      MOSS_ALLOCATION_CATEGORY_SPRITE_BATCH
     );
-    if (result != VK_SUCCESS)
+    if (sprite_batch->host_sprite_data == NULL)
     {
-      moss__error ("Failed to map staging buffer memory: %d.\n", result);
-      moss_vk__destroy_buffer (
-        info->engine->device,
-        sprite_batch->staging_buffer,
-        sprite_batch->staging_memory
-      );
-      moss_vk__destroy_buffer (
-        info->engine->device,
-        sprite_batch->buffer,
-        sprite_batch->buffer_memory
-      );
-      free (sprite_batch);
+      moss__error ("Failed to allocate memory for sprite batch host copy.\n");
+      moss_destroy_sprite_batch (sprite_batch);
       return NULL;
     }
   }
 
-  // Save original engine
-  sprite_batch->original_engine = info->engine;
-
-  // Set default field values
-  sprite_batch->buffer_capacity    = total_buffer_size;
-  sprite_batch->vertex_data_offset = vertex_data_offset;
-  sprite_batch->index_data_offset  = index_data_offset;
-  sprite_batch->vertex_data_size   = 0;
-  sprite_batch->index_data_size    = 0;
-  sprite_batch->vertex_capacity    = vertex_data_size;
-  sprite_batch->index_capacity     = index_data_size;
-  sprite_batch->index_count        = 0;
-  sprite_batch->is_begun           = false;
+  if (sprite_batch->is_culled &&
+      moss__create_cull_resources (sprite_batch) != MOSS_RESULT_SUCCESS)
+  {
+    moss__error ("Failed to create culling resources for sprite batch.\n");
+    moss_destroy_sprite_batch (sprite_batch);
+    return NULL;
+  }
 
   return sprite_batch;
 }
@@ -226,33 +534,47 @@ void moss_destroy_sprite_batch (MossSpriteBatch *const sprite_batch)
 
   MossEngine *const engine = sprite_batch->original_engine;
 
+  // Copies waiting for the next frame would write the destroyed buffer
+  moss__discard_frame_upload_copies (&engine->frame_upload_queue, sprite_batch->buffer);
+
   // Wait until device finishes all his work
   vkDeviceWaitIdle (engine->device);
 
-  // Unmap and cleanup staging buffer
-  vkUnmapMemory (engine->device, sprite_batch->staging_memory);
+  moss__destroy_cull_resources (sprite_batch);
+
+  moss__discard_sprite_batch_updates (sprite_batch);
+  moss__free (&engine->host_allocator, sprite_batch->dirty_ranges);
+
+  moss__free (&engine->host_allocator, sprite_batch->chunks);
+  moss__free (&engine->host_allocator, sprite_batch->host_sprite_data);
+
+  // Cleanup staging buffer, stream batches don't have one
   moss_vk__destroy_buffer (
-    engine->device,
+    &engine->allocator,
     sprite_batch->staging_buffer,
-    sprite_batch->staging_memory
+    &sprite_batch->staging_allocation
   );
 
-  // Cleanup device-local buffer
+  // Cleanup vertex buffer
   moss_vk__destroy_buffer (
-    engine->device,
+    &engine->allocator,
     sprite_batch->buffer,
-    sprite_batch->buffer_memory
+    &sprite_batch->buffer_allocation
   );
 
-  free (sprite_batch);
+  moss__free (&engine->host_allocator, sprite_batch);
 }
 
 void moss_clear_sprite_batch (MossSpriteBatch *sprite_batch)
 {
-  sprite_batch->vertex_data_size = 0;
-  sprite_batch->index_data_size  = 0;
-  sprite_batch->index_count      = 0;
-  sprite_batch->is_begun         = false;
+  sprite_batch->sprite_count = 0;
+  sprite_batch->is_begun     = false;
+
+  moss__free (&sprite_batch->original_engine->host_allocator, sprite_batch->chunks);
+  sprite_batch->chunks      = NULL;
+  sprite_batch->chunk_count = 0;
+
+  moss__discard_sprite_batch_updates (sprite_batch);
 }
 
 MossResult moss_begin_sprite_batch (MossSpriteBatch *sprite_batch)
@@ -269,10 +591,29 @@ MossResult moss_begin_sprite_batch (MossSpriteBatch *sprite_batch)
     return MOSS_RESULT_ERROR;
   }
 
-  sprite_batch->is_begun         = true;
-  sprite_batch->vertex_data_size = 0;
-  sprite_batch->index_data_size  = 0;
-  sprite_batch->index_count      = 0;
+  if (sprite_batch->usage == MOSS_SPRITE_BATCH_USAGE_STREAM)
+  {
+    MossEngine *const engine = sprite_batch->original_engine;
+
+    // Region of the current frame slot is read by the frame that used this slot
+    // last time, moss_begin_frame has already waited for it if the frame is begun
+    if (!engine->is_frame_begun)
+    {
+      vkWaitForFences (
+        engine->device,
+        1,
+        &engine->in_flight_fences[ engine->current_frame ],
+        VK_TRUE,
+        UINT64_MAX
+      );
+    }
+
+    sprite_batch->vertex_data_offset =
+      engine->current_frame * sprite_batch->vertex_capacity;
+  }
+
+  sprite_batch->is_begun     = true;
+  sprite_batch->sprite_count = 0;
 
   return MOSS_RESULT_SUCCESS;
 }
@@ -281,6 +622,60 @@ MossResult moss_add_sprites_to_sprite_batch (
   MossSpriteBatch *const                       sprite_batch,
   const MossAddSpritesToSpriteBatchInfo *const info
 )
+{
+  MossSpriteBatchRange range;
+  if (moss_reserve_sprite_batch_range (sprite_batch, info->sprite_count, &range) !=
+      MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  const MossWriteSpritesToSpriteBatchInfo write_info = {
+    .first_sprite = range.first_sprite,
+    .sprites      = info->sprites,
+    .sprite_count = info->sprite_count,
+  };
+  return moss_write_sprites_to_sprite_batch (sprite_batch, &write_info);
+}
+
+MossResult moss_reserve_sprite_batch_range (
+  MossSpriteBatch *const      sprite_batch,
+  const size_t                sprite_count,
+  MossSpriteBatchRange *const out_range
+)
+{
+  if (!sprite_batch->is_begun)
+  {
+    moss__error ("Sprite batch not begun. Call moss_begin_sprite_batch first.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Compare-exchange instead of fetch-add, so failed reservation doesn't bump the
+  // counter past the capacity
+  uint32_t first_sprite = moss__atomic_load_u32 (&sprite_batch->sprite_count);
+  do
+  {
+    if (sprite_count > (size_t)(sprite_batch->sprite_capacity - first_sprite))
+    {
+      moss__error ("Sprite batch capacity exceeded.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  } while (!moss__atomic_compare_exchange_u32 (
+    &sprite_batch->sprite_count,
+    &first_sprite,
+    first_sprite + (uint32_t)sprite_count
+  ));
+
+  out_range->first_sprite = first_sprite;
+  out_range->sprite_count = (uint32_t)sprite_count;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+MossResult moss_write_sprites_to_sprite_batch (
+  MossSpriteBatch *const                         sprite_batch,
+  const MossWriteSpritesToSpriteBatchInfo *const info
+)
 {
   if (!sprite_batch->is_begun)
   {
@@ -294,183 +689,899 @@ MossResult moss_add_sprites_to_sprite_batch (
     return MOSS_RESULT_ERROR;
   }
 
-  Moss__Vertex *vertices =
-    (Moss__Vertex *)((char *)sprite_batch->mapped_memory +
-                     sprite_batch->vertex_data_offset + sprite_batch->vertex_data_size);
-  uint16_t *indices =
-    (uint16_t *)((char *)sprite_batch->mapped_memory + sprite_batch->index_data_offset +
-                 sprite_batch->index_data_size);
-  uint16_t base_vertex =
-    (uint16_t)((sprite_batch->vertex_data_size) / sizeof (Moss__Vertex));
-
-  // Generate vertices and indices for each sprite
-  for (size_t i = 0; i < info->sprite_count; ++i)
+  const uint32_t reserved_sprite_count =
+    moss__atomic_load_u32 (&sprite_batch->sprite_count);
+  if (info->first_sprite > reserved_sprite_count ||
+      info->sprite_count > (size_t)(reserved_sprite_count - info->first_sprite))
   {
-    moss__generate_verticies_from_sprite (&info->sprites[ i ], vertices);
-
-    // Create indices: two triangles (0,1,2) and (2,3,0)
-    indices[ 0 ] = base_vertex + 0;
-    indices[ 1 ] = base_vertex + 1;
-    indices[ 2 ] = base_vertex + 2;
-    indices[ 3 ] = base_vertex + 2;
-    indices[ 4 ] = base_vertex + 3;
-    indices[ 5 ] = base_vertex + 0;
-
-    vertices += MOSS__VERTICIES_PER_SPRITE;
-    indices += MOSS__INDICES_PER_SPRITE;
-    base_vertex += MOSS__VERTICIES_PER_SPRITE;
-    sprite_batch->vertex_data_size += sizeof (Moss__Vertex) * MOSS__VERTICIES_PER_SPRITE;
-    sprite_batch->index_data_size += sizeof (uint16_t) * MOSS__INDICES_PER_SPRITE;
-    sprite_batch->index_count += MOSS__INDICES_PER_SPRITE;
+    moss__error ("Sprites are written outside of reserved range.\n");
+    return MOSS_RESULT_ERROR;
   }
 
+  moss__write_sprites (
+    sprite_batch,
+    info->first_sprite,
+    info->sprites,
+    info->sprite_count
+  );
+
   return MOSS_RESULT_SUCCESS;
 }
 
-MossResult moss_end_sprite_batch (MossSpriteBatch *sprite_batch)
+MossResult moss_update_sprites_in_sprite_batch (
+  MossSpriteBatch *const                         sprite_batch,
+  const MossWriteSpritesToSpriteBatchInfo *const info
+)
 {
-  if (!sprite_batch->is_begun)
+  if (sprite_batch->is_begun)
   {
-    moss__error ("Sprite batch not begun. Call moss_begin_sprite_batch first.\n");
+    moss__error ("Sprite batch is begun. Call moss_end_sprite_batch first.\n");
     return MOSS_RESULT_ERROR;
   }
 
-  MossEngine *const engine = sprite_batch->original_engine;
-
-  // Copy from staging buffer to device-local buffer with offsets
-  VkCommandBuffer command_buffer;
+  if (sprite_batch->usage != MOSS_SPRITE_BATCH_USAGE_STATIC)
   {
-    const Moss__BeginOneTimeVkCommandBufferInfo begin_info = {
-      .device       = engine->device,
-      .command_pool = engine->transfer_command_pool,
-    };
-    command_buffer = moss_vk__begin_one_time_command_buffer (&begin_info);
-    if (command_buffer == VK_NULL_HANDLE)
-    {
-      moss__error ("Failed to begin one time command buffer for sprite batch copy.\n");
-      return MOSS_RESULT_ERROR;
-    }
+    moss__error ("Only static sprite batches can be updated.\n");
+    return MOSS_RESULT_ERROR;
   }
 
-  // Copy vertex data
-  if (sprite_batch->vertex_data_size > 0)
+  // Sorting and chunking reorder sprites, slots no longer match the fill order
+  if (sprite_batch->material != MOSS_SPRITE_BATCH_MATERIAL_ALPHA_TEST ||
+      sprite_batch->chunk_size > 0.0F)
   {
-    const VkBufferCopy vertex_copy_region = {
-      .srcOffset = sprite_batch->vertex_data_offset,
-      .dstOffset = sprite_batch->vertex_data_offset,
-      .size      = (VkDeviceSize)sprite_batch->vertex_data_size,
-    };
-    vkCmdCopyBuffer (
-      command_buffer,
-      sprite_batch->staging_buffer,
-      sprite_batch->buffer,
-      1,
-      &vertex_copy_region
-    );
+    moss__error ("Sprites of sorted or chunked batches can't be updated.\n");
+    return MOSS_RESULT_ERROR;
   }
 
-  // Copy index data
-  if (sprite_batch->index_data_size > 0)
+  if (info->first_sprite > sprite_batch->sprite_count ||
+      info->sprite_count > (size_t)(sprite_batch->sprite_count - info->first_sprite))
   {
-    const VkBufferCopy index_copy_region = {
-      .srcOffset = sprite_batch->index_data_offset,
-      .dstOffset = sprite_batch->index_data_offset,
-      .size      = (VkDeviceSize)sprite_batch->index_data_size,
-    };
-    vkCmdCopyBuffer (
-      command_buffer,
-      sprite_batch->staging_buffer,
-      sprite_batch->buffer,
-      1,
-      &index_copy_region
-    );
+    moss__error ("Updated sprites are outside of the sprite batch.\n");
+    return MOSS_RESULT_ERROR;
   }
 
+  if (info->sprite_count == 0) { return MOSS_RESULT_SUCCESS; }
+
+  if (sprite_batch->dirty_ranges == NULL)
   {
-    const Moss__EndOneTimeVkCommandBufferInfo end_info = {
-      .device         = engine->device,
-      .command_pool   = engine->transfer_command_pool,
-      .command_buffer = command_buffer,
-      .queue          = engine->transfer_queue,
-    };
-    const MossResult result = moss_vk__end_one_time_command_buffer (&end_info);
-    if (result != MOSS_RESULT_SUCCESS)
+    // One extra range holds the new one before the closest ranges are merged
+    sprite_batch->dirty_ranges = moss__allocate (
+      &sprite_batch->original_engine->host_allocator,
+      (MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT + 1) * sizeof (MossSpriteBatchRange),
+      MOSS_ALLOCATION_CATEGORY_SPRITE_BATCH
+    );
+    if (sprite_batch->dirty_ranges == NULL)
     {
-      moss__error ("Failed to end one time command buffer for sprite batch copy.\n");
-      return result;
+      moss__error ("Failed to allocate memory for sprite batch dirty ranges.\n");
+      return MOSS_RESULT_ERROR;
     }
   }
 
-  sprite_batch->is_begun = false;
+  // Only the host copy is written, frames in flight keep reading the old sprites
+  moss__write_sprites (
+    sprite_batch,
+    info->first_sprite,
+    info->sprites,
+    info->sprite_count
+  );
+
+  if (sprite_batch->dirty_range_count == 0)
+  {
+    MossEngine *const engine         = sprite_batch->original_engine;
+    sprite_batch->next_updated_batch = engine->updated_sprite_batches;
+    engine->updated_sprite_batches   = sprite_batch;
+  }
+
+  moss__merge_sprite_dirty_range (
+    sprite_batch->dirty_ranges,
+    &sprite_batch->dirty_range_count,
+    info->first_sprite,
+    (uint32_t)info->sprite_count
+  );
 
   return MOSS_RESULT_SUCCESS;
 }
 
-MossResult
-moss_draw_sprite_batch (MossEngine *const engine, MossSpriteBatch *const sprite_batch)
+MossResult moss_end_sprite_batch (MossSpriteBatch *sprite_batch)
 {
-  if (sprite_batch == NULL || engine == NULL)
+  if (!sprite_batch->is_begun)
   {
-    moss__error ("Invalid parameters to moss_draw_sprite_batch.\n");
+    moss__error ("Sprite batch not begun. Call moss_begin_sprite_batch first.\n");
     return MOSS_RESULT_ERROR;
   }
 
-  if (sprite_batch->index_count == 0) { return MOSS_RESULT_SUCCESS; }
+  // Stream batches are written in place, nothing to copy
+  if (sprite_batch->usage == MOSS_SPRITE_BATCH_USAGE_STREAM)
+  {
+    sprite_batch->original_engine->upload_queue.recorded_bytes +=
+      (uint64_t)sprite_batch->sprite_count * sprite_batch->sprite_data_size;
+    sprite_batch->is_begun = false;
+    return MOSS_RESULT_SUCCESS;
+  }
 
-  if (sprite_batch->is_begun)
+  // Whole batch is copied below, pending updates are part of it
+  moss__discard_sprite_batch_updates (sprite_batch);
+
+  if (moss__reorder_sprite_batch (sprite_batch) != MOSS_RESULT_SUCCESS)
   {
-    moss__error ("Sprite batch not ended. Call moss_end_sprite_batch first.\n");
+    moss__error ("Failed to write sprite batch to staging memory.\n");
     return MOSS_RESULT_ERROR;
   }
 
-  if (sprite_batch->original_engine != engine)
+  if (moss__record_sprite_batch_upload (sprite_batch) != MOSS_RESULT_SUCCESS)
   {
-    moss__error ("Sprite batch created with different engine.\n");
     return MOSS_RESULT_ERROR;
   }
 
-  // Get the command buffer that's currently being recorded
-  // This assumes the command buffer is already in recording state
-  const VkCommandBuffer command_buffer =
-    engine->general_command_buffers[ engine->current_frame ];
-
-  // Bind vertex buffer with offset
-  const VkBuffer     vertex_buffers[]        = { sprite_batch->buffer };
-  const VkDeviceSize vertex_buffer_offsets[] = {
-    (VkDeviceSize)sprite_batch->vertex_data_offset
-  };
-  vkCmdBindVertexBuffers (command_buffer, 0, 1, vertex_buffers, vertex_buffer_offsets);
-
-  // Bind index buffer with offset
-  vkCmdBindIndexBuffer (
-    command_buffer,
-    sprite_batch->buffer,
-    (VkDeviceSize)sprite_batch->index_data_offset,
-    VK_INDEX_TYPE_UINT16
-  );
-
-  // Draw indexed
-  vkCmdDrawIndexed (command_buffer, sprite_batch->index_count, 1, 0, 0, 0);
+  sprite_batch->is_begun = false;
 
   return MOSS_RESULT_SUCCESS;
 }
 
-/*=============================================================================
-    PRIVATE FUNCTIONS IMPLEMENTATION
+MossResult moss_save_sprite_batch_snapshot (
+  const MossSpriteBatch *const sprite_batch,
+  const char *const            file_path
+)
+{
+  if (sprite_batch == NULL || file_path == NULL)
+  {
+    moss__error ("Invalid parameters to moss_save_sprite_batch_snapshot.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (sprite_batch->usage != MOSS_SPRITE_BATCH_USAGE_STATIC || sprite_batch->is_begun)
+  {
+    moss__error ("Only ended static sprite batches can be saved.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  Moss__HostAllocator *const host_allocator =
+    &sprite_batch->original_engine->host_allocator;
+
+  const size_t path_length = strlen (file_path);
+  char *const  temp_path   = moss__allocate (
+    host_allocator,
+    path_length + sizeof (".tmp"),
+    MOSS_ALLOCATION_CATEGORY_TEMPORARY
+  );
+  if (temp_path == NULL)
+  {
+    moss__error ("Failed to allocate memory for sprite batch snapshot path.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  memcpy (temp_path, file_path, path_length);
+  memcpy (temp_path + path_length, ".tmp", sizeof (".tmp"));
+
+  // Snapshot is renamed over the old one, so a failed save never truncates it
+  FILE *const file = fopen (temp_path, "wb");
+  if (file == NULL)
+  {
+    moss__error ("Failed to open sprite batch snapshot file: %s\n", temp_path);
+    moss__free (host_allocator, temp_path);
+    return MOSS_RESULT_ERROR;
+  }
+
+  const MossResult write_result = moss__write_sprite_batch_snapshot (sprite_batch, file);
+  const int        close_result = fclose (file);
+
+  if (write_result != MOSS_RESULT_SUCCESS || close_result != 0 ||
+      rename (temp_path, file_path) != 0)
+  {
+    moss__error ("Failed to write sprite batch snapshot file: %s\n", file_path);
+    remove (temp_path);
+    moss__free (host_allocator, temp_path);
+    return MOSS_RESULT_ERROR;
+  }
+
+  moss__free (host_allocator, temp_path);
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+MossResult moss_load_sprite_batch_snapshot (
+  MossSpriteBatch *const sprite_batch,
+  const char *const      file_path
+)
+{
+  if (sprite_batch == NULL || file_path == NULL)
+  {
+    moss__error ("Invalid parameters to moss_load_sprite_batch_snapshot.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (sprite_batch->usage != MOSS_SPRITE_BATCH_USAGE_STATIC || sprite_batch->is_begun)
+  {
+    moss__error ("Snapshots can only be loaded to static batches that aren't begun.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  Moss__MappedFile snapshot;
+  if (moss__map_file (file_path, &snapshot) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (!moss__is_sprite_batch_snapshot_valid (&snapshot))
+  {
+    moss__error ("File isn't a compatible sprite batch snapshot: %s\n", file_path);
+    moss__unmap_file (&snapshot);
+    return MOSS_RESULT_ERROR;
+  }
+
+  const MossResult result = moss__read_sprite_batch_snapshot (sprite_batch, &snapshot);
+  moss__unmap_file (&snapshot);
+
+  return result;
+}
+
+void moss_set_sprite_batch_texture (
+  MossSpriteBatch *const sprite_batch,
+  MossTexture *const     texture
+)
+{
+  sprite_batch->texture = texture;
+}
+
+MossResult
+moss_draw_sprite_batch (MossEngine *const engine, MossSpriteBatch *const sprite_batch)
+{
+  if (sprite_batch == NULL || engine == NULL)
+  {
+    moss__error ("Invalid parameters to moss_draw_sprite_batch.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  return moss_record_sprite_batch (&engine->main_recorder, sprite_batch);
+}
+
+MossResult moss_record_sprite_batch (
+  MossCommandRecorder *const recorder,
+  MossSpriteBatch *const     sprite_batch
+)
+{
+  if (sprite_batch == NULL || recorder == NULL)
+  {
+    moss__error ("Invalid parameters to moss_record_sprite_batch.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (!recorder->is_recording)
+  {
+    moss__error ("Command recorder isn't begun.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (sprite_batch->sprite_count == 0) { return MOSS_RESULT_SUCCESS; }
+
+  if (moss__check_sprite_batch_draw (recorder, sprite_batch) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  const MossTexture *const texture =
+    moss__get_sprite_batch_draw_texture (recorder->engine, sprite_batch);
+
+  return moss__record_sprite_batch_draw (
+    recorder,
+    sprite_batch,
+    texture->descriptor_set
+  );
+}
+
+MossResult moss_queue_sprite_batch (
+  MossEngine *const                     engine,
+  const MossQueueSpriteBatchInfo *const info
+)
+{
+  if (engine == NULL || info == NULL)
+  {
+    moss__error ("Invalid parameters to moss_queue_sprite_batch.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  return moss_queue_command_recorder_sprite_batch (&engine->main_recorder, info);
+}
+
+MossResult moss_queue_command_recorder_sprite_batch (
+  MossCommandRecorder *const            recorder,
+  const MossQueueSpriteBatchInfo *const info
+)
+{
+  if (recorder == NULL || info == NULL || info->sprite_batch == NULL)
+  {
+    moss__error ("Invalid parameters to moss_queue_command_recorder_sprite_batch.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (!recorder->is_recording)
+  {
+    moss__error ("Command recorder isn't begun.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  MossSpriteBatch *const sprite_batch = info->sprite_batch;
+
+  if (sprite_batch->sprite_count == 0) { return MOSS_RESULT_SUCCESS; }
+
+  if (moss__check_sprite_batch_draw (recorder, sprite_batch) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  MossEngine *const        engine = recorder->engine;
+  const MossTexture *const texture =
+    moss__get_sprite_batch_draw_texture (engine, sprite_batch);
+
+  // Camera and texture are captured, so the draw looks as if it was recorded now
+  const Moss__QueuedDraw draw = {
+    .sprite_batch           = sprite_batch,
+    .camera                 = *recorder->camera,
+    .pipeline               = moss__get_sprite_batch_pipeline (engine, sprite_batch),
+    .texture_descriptor_set = texture->descriptor_set,
+    .layer                  = info->layer,
+    .material_order         = moss__get_material_draw_order (sprite_batch->material),
+    .depth                  = info->depth,
+    .index                  = 0,
+  };
+
+  return moss__push_queued_draw (&recorder->draw_queue, &draw);
+}
+
+/*=============================================================================
+    INTERNAL FUNCTIONS IMPLEMENTATION
+  =============================================================================*/
+
+MossResult moss__flush_draw_queue (MossCommandRecorder *const recorder)
+{
+  Moss__DrawQueue *const draw_queue = &recorder->draw_queue;
+  if (draw_queue->draw_count == 0) { return MOSS_RESULT_SUCCESS; }
+
+  moss__sort_draw_queue (draw_queue);
+
+  // Every draw is recorded with its own camera copy, the set camera is kept
+  const MossCamera *const camera = recorder->camera;
+
+  MossResult result = MOSS_RESULT_SUCCESS;
+  for (size_t i = 0; i < draw_queue->draw_count; ++i)
+  {
+    const Moss__QueuedDraw *const draw = &draw_queue->draws[ i ];
+
+    recorder->camera = &draw->camera;
+    result           = moss__record_sprite_batch_draw (
+      recorder,
+      draw->sprite_batch,
+      draw->texture_descriptor_set
+    );
+    if (result != MOSS_RESULT_SUCCESS) { break; }
+  }
+
+  recorder->camera       = camera;
+  draw_queue->draw_count = 0;
+
+  return result;
+}
+
+void moss__upload_sprite_batch_updates (MossEngine *const engine)
+{
+  MossSpriteBatch *sprite_batch = engine->updated_sprite_batches;
+  while (sprite_batch != NULL)
+  {
+    const uint32_t range_count = sprite_batch->dirty_range_count;
+
+    VkDeviceSize copy_size = 0;
+    for (uint32_t i = 0; i < range_count; ++i)
+    {
+      copy_size +=
+        (VkDeviceSize)sprite_batch->dirty_ranges[ i ].sprite_count *
+        sprite_batch->sprite_data_size;
+    }
+
+    // Ranges are staged in the frame slot, so frames in flight keep reading the
+    // old sprites until the copies run ahead of this frame's draws
+    VkBuffer     staging_buffer;
+    VkDeviceSize staging_offset;
+    void        *staging_memory;
+    if (moss__allocate_frame_upload (
+          engine,
+          copy_size,
+          &staging_buffer,
+          &staging_offset,
+          &staging_memory
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      // Ranges stay dirty and are retried by the next frame
+      moss__error ("Failed to stage sprite batch updates.\n");
+      return;
+    }
+
+    for (uint32_t i = 0; i < range_count; ++i)
+    {
+      const MossSpriteBatchRange *const range = &sprite_batch->dirty_ranges[ i ];
+
+      const size_t offset = (size_t)range->first_sprite * sprite_batch->sprite_data_size;
+      const size_t size   = (size_t)range->sprite_count * sprite_batch->sprite_data_size;
+
+      memcpy (
+        staging_memory,
+        (const char *)sprite_batch->host_sprite_data + offset,
+        size
+      );
+
+      const Moss__FrameUploadCopy copy = {
+        .source_buffer      = staging_buffer,
+        .destination_buffer = sprite_batch->buffer,
+        .region =
+          {
+            .srcOffset = staging_offset,
+            .dstOffset = (VkDeviceSize)(sprite_batch->vertex_data_offset + offset),
+            .size      = (VkDeviceSize)size,
+          },
+      };
+      if (moss__push_frame_upload_copy (&engine->frame_upload_queue, &copy) !=
+          MOSS_RESULT_SUCCESS)
+      {
+        // Copies pushed so far are repeated by the next frame, that is harmless
+        moss__error ("Failed to queue sprite batch update copy.\n");
+        return;
+      }
+
+      staging_memory  = (char *)staging_memory + size;
+      staging_offset += (VkDeviceSize)size;
+    }
+
+    engine->upload_queue.recorded_bytes += (uint64_t)copy_size;
+
+    MossSpriteBatch *const next_batch = sprite_batch->next_updated_batch;
+    sprite_batch->dirty_range_count   = 0;
+    sprite_batch->next_updated_batch  = NULL;
+    sprite_batch                      = next_batch;
+
+    // Batches already uploaded are unlinked right away, a failure leaves the rest
+    engine->updated_sprite_batches = next_batch;
+  }
+}
+
+/*=============================================================================
+    PRIVATE FUNCTIONS IMPLEMENTATION
   =============================================================================*/
 
-inline static MossResult moss__create_combined_buffer (
-  const Moss__CreateCombinedBufferInfo *const info,
-  VkBuffer                                   *out_buffer,
-  VkDeviceMemory                             *out_buffer_memory
+inline static MossResult moss__check_sprite_batch_draw (
+  const MossCommandRecorder *const recorder,
+  const MossSpriteBatch *const     sprite_batch
+)
+{
+  if (sprite_batch->is_begun)
+  {
+    moss__error ("Sprite batch not ended. Call moss_end_sprite_batch first.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (sprite_batch->original_engine != recorder->engine)
+  {
+    moss__error ("Sprite batch created with different engine.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static const MossTexture *moss__get_sprite_batch_draw_texture (
+  const MossEngine *const      engine,
+  const MossSpriteBatch *const sprite_batch
+)
+{
+  return sprite_batch->texture != NULL ? sprite_batch->texture : engine->default_texture;
+}
+
+inline static VkPipeline moss__get_sprite_batch_pipeline (
+  const MossEngine *const      engine,
+  const MossSpriteBatch *const sprite_batch
+)
+{
+  // Every material has its own pipeline per batch mode
+  switch (sprite_batch->mode)
+  {
+    case MOSS_SPRITE_BATCH_MODE_INSTANCED:
+      return engine->instanced_graphics_pipelines[ sprite_batch->material ];
+    case MOSS_SPRITE_BATCH_MODE_COMPACT:
+      return engine->compact_graphics_pipelines[ sprite_batch->material ];
+    case MOSS_SPRITE_BATCH_MODE_INDEXED: break;
+  }
+
+  return engine->graphics_pipelines[ sprite_batch->material ];
+}
+
+inline static MossResult moss__record_sprite_batch_draw (
+  MossCommandRecorder *const recorder,
+  MossSpriteBatch *const     sprite_batch,
+  const VkDescriptorSet      texture_descriptor_set
+)
+{
+  MossEngine *const engine = recorder->engine;
+
+  const VkCommandBuffer command_buffer = recorder->command_buffer;
+
+  // Bind texture, set stays bound across pipeline switches since layouts match. In
+  // bindless mode every texture refers to the same set holding the texture array
+  moss__bind_texture_descriptor_set (recorder, texture_descriptor_set);
+
+  const VkDeviceSize vertex_buffer_offset =
+    (VkDeviceSize)sprite_batch->vertex_data_offset;
+
+  const bool is_instanced = sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_INSTANCED;
+  const bool is_compact   = sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_COMPACT;
+
+  const VkPipeline pipeline = moss__get_sprite_batch_pipeline (engine, sprite_batch);
+
+  if (is_compact)
+  {
+    // Compact positions span [-1, 1] over the bounds, fold bounds into the camera
+    Moss__CameraPushConstants push_constants =
+      moss__get_camera_push_constants (recorder->camera);
+    for (int i = 0; i < 2; ++i)
+    {
+      const float half_size = sprite_batch->bounds_size[ i ] * 0.5F;
+
+      push_constants.offset[ i ] +=
+        sprite_batch->bounds_position[ i ] * push_constants.scale[ i ];
+      push_constants.scale[ i ] *= half_size;
+    }
+    moss__bind_camera (recorder, &push_constants);
+  }
+  else {
+    moss__bind_camera (recorder, NULL);
+  }
+
+  bool is_culled_for_camera = false;
+  if (sprite_batch->is_culled)
+  {
+    Moss__CameraPushConstants camera = moss__get_camera_push_constants (recorder->camera);
+
+    // Batch content can't change within a frame, so one culling pass is enough. It's
+    // done for the first camera the batch is drawn with, draws through other cameras
+    // go unculled. Other recorders may draw the same batch or record culling at the
+    // same time
+    pthread_mutex_lock (&engine->cull_mutex);
+    MossResult result = MOSS_RESULT_SUCCESS;
+    if (sprite_batch->culled_frame_count != engine->frame_count)
+    {
+      result = moss__record_sprite_batch_culling (sprite_batch, &camera);
+      if (result == MOSS_RESULT_SUCCESS)
+      {
+        sprite_batch->culled_frame_count = engine->frame_count;
+        glm_vec2_copy (camera.scale, sprite_batch->culled_camera_scale);
+        glm_vec2_copy (camera.offset, sprite_batch->culled_camera_offset);
+      }
+    }
+    is_culled_for_camera =
+      glm_vec2_eqv (sprite_batch->culled_camera_scale, camera.scale) &&
+      glm_vec2_eqv (sprite_batch->culled_camera_offset, camera.offset);
+    pthread_mutex_unlock (&engine->cull_mutex);
+
+    if (result != MOSS_RESULT_SUCCESS) { return MOSS_RESULT_ERROR; }
+  }
+
+  if (is_culled_for_camera)
+  {
+    // Visible count stays on the GPU, so submitted sprites are counted
+    ++recorder->draw_call_count;
+    recorder->sprite_count += sprite_batch->sprite_count;
+
+    if (is_instanced)
+    {
+      // Visible instances are compacted into the culled buffer
+      const VkDeviceSize culled_buffer_offset = 0;
+
+      moss__bind_graphics_pipeline (recorder, pipeline);
+      moss__bind_vertex_buffer (
+        recorder,
+        sprite_batch->culled_buffer,
+        culled_buffer_offset
+      );
+      vkCmdDrawIndirect (command_buffer, sprite_batch->draw_command_buffer, 0, 1, 0);
+
+      return MOSS_RESULT_SUCCESS;
+    }
+
+    // Visible indices refer to vertices of the bound batch region
+    moss__bind_graphics_pipeline (recorder, pipeline);
+    moss__bind_vertex_buffer (recorder, sprite_batch->buffer, vertex_buffer_offset);
+    moss__bind_index_buffer (recorder, sprite_batch->culled_buffer, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexedIndirect (command_buffer, sprite_batch->draw_command_buffer, 0, 1, 0);
+
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  moss__bind_graphics_pipeline (recorder, pipeline);
+  moss__bind_vertex_buffer (recorder, sprite_batch->buffer, vertex_buffer_offset);
+
+  if (!is_instanced)
+  {
+    // Shared quad index buffer stays bound across batches of the same index type
+    const VkIndexType index_type =
+      moss__get_quad_index_type (sprite_batch->sprite_capacity);
+    moss__bind_index_buffer (
+      recorder,
+      moss__get_quad_index_buffer (engine, index_type),
+      index_type
+    );
+  }
+
+  if (sprite_batch->chunks == NULL)
+  {
+    moss__draw_sprite_batch_range (recorder, sprite_batch, 0, sprite_batch->sprite_count);
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  vec2 view_min, view_max;
+  moss__get_camera_view_rect (recorder->camera, view_min, view_max);
+
+  // Chunks are contiguous in the buffer, neighbouring visible ones share a draw
+  uint32_t range_first = 0;
+  uint32_t range_count = 0;
+  for (uint32_t i = 0; i < sprite_batch->chunk_count; ++i)
+  {
+    const Moss__SpriteChunk *const chunk = &sprite_batch->chunks[ i ];
+
+    const bool is_visible = chunk->min[ 0 ] <= view_max[ 0 ] &&
+                            chunk->max[ 0 ] >= view_min[ 0 ] &&
+                            chunk->min[ 1 ] <= view_max[ 1 ] &&
+                            chunk->max[ 1 ] >= view_min[ 1 ];
+    if (!is_visible) { continue; }
+
+    if (range_count > 0 && range_first + range_count == chunk->first_sprite)
+    {
+      range_count += chunk->sprite_count;
+      continue;
+    }
+
+    if (range_count > 0)
+    {
+      moss__draw_sprite_batch_range (recorder, sprite_batch, range_first, range_count);
+    }
+    range_first = chunk->first_sprite;
+    range_count = chunk->sprite_count;
+  }
+
+  if (range_count > 0)
+  {
+    moss__draw_sprite_batch_range (recorder, sprite_batch, range_first, range_count);
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+
+inline static MossResult
+moss__wait_staging_buffer_reads (MossSpriteBatch *const sprite_batch)
+{
+  MossEngine *const engine = sprite_batch->original_engine;
+
+  // Frame that is not submitted yet copies new data, so there is nothing to wait for
+  if (sprite_batch->staging_frame_count > engine->frame_count)
+  {
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  // Frame semaphore is signaled with the frame count once the frame completes
+  const VkSemaphoreWaitInfo wait_info = {
+    .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+    .pNext          = NULL,
+    .flags          = 0,
+    .semaphoreCount = 1,
+    .pSemaphores    = &engine->upload_queue.frame_semaphore,
+    .pValues        = &sprite_batch->staging_frame_count,
+  };
+
+  const VkResult result = vkWaitSemaphores (engine->device, &wait_info, UINT64_MAX);
+  if (result != VK_SUCCESS)
+  {
+    moss__error ("Failed to wait for sprite batch copy. Error code: %d.\n", result);
+    return MOSS_RESULT_ERROR;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static void moss__write_sprites (
+  MossSpriteBatch *const  sprite_batch,
+  const uint32_t          first_sprite,
+  const MossSprite *const sprites,
+  const size_t            sprite_count
+)
+{
+  // Static batches are filled into the host copy and written to staging at end
+  void *const data =
+    sprite_batch->host_sprite_data != NULL
+      ? (char *)sprite_batch->host_sprite_data +
+          (size_t)first_sprite * sprite_batch->sprite_data_size
+      : (char *)sprite_batch->mapped_memory + sprite_batch->vertex_data_offset +
+          (size_t)first_sprite * sprite_batch->sprite_data_size;
+
+  if (sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_INSTANCED)
+  {
+    Moss__SpriteInstance *const instances = (Moss__SpriteInstance *)data;
+    for (size_t i = 0; i < sprite_count; ++i)
+    {
+      moss__generate_instance_from_sprite (&sprites[ i ], &instances[ i ]);
+    }
+
+    return;
+  }
+
+  if (sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_COMPACT)
+  {
+    Moss__CompactVertex *const vertices = (Moss__CompactVertex *)data;
+    for (size_t i = 0; i < sprite_count; ++i)
+    {
+      moss__generate_compact_verticies_from_sprite (
+        sprite_batch,
+        &sprites[ i ],
+        &vertices[ i * MOSS__VERTICIES_PER_SPRITE ]
+      );
+    }
+
+    return;
+  }
+
+  // Generate vertices for each sprite, indices come from the shared quad index buffer
+  moss__generate_verticies_from_sprites (sprites, sprite_count, (Moss__Vertex *)data);
+}
+
+inline static void
+moss__discard_sprite_batch_updates (MossSpriteBatch *const sprite_batch)
+{
+  if (sprite_batch->dirty_range_count == 0) { return; }
+
+  MossSpriteBatch **link = &sprite_batch->original_engine->updated_sprite_batches;
+  while (*link != NULL && *link != sprite_batch)
+  {
+    link = &(*link)->next_updated_batch;
+  }
+  if (*link != NULL) { *link = sprite_batch->next_updated_batch; }
+
+  sprite_batch->dirty_range_count  = 0;
+  sprite_batch->next_updated_batch = NULL;
+}
+
+inline static MossResult moss__create_static_buffers (
+  const Moss__CreateVertexBufferInfo *const info,
+  MossSpriteBatch *const                    sprite_batch
+)
+{
+  MossEngine *const engine = info->engine;
+
+  {  // Create vertex buffer
+    const MossResult result = moss__create_vertex_buffer (
+      info,
+      &sprite_batch->buffer,
+      &sprite_batch->buffer_allocation
+    );
+
+    if (result != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create vertex buffer for sprite batch.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Create staging buffer
+    const Moss__CreateVkBufferInfo create_info = {
+      .allocator       = &engine->allocator,
+      .device          = engine->device,
+      .size            = (VkDeviceSize)info->size,
+      .usage           = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      .memory_properties =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      .sharing_mode                    = engine->buffer_sharing_mode,
+      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+    };
+
+    const MossResult result = moss_vk__create_buffer (
+      &create_info,
+      &sprite_batch->staging_buffer,
+      &sprite_batch->staging_allocation
+    );
+    if (result != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create staging buffer.\n");
+      moss_vk__destroy_buffer (
+        &engine->allocator,
+        sprite_batch->buffer,
+        &sprite_batch->buffer_allocation
+      );
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  sprite_batch->mapped_memory = sprite_batch->staging_allocation.mapped_memory;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult moss__create_stream_buffer (
+  const Moss__CreateVertexBufferInfo *const info,
+  MossSpriteBatch *const                    sprite_batch
+)
+{
+  MossEngine *const  engine = info->engine;
+  const VkDeviceSize size = (VkDeviceSize)(info->size * engine->frames_in_flight_count);
+
+  const VkMemoryPropertyFlags host_memory_properties =
+    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  const VkMemoryPropertyFlags device_host_memory_properties =
+    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | host_memory_properties;
+
+  Moss__CreateVkBufferInfo create_info = {
+    .allocator                       = &engine->allocator,
+    .device                          = engine->device,
+    .size                            = size,
+    .usage             = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | info->extra_usage,
+    .memory_properties = host_memory_properties,
+    .sharing_mode                    = engine->buffer_sharing_mode,
+    .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+    .shared_queue_family_indices     = engine->shared_queue_family_indices,
+  };
+
+  // Prefer device-local host-visible memory (ReBAR/UMA) when the device has it
+  uint32_t memory_type_index;
+  const bool has_device_host_memory =
+    moss__select_suitable_memory_type (
+      engine->physical_device,
+      UINT32_MAX,
+      device_host_memory_properties,
+      &memory_type_index
+    ) == MOSS_RESULT_SUCCESS;
+
+  MossResult result = MOSS_RESULT_ERROR;
+  if (has_device_host_memory)
+  {
+    create_info.memory_properties = device_host_memory_properties;
+    result                        = moss_vk__create_buffer (
+      &create_info,
+      &sprite_batch->buffer,
+      &sprite_batch->buffer_allocation
+    );
+  }
+
+  // Device-local host-visible heap may be too small, fall back to host memory
+  if (result != MOSS_RESULT_SUCCESS)
+  {
+    create_info.memory_properties = host_memory_properties;
+    result                        = moss_vk__create_buffer (
+      &create_info,
+      &sprite_batch->buffer,
+      &sprite_batch->buffer_allocation
+    );
+  }
+
+  if (result != MOSS_RESULT_SUCCESS)
+  {
+    moss__error ("Failed to create stream buffer for sprite batch.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  sprite_batch->mapped_memory      = sprite_batch->buffer_allocation.mapped_memory;
+  sprite_batch->staging_buffer     = VK_NULL_HANDLE;
+  sprite_batch->staging_allocation = (Moss__VkAllocation) { 0 };
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult moss__create_vertex_buffer (
+  const Moss__CreateVertexBufferInfo *const info,
+  VkBuffer                                 *out_buffer,
+  Moss__VkAllocation                       *out_buffer_allocation
 )
 {
   const Moss__CreateVkBufferInfo create_info = {
-    .physical_device = info->engine->physical_device,
+    .allocator       = &info->engine->allocator,
     .device          = info->engine->device,
     .size            = (VkDeviceSize)info->size,
     .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
-             VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+             info->extra_usage,
     .memory_properties               = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
     .sharing_mode                    = info->engine->buffer_sharing_mode,
     .shared_queue_family_index_count = info->engine->shared_queue_family_index_count,
@@ -478,42 +1589,737 @@ inline static MossResult moss__create_combined_buffer (
   };
 
   const MossResult result =
-    moss_vk__create_buffer (&create_info, out_buffer, out_buffer_memory);
+    moss_vk__create_buffer (&create_info, out_buffer, out_buffer_allocation);
   if (result != MOSS_RESULT_SUCCESS)
   {
-    moss__error ("Failed to create combined buffer.\n");
+    moss__error ("Failed to create vertex buffer.\n");
   }
 
   return result;
 }
 
-inline static void moss__generate_verticies_from_sprite (
-  const MossSprite *const sprite,
-  Moss__Vertex            out_vertices[ 4 ]
+inline static MossResult moss__create_cull_resources (MossSpriteBatch *const sprite_batch)
+{
+  MossEngine *const engine       = sprite_batch->original_engine;
+  const bool        is_instanced = sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_INSTANCED;
+
+  {  // Create culled buffer
+    const VkDeviceSize size =
+      is_instanced
+        ? (VkDeviceSize)sprite_batch->sprite_capacity * sizeof (Moss__SpriteInstance)
+        : (VkDeviceSize)sprite_batch->sprite_capacity * MOSS__INDICES_PER_SPRITE *
+            sizeof (uint32_t);
+
+    const Moss__CreateVkBufferInfo create_info = {
+      .allocator = &engine->allocator,
+      .device    = engine->device,
+      .size      = size,
+      .usage     = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+               (is_instanced ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+                             : VK_BUFFER_USAGE_INDEX_BUFFER_BIT),
+      .memory_properties               = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+      .sharing_mode                    = VK_SHARING_MODE_EXCLUSIVE,
+      .shared_queue_family_index_count = 0,
+      .shared_queue_family_indices     = NULL,
+    };
+
+    if (moss_vk__create_buffer (
+          &create_info,
+          &sprite_batch->culled_buffer,
+          &sprite_batch->culled_allocation
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create culled sprite buffer.\n");
+      sprite_batch->culled_buffer = VK_NULL_HANDLE;
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Create draw command buffer
+    // Indexed command is the larger one, instanced batches use its first 16 bytes
+    const Moss__CreateVkBufferInfo create_info = {
+      .allocator = &engine->allocator,
+      .device    = engine->device,
+      .size      = sizeof (VkDrawIndexedIndirectCommand),
+      .usage     = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      .memory_properties               = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+      .sharing_mode                    = VK_SHARING_MODE_EXCLUSIVE,
+      .shared_queue_family_index_count = 0,
+      .shared_queue_family_indices     = NULL,
+    };
+
+    if (moss_vk__create_buffer (
+          &create_info,
+          &sprite_batch->draw_command_buffer,
+          &sprite_batch->draw_command_allocation
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create draw command buffer.\n");
+      sprite_batch->draw_command_buffer = VK_NULL_HANDLE;
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Allocate descriptor set
+    const VkDescriptorSetAllocateInfo alloc_info = {
+      .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .descriptorPool     = engine->cull_descriptor_pool,
+      .descriptorSetCount = 1,
+      .pSetLayouts        = &engine->cull_descriptor_set_layout,
+    };
+
+    const VkResult result = vkAllocateDescriptorSets (
+      engine->device,
+      &alloc_info,
+      &sprite_batch->cull_descriptor_set
+    );
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to allocate cull descriptor set: %d.\n", result);
+      sprite_batch->cull_descriptor_set = VK_NULL_HANDLE;
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  // Whole vertex buffer is bound, stream regions are selected with push constants
+  const VkDescriptorBufferInfo buffer_infos[] = {
+    { .buffer = sprite_batch->buffer,              .offset = 0, .range = VK_WHOLE_SIZE },
+    { .buffer = sprite_batch->culled_buffer,       .offset = 0, .range = VK_WHOLE_SIZE },
+    { .buffer = sprite_batch->draw_command_buffer, .offset = 0, .range = VK_WHOLE_SIZE },
+  };
+  const uint32_t buffer_info_count = sizeof (buffer_infos) / sizeof (buffer_infos[ 0 ]);
+
+  const VkWriteDescriptorSet descriptor_write = {
+    .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+    .dstSet          = sprite_batch->cull_descriptor_set,
+    .dstBinding      = 0,
+    .dstArrayElement = 0,
+    .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+    .descriptorCount = buffer_info_count,
+    .pBufferInfo     = buffer_infos,
+  };
+
+  vkUpdateDescriptorSets (engine->device, 1, &descriptor_write, 0, NULL);
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static void moss__destroy_cull_resources (MossSpriteBatch *const sprite_batch)
+{
+  MossEngine *const engine = sprite_batch->original_engine;
+
+  if (sprite_batch->cull_descriptor_set != VK_NULL_HANDLE)
+  {
+    vkFreeDescriptorSets (
+      engine->device,
+      engine->cull_descriptor_pool,
+      1,
+      &sprite_batch->cull_descriptor_set
+    );
+    sprite_batch->cull_descriptor_set = VK_NULL_HANDLE;
+  }
+
+  moss_vk__destroy_buffer (
+    &engine->allocator,
+    sprite_batch->draw_command_buffer,
+    &sprite_batch->draw_command_allocation
+  );
+
+  moss_vk__destroy_buffer (
+    &engine->allocator,
+    sprite_batch->culled_buffer,
+    &sprite_batch->culled_allocation
+  );
+}
+
+inline static MossResult moss__record_sprite_batch_culling (
+  MossSpriteBatch *const                 sprite_batch,
+  const Moss__CameraPushConstants *const camera
+)
+{
+  MossEngine *const     engine         = sprite_batch->original_engine;
+  const VkCommandBuffer command_buffer = moss__get_cull_command_buffer (engine);
+  if (command_buffer == VK_NULL_HANDLE) { return MOSS_RESULT_ERROR; }
+
+  const bool is_instanced = sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_INSTANCED;
+
+  // Shader counts visible sprites up from zero, the rest of the command is fixed
+  if (is_instanced)
+  {
+    const VkDrawIndirectCommand draw_command = {
+      .vertexCount   = MOSS__VERTICIES_PER_INSTANCE,
+      .instanceCount = 0,
+      .firstVertex   = 0,
+      .firstInstance = 0,
+    };
+    vkCmdUpdateBuffer (
+      command_buffer,
+      sprite_batch->draw_command_buffer,
+      0,
+      sizeof (draw_command),
+      &draw_command
+    );
+  }
+  else {
+    const VkDrawIndexedIndirectCommand draw_command = {
+      .indexCount    = 0,
+      .instanceCount = 1,
+      .firstIndex    = 0,
+      .vertexOffset  = 0,
+      .firstInstance = 0,
+    };
+    vkCmdUpdateBuffer (
+      command_buffer,
+      sprite_batch->draw_command_buffer,
+      0,
+      sizeof (draw_command),
+      &draw_command
+    );
+  }
+
+  const VkMemoryBarrier barrier = {
+    .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+    .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+    .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+  };
+
+  vkCmdPipelineBarrier (
+    command_buffer,
+    VK_PIPELINE_STAGE_TRANSFER_BIT,
+    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+    0,
+    1,
+    &barrier,
+    0,
+    NULL,
+    0,
+    NULL
+  );
+
+  vkCmdBindPipeline (
+    command_buffer,
+    VK_PIPELINE_BIND_POINT_COMPUTE,
+    is_instanced ? engine->instanced_cull_pipeline : engine->cull_pipeline
+  );
+
+  vkCmdBindDescriptorSets (
+    command_buffer,
+    VK_PIPELINE_BIND_POINT_COMPUTE,
+    engine->cull_pipeline_layout,
+    0,
+    1,
+    &sprite_batch->cull_descriptor_set,
+    0,
+    NULL
+  );
+
+  const Moss__SpriteCullPushConstants push_constants = {
+    .camera_scale  = { camera->scale[ 0 ], camera->scale[ 1 ] },
+    .camera_offset = { camera->offset[ 0 ], camera->offset[ 1 ] },
+    .first_sprite  =
+      (uint32_t)(sprite_batch->vertex_data_offset / sprite_batch->sprite_data_size),
+    .sprite_count = sprite_batch->sprite_count,
+  };
+
+  vkCmdPushConstants (
+    command_buffer,
+    engine->cull_pipeline_layout,
+    VK_SHADER_STAGE_COMPUTE_BIT,
+    0,
+    sizeof (push_constants),
+    &push_constants
+  );
+
+  const uint32_t group_count =
+    (sprite_batch->sprite_count + SPRITE_CULL_WORKGROUP_SIZE - 1) /
+    SPRITE_CULL_WORKGROUP_SIZE;
+  vkCmdDispatch (command_buffer, group_count, 1, 1);
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult
+moss__reorder_sprite_batch (MossSpriteBatch *const sprite_batch)
+{
+  MossEngine *const engine = sprite_batch->original_engine;
+
+  moss__free (&engine->host_allocator, sprite_batch->chunks);
+  sprite_batch->chunks      = NULL;
+  sprite_batch->chunk_count = 0;
+
+  if (sprite_batch->sprite_count == 0) { return MOSS_RESULT_SUCCESS; }
+
+  if (moss__wait_staging_buffer_reads (sprite_batch) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Fill order is kept, staging is written with a single sequential copy
+  if (sprite_batch->chunk_size <= 0.0F &&
+      sprite_batch->material == MOSS_SPRITE_BATCH_MATERIAL_ALPHA_TEST)
+  {
+    memcpy (
+      sprite_batch->mapped_memory,
+      sprite_batch->host_sprite_data,
+      (size_t)sprite_batch->sprite_count * sprite_batch->sprite_data_size
+    );
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  uint32_t *const sprite_order = moss__allocate (
+    &engine->host_allocator,
+    sizeof (uint32_t) * sprite_batch->sprite_count,
+    MOSS_ALLOCATION_CATEGORY_TEMPORARY
+  );
+  if (sprite_order == NULL)
+  {
+    moss__error ("Failed to allocate memory for sprite batch order.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (sprite_batch->chunk_size > 0.0F)
+  {
+    const Moss__BuildSpriteChunksInfo chunks_info = {
+      .sprite_data      = sprite_batch->host_sprite_data,
+      .sprite_count     = sprite_batch->sprite_count,
+      .sprite_data_size = sprite_batch->sprite_data_size,
+      .is_instanced     = sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_INSTANCED,
+      .chunk_size       = sprite_batch->chunk_size,
+      .host_allocator   = &engine->host_allocator,
+    };
+    if (moss__build_sprite_chunks (
+          &chunks_info,
+          &sprite_batch->chunks,
+          &sprite_batch->chunk_count,
+          sprite_order
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      moss__free (&engine->host_allocator, sprite_order);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+  else {
+    for (uint32_t i = 0; i < sprite_batch->sprite_count; ++i) { sprite_order[ i ] = i; }
+  }
+
+  if (sprite_batch->material != MOSS_SPRITE_BATCH_MATERIAL_ALPHA_TEST &&
+      moss__sort_sprite_batch (sprite_batch, sprite_order) != MOSS_RESULT_SUCCESS)
+  {
+    moss__free (&engine->host_allocator, sprite_order);
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Staging is written once and in order, never read back
+  const char *const source      = sprite_batch->host_sprite_data;
+  char *const       destination = sprite_batch->mapped_memory;
+  const size_t      data_size   = sprite_batch->sprite_data_size;
+  for (uint32_t i = 0; i < sprite_batch->sprite_count; ++i)
+  {
+    memcpy (
+      destination + (size_t)i * data_size,
+      source + (size_t)sprite_order[ i ] * data_size,
+      data_size
+    );
+  }
+
+  moss__free (&engine->host_allocator, sprite_order);
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult moss__sort_sprite_batch (
+  MossSpriteBatch *const sprite_batch,
+  uint32_t *const        sprite_order
+)
+{
+  // Whole batch is a single range unless it's chunked
+  const Moss__SpriteChunk whole_batch = {
+    .first_sprite = 0,
+    .sprite_count = sprite_batch->sprite_count,
+  };
+  const Moss__SpriteChunk *const ranges =
+    sprite_batch->chunks != NULL ? sprite_batch->chunks : &whole_batch;
+  const uint32_t range_count =
+    sprite_batch->chunks != NULL ? sprite_batch->chunk_count : 1;
+
+  const bool is_translucent =
+    sprite_batch->material == MOSS_SPRITE_BATCH_MATERIAL_TRANSLUCENT;
+
+  for (uint32_t i = 0; i < range_count; ++i)
+  {
+    const Moss__SortSpritesByDepthInfo sort_info = {
+      .sprite_data      = sprite_batch->host_sprite_data,
+      .sprite_order     = sprite_order + ranges[ i ].first_sprite,
+      .sprite_count     = ranges[ i ].sprite_count,
+      .sprite_data_size = sprite_batch->sprite_data_size,
+      .is_instanced     = sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_INSTANCED,
+      .is_compact       = sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_COMPACT,
+      .is_back_to_front = is_translucent,
+      .host_allocator   = &sprite_batch->original_engine->host_allocator,
+    };
+    if (moss__sort_sprites_by_depth (&sort_info) != MOSS_RESULT_SUCCESS)
+    {
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult
+moss__record_sprite_batch_upload (MossSpriteBatch *const sprite_batch)
+{
+  MossEngine *const engine = sprite_batch->original_engine;
+
+  const size_t vertex_data_size =
+    (size_t)sprite_batch->sprite_count * sprite_batch->sprite_data_size;
+  if (vertex_data_size == 0) { return MOSS_RESULT_SUCCESS; }
+
+  // Refilled batch may still be drawn by frames in flight, the copy runs ahead of
+  // the next frame's draws instead of waiting for them
+  const Moss__FrameUploadCopy copy = {
+    .source_buffer      = sprite_batch->staging_buffer,
+    .destination_buffer = sprite_batch->buffer,
+    .region =
+      {
+        .srcOffset = sprite_batch->vertex_data_offset,
+        .dstOffset = sprite_batch->vertex_data_offset,
+        .size      = (VkDeviceSize)vertex_data_size,
+      },
+  };
+  if (moss__push_frame_upload_copy (&engine->frame_upload_queue, &copy) !=
+      MOSS_RESULT_SUCCESS)
+  {
+    moss__error ("Failed to queue sprite batch copy.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Next submitted frame copies from staging
+  sprite_batch->staging_frame_count = engine->frame_count + 1;
+  engine->upload_queue.recorded_bytes += (uint64_t)vertex_data_size;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult moss__write_sprite_batch_snapshot (
+  const MossSpriteBatch *const sprite_batch,
+  FILE *const                  file
+)
+{
+  const Moss__SpriteBatchSnapshotHeader header = {
+    .magic             = MOSS__SPRITE_BATCH_SNAPSHOT_MAGIC,
+    .version           = MOSS__SPRITE_BATCH_SNAPSHOT_VERSION,
+    .header_size       = sizeof (Moss__SpriteBatchSnapshotHeader),
+    .mode              = (uint32_t)sprite_batch->mode,
+    .material          = (uint32_t)sprite_batch->material,
+    .sprite_data_size  = (uint32_t)sprite_batch->sprite_data_size,
+    .chunk_record_size = sizeof (Moss__SpriteChunk),
+    .sprite_count      = sprite_batch->sprite_count,
+    .chunk_count       = sprite_batch->chunk_count,
+    .chunk_size        = sprite_batch->chunk_size,
+    .bounds_position   = { sprite_batch->bounds_position[ 0 ],
+                           sprite_batch->bounds_position[ 1 ] },
+    .bounds_size       = { sprite_batch->bounds_size[ 0 ],
+                           sprite_batch->bounds_size[ 1 ] },
+  };
+
+  // Host copy of batches kept in fill order holds updates, reordered batches can't be
+  // updated and only staging holds their sorted and chunked sprites
+  const bool is_reordered =
+    sprite_batch->chunk_size > 0.0F ||
+    sprite_batch->material != MOSS_SPRITE_BATCH_MATERIAL_ALPHA_TEST;
+  const size_t vertex_data_size =
+    (size_t)sprite_batch->sprite_count * sprite_batch->sprite_data_size;
+  const void *const vertex_data =
+    is_reordered ? sprite_batch->mapped_memory : sprite_batch->host_sprite_data;
+
+  if (fwrite (&header, sizeof (header), 1, file) != 1) { return MOSS_RESULT_ERROR; }
+
+  if (sprite_batch->chunk_count > 0 &&
+      fwrite (
+        sprite_batch->chunks,
+        sizeof (Moss__SpriteChunk),
+        sprite_batch->chunk_count,
+        file
+      ) != sprite_batch->chunk_count)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (vertex_data_size > 0 && fwrite (vertex_data, vertex_data_size, 1, file) != 1)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult moss__read_sprite_batch_snapshot (
+  MossSpriteBatch *const        sprite_batch,
+  const Moss__MappedFile *const snapshot
+)
+{
+  MossEngine *const engine = sprite_batch->original_engine;
+
+  const Moss__SpriteBatchSnapshotHeader *const header = snapshot->data;
+
+  // Sprite data is copied as is, so it must be laid out and ordered as batch expects
+  if (header->mode != (uint32_t)sprite_batch->mode ||
+      header->material != (uint32_t)sprite_batch->material ||
+      header->sprite_data_size != sprite_batch->sprite_data_size ||
+      header->chunk_size != sprite_batch->chunk_size)
+  {
+    moss__error ("Sprite batch snapshot doesn't match the sprite batch.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (header->sprite_count > sprite_batch->sprite_capacity)
+  {
+    moss__error ("Sprite batch snapshot exceeds sprite batch capacity.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  Moss__SpriteChunk *chunks = NULL;
+
+  const Moss__SpriteChunk *const snapshot_chunks =
+    (const Moss__SpriteChunk *)((const char *)snapshot->data + header->header_size);
+  const size_t      chunk_data_size = (size_t)header->chunk_count * sizeof (chunks[ 0 ]);
+  const void *const vertex_data     = (const char *)snapshot_chunks + chunk_data_size;
+
+  // Draws issue chunk ranges straight from the buffer
+  for (uint32_t i = 0; i < header->chunk_count; ++i)
+  {
+    if (snapshot_chunks[ i ].first_sprite > header->sprite_count ||
+        snapshot_chunks[ i ].sprite_count >
+          header->sprite_count - snapshot_chunks[ i ].first_sprite)
+    {
+      moss__error ("Sprite batch snapshot chunk is out of sprite range.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  // Shader indexes the bindless array with them as is
+  if (!moss__are_snapshot_texture_indices_valid (
+        sprite_batch,
+        vertex_data,
+        header->sprite_count
+      ))
+  {
+    moss__error ("Sprite batch snapshot texture index is out of range.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (header->chunk_count > 0)
+  {
+    chunks = moss__allocate (
+      &engine->host_allocator,
+      chunk_data_size,
+      MOSS_ALLOCATION_CATEGORY_SPRITE_BATCH
+    );
+    if (chunks == NULL)
+    {
+      moss__error ("Failed to allocate memory for sprite batch chunks.\n");
+      return MOSS_RESULT_ERROR;
+    }
+    memcpy (chunks, snapshot_chunks, chunk_data_size);
+  }
+
+  if (moss__wait_staging_buffer_reads (sprite_batch) != MOSS_RESULT_SUCCESS)
+  {
+    moss__free (&engine->host_allocator, chunks);
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Whole batch is copied below, pending updates are part of it
+  moss__discard_sprite_batch_updates (sprite_batch);
+
+  moss__free (&engine->host_allocator, sprite_batch->chunks);
+  sprite_batch->chunks      = chunks;
+  sprite_batch->chunk_count = header->chunk_count;
+
+  // Host copy takes loaded sprites as well, so updates and saves start from them
+  const size_t vertex_data_size =
+    (size_t)header->sprite_count * sprite_batch->sprite_data_size;
+  memcpy (sprite_batch->mapped_memory, vertex_data, vertex_data_size);
+  memcpy (sprite_batch->host_sprite_data, vertex_data, vertex_data_size);
+  sprite_batch->sprite_count = header->sprite_count;
+
+  // Compact positions are normalized to the bounds they were written with
+  sprite_batch->bounds_position[ 0 ] = header->bounds_position[ 0 ];
+  sprite_batch->bounds_position[ 1 ] = header->bounds_position[ 1 ];
+  sprite_batch->bounds_size[ 0 ]     = header->bounds_size[ 0 ];
+  sprite_batch->bounds_size[ 1 ]     = header->bounds_size[ 1 ];
+
+  return moss__record_sprite_batch_upload (sprite_batch);
+}
+
+inline static bool moss__are_snapshot_texture_indices_valid (
+  const MossSpriteBatch *const sprite_batch,
+  const void *const            vertex_data,
+  const uint32_t               sprite_count
+)
+{
+  const MossEngine *const engine = sprite_batch->original_engine;
+
+  // Non-bindless shaders sample the batch texture and ignore the index
+  if (!engine->is_bindless) { return true; }
+
+  size_t record_size   = sizeof (Moss__Vertex);
+  size_t index_offset  = offsetof (Moss__Vertex, texture_index);
+  bool   is_index_wide = true;
+  if (sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_INSTANCED)
+  {
+    record_size  = sizeof (Moss__SpriteInstance);
+    index_offset = offsetof (Moss__SpriteInstance, texture_index);
+  }
+  else if (sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_COMPACT) {
+    record_size   = sizeof (Moss__CompactVertex);
+    index_offset  = offsetof (Moss__CompactVertex, texture_index);
+    is_index_wide = false;
+  }
+
+  const uint32_t texture_count = engine->texture_index_pool.capacity;
+  const size_t   record_count =
+    (size_t)sprite_count * sprite_batch->sprite_data_size / record_size;
+
+  // Mapped snapshot data isn't guaranteed to be aligned, indices are copied out
+  const char *record = vertex_data;
+  for (size_t i = 0; i < record_count; ++i, record += record_size)
+  {
+    uint32_t texture_index = 0;
+    if (is_index_wide)
+    {
+      memcpy (&texture_index, record + index_offset, sizeof (texture_index));
+    }
+    else {
+      uint16_t narrow_index = 0;
+      memcpy (&narrow_index, record + index_offset, sizeof (narrow_index));
+      texture_index = narrow_index;
+    }
+
+    if (texture_index >= texture_count) { return false; }
+  }
+
+  return true;
+}
+
+inline static void moss__draw_sprite_batch_range (
+  MossCommandRecorder *const   recorder,
+  const MossSpriteBatch *const sprite_batch,
+  const uint32_t               first_sprite,
+  const uint32_t               sprite_count
 )
 {
-  const float half_width  = sprite->size[ 0 ] * 0.5F;
-  const float half_height = sprite->size[ 1 ] * 0.5F;
+  const VkCommandBuffer command_buffer = recorder->command_buffer;
+
+  ++recorder->draw_call_count;
+  recorder->sprite_count += sprite_count;
+
+  if (sprite_batch->mode == MOSS_SPRITE_BATCH_MODE_INSTANCED)
+  {
+    // Every instance expands to two triangles in the vertex shader
+    vkCmdDraw (
+      command_buffer,
+      MOSS__VERTICIES_PER_INSTANCE,
+      sprite_count,
+      0,
+      first_sprite
+    );
+    return;
+  }
 
-  const float bbox_left   = sprite->position[ 0 ] - half_width;
-  const float bbox_right  = sprite->position[ 0 ] + half_width;
-  const float bbox_bottom = sprite->position[ 1 ] - half_height;
-  const float bbox_top    = sprite->position[ 1 ] + half_height;
+  // Quad index buffer refers to vertices of sprite i at 4 * i, so ranges map directly
+  const uint32_t index_count = sprite_count * (uint32_t)MOSS__INDICES_PER_SPRITE;
+  const uint32_t first_index = first_sprite * (uint32_t)MOSS__INDICES_PER_SPRITE;
+  vkCmdDrawIndexed (command_buffer, index_count, 1, first_index, 0, 0);
+}
+
+inline static void moss__generate_instance_from_sprite (
+  const MossSprite *const     sprite,
+  Moss__SpriteInstance *const out_instance
+)
+{
+  *out_instance = (Moss__SpriteInstance) {
+    .position = { sprite->position[ 0 ], sprite->position[ 1 ] },
+    .size     = { sprite->size[ 0 ], sprite->size[ 1 ] },
+    .depth    = sprite->depth,
+    .uv       = {
+      moss__pack_unorm16 (sprite->uv.top_left[ 0 ]),
+      moss__pack_unorm16 (sprite->uv.top_left[ 1 ]),
+      moss__pack_unorm16 (sprite->uv.bottom_right[ 0 ]),
+      moss__pack_unorm16 (sprite->uv.bottom_right[ 1 ]),
+    },
+    .texture_index        = sprite->texture_index,
+    .animation_start_time = sprite->animation_start_time,
+    .animation_rate       = sprite->animation_rate,
+    .animation_clip       = sprite->animation_clip,
+  };
+}
 
-  out_vertices[ 0 ] = (Moss__Vertex) {
-    .position       = { bbox_left, bbox_top, sprite->depth },
-    .texture_coords = { sprite->uv.top_left[ 0 ], sprite->uv.top_left[ 1 ] },
+inline static void moss__generate_compact_verticies_from_sprite (
+  const MossSpriteBatch *const sprite_batch,
+  const MossSprite *const      sprite,
+  Moss__CompactVertex          out_vertices[ 4 ]
+)
+{
+  const float *const bounds_position = sprite_batch->bounds_position;
+  const float *const bounds_size     = sprite_batch->bounds_size;
+
+  // Bounds map to [-1, 1], the draw folds them back into the camera transform
+  const float scale_x = 2.0F / bounds_size[ 0 ];
+  const float scale_y = 2.0F / bounds_size[ 1 ];
+
+  const float center_x = (sprite->position[ 0 ] - bounds_position[ 0 ]) * scale_x;
+  const float center_y = (sprite->position[ 1 ] - bounds_position[ 1 ]) * scale_y;
+  const float half_w   = sprite->size[ 0 ] * 0.5F * scale_x;
+  const float half_h   = sprite->size[ 1 ] * 0.5F * scale_y;
+
+  const int16_t left   = moss__pack_snorm16 (center_x - half_w);
+  const int16_t right  = moss__pack_snorm16 (center_x + half_w);
+  const int16_t bottom = moss__pack_snorm16 (center_y - half_h);
+  const int16_t top    = moss__pack_snorm16 (center_y + half_h);
+
+  const uint16_t left_u   = moss__pack_unorm16 (sprite->uv.top_left[ 0 ]);
+  const uint16_t top_v    = moss__pack_unorm16 (sprite->uv.top_left[ 1 ]);
+  const uint16_t right_u  = moss__pack_unorm16 (sprite->uv.bottom_right[ 0 ]);
+  const uint16_t bottom_v = moss__pack_unorm16 (sprite->uv.bottom_right[ 1 ]);
+
+  const uint16_t depth         = moss__pack_unorm16 (sprite->depth);
+  const uint16_t texture_index = (uint16_t)sprite->texture_index;
+
+  // Corner order matches moss__generate_verticies_from_sprite
+  out_vertices[ 0 ] = (Moss__CompactVertex) {
+    .position       = { left, top },
+    .texture_coords = { left_u, top_v },
+    .depth          = depth,
+    .texture_index  = texture_index,
   };
-  out_vertices[ 1 ] = (Moss__Vertex) {
-    .position       = { bbox_right, bbox_top, sprite->depth },
-    .texture_coords = { sprite->uv.bottom_right[ 0 ], sprite->uv.top_left[ 1 ] },
+  out_vertices[ 1 ] = (Moss__CompactVertex) {
+    .position       = { right, top },
+    .texture_coords = { right_u, top_v },
+    .depth          = depth,
+    .texture_index  = texture_index,
   };
-  out_vertices[ 2 ] = (Moss__Vertex) {
-    .position       = { bbox_right, bbox_bottom, sprite->depth },
-    .texture_coords = { sprite->uv.bottom_right[ 0 ], sprite->uv.bottom_right[ 1 ] },
+  out_vertices[ 2 ] = (Moss__CompactVertex) {
+    .position       = { right, bottom },
+    .texture_coords = { right_u, bottom_v },
+    .depth          = depth,
+    .texture_index  = texture_index,
   };
-  out_vertices[ 3 ] = (Moss__Vertex) {
-    .position       = { bbox_left, bbox_bottom, sprite->depth },
-    .texture_coords = { sprite->uv.top_left[ 0 ], sprite->uv.bottom_right[ 1 ] },
+  out_vertices[ 3 ] = (Moss__CompactVertex) {
+    .position       = { left, bottom },
+    .texture_coords = { left_u, bottom_v },
+    .depth          = depth,
+    .texture_index  = texture_index,
   };
 }
+
+inline static int16_t moss__pack_snorm16 (const float value)
+{
+  if (value <= -1.0F) { return -INT16_MAX; }
+  if (value >= 1.0F) { return INT16_MAX; }
+
+  const float scaled = value * (float)INT16_MAX;
+  return (int16_t)(scaled < 0.0F ? scaled - 0.5F : scaled + 0.5F);
+}
@@ -0,0 +1,679 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/texture.c
+  @brief Texture functions implementation.
+  @author Ilya Buravov (ilburale@gmail.com)
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vulkan/vulkan.h>
+
+#include "moss/engine.h"
+#include "moss/result.h"
+#include "moss/texture.h"
+
+#include "src/internal/config.h"
+#include "src/internal/deletion_queue.h"
+#include "src/internal/engine.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/ktx2.h"
+#include "src/internal/log.h"
+#include "src/internal/mipmap.h"
+#include "src/internal/texture.h"
+#include "src/internal/texture_decoder.h"
+#include "src/internal/texture_index_pool.h"
+#include "src/internal/texture_loader.h"
+#include "src/internal/upload_queue.h"
+#include "src/internal/vulkan/utils/allocator.h"
+#include "src/internal/vulkan/utils/buffer.h"
+#include "src/internal/vulkan/utils/image.h"
+#include "src/internal/vulkan/utils/image_view.h"
+
+/* Alignment of mip levels in the staging buffer, a multiple of every block size. */
+#define MOSS__TEXTURE_LEVEL_ALIGNMENT (size_t)(16)
+
+/*=============================================================================
+    PRIVATE FUNCTION DECLARATIONS
+  =============================================================================*/
+
+/*
+  @brief Allocates texture without device resources.
+  @details Texture refers to the default texture descriptor, so it's drawn as
+           plain white until its own resources are created.
+  @param engine Engine handle.
+  @return Returns a valid pointer to a texture on success, otherwise returns NULL.
+*/
+inline static MossTexture *moss__allocate_texture (MossEngine *engine);
+
+/*
+  @brief Creates texture with image, image view and descriptor set.
+  @param engine Engine handle.
+  @param decoded Texture image contents.
+  @return Returns a valid pointer to a texture on success, otherwise returns NULL.
+*/
+inline static MossTexture *
+moss__create_texture (MossEngine *engine, const Moss__DecodedTexture *decoded);
+
+/*
+  @brief Creates image, image view and descriptor set of the texture.
+  @details Marks texture as ready on success. On failure texture is left without
+           device resources.
+  @param engine Engine handle.
+  @param texture Texture to create resources for.
+  @param decoded Texture image contents.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_texture_resources (
+  MossEngine                 *engine,
+  MossTexture                *texture,
+  const Moss__DecodedTexture *decoded
+);
+
+/*
+  @brief Destroys device resources of the texture once frames stop using them.
+  @param texture Texture handle.
+*/
+inline static void moss__destroy_texture_resources (MossTexture *texture);
+
+/*
+  @brief Uploads texture of the decoded job and invokes its callback.
+  @param engine Engine handle.
+  @param job Decoded job, destroyed by the call.
+*/
+inline static void
+moss__finish_texture_load (MossEngine *engine, Moss__TextureLoadJob *job);
+
+/*
+  @brief Checks if device can sample images of the format.
+  @param engine Engine handle.
+  @param format Image format.
+  @return Returns true if format is supported, false otherwise.
+*/
+inline static bool
+moss__check_texture_format_support (MossEngine *engine, VkFormat format);
+
+/*
+  @brief Creates texture image and records upload of every mip level.
+  @param engine Engine handle.
+  @param texture Texture to create image for, format, size and level count must be set.
+  @param decoded Texture image contents.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_texture_image (
+  MossEngine                 *engine,
+  MossTexture                *texture,
+  const Moss__DecodedTexture *decoded
+);
+
+/*
+  @brief Allocates and writes texture descriptor set.
+  @details In bindless mode acquires a slot in the bindless texture array and writes
+           it instead, texture refers to the shared bindless set then.
+  @param engine Engine handle.
+  @param texture Texture to allocate descriptor set for.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult
+moss__create_texture_descriptor_set (MossEngine *engine, MossTexture *texture);
+
+/*=============================================================================
+    PUBLIC FUNCTIONS IMPLEMENTATION
+  =============================================================================*/
+
+MossTexture *
+moss_create_texture_from_file (const MossTextureCreateFromFileInfo *const info)
+{
+  Moss__DecodedTexture decoded;
+  if (moss__decode_texture_file (
+        &info->engine->host_allocator,
+        info->file_path,
+        info->generate_mipmaps,
+        &decoded
+      ) != MOSS_RESULT_SUCCESS)
+  {
+    return NULL;
+  }
+
+  MossTexture *const texture = moss__create_texture (info->engine, &decoded);
+  if (texture == NULL) { moss__error ("Failed to load \"%s\".\n", info->file_path); }
+
+  moss__free_decoded_texture (&decoded);
+
+  return texture;
+}
+
+MossTexture *
+moss_create_texture_from_memory (const MossTextureCreateFromMemoryInfo *const info)
+{
+  if (info->pixels == NULL || info->width == 0 || info->height == 0)
+  {
+    moss__error ("Invalid parameters to moss_create_texture_from_memory.\n");
+    return NULL;
+  }
+
+  // Level 0 stays in caller memory, only generated levels are owned
+  Moss__DecodedTexture decoded;
+  moss__init_decoded_texture_state (&decoded, &info->engine->host_allocator);
+  decoded.width       = info->width;
+  decoded.height      = info->height;
+  decoded.levels[ 0 ] = (Moss__TextureLevel) {
+    .data = info->pixels,
+    .size = (size_t)info->width * (size_t)info->height * 4,
+  };
+
+  if (moss__generate_texture_mip_chain (&decoded, info->generate_mipmaps) !=
+      MOSS_RESULT_SUCCESS)
+  {
+    return NULL;
+  }
+
+  MossTexture *const texture = moss__create_texture (info->engine, &decoded);
+
+  moss__free_decoded_texture (&decoded);
+
+  return texture;
+}
+
+MossTexture *moss_load_texture_async (const MossTextureLoadAsyncInfo *const info)
+{
+  MossEngine *const engine = info->engine;
+
+  if (info->file_path == NULL)
+  {
+    moss__error ("Invalid parameters to moss_load_texture_async.\n");
+    return NULL;
+  }
+
+  // Loader thread is only started for applications that stream textures
+  if (!engine->texture_loader.is_running &&
+      moss__start_texture_loader (&engine->texture_loader) != MOSS_RESULT_SUCCESS)
+  {
+    return NULL;
+  }
+
+  Moss__TextureLoadJob *const job = moss__create_texture_load_job (
+    &engine->host_allocator,
+    info->file_path,
+    info->generate_mipmaps
+  );
+  if (job == NULL) { return NULL; }
+
+  MossTexture *const texture = moss__allocate_texture (engine);
+  if (texture == NULL)
+  {
+    moss__destroy_texture_load_job (job);
+    return NULL;
+  }
+
+  texture->load_job = job;
+
+  job->texture   = texture;
+  job->callback  = info->callback;
+  job->user_data = info->user_data;
+
+  moss__push_texture_load_job (&engine->texture_loader, job);
+
+  return texture;
+}
+
+MossTextureState moss_get_texture_state (const MossTexture *const texture)
+{
+  return texture->state;
+}
+
+void moss_destroy_texture (MossTexture *const texture)
+{
+  if (texture == NULL) { return; }
+
+  // Job is owned by the loader, it's dropped once decoded. Failed textures have no
+  // device resources to destroy
+  if (texture->load_job != NULL) { texture->load_job->texture = NULL; }
+  else if (texture->state == MOSS_TEXTURE_STATE_READY) {
+    moss__destroy_texture_resources (texture);
+  }
+
+  moss__free (&texture->original_engine->host_allocator, texture);
+}
+
+uint32_t moss_get_texture_index (const MossTexture *const texture)
+{
+  return texture->index;
+}
+
+/*=============================================================================
+    INTERNAL FUNCTIONS IMPLEMENTATION
+  =============================================================================*/
+
+void moss__finish_texture_loads (MossEngine *const engine)
+{
+  // At least one texture is uploaded per frame, however big it is
+  size_t uploaded_size = 0;
+  while (uploaded_size < TEXTURE_STREAMING_BYTES_PER_FRAME)
+  {
+    Moss__TextureLoadJob *const job =
+      moss__pop_completed_texture_load_job (&engine->texture_loader);
+    if (job == NULL) { break; }
+
+    uploaded_size += moss__get_decoded_texture_size (&job->decoded);
+    moss__finish_texture_load (engine, job);
+  }
+}
+
+/*=============================================================================
+    PRIVATE FUNCTIONS IMPLEMENTATION
+  =============================================================================*/
+
+inline static MossTexture *moss__allocate_texture (MossEngine *const engine)
+{
+  MossTexture *const texture = moss__allocate (
+    &engine->host_allocator,
+    sizeof (MossTexture),
+    MOSS_ALLOCATION_CATEGORY_TEXTURE
+  );
+  if (texture == NULL)
+  {
+    moss__error ("Failed to allocate memory for a texture.\n");
+    return NULL;
+  }
+
+  // Default texture itself is created before there is a placeholder to refer to
+  const MossTexture *const placeholder     = engine->default_texture;
+  const bool               has_placeholder = placeholder != NULL;
+
+  *texture = (MossTexture) {
+    .original_engine  = engine,
+    .image            = VK_NULL_HANDLE,
+    .image_view       = VK_NULL_HANDLE,
+    .image_allocation = { 0 },
+    .descriptor_set   = has_placeholder ? placeholder->descriptor_set : VK_NULL_HANDLE,
+    .index            = has_placeholder ? placeholder->index : 0,
+    .format           = MOSS__TEXTURE_FORMAT,
+    .width            = 0,
+    .height           = 0,
+    .mip_level_count  = 0,
+    .upload_value     = 0,
+    .state            = MOSS_TEXTURE_STATE_LOADING,
+    .load_job         = NULL,
+  };
+
+  return texture;
+}
+
+inline static MossTexture *
+moss__create_texture (MossEngine *const engine, const Moss__DecodedTexture *const decoded)
+{
+  MossTexture *const texture = moss__allocate_texture (engine);
+  if (texture == NULL) { return NULL; }
+
+  if (moss__create_texture_resources (engine, texture, decoded) != MOSS_RESULT_SUCCESS)
+  {
+    moss__free (&engine->host_allocator, texture);
+    return NULL;
+  }
+
+  return texture;
+}
+
+inline static MossResult moss__create_texture_resources (
+  MossEngine *const                 engine,
+  MossTexture *const                texture,
+  const Moss__DecodedTexture *const decoded
+)
+{
+  // Compressed blocks can't be decoded on the fly, e.g. BC7 is absent on Apple GPUs
+  if (!moss__check_texture_format_support (engine, decoded->format))
+  {
+    moss__error (
+      "Texture format %u is not supported by the device.\n",
+      (uint32_t)decoded->format
+    );
+    return MOSS_RESULT_ERROR;
+  }
+
+  texture->format          = decoded->format;
+  texture->width           = decoded->width;
+  texture->height          = decoded->height;
+  texture->mip_level_count = decoded->level_count;
+
+  if (moss__create_texture_image (engine, texture, decoded) != MOSS_RESULT_SUCCESS)
+  {
+    return MOSS_RESULT_ERROR;
+  }
+
+  {  // Create image view
+    const Moss__VkImageViewCreateInfo create_info = {
+      .device               = engine->device,
+      .image                = texture->image,
+      .format               = texture->format,
+      .aspect               = VK_IMAGE_ASPECT_COLOR_BIT,
+      .allocation_callbacks = &engine->vk_allocation_callbacks,
+    };
+
+    texture->image_view = moss_vk__create_image_view (&create_info);
+    if (texture->image_view == VK_NULL_HANDLE)
+    {
+      moss__error ("Failed to create texture image view.\n");
+      moss__destroy_texture_resources (texture);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  if (moss__create_texture_descriptor_set (engine, texture) != MOSS_RESULT_SUCCESS)
+  {
+    moss__destroy_texture_resources (texture);
+    return MOSS_RESULT_ERROR;
+  }
+
+  texture->state = MOSS_TEXTURE_STATE_READY;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static void moss__destroy_texture_resources (MossTexture *const texture)
+{
+  MossEngine *const engine = texture->original_engine;
+
+  // Only ready textures own a descriptor, others refer to the placeholder. Bindless
+  // set is shared, only the slot goes back once frames stop sampling it
+  const bool has_descriptor = texture->state == MOSS_TEXTURE_STATE_READY;
+  const bool is_bindless    = engine->is_bindless;
+
+  const Moss__DeletionQueueEntry entry = {
+    .image_view      = texture->image_view,
+    .image           = texture->image,
+    .buffer          = VK_NULL_HANDLE,
+    .allocation      = texture->image_allocation,
+    .descriptor_pool = engine->texture_descriptor_pool,
+    .descriptor_set =
+      has_descriptor && !is_bindless ? texture->descriptor_set : VK_NULL_HANDLE,
+    .release_texture_index = has_descriptor && is_bindless,
+    .texture_index         = texture->index,
+  };
+  moss__defer_deletion (engine, &entry, texture->upload_value);
+
+  texture->image            = VK_NULL_HANDLE;
+  texture->image_view       = VK_NULL_HANDLE;
+  texture->image_allocation = (Moss__VkAllocation) { 0 };
+}
+
+inline static void
+moss__finish_texture_load (MossEngine *const engine, Moss__TextureLoadJob *const job)
+{
+  MossTexture *const texture = job->texture;
+
+  // Texture was destroyed while it was being decoded
+  if (texture == NULL)
+  {
+    moss__destroy_texture_load_job (job);
+    return;
+  }
+
+  texture->load_job = NULL;
+
+  MossResult result = job->result;
+  if (result == MOSS_RESULT_SUCCESS)
+  {
+    result = moss__create_texture_resources (engine, texture, &job->decoded);
+  }
+
+  // Failed texture keeps referring to the placeholder
+  if (result != MOSS_RESULT_SUCCESS)
+  {
+    moss__error ("Failed to load \"%s\".\n", job->file_path);
+    texture->state = MOSS_TEXTURE_STATE_FAILED;
+  }
+
+  const MossTextureLoadCallback callback  = job->callback;
+  void *const                   user_data = job->user_data;
+  moss__destroy_texture_load_job (job);
+
+  // Callback goes last, it may destroy the texture
+  if (callback != NULL) { callback (texture, result, user_data); }
+}
+
+inline static bool
+moss__check_texture_format_support (MossEngine *const engine, const VkFormat format)
+{
+  VkFormatProperties properties;
+  vkGetPhysicalDeviceFormatProperties (engine->physical_device, format, &properties);
+
+  return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
+inline static MossResult moss__create_texture_image (
+  MossEngine *const                 engine,
+  MossTexture *const                texture,
+  const Moss__DecodedTexture *const decoded
+)
+{
+  // Levels are packed into one staging buffer, each at an aligned offset
+  VkBufferImageCopy regions[ MAX_TEXTURE_MIP_LEVEL_COUNT ];
+  size_t            staging_size = 0;
+  for (uint32_t level = 0; level < texture->mip_level_count; ++level)
+  {
+    staging_size = (staging_size + MOSS__TEXTURE_LEVEL_ALIGNMENT - 1) &
+                   ~(MOSS__TEXTURE_LEVEL_ALIGNMENT - 1);
+
+    regions[ level ] = (VkBufferImageCopy) {
+      .bufferOffset      = (VkDeviceSize)staging_size,
+      .bufferRowLength   = 0,
+      .bufferImageHeight = 0,
+
+      .imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+      .imageSubresource.mipLevel       = level,
+      .imageSubresource.baseArrayLayer = 0,
+      .imageSubresource.layerCount     = 1,
+
+      .imageOffset = (VkOffset3D) { 0, 0, 0 },
+      .imageExtent = (VkExtent3D) {
+        moss__get_mip_level_size (texture->width, level),
+        moss__get_mip_level_size (texture->height, level),
+        1,
+      },
+    };
+
+    staging_size += decoded->levels[ level ].size;
+  }
+
+  VkBuffer           staging_buffer;
+  Moss__VkAllocation staging_allocation;
+  {  // Create staging buffer
+    const Moss__CreateVkBufferInfo create_info = {
+      .allocator       = &engine->allocator,
+      .device          = engine->device,
+      .size            = (VkDeviceSize)staging_size,
+      .usage           = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      .memory_properties =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      .sharing_mode                    = engine->buffer_sharing_mode,
+      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+    };
+    const MossResult result =
+      moss_vk__create_buffer (&create_info, &staging_buffer, &staging_allocation);
+    if (result != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create staging buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  // Copy levels into the persistently mapped staging buffer
+  for (uint32_t level = 0; level < texture->mip_level_count; ++level)
+  {
+    memcpy (
+      (uint8_t *)staging_allocation.mapped_memory + regions[ level ].bufferOffset,
+      decoded->levels[ level ].data,
+      decoded->levels[ level ].size
+    );
+  }
+
+  {  // Create texture image
+    const MossVk__CreateImageInfo create_info = {
+      .device                          = engine->device,
+      .format                          = texture->format,
+      .image_width                     = texture->width,
+      .image_height                    = texture->height,
+      .mip_level_count                 = texture->mip_level_count,
+      .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+      .sharing_mode                    = engine->buffer_sharing_mode,
+      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .allocation_callbacks            = &engine->vk_allocation_callbacks,
+    };
+
+    texture->image = moss_vk__create_image (&create_info);
+    if (texture->image == VK_NULL_HANDLE)
+    {
+      moss_vk__destroy_buffer (&engine->allocator, staging_buffer, &staging_allocation);
+      moss__error ("Failed to create texture image.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Allocate memory for texture image
+    const MossVk__AllocateImageMemoryInfo alloc_info = {
+      .allocator = &engine->allocator,
+      .device    = engine->device,
+      .image     = texture->image,
+    };
+
+    if (moss_vk__allocate_image_memory (&alloc_info, &texture->image_allocation) !=
+        MOSS_RESULT_SUCCESS)
+    {
+      moss_vk__destroy_buffer (&engine->allocator, staging_buffer, &staging_allocation);
+      vkDestroyImage (engine->device, texture->image, &engine->vk_allocation_callbacks);
+      moss__error ("Failed to allocate memory for the texture image.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  // Record upload, the first frame that samples the texture waits for it on the GPU
+  const VkCommandBuffer command_buffer =
+    moss__get_upload_command_buffer (&engine->upload_queue);
+  if (command_buffer == VK_NULL_HANDLE ||
+      moss_vk__cmd_transition_image_layout (
+        command_buffer,
+        texture->image,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+      ) != MOSS_RESULT_SUCCESS)
+  {
+    moss_vk__destroy_buffer (&engine->allocator, staging_buffer, &staging_allocation);
+    moss_vk__free_memory (&engine->allocator, &texture->image_allocation);
+    vkDestroyImage (engine->device, texture->image, &engine->vk_allocation_callbacks);
+    return MOSS_RESULT_ERROR;
+  }
+
+  vkCmdCopyBufferToImage (
+    command_buffer,
+    staging_buffer,
+    texture->image,
+    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    texture->mip_level_count,
+    regions
+  );
+
+  // Transition command is valid at this point, so it can't fail
+  moss_vk__cmd_transition_image_layout (
+    command_buffer,
+    texture->image,
+    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+  );
+
+  texture->upload_value = moss__get_upload_queue_pending_value (&engine->upload_queue);
+  engine->upload_queue.recorded_bytes += (uint64_t)staging_size;
+
+  // Staging buffer is freed once the upload completes
+  if (moss__release_upload_staging_buffer (
+        &engine->upload_queue,
+        staging_buffer,
+        &staging_allocation
+      ) != MOSS_RESULT_SUCCESS)
+  {
+    moss__flush_upload_queue (&engine->upload_queue);
+    moss__wait_upload_queue_value (&engine->upload_queue, texture->upload_value);
+    moss_vk__destroy_buffer (&engine->allocator, staging_buffer, &staging_allocation);
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult
+moss__create_texture_descriptor_set (MossEngine *const engine, MossTexture *const texture)
+{
+  // Placeholder descriptor is only replaced once the new one is written
+  VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+  uint32_t        index          = 0;
+
+  if (engine->is_bindless)
+  {
+    if (moss__acquire_texture_index (&engine->texture_index_pool, &index) !=
+        MOSS_RESULT_SUCCESS)
+    {
+      return MOSS_RESULT_ERROR;
+    }
+
+    // Texture refers to the shared set, only its slot is written below
+    descriptor_set = engine->bindless_descriptor_set;
+  }
+  else {
+    const VkDescriptorSetAllocateInfo alloc_info = {
+      .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .descriptorPool     = engine->texture_descriptor_pool,
+      .descriptorSetCount = 1,
+      .pSetLayouts        = &engine->texture_descriptor_set_layout,
+    };
+
+    const VkResult result =
+      vkAllocateDescriptorSets (engine->device, &alloc_info, &descriptor_set);
+    if (result != VK_SUCCESS)
+    {
+      moss__error ("Failed to allocate texture descriptor set: %d.\n", result);
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  // Neither a new set nor a released slot is used by pending command buffers, the
+  // latter since slots are released once frames that sampled them complete
+  const VkDescriptorImageInfo image_info = {
+    .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    .sampler     = engine->sampler,
+    .imageView   = texture->image_view,
+  };
+
+  const VkWriteDescriptorSet descriptor_write = {
+    .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+    .dstSet          = descriptor_set,
+    .dstBinding      = 0,
+    .dstArrayElement = index,
+    .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+    .descriptorCount = 1,
+    .pImageInfo      = &image_info,
+  };
+
+  vkUpdateDescriptorSets (engine->device, 1, &descriptor_write, 0, NULL);
+
+  texture->descriptor_set = descriptor_set;
+  texture->index          = index;
+
+  return MOSS_RESULT_SUCCESS;
+}
@@ -0,0 +1,576 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file src/tilemap.c
+  @brief Tilemap functions implementation.
+  @author Ilya Buravov (ilburale@gmail.com)
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cglm/vec2.h>
+
+#include "moss/engine.h"
+#include "moss/result.h"
+#include "moss/texture.h"
+#include "moss/tilemap.h"
+
+#include "src/internal/camera.h"
+#include "src/internal/config.h"
+#include "src/internal/engine.h"
+#include "src/internal/frame_upload_queue.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/log.h"
+#include "src/internal/texture.h"
+#include "src/internal/tilemap.h"
+#include "src/internal/upload_queue.h"
+#include "src/internal/vulkan/utils/buffer.h"
+
+/* Number of vertices of a chunk quad. */
+#define MOSS__VERTICIES_PER_CHUNK (uint32_t)(6)
+
+/*=============================================================================
+    INTERNAL STRUCT DECLARATIONS
+  =============================================================================*/
+
+struct MossTilemap
+{
+  MossEngine        *original_engine;   /* Engine this tilemap was created on. */
+  MossTexture       *atlas;             /* Texture atlas, NULL for the default. */
+  uint32_t           atlas_columns;     /* Number of atlas cell columns. */
+  uint32_t           atlas_rows;        /* Number of atlas cell rows. */
+  uint32_t           width;             /* Map width in tiles. */
+  uint32_t           height;            /* Map height in tiles. */
+  uint32_t           chunk_columns;     /* Number of chunk columns. */
+  uint32_t           chunk_rows;        /* Number of chunk rows. */
+  vec2               position;          /* World position of the top left corner. */
+  vec2               tile_size;         /* World size of a single tile. */
+  float              depth;             /* Depth tiles are drawn at. */
+  VkBuffer           buffer;            /* Tile buffer, two tiles per word. */
+  Moss__VkAllocation buffer_allocation; /* Tile buffer memory. */
+  VkDescriptorSet    descriptor_set;    /* Set 2 holding the tile buffer. */
+  uint64_t           upload_value;      /* Upload value of the initial tile copy. */
+};
+
+/*=============================================================================
+    PRIVATE FUNCTION DECLARATIONS
+  =============================================================================*/
+
+/*
+  @brief Creates tile buffer and its descriptor set.
+  @param tilemap Tilemap with map size set.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__create_tile_buffer (MossTilemap *tilemap);
+
+/*
+  @brief Queues upload of a rect of tiles with the next submitted frame.
+  @details Rows are packed into a single staging region of the frame slot and
+           copied with one region per row, ahead of the frame draws, so frames in
+           flight keep reading the old tiles. Rects written again within a frame
+           overlap earlier rows, the frame upload queue orders those copies.
+  @param tilemap Tilemap handle.
+  @param first_tile Row-major index of the top left tile of the rect.
+  @param tiles Tiles to write, rows of the rect follow each other.
+  @param row_length Number of tiles in a row of the rect.
+  @param row_count Number of rows in the rect.
+  @return Returns MOSS_RESULT_SUCCESS on success, MOSS_RESULT_ERROR otherwise.
+*/
+inline static MossResult moss__upload_tile_rows (
+  MossTilemap    *tilemap,
+  size_t          first_tile,
+  const uint16_t *tiles,
+  uint32_t        row_length,
+  uint32_t        row_count
+);
+
+/*
+  @brief Returns range of chunks along one axis that overlap passed tile range.
+  @param first_tile First overlapped tile, may be outside the map.
+  @param last_tile Last overlapped tile, may be outside the map.
+  @param chunk_count Number of chunks along the axis.
+  @param out_first Output first overlapped chunk.
+  @param out_last Output last overlapped chunk.
+  @return Returns false if no chunk is overlapped.
+*/
+inline static bool moss__get_visible_chunk_range (
+  float     first_tile,
+  float     last_tile,
+  uint32_t  chunk_count,
+  uint32_t *out_first,
+  uint32_t *out_last
+);
+
+/*=============================================================================
+    PUBLIC FUNCTIONS IMPLEMENTATION
+  =============================================================================*/
+
+MossTilemap *moss_create_tilemap (const MossTilemapCreateInfo *const info)
+{
+  if (info == NULL || info->engine == NULL || info->width == 0 || info->height == 0 ||
+      info->atlas_columns == 0 || info->atlas_rows == 0 ||
+      !(info->tile_size[ 0 ] > 0.0F) || !(info->tile_size[ 1 ] > 0.0F))
+  {
+    moss__error ("Invalid parameters to moss_create_tilemap.\n");
+    return NULL;
+  }
+
+  // Shaders index tiles and atlas cells with 32-bit and 16-bit values
+  if ((uint64_t)info->width * info->height > UINT32_MAX)
+  {
+    moss__error ("Tilemap of %ux%u tiles is too large.\n", info->width, info->height);
+    return NULL;
+  }
+
+  if ((uint64_t)info->atlas_columns * info->atlas_rows > UINT16_MAX)
+  {
+    moss__error ("Tilemap atlas can't have more than %u cells.\n", UINT16_MAX);
+    return NULL;
+  }
+
+  MossTilemap *const tilemap = moss__allocate (
+    &info->engine->host_allocator,
+    sizeof (MossTilemap),
+    MOSS_ALLOCATION_CATEGORY_ENGINE
+  );
+  if (tilemap == NULL)
+  {
+    moss__error ("Failed to allocate memory for tilemap.\n");
+    return NULL;
+  }
+
+  *tilemap = (MossTilemap) {
+    .original_engine   = info->engine,
+    .atlas             = info->atlas,
+    .atlas_columns     = info->atlas_columns,
+    .atlas_rows        = info->atlas_rows,
+    .width             = info->width,
+    .height            = info->height,
+    .chunk_columns     = (info->width + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE,
+    .chunk_rows        = (info->height + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE,
+    .position          = { info->position[ 0 ], info->position[ 1 ] },
+    .tile_size         = { info->tile_size[ 0 ], info->tile_size[ 1 ] },
+    .depth             = info->depth,
+    .buffer            = VK_NULL_HANDLE,
+    .buffer_allocation = { 0 },
+    .descriptor_set    = VK_NULL_HANDLE,
+    .upload_value      = 0,
+  };
+
+  if (moss__create_tile_buffer (tilemap) != MOSS_RESULT_SUCCESS)
+  {
+    moss_destroy_tilemap (tilemap);
+    return NULL;
+  }
+
+  // Device-local memory isn't zeroed, empty maps upload zero tiles too
+  const size_t tile_count  = (size_t)tilemap->width * tilemap->height;
+  uint16_t    *empty_tiles = NULL;
+  if (info->tiles == NULL)
+  {
+    empty_tiles = moss__allocate_zeroed (
+      &info->engine->host_allocator,
+      tile_count,
+      sizeof (uint16_t),
+      MOSS_ALLOCATION_CATEGORY_TEMPORARY
+    );
+    if (empty_tiles == NULL)
+    {
+      moss__error ("Failed to allocate memory for empty tiles.\n");
+      moss_destroy_tilemap (tilemap);
+      return NULL;
+    }
+  }
+
+  // No frame reads the new buffer yet, so the whole map goes through the upload queue
+  MossEngine *const                     engine    = info->engine;
+  const Moss__UploadQueueFillBufferInfo fill_info = {
+    .destination_buffer              = tilemap->buffer,
+    .destination_offset              = 0,
+    .source_data                     = info->tiles != NULL ? info->tiles : empty_tiles,
+    .data_size                       = (VkDeviceSize)(tile_count * sizeof (uint16_t)),
+    .sharing_mode                    = engine->buffer_sharing_mode,
+    .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+    .shared_queue_family_indices     = engine->shared_queue_family_indices,
+  };
+  const MossResult result =
+    moss__upload_queue_fill_buffer (&engine->upload_queue, &fill_info);
+  moss__free (&engine->host_allocator, empty_tiles);
+  if (result != MOSS_RESULT_SUCCESS)
+  {
+    moss__error ("Failed to upload tiles.\n");
+    moss_destroy_tilemap (tilemap);
+    return NULL;
+  }
+  tilemap->upload_value = moss__get_upload_queue_pending_value (&engine->upload_queue);
+
+  return tilemap;
+}
+
+void moss_destroy_tilemap (MossTilemap *const tilemap)
+{
+  if (tilemap == NULL) { return; }
+
+  MossEngine *const engine = tilemap->original_engine;
+
+  // Pending copy references the tile buffer, submit it before waiting
+  if (tilemap->upload_value > engine->upload_queue.submitted_value)
+  {
+    moss__flush_upload_queue (&engine->upload_queue);
+  }
+
+  // Copies waiting for the next frame would write the destroyed buffer
+  moss__discard_frame_upload_copies (&engine->frame_upload_queue, tilemap->buffer);
+
+  // Wait until device finishes all his work
+  vkDeviceWaitIdle (engine->device);
+
+  if (tilemap->descriptor_set != VK_NULL_HANDLE)
+  {
+    vkFreeDescriptorSets (
+      engine->device,
+      engine->tilemap_descriptor_pool,
+      1,
+      &tilemap->descriptor_set
+    );
+  }
+
+  moss_vk__destroy_buffer (
+    &engine->allocator,
+    tilemap->buffer,
+    &tilemap->buffer_allocation
+  );
+
+  moss__free (&engine->host_allocator, tilemap);
+}
+
+MossResult moss_set_tilemap_tiles (
+  MossTilemap *const                   tilemap,
+  const MossSetTilemapTilesInfo *const info
+)
+{
+  if (tilemap == NULL || info == NULL || info->tiles == NULL)
+  {
+    moss__error ("Invalid parameters to moss_set_tilemap_tiles.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (info->x > tilemap->width || info->width > tilemap->width - info->x ||
+      info->y > tilemap->height || info->height > tilemap->height - info->y)
+  {
+    moss__error ("Tiles rect is out of tilemap bounds.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (info->width == 0 || info->height == 0) { return MOSS_RESULT_SUCCESS; }
+
+  return moss__upload_tile_rows (
+    tilemap,
+    (size_t)info->y * tilemap->width + info->x,
+    info->tiles,
+    info->width,
+    info->height
+  );
+}
+
+MossResult moss_draw_tilemap (MossEngine *const engine, MossTilemap *const tilemap)
+{
+  if (engine == NULL || tilemap == NULL)
+  {
+    moss__error ("Invalid parameters to moss_draw_tilemap.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  return moss_record_tilemap (&engine->main_recorder, tilemap);
+}
+
+MossResult
+moss_record_tilemap (MossCommandRecorder *const recorder, MossTilemap *const tilemap)
+{
+  if (recorder == NULL || tilemap == NULL)
+  {
+    moss__error ("Invalid parameters to moss_record_tilemap.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  if (!recorder->is_recording)
+  {
+    moss__error ("Command recorder isn't begun.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  MossEngine *const engine = recorder->engine;
+
+  if (tilemap->original_engine != engine)
+  {
+    moss__error ("Tilemap created with different engine.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Cull chunks against the camera view, tile rows go down from the map position
+  vec2 view_min, view_max;
+  moss__get_camera_view_rect (recorder->camera, view_min, view_max);
+
+  uint32_t first_column, last_column, first_row, last_row;
+  if (!moss__get_visible_chunk_range (
+        (view_min[ 0 ] - tilemap->position[ 0 ]) / tilemap->tile_size[ 0 ],
+        (view_max[ 0 ] - tilemap->position[ 0 ]) / tilemap->tile_size[ 0 ],
+        tilemap->chunk_columns,
+        &first_column,
+        &last_column
+      ) ||
+      !moss__get_visible_chunk_range (
+        (tilemap->position[ 1 ] - view_max[ 1 ]) / tilemap->tile_size[ 1 ],
+        (tilemap->position[ 1 ] - view_min[ 1 ]) / tilemap->tile_size[ 1 ],
+        tilemap->chunk_rows,
+        &first_row,
+        &last_row
+      ))
+  {
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  const VkCommandBuffer command_buffer = recorder->command_buffer;
+
+  const MossTexture *const texture =
+    tilemap->atlas != NULL ? tilemap->atlas : engine->default_texture;
+
+  moss__bind_graphics_pipeline (recorder, engine->tilemap_graphics_pipeline);
+  moss__bind_texture_descriptor_set (recorder, texture->descriptor_set);
+  moss__bind_camera (recorder, NULL);
+
+  vkCmdBindDescriptorSets (
+    command_buffer,
+    VK_PIPELINE_BIND_POINT_GRAPHICS,
+    engine->pipeline_layout,
+    2,
+    1,
+    &tilemap->descriptor_set,
+    0,
+    NULL
+  );
+
+  const Moss__TilemapPushConstants push_constants = {
+    .position      = { tilemap->position[ 0 ], tilemap->position[ 1 ] },
+    .tile_size     = { tilemap->tile_size[ 0 ], tilemap->tile_size[ 1 ] },
+    .map_size      = { tilemap->width, tilemap->height },
+    .atlas_size    = { tilemap->atlas_columns, tilemap->atlas_rows },
+    .depth         = tilemap->depth,
+    .texture_index = texture->index,
+    .chunk_size    = TILEMAP_CHUNK_SIZE,
+  };
+  vkCmdPushConstants (
+    command_buffer,
+    engine->pipeline_layout,
+    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+    MOSS__TILEMAP_PUSH_CONSTANT_OFFSET,
+    sizeof (push_constants),
+    &push_constants
+  );
+
+  // Every instance is a chunk, visible rows of full width are consecutive
+  const uint32_t column_count = last_column - first_column + 1;
+  if (column_count == tilemap->chunk_columns)
+  {
+    vkCmdDraw (
+      command_buffer,
+      MOSS__VERTICIES_PER_CHUNK,
+      (last_row - first_row + 1) * column_count,
+      0,
+      first_row * tilemap->chunk_columns
+    );
+    ++recorder->draw_call_count;
+
+    return MOSS_RESULT_SUCCESS;
+  }
+
+  for (uint32_t row = first_row; row <= last_row; ++row)
+  {
+    vkCmdDraw (
+      command_buffer,
+      MOSS__VERTICIES_PER_CHUNK,
+      column_count,
+      0,
+      row * tilemap->chunk_columns + first_column
+    );
+    ++recorder->draw_call_count;
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+/*=============================================================================
+    PRIVATE FUNCTIONS IMPLEMENTATION
+  =============================================================================*/
+
+inline static MossResult moss__create_tile_buffer (MossTilemap *const tilemap)
+{
+  MossEngine *const engine = tilemap->original_engine;
+
+  // Shaders read whole words, odd tile count is padded to one
+  const size_t       tile_count = (size_t)tilemap->width * tilemap->height;
+  const VkDeviceSize size = (VkDeviceSize)((tile_count + 1) / 2) * sizeof (uint32_t);
+
+  {  // Create device-local tile buffer
+    const Moss__CreateVkBufferInfo create_info = {
+      .allocator       = &engine->allocator,
+      .device          = engine->device,
+      .size            = size,
+      .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      .memory_properties               = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+      .sharing_mode                    = engine->buffer_sharing_mode,
+      .shared_queue_family_index_count = engine->shared_queue_family_index_count,
+      .shared_queue_family_indices     = engine->shared_queue_family_indices,
+    };
+    if (moss_vk__create_buffer (
+          &create_info,
+          &tilemap->buffer,
+          &tilemap->buffer_allocation
+        ) != MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to create tile buffer.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  {  // Allocate and write descriptor set
+    const VkDescriptorSetAllocateInfo alloc_info = {
+      .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .descriptorPool     = engine->tilemap_descriptor_pool,
+      .descriptorSetCount = 1,
+      .pSetLayouts        = &engine->tilemap_descriptor_set_layout,
+    };
+
+    if (vkAllocateDescriptorSets (
+          engine->device,
+          &alloc_info,
+          &tilemap->descriptor_set
+        ) != VK_SUCCESS)
+    {
+      moss__error ("Failed to allocate tilemap descriptor set.\n");
+      tilemap->descriptor_set = VK_NULL_HANDLE;
+      return MOSS_RESULT_ERROR;
+    }
+
+    const VkDescriptorBufferInfo buffer_info = {
+      .buffer = tilemap->buffer,
+      .offset = 0,
+      .range  = size,
+    };
+
+    const VkWriteDescriptorSet write = {
+      .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+      .dstSet          = tilemap->descriptor_set,
+      .dstBinding      = 0,
+      .dstArrayElement = 0,
+      .descriptorCount = 1,
+      .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+      .pBufferInfo     = &buffer_info,
+    };
+
+    vkUpdateDescriptorSets (engine->device, 1, &write, 0, NULL);
+  }
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static MossResult moss__upload_tile_rows (
+  MossTilemap *const    tilemap,
+  const size_t          first_tile,
+  const uint16_t *const tiles,
+  uint32_t              row_length,
+  uint32_t              row_count
+)
+{
+  MossEngine *const engine = tilemap->original_engine;
+
+  // Full-width rows are consecutive in the buffer and go as a single region
+  if (row_length == tilemap->width)
+  {
+    row_length *= row_count;
+    row_count = 1;
+  }
+
+  const size_t row_size  = (size_t)row_length * sizeof (uint16_t);
+  const size_t data_size = row_size * row_count;
+
+  VkBuffer     staging_buffer;
+  VkDeviceSize staging_offset;
+  void        *staging_memory;
+  if (moss__allocate_frame_upload (
+        engine,
+        (VkDeviceSize)data_size,
+        &staging_buffer,
+        &staging_offset,
+        &staging_memory
+      ) != MOSS_RESULT_SUCCESS)
+  {
+    moss__error ("Failed to upload tiles.\n");
+    return MOSS_RESULT_ERROR;
+  }
+
+  // Rect rows are packed in the passed tiles already, copies have no alignment
+  // requirements, so single tiles can be written
+  memcpy (staging_memory, tiles, data_size);
+
+  for (uint32_t row = 0; row < row_count; ++row)
+  {
+    const size_t row_first_tile = first_tile + (size_t)row * tilemap->width;
+
+    const Moss__FrameUploadCopy copy = {
+      .source_buffer      = staging_buffer,
+      .destination_buffer = tilemap->buffer,
+      .region =
+        {
+          .srcOffset = staging_offset + (VkDeviceSize)row * row_size,
+          .dstOffset = (VkDeviceSize)row_first_tile * sizeof (uint16_t),
+          .size      = (VkDeviceSize)row_size,
+        },
+    };
+    if (moss__push_frame_upload_copy (&engine->frame_upload_queue, &copy) !=
+        MOSS_RESULT_SUCCESS)
+    {
+      moss__error ("Failed to upload tiles.\n");
+      return MOSS_RESULT_ERROR;
+    }
+  }
+
+  engine->upload_queue.recorded_bytes += (uint64_t)data_size;
+
+  return MOSS_RESULT_SUCCESS;
+}
+
+inline static bool moss__get_visible_chunk_range (
+  const float     first_tile,
+  const float     last_tile,
+  const uint32_t  chunk_count,
+  uint32_t *const out_first,
+  uint32_t *const out_last
+)
+{
+  const float first_chunk = floorf (first_tile / (float)TILEMAP_CHUNK_SIZE);
+  const float last_chunk  = floorf (last_tile / (float)TILEMAP_CHUNK_SIZE);
+
+  if (last_chunk < 0.0F || first_chunk >= (float)chunk_count) { return false; }
+
+  *out_first = first_chunk < 0.0F ? 0 : (uint32_t)first_chunk;
+  *out_last =
+    last_chunk >= (float)chunk_count ? chunk_count - 1 : (uint32_t)last_chunk;
+
+  return true;
+}
@@ -0,0 +1,142 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file tests/test_frame_upload_queue.c
+  @brief Frame upload copy ordering tests.
+  @author Ilya Buravov (ilburale@gmail.com)
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+
+#include "src/internal/config.h"
+#include "src/internal/frame_upload_queue.h"
+
+/* Copies never reach a command buffer, so handles only have to differ. */
+#define STAGING_BUFFER (VkBuffer)(uintptr_t)(1)
+#define BUFFER_A       (VkBuffer)(uintptr_t)(2)
+#define BUFFER_B       (VkBuffer)(uintptr_t)(3)
+
+static Moss__FrameUploadCopy copies[ 8 ];
+static size_t                copy_count;
+
+static void reset_copies (void) { copy_count = 0; }
+
+static void
+push (const VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize size)
+{
+  copies[ copy_count++ ] = (Moss__FrameUploadCopy) {
+    .source_buffer      = STAGING_BUFFER,
+    .destination_buffer = buffer,
+    .region             = {.srcOffset = 0, .dstOffset = offset, .size = size},
+  };
+}
+
+static bool overlaps (const size_t first_copy)
+{
+  return moss__does_frame_upload_copy_overlap (copies, first_copy, copy_count - 1);
+}
+
+START_TEST (test_overlapping_copy_overlaps)
+{
+  push (BUFFER_A, 0, 64);
+  push (BUFFER_A, 48, 32);
+
+  ck_assert (overlaps (0));
+}
+END_TEST
+
+START_TEST (test_contained_copy_overlaps)
+{
+  // Whole batch copy followed by an update of its sprites
+  push (BUFFER_A, 0, 4096);
+  push (BUFFER_A, 1024, 64);
+
+  ck_assert (overlaps (0));
+}
+END_TEST
+
+START_TEST (test_adjacent_copies_do_not_overlap)
+{
+  push (BUFFER_A, 0, 64);
+  push (BUFFER_A, 64, 64);
+  push (BUFFER_A, 192, 32);
+  push (BUFFER_A, 128, 64);
+
+  ck_assert (!overlaps (0));
+}
+END_TEST
+
+START_TEST (test_copies_to_other_buffers_do_not_overlap)
+{
+  push (BUFFER_A, 0, 64);
+  push (BUFFER_B, 0, 64);
+
+  ck_assert (!overlaps (0));
+}
+END_TEST
+
+START_TEST (test_copies_before_barrier_are_ignored)
+{
+  push (BUFFER_A, 0, 64);
+  push (BUFFER_A, 128, 64);
+  push (BUFFER_A, 32, 16);
+
+  // Copy 0 is already ordered by a barrier
+  ck_assert (!overlaps (1));
+  ck_assert (overlaps (0));
+}
+END_TEST
+
+START_TEST (test_overlapping_tile_rows_overlap)
+{
+  // Second rect of the same tilemap shares a row with the first one
+  push (BUFFER_A, 64, 16);
+  push (BUFFER_A, 128, 16);
+  push (BUFFER_A, 136, 16);
+
+  ck_assert (overlaps (0));
+}
+END_TEST
+
+static Suite *frame_upload_queue_suite (void)
+{
+  Suite *const suite = suite_create ("FrameUploadQueue");
+
+  TCase *const overlap_case = tcase_create ("Overlap");
+  tcase_add_checked_fixture (overlap_case, reset_copies, NULL);
+  tcase_add_test (overlap_case, test_overlapping_copy_overlaps);
+  tcase_add_test (overlap_case, test_contained_copy_overlaps);
+  tcase_add_test (overlap_case, test_adjacent_copies_do_not_overlap);
+  tcase_add_test (overlap_case, test_copies_to_other_buffers_do_not_overlap);
+  tcase_add_test (overlap_case, test_copies_before_barrier_are_ignored);
+  tcase_add_test (overlap_case, test_overlapping_tile_rows_overlap);
+  suite_add_tcase (suite, overlap_case);
+
+  return suite;
+}
+
+int main (void)
+{
+  SRunner *const runner = srunner_create (frame_upload_queue_suite ());
+
+  srunner_run_all (runner, CK_NORMAL);
+  const int failed_count = srunner_ntests_failed (runner);
+  srunner_free (runner);
+
+  return failed_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,197 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file tests/test_sprite_dirty_ranges.c
+  @brief Dirty sprite range merging tests.
+  @author Ilya Buravov (ilburale@gmail.com)
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+
+#include "src/internal/config.h"
+#include "src/internal/sprite_dirty_ranges.h"
+
+/* One extra range holds the new one before the closest ranges are merged. */
+static MossSpriteBatchRange ranges[ MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT + 1 ];
+static uint32_t             range_count;
+
+static void reset_ranges (void) { range_count = 0; }
+
+static void merge (const uint32_t first_sprite, const uint32_t sprite_count)
+{
+  moss__merge_sprite_dirty_range (ranges, &range_count, first_sprite, sprite_count);
+}
+
+static void assert_range (
+  const uint32_t index,
+  const uint32_t first_sprite,
+  const uint32_t sprite_count
+)
+{
+  ck_assert_uint_eq (ranges[ index ].first_sprite, first_sprite);
+  ck_assert_uint_eq (ranges[ index ].sprite_count, sprite_count);
+}
+
+/* Fills ranges up to the cap, range i covers sprite i * 10. */
+static void fill_ranges (void)
+{
+  for (uint32_t i = 0; i < MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT; ++i) { merge (i * 10, 1); }
+  ck_assert_uint_eq (range_count, MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT);
+}
+
+START_TEST (test_disjoint_ranges_are_sorted)
+{
+  merge (20, 2);
+  merge (0, 2);
+  merge (10, 2);
+
+  ck_assert_uint_eq (range_count, 3);
+  assert_range (0, 0, 2);
+  assert_range (1, 10, 2);
+  assert_range (2, 20, 2);
+}
+END_TEST
+
+START_TEST (test_overlapping_ranges_are_joined)
+{
+  merge (0, 10);
+  merge (5, 10);
+
+  ck_assert_uint_eq (range_count, 1);
+  assert_range (0, 0, 15);
+
+  // Contained range changes nothing
+  merge (2, 3);
+
+  ck_assert_uint_eq (range_count, 1);
+  assert_range (0, 0, 15);
+}
+END_TEST
+
+START_TEST (test_spanning_range_absorbs_ranges)
+{
+  merge (0, 2);
+  merge (4, 2);
+  merge (8, 2);
+  merge (20, 2);
+
+  merge (1, 8);
+
+  ck_assert_uint_eq (range_count, 2);
+  assert_range (0, 0, 10);
+  assert_range (1, 20, 2);
+}
+END_TEST
+
+START_TEST (test_adjacent_ranges_are_joined)
+{
+  merge (5, 5);
+
+  // Touches the end of the range
+  merge (10, 5);
+  ck_assert_uint_eq (range_count, 1);
+  assert_range (0, 5, 10);
+
+  // Touches the start of the range
+  merge (0, 5);
+  ck_assert_uint_eq (range_count, 1);
+  assert_range (0, 0, 15);
+
+  // Fills the gap between two ranges exactly
+  merge (20, 5);
+  merge (15, 5);
+  ck_assert_uint_eq (range_count, 1);
+  assert_range (0, 0, 25);
+}
+END_TEST
+
+START_TEST (test_absorbed_range_does_not_merge_at_cap)
+{
+  fill_ranges ();
+
+  merge (0, 5);
+
+  ck_assert_uint_eq (range_count, MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT);
+  assert_range (0, 0, 5);
+  assert_range (1, 10, 1);
+}
+END_TEST
+
+START_TEST (test_closest_ranges_are_merged_over_cap)
+{
+  fill_ranges ();
+
+  // Gap of 2 to the last range is the smallest one
+  const uint32_t last = (MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT - 1) * 10;
+  merge (last + 3, 1);
+
+  ck_assert_uint_eq (range_count, MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT);
+  for (uint32_t i = 0; i + 1 < MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT; ++i)
+  {
+    assert_range (i, i * 10, 1);
+  }
+  assert_range (MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT - 1, last, 4);
+}
+END_TEST
+
+START_TEST (test_first_closest_ranges_are_merged_on_tie)
+{
+  fill_ranges ();
+
+  // Every gap is 9 but the new one, the first pair is merged
+  merge (1000, 1);
+
+  ck_assert_uint_eq (range_count, MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT);
+  assert_range (0, 0, 11);
+  assert_range (1, 20, 1);
+  assert_range (MAX_SPRITE_BATCH_DIRTY_RANGE_COUNT - 1, 1000, 1);
+}
+END_TEST
+
+static Suite *sprite_dirty_ranges_suite (void)
+{
+  Suite *const suite = suite_create ("SpriteDirtyRanges");
+
+  TCase *const merge_case = tcase_create ("Merge");
+  tcase_add_checked_fixture (merge_case, reset_ranges, NULL);
+  tcase_add_test (merge_case, test_disjoint_ranges_are_sorted);
+  tcase_add_test (merge_case, test_overlapping_ranges_are_joined);
+  tcase_add_test (merge_case, test_spanning_range_absorbs_ranges);
+  tcase_add_test (merge_case, test_adjacent_ranges_are_joined);
+  suite_add_tcase (suite, merge_case);
+
+  TCase *const cap_case = tcase_create ("Cap");
+  tcase_add_checked_fixture (cap_case, reset_ranges, NULL);
+  tcase_add_test (cap_case, test_absorbed_range_does_not_merge_at_cap);
+  tcase_add_test (cap_case, test_closest_ranges_are_merged_over_cap);
+  tcase_add_test (cap_case, test_first_closest_ranges_are_merged_on_tie);
+  suite_add_tcase (suite, cap_case);
+
+  return suite;
+}
+
+int main (void)
+{
+  SRunner *const runner = srunner_create (sprite_dirty_ranges_suite ());
+
+  srunner_run_all (runner, CK_NORMAL);
+  const int failed_count = srunner_ntests_failed (runner);
+  srunner_free (runner);
+
+  return failed_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
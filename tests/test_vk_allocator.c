@@ -0,0 +1,294 @@
+/*
+  Copyright 2025 Osfabias
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  @file tests/test_vk_allocator.c
+  @brief Device memory block free list tests.
+  @author Ilya Buravov (ilburale@gmail.com)
+  @details Blocks are built without device memory, only their free lists are
+           exercised, so no device is needed.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <check.h>
+
+#include "src/internal/config.h"
+#include "src/internal/host_allocator.h"
+#include "src/internal/vulkan/utils/allocator.h"
+
+#define BLOCK_SIZE (VkDeviceSize)(1024)
+
+static Moss__HostAllocator host_allocator;
+static Moss__VkAllocator   allocator;
+static Moss__VkMemoryBlock block;
+
+static void setup_block (void)
+{
+  moss__init_host_allocator (&host_allocator, NULL);
+
+  moss_vk__init_allocator_state (&allocator);
+  allocator.host_allocator = &host_allocator;
+
+  block = (Moss__VkMemoryBlock) {
+    .memory              = VK_NULL_HANDLE,
+    .size                = BLOCK_SIZE,
+    .mapped_memory       = NULL,
+    .memory_type_index   = 0,
+    .tiling              = MOSS__VK_RESOURCE_TILING_LINEAR,
+    .free_ranges         = NULL,
+    .free_range_count    = 0,
+    .free_range_capacity = 0,
+    .allocation_count    = 0,
+  };
+
+  const Moss__VkMemoryRange whole_range = { .offset = 0, .size = block.size };
+  ck_assert_int_eq (
+    moss_vk__insert_free_range (&allocator, &block, 0, whole_range),
+    MOSS_RESULT_SUCCESS
+  );
+}
+
+static void teardown_block (void) { moss__free (&host_allocator, block.free_ranges); }
+
+static VkDeviceSize allocate (const VkDeviceSize size, const VkDeviceSize alignment)
+{
+  VkDeviceSize offset = 0;
+  ck_assert (moss_vk__allocate_from_block (&allocator, &block, size, alignment, &offset));
+  ck_assert_uint_eq (offset % alignment, 0);
+  return offset;
+}
+
+static void release (const VkDeviceSize offset, const VkDeviceSize size)
+{
+  moss_vk__free_block_range (&allocator, &block, offset, size);
+}
+
+static void assert_free_range (
+  const size_t       index,
+  const VkDeviceSize offset,
+  const VkDeviceSize size
+)
+{
+  ck_assert_uint_lt (index, block.free_range_count);
+  ck_assert_uint_eq (block.free_ranges[ index ].offset, offset);
+  ck_assert_uint_eq (block.free_ranges[ index ].size, size);
+}
+
+START_TEST (test_allocation_splits_tail)
+{
+  ck_assert_uint_eq (allocate (256, 1), 0);
+
+  ck_assert_uint_eq (block.free_range_count, 1);
+  assert_free_range (0, 256, BLOCK_SIZE - 256);
+}
+END_TEST
+
+START_TEST (test_aligned_allocation_splits_head_and_tail)
+{
+  ck_assert_uint_eq (allocate (100, 1), 0);
+  ck_assert_uint_eq (allocate (64, 256), 256);
+
+  ck_assert_uint_eq (block.free_range_count, 2);
+  assert_free_range (0, 100, 156);
+  assert_free_range (1, 320, BLOCK_SIZE - 320);
+}
+END_TEST
+
+START_TEST (test_aligned_allocation_splits_head)
+{
+  ck_assert_uint_eq (allocate (100, 1), 0);
+  ck_assert_uint_eq (allocate (BLOCK_SIZE - 512, 512), 512);
+
+  ck_assert_uint_eq (block.free_range_count, 1);
+  assert_free_range (0, 100, 412);
+}
+END_TEST
+
+START_TEST (test_exact_fit_removes_range)
+{
+  ck_assert_uint_eq (allocate (BLOCK_SIZE, 1), 0);
+  ck_assert_uint_eq (block.free_range_count, 0);
+
+  VkDeviceSize offset = 0;
+  ck_assert (!moss_vk__allocate_from_block (&allocator, &block, 1, 1, &offset));
+}
+END_TEST
+
+START_TEST (test_first_fit_skips_small_ranges)
+{
+  ck_assert_uint_eq (allocate (16, 1), 0);
+  ck_assert_uint_eq (allocate (48, 1), 16);
+  ck_assert_uint_eq (allocate (64, 1), 64);
+  release (16, 48);
+
+  // Freed range is too small
+  ck_assert_uint_eq (allocate (64, 1), 128);
+
+  // Freed range is large enough, but not once aligned
+  ck_assert_uint_eq (allocate (32, 64), 192);
+  ck_assert_uint_eq (allocate (32, 16), 16);
+
+  ck_assert_uint_eq (block.free_range_count, 2);
+  assert_free_range (0, 48, 16);
+  assert_free_range (1, 224, BLOCK_SIZE - 224);
+}
+END_TEST
+
+START_TEST (test_free_merges_next_range)
+{
+  const VkDeviceSize first  = allocate (256, 1);
+  const VkDeviceSize second = allocate (256, 1);
+
+  release (second, 256);
+  ck_assert_uint_eq (block.free_range_count, 1);
+  assert_free_range (0, 256, BLOCK_SIZE - 256);
+
+  release (first, 256);
+  ck_assert_uint_eq (block.free_range_count, 1);
+  assert_free_range (0, 0, BLOCK_SIZE);
+}
+END_TEST
+
+START_TEST (test_free_merges_previous_range)
+{
+  VkDeviceSize offsets[ 4 ];
+  for (size_t i = 0; i < 4; ++i) { offsets[ i ] = allocate (BLOCK_SIZE / 4, 1); }
+  ck_assert_uint_eq (block.free_range_count, 0);
+
+  release (offsets[ 0 ], BLOCK_SIZE / 4);
+  release (offsets[ 1 ], BLOCK_SIZE / 4);
+
+  ck_assert_uint_eq (block.free_range_count, 1);
+  assert_free_range (0, 0, BLOCK_SIZE / 2);
+}
+END_TEST
+
+START_TEST (test_free_merges_both_ranges)
+{
+  VkDeviceSize offsets[ 4 ];
+  for (size_t i = 0; i < 4; ++i) { offsets[ i ] = allocate (BLOCK_SIZE / 4, 1); }
+
+  // Disjoint ranges stay sorted by offset
+  release (offsets[ 2 ], BLOCK_SIZE / 4);
+  release (offsets[ 0 ], BLOCK_SIZE / 4);
+
+  ck_assert_uint_eq (block.free_range_count, 2);
+  assert_free_range (0, offsets[ 0 ], BLOCK_SIZE / 4);
+  assert_free_range (1, offsets[ 2 ], BLOCK_SIZE / 4);
+
+  release (offsets[ 1 ], BLOCK_SIZE / 4);
+
+  ck_assert_uint_eq (block.free_range_count, 1);
+  assert_free_range (0, 0, 3 * BLOCK_SIZE / 4);
+
+  release (offsets[ 3 ], BLOCK_SIZE / 4);
+
+  ck_assert_uint_eq (block.free_range_count, 1);
+  assert_free_range (0, 0, BLOCK_SIZE);
+}
+END_TEST
+
+START_TEST (test_free_list_grows)
+{
+  // Every other allocation is freed, so each leaves a separate range
+  const size_t range_count = 32;
+  for (size_t i = 0; i < range_count; ++i) { allocate (16, 1); }
+  for (size_t i = 0; i < range_count; i += 2) { release (i * 16, 16); }
+
+  ck_assert_uint_eq (block.free_range_count, range_count / 2 + 1);
+  for (size_t i = 0; i < range_count / 2; ++i) { assert_free_range (i, i * 32, 16); }
+  assert_free_range (range_count / 2, range_count * 16, BLOCK_SIZE - range_count * 16);
+}
+END_TEST
+
+START_TEST (test_empty_block_is_kept)
+{
+  // Only standard size block of its memory type is kept, device memory is not touched
+  Moss__VkMemoryBlock standard_block  = block;
+  standard_block.size                  = MEMORY_BLOCK_SIZE;
+  standard_block.free_ranges[ 0 ].size = MEMORY_BLOCK_SIZE;
+
+  Moss__VkMemoryBlock *blocks[] = { &standard_block };
+  allocator.blocks              = blocks;
+  allocator.block_count         = 1;
+  allocator.block_capacity      = 1;
+
+  VkDeviceSize offset = 0;
+  ck_assert (
+    moss_vk__allocate_from_block (&allocator, &standard_block, 256, 256, &offset)
+  );
+  ++standard_block.allocation_count;
+  ++allocator.allocation_count;
+  allocator.allocation_bytes += 256;
+
+  Moss__VkAllocation allocation = {
+    .block         = &standard_block,
+    .memory        = standard_block.memory,
+    .offset        = offset,
+    .size          = 256,
+    .mapped_memory = NULL,
+  };
+  moss_vk__free_memory (&allocator, &allocation);
+
+  ck_assert_ptr_null (allocation.block);
+  ck_assert_uint_eq (allocator.block_count, 1);
+  ck_assert_uint_eq (allocator.allocation_count, 0);
+  ck_assert_uint_eq (standard_block.allocation_count, 0);
+  ck_assert_uint_eq (standard_block.free_range_count, 1);
+  ck_assert_uint_eq (standard_block.free_ranges[ 0 ].offset, 0);
+  ck_assert_uint_eq (standard_block.free_ranges[ 0 ].size, MEMORY_BLOCK_SIZE);
+
+  // Free ranges are shared with the fixture block, which frees them
+  block.free_ranges = standard_block.free_ranges;
+}
+END_TEST
+
+static Suite *vk_allocator_suite (void)
+{
+  Suite *const suite = suite_create ("VkAllocator");
+
+  TCase *const allocate_case = tcase_create ("Allocate");
+  tcase_add_checked_fixture (allocate_case, setup_block, teardown_block);
+  tcase_add_test (allocate_case, test_allocation_splits_tail);
+  tcase_add_test (allocate_case, test_aligned_allocation_splits_head_and_tail);
+  tcase_add_test (allocate_case, test_aligned_allocation_splits_head);
+  tcase_add_test (allocate_case, test_exact_fit_removes_range);
+  tcase_add_test (allocate_case, test_first_fit_skips_small_ranges);
+  suite_add_tcase (suite, allocate_case);
+
+  TCase *const free_case = tcase_create ("Free");
+  tcase_add_checked_fixture (free_case, setup_block, teardown_block);
+  tcase_add_test (free_case, test_free_merges_next_range);
+  tcase_add_test (free_case, test_free_merges_previous_range);
+  tcase_add_test (free_case, test_free_merges_both_ranges);
+  tcase_add_test (free_case, test_free_list_grows);
+  tcase_add_test (free_case, test_empty_block_is_kept);
+  suite_add_tcase (suite, free_case);
+
+  return suite;
+}
+
+int main (void)
+{
+  SRunner *const runner = srunner_create (vk_allocator_suite ());
+
+  srunner_run_all (runner, CK_NORMAL);
+  const int failed_count = srunner_ntests_failed (runner);
+  srunner_free (runner);
+
+  return failed_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}